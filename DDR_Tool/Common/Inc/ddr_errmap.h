@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    ddr_errmap.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_errmap.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_ERRMAP_H
+#define __DDR_ERRMAP_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* default number of error lines printed by the tests */
+#define DDR_ERRMAP_LINE_MAX       32UL
+
+/* tests and rows counted separately, the others are grouped */
+#define DDR_ERRMAP_TEST_MAX       16U
+#define DDR_ERRMAP_ROW_MAX        16U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void DDR_ErrMap_Enable(bool enable, unsigned long line_max);
+bool DDR_ErrMap_IsEnabled(void);
+void DDR_ErrMap_Start(void);
+void DDR_ErrMap_SetTest(const char *name);
+bool DDR_ErrMap_Record(unsigned long offset, unsigned long expected,
+                       unsigned long read);
+bool DDR_ErrMap_Line(void);
+void DDR_ErrMap_Print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DDR_ERRMAP_H */
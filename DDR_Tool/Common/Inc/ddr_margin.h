@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    ddr_margin.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_margin.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_MARGIN_H
+#define __DDR_MARGIN_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* maximum number of points of a map line or column */
+#define DDR_MARGIN_POINT_MAX      65U
+
+/* Exported types ------------------------------------------------------------*/
+/*
+ * One PHY setting swept around its trained value, seen as a linear position
+ * in [min, max] whatever its register encoding.
+ */
+typedef struct {
+  const char *name;                         /* printed name */
+  int32_t min;                              /* lowest position */
+  int32_t max;                              /* highest position */
+  uint32_t tick_fs;                         /* delay of one position in fs,
+                                               0 when not a delay or unknown */
+  int32_t (*get)(uint32_t lane);            /* position of a lane */
+  void (*set)(uint32_t lane, int32_t pos);  /* program a lane */
+} DDR_MarginAxisTypeDef;
+
+typedef struct {
+  const DDR_MarginAxisTypeDef *x;           /* swept on the columns */
+  const DDR_MarginAxisTypeDef *y;           /* swept on the rows of a 2D eye of
+                                               the first lane, NULL for one
+                                               row per lane */
+  int32_t x_range;                          /* positions around the trained */
+  int32_t x_step;
+  int32_t y_range;
+  int32_t y_step;
+  uint32_t lane;                            /* first lane */
+  uint32_t nb_lane;                         /* number of lanes */
+  const char *lane_name;                    /* printed lane prefix */
+  unsigned long (*lane_mask)(uint32_t lane);  /* data bits of a lane in a
+                                                 word of the kernel */
+  uintptr_t addr;                           /* kernel buffer */
+  unsigned long size;
+  void (*flush)(uintptr_t addr, unsigned long size);  /* write back the
+                                                         kernel buffer, or
+                                                         NULL */
+} DDR_MarginCfgTypeDef;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+unsigned long DDR_Margin_Check(const DDR_MarginCfgTypeDef *cfg);
+int DDR_Margin_Run(const DDR_MarginCfgTypeDef *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DDR_MARGIN_H */
@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    ddr_pmu.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_pmu.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_PMU_H
+#define __DDR_PMU_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* event counters used: 4 on Cortex-A7, 6 on Cortex-A35 */
+#define DDR_PMU_CNT_NB            6U
+
+/* common architectural events */
+#define DDR_PMU_L1I_REFILL        0x01U
+#define DDR_PMU_L1D_REFILL        0x03U
+#define DDR_PMU_L1D_ACCESS        0x04U
+#define DDR_PMU_INST_RETIRED      0x08U
+#define DDR_PMU_BR_MIS_PRED       0x10U
+#define DDR_PMU_MEM_ACCESS        0x13U
+#define DDR_PMU_L2D_ACCESS        0x16U
+#define DDR_PMU_L2D_REFILL        0x17U
+#define DDR_PMU_L2D_WB            0x18U
+#define DDR_PMU_BUS_ACCESS        0x19U
+#define DDR_PMU_STALL_FRONTEND    0x23U  /* Armv8 only */
+#define DDR_PMU_STALL_BACKEND     0x24U  /* Armv8 only */
+#define DDR_PMU_BUS_READ          0x60U
+#define DDR_PMU_BUS_WRITE         0x61U
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct {
+  uint64_t cycles;                      /* CPU cycles */
+  uint32_t event[DDR_PMU_CNT_NB];       /* events of each counter */
+  uint32_t overflow;                    /* counters overflow, bit 31: cycles */
+  uint64_t time_us;                     /* duration of the measure */
+} DDR_PmuCountTypeDef;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void DDR_PMU_Enable(bool enable);
+bool DDR_PMU_IsEnabled(void);
+uint32_t DDR_PMU_GetNbCounters(void);
+int DDR_PMU_SetEvent(uint32_t counter, uint32_t event);
+uint32_t DDR_PMU_GetEvent(uint32_t counter);
+const char *DDR_PMU_EventName(uint32_t event);
+void DDR_PMU_Start(void);
+void DDR_PMU_Stop(DDR_PmuCountTypeDef *count);
+void DDR_PMU_Print(const DDR_PmuCountTypeDef *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DDR_PMU_H */
@@ -0,0 +1,54 @@
+/**
+  ******************************************************************************
+  * @file    ddr_script.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_script.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_SCRIPT_H
+#define __DDR_SCRIPT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* size of the script uploaded on the console */
+#define DDR_SCRIPT_SIZE_MAX       0x1000U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+bool DDR_Script_SelectBuiltin(void);
+void DDR_Script_BeginLoad(void);
+bool DDR_Script_IsLoading(void);
+void DDR_Script_LoadLine(const char *line);
+int DDR_Script_Start(unsigned long loop, bool stop_on_fail);
+void DDR_Script_Stop(void);
+bool DDR_Script_IsRunning(void);
+bool DDR_Script_GetLine(char *line, size_t size);
+void DDR_Script_Result(bool pass);
+void DDR_Script_Print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DDR_SCRIPT_H */
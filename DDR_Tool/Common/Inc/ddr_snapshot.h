@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    ddr_snapshot.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_snapshot.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_SNAPSHOT_H
+#define __DDR_SNAPSHOT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+/*
+ * binary snapshot, little endian: this header followed by the nb register
+ * values, in the order of the register layout identified by its CRC32
+ */
+typedef struct {
+  uint32_t magic;               /* DDR_SNAP_MAGIC */
+  uint16_t version;             /* DDR_SNAP_VERSION */
+  uint16_t header_size;         /* bytes before the values */
+  uint32_t layout;              /* CRC32 of the register names */
+  uint32_t nb;                  /* number of values */
+  uint32_t speed;               /* DDR frequency in kHz */
+  uint32_t crc;                 /* CRC32 of the values */
+} DDR_SnapHeaderTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define DDR_SNAP_MAGIC            0x50414E53U   /* "SNAP" */
+#define DDR_SNAP_VERSION          1U
+
+/* snapshots kept in memory and their maximum number of registers */
+#define DDR_SNAP_SLOT_NB          4U
+#define DDR_SNAP_REG_MAX          320U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+int DDR_Snap_Save(uint32_t slot, uint32_t speed);
+int DDR_Snap_Diff(uint32_t slot_a, int32_t slot_b);
+int DDR_Snap_Restore(uint32_t slot);
+int DDR_Snap_Dump(uint32_t slot);
+void DDR_Snap_Layout(void);
+void DDR_Snap_Print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DDR_SNAPSHOT_H */
@@ -26,15 +26,25 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32_device_hal.h"
+#include <stdbool.h>
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 
+uint64_t time_get_counter(void);
+uint64_t time_get_frequency(void);
+uint64_t time_counter_to_us(uint64_t count);
+uint64_t time_counter_to_ns(uint64_t count);
+uint64_t time_get_us(void);
+uint64_t time_get_ns(void);
+uint64_t time_elapsed_us(uint64_t start);
+uint64_t time_elapsed_ns(uint64_t start);
+
 void delay_us(unsigned long delay_us);
-__IO uint32_t timeout_init_us(unsigned long timeout_us);
-bool timeout_elapsed(__IO uint32_t timeout);
+uint64_t timeout_init_us(unsigned long timeout_us);
+bool timeout_elapsed(uint64_t timeout);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,60 @@
+/**
+  ******************************************************************************
+  * @file    uart_tx.h
+  * @author  MCD Application Team
+  * @brief   Header for uart_tx.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __UART_TX_H
+#define __UART_TX_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct {
+  unsigned long written;        /* bytes accepted in the buffer */
+  unsigned long dropped;        /* bytes lost on a full buffer */
+  unsigned long overflow;       /* writes which did not fit in the buffer */
+  unsigned long peak;           /* highest number of bytes buffered */
+} UART_TX_StatsTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+/* size of the transmit buffer, power of 2 */
+#define UART_TX_BUF_SIZE          0x2000U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void UART_TX_Init(UART_HandleTypeDef *huart, bool irq,
+                  void (*flush)(uintptr_t addr, unsigned long size));
+int UART_TX_Write(const char *data, int len);
+void UART_TX_Poll(void);
+void UART_TX_Flush(void);
+void UART_TX_SetDrop(bool drop);
+bool UART_TX_GetDrop(void);
+unsigned long UART_TX_GetLevel(void);
+void UART_TX_GetStats(UART_TX_StatsTypeDef *stats);
+void UART_TX_ResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_TX_H */
@@ -0,0 +1,504 @@
+/**
+  ******************************************************************************
+  * @file    ddr_errmap.c
+  * @author  MCD Application Team
+  * @brief   Error map of the DDR tests: when enabled, the tests continue after
+  *          a data error and the errors are counted per data bit, byte lane,
+  *          bank, row, column and test, with a summary at the end of the
+  *          test command and a limited number of error lines.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32_device_hal.h"
+#include "ddr_errmap.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* DDRCTRL address map field giving the HIF address bit of an address bit */
+typedef struct {
+  uint8_t reg;                    /* ADDRMAP<reg> */
+  uint8_t shift;
+  uint8_t mask;                   /* all ones: address bit not used */
+  uint8_t base;                   /* internal base added to the field */
+} errmap_field;
+
+typedef struct {
+  uint32_t bank;
+  uint32_t row;
+  unsigned long count;
+} errmap_row;
+
+typedef struct {
+  const char *name;
+  unsigned long count;
+} errmap_test;
+
+/* Private define ------------------------------------------------------------*/
+#if defined(__AARCH64__)
+#define ERRMAP_DDRC               DDRC
+#define ERRMAP_BUS_WIDTH_Msk      DDRC_MSTR_DATA_BUS_WIDTH_Msk
+#define ERRMAP_BUS_WIDTH_Pos      DDRC_MSTR_DATA_BUS_WIDTH_Pos
+#else
+#define ERRMAP_DDRC               DDRCTRL
+#define ERRMAP_BUS_WIDTH_Msk      DDRCTRL_MSTR_DATA_BUS_WIDTH_Msk
+#define ERRMAP_BUS_WIDTH_Pos      DDRCTRL_MSTR_DATA_BUS_WIDTH_Pos
+#endif
+
+/* HIF address unit is the full DRAM data bus width (32 bits) */
+#define ERRMAP_HIF_SHIFT          2U
+#define ERRMAP_WIDTH_QUARTER      2U
+#define ERRMAP_WORD_BITS          (sizeof(unsigned long) * 8U)
+#define ERRMAP_DQ_NB              32U
+#define ERRMAP_LANE_NB            (ERRMAP_DQ_NB / 8U)
+
+/* 3 bank bits and 2 bank group bits */
+#define ERRMAP_BANK_NB            32U
+#define ERRMAP_COL_BUCKET_BITS    3U
+#define ERRMAP_COL_BUCKET_NB      (1U << ERRMAP_COL_BUCKET_BITS)
+
+/* ADDRMAP5 row bits 2 to 10 field, all ones: given by ADDRMAP9 to 11 */
+#define ERRMAP_ROW_B2_10_SHIFT    16U
+#define ERRMAP_ROW_B2_10_MASK     0xFU
+
+/* counters printed on a line */
+#define ERRMAP_PRINT_LINE         8U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const errmap_field field_bank[] = {
+  {1U, 0U, 0x3FU, 2U}, {1U, 8U, 0x3FU, 3U}, {1U, 16U, 0x3FU, 4U},
+};
+
+static const errmap_field field_bg[] = {
+  {8U, 0U, 0x3FU, 2U}, {8U, 8U, 0x3FU, 3U},
+};
+
+/* column bits 0 and 1 are the HIF address bits 0 and 1 */
+static const errmap_field field_col[] = {
+  {2U, 0U, 0xFU, 2U}, {2U, 8U, 0xFU, 3U}, {2U, 16U, 0xFU, 4U},
+  {2U, 24U, 0xFU, 5U}, {3U, 0U, 0xFU, 6U}, {3U, 8U, 0x1FU, 7U},
+  {3U, 16U, 0x1FU, 8U}, {3U, 24U, 0x1FU, 9U}, {4U, 0U, 0x1FU, 10U},
+  {4U, 8U, 0x1FU, 11U},
+};
+
+static const errmap_field field_row_low[] = {
+  {5U, 0U, 0xFU, 6U}, {5U, 8U, 0xFU, 7U},
+};
+
+/* row bits 2 to 10: ADDRMAP5 field with base 8 to 16, or ADDRMAP9 to 11 */
+static const errmap_field field_row_b2_10[] = {
+  {9U, 0U, 0xFU, 8U}, {9U, 8U, 0xFU, 9U}, {9U, 16U, 0xFU, 10U},
+  {9U, 24U, 0xFU, 11U}, {10U, 0U, 0xFU, 12U}, {10U, 8U, 0xFU, 13U},
+  {10U, 16U, 0xFU, 14U}, {10U, 24U, 0xFU, 15U}, {11U, 0U, 0xFU, 16U},
+};
+
+static const errmap_field field_row_high[] = {
+  {5U, 24U, 0xFU, 17U}, {6U, 0U, 0xFU, 18U}, {6U, 8U, 0xFU, 19U},
+  {6U, 16U, 0xFU, 20U}, {6U, 24U, 0xFU, 21U},
+};
+
+static struct {
+  bool enabled;
+  unsigned long line_max;
+  unsigned long line;             /* error lines printed */
+  unsigned long line_drop;        /* error lines not printed */
+  uint32_t addrmap[12];           /* ADDRMAP1 to ADDRMAP11 at the start */
+  uint32_t width;                 /* MSTR.DATA_BUS_WIDTH */
+  unsigned int col_bits;
+  unsigned long error;            /* words in error */
+  unsigned long bit;              /* bits in error */
+  unsigned long first_offset;
+  unsigned long first_expected;
+  unsigned long first_read;
+  unsigned long dq[ERRMAP_DQ_NB];
+  unsigned long lane[ERRMAP_LANE_NB];
+  unsigned long bank[ERRMAP_BANK_NB];
+  unsigned long col[ERRMAP_COL_BUCKET_NB];
+  errmap_row row[DDR_ERRMAP_ROW_MAX];
+  uint32_t row_nb;
+  unsigned long row_other;
+  errmap_test test[DDR_ERRMAP_TEST_MAX];
+  uint32_t test_nb;
+  unsigned long test_other;
+  const char *test_name;          /* test in progress */
+} errmap = {
+  .line_max = DDR_ERRMAP_LINE_MAX,
+};
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/*
+ * value of the address bits described by nb fields, from the bit first of
+ * the value, in the HIF address hif; stops at the first unused bit
+ */
+static uint32_t errmap_decode(const errmap_field *field, unsigned int nb,
+                              unsigned int first, unsigned long hif,
+                              unsigned int *bits)
+{
+  uint32_t value = 0U;
+  uint32_t f;
+  unsigned int i;
+
+  for (i = 0U; i < nb; i++)
+  {
+    f = (errmap.addrmap[field[i].reg] >> field[i].shift) & field[i].mask;
+    if (f == field[i].mask)
+    {
+      break;
+    }
+    value |= (uint32_t)((hif >> (f + field[i].base)) & 1UL) << (first + i);
+  }
+
+  if (bits != NULL)
+  {
+    *bits = first + i;
+  }
+
+  return value;
+}
+
+static void errmap_read_addrmap(void)
+{
+  errmap.addrmap[1] = READ_REG(ERRMAP_DDRC->ADDRMAP1);
+  errmap.addrmap[2] = READ_REG(ERRMAP_DDRC->ADDRMAP2);
+  errmap.addrmap[3] = READ_REG(ERRMAP_DDRC->ADDRMAP3);
+  errmap.addrmap[4] = READ_REG(ERRMAP_DDRC->ADDRMAP4);
+  errmap.addrmap[5] = READ_REG(ERRMAP_DDRC->ADDRMAP5);
+  errmap.addrmap[6] = READ_REG(ERRMAP_DDRC->ADDRMAP6);
+#if defined(__AARCH64__)
+  errmap.addrmap[8] = READ_REG(ERRMAP_DDRC->ADDRMAP8);
+#else
+  /* no bank group on STM32MP1 */
+  errmap.addrmap[8] = 0x3F3FU;
+#endif
+  errmap.addrmap[9] = READ_REG(ERRMAP_DDRC->ADDRMAP9);
+  errmap.addrmap[10] = READ_REG(ERRMAP_DDRC->ADDRMAP10);
+  errmap.addrmap[11] = READ_REG(ERRMAP_DDRC->ADDRMAP11);
+
+  errmap.width = (READ_REG(ERRMAP_DDRC->MSTR) & ERRMAP_BUS_WIDTH_Msk) >>
+                 ERRMAP_BUS_WIDTH_Pos;
+  if (errmap.width > ERRMAP_WIDTH_QUARTER)
+  {
+    errmap.width = 0U;
+  }
+
+  (void)errmap_decode(field_col, 10U, 2U, 0UL, &errmap.col_bits);
+}
+
+/*
+ * bank (bank group in the upper bits), row and column of a byte offset in the
+ * DDR, the column decoded with the full bus width mapping
+ */
+static void errmap_locate(unsigned long offset, uint32_t *bank, uint32_t *row,
+                          uint32_t *col)
+{
+  unsigned long hif = offset >> (ERRMAP_HIF_SHIFT - errmap.width);
+  errmap_field field = {5U, ERRMAP_ROW_B2_10_SHIFT, ERRMAP_ROW_B2_10_MASK, 8U};
+  unsigned int i;
+
+  *bank = errmap_decode(field_bank, 3U, 0U, hif, NULL) |
+          errmap_decode(field_bg, 2U, 3U, hif, NULL);
+
+  *row = errmap_decode(field_row_low, 2U, 0U, hif, NULL);
+  if (((errmap.addrmap[5] >> ERRMAP_ROW_B2_10_SHIFT) & ERRMAP_ROW_B2_10_MASK)
+      == ERRMAP_ROW_B2_10_MASK)
+  {
+    *row |= errmap_decode(field_row_b2_10, 9U, 2U, hif, NULL);
+  }
+  else
+  {
+    /* one field for the row bits 2 to 10, with successive bases */
+    for (i = 0U; i < 9U; i++, field.base++)
+    {
+      *row |= errmap_decode(&field, 1U, 2U + i, hif, NULL);
+    }
+  }
+  *row |= errmap_decode(field_row_high, 5U, 11U, hif, NULL);
+
+  *col = (uint32_t)(hif & 3UL) | errmap_decode(field_col, 10U, 2U, hif, NULL);
+}
+
+static void errmap_count_row(uint32_t bank, uint32_t row)
+{
+  uint32_t i;
+
+  for (i = 0U; i < errmap.row_nb; i++)
+  {
+    if ((errmap.row[i].bank == bank) && (errmap.row[i].row == row))
+    {
+      errmap.row[i].count++;
+      return;
+    }
+  }
+
+  if (errmap.row_nb < DDR_ERRMAP_ROW_MAX)
+  {
+    errmap.row[errmap.row_nb].bank = bank;
+    errmap.row[errmap.row_nb].row = row;
+    errmap.row[errmap.row_nb].count = 1UL;
+    errmap.row_nb++;
+    return;
+  }
+
+  errmap.row_other++;
+}
+
+static void errmap_count_test(void)
+{
+  uint32_t i;
+
+  for (i = 0U; i < errmap.test_nb; i++)
+  {
+    if (errmap.test[i].name == errmap.test_name)
+    {
+      errmap.test[i].count++;
+      return;
+    }
+  }
+
+  if (errmap.test_nb < DDR_ERRMAP_TEST_MAX)
+  {
+    errmap.test[errmap.test_nb].name = errmap.test_name;
+    errmap.test[errmap.test_nb].count = 1UL;
+    errmap.test_nb++;
+    return;
+  }
+
+  errmap.test_other++;
+}
+
+/* "<title> <index>=<count>..." for the non zero counters */
+static void errmap_print_hist(const char *title, const unsigned long *count,
+                              unsigned int nb)
+{
+  unsigned int i;
+  unsigned int n = 0U;
+
+  printf("  %-8s", title);
+  for (i = 0U; i < nb; i++)
+  {
+    if (count[i] == 0UL)
+    {
+      continue;
+    }
+    if ((n != 0U) && ((n % ERRMAP_PRINT_LINE) == 0U))
+    {
+      printf("\n\r  %-8s", "");
+    }
+    printf(" %u=%lu", i, count[i]);
+    n++;
+  }
+  printf("\n\r");
+}
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Enable or disable the error map of the tests.
+  * @param  enable: when true, the tests continue after a data error
+  * @param  line_max: error lines printed by a test command, 0 for the default
+  * @retval None
+  */
+void DDR_ErrMap_Enable(bool enable, unsigned long line_max)
+{
+  errmap.enabled = enable;
+  errmap.line_max = (line_max != 0UL) ? line_max : DDR_ERRMAP_LINE_MAX;
+
+  if (enable)
+  {
+    errmap_read_addrmap();
+  }
+}
+
+bool DDR_ErrMap_IsEnabled(void)
+{
+  return errmap.enabled;
+}
+
+/**
+  * @brief  Clear the error map at the start of a test command.
+  * @retval None
+  */
+void DDR_ErrMap_Start(void)
+{
+  bool enabled = errmap.enabled;
+  unsigned long line_max = errmap.line_max;
+
+  memset(&errmap, 0, sizeof(errmap));
+  errmap.enabled = enabled;
+  errmap.line_max = line_max;
+
+  if (enabled)
+  {
+    errmap_read_addrmap();
+  }
+}
+
+/**
+  * @brief  Select the test charged with the next errors.
+  * @param  name: name of the test, kept as a pointer
+  * @retval None
+  */
+void DDR_ErrMap_SetTest(const char *name)
+{
+  errmap.test_name = name;
+}
+
+/**
+  * @brief  Record a data error in the error map.
+  * @param  offset: offset in the DDR of the word in error
+  * @param  expected: value written
+  * @param  read: value read
+  * @retval true when the caller prints the error line, see DDR_ErrMap_Line
+  */
+bool DDR_ErrMap_Record(unsigned long offset, unsigned long expected,
+                       unsigned long read)
+{
+  unsigned long diff = expected ^ read;
+  uint32_t bus_bytes;
+  uint32_t bank, row, col;
+  unsigned int first = ERRMAP_WORD_BITS;
+  unsigned int b, dq;
+
+  if (!errmap.enabled)
+  {
+    return true;
+  }
+
+  if (errmap.error == 0UL)
+  {
+    errmap.first_offset = offset;
+    errmap.first_expected = expected;
+    errmap.first_read = read;
+  }
+  errmap.error++;
+  errmap_count_test();
+
+  /* DQ of each bit: bytes of the word on the successive byte lanes */
+  bus_bytes = ERRMAP_LANE_NB >> errmap.width;
+  for (b = 0U; b < ERRMAP_WORD_BITS; b++)
+  {
+    if (((diff >> b) & 1UL) == 0UL)
+    {
+      continue;
+    }
+    if (first == ERRMAP_WORD_BITS)
+    {
+      first = b;
+    }
+    dq = (unsigned int)(((offset + b / 8U) % bus_bytes) * 8U) + (b % 8U);
+    errmap.dq[dq]++;
+    errmap.bit++;
+  }
+
+  for (b = 0U; b < sizeof(unsigned long); b++)
+  {
+    if (((diff >> (b * 8U)) & 0xFFUL) != 0UL)
+    {
+      errmap.lane[(offset + b) % bus_bytes]++;
+    }
+  }
+
+  /* location of the first byte in error */
+  errmap_locate(offset + first / 8U, &bank, &row, &col);
+  errmap.bank[bank]++;
+  errmap_count_row(bank, row);
+  if (errmap.col_bits > ERRMAP_COL_BUCKET_BITS)
+  {
+    col >>= errmap.col_bits - ERRMAP_COL_BUCKET_BITS;
+  }
+  errmap.col[col % ERRMAP_COL_BUCKET_NB]++;
+
+  return DDR_ErrMap_Line();
+}
+
+/**
+  * @brief  Request to print an error line, limited by the error map.
+  * @retval true when the line is printed, always when the map is disabled
+  */
+bool DDR_ErrMap_Line(void)
+{
+  if (!errmap.enabled || (errmap.line < errmap.line_max))
+  {
+    errmap.line++;
+    return true;
+  }
+
+  errmap.line_drop++;
+
+  return false;
+}
+
+/**
+  * @brief  Print the summary of the error map.
+  * @retval None
+  */
+void DDR_ErrMap_Print(void)
+{
+  char title[24];
+  uint32_t i;
+
+  if (!errmap.enabled)
+  {
+    printf("error map disabled\n\r");
+    return;
+  }
+
+  printf("errmap: %lu errors, %lu bits, %lu error lines not printed\n\r",
+         errmap.error, errmap.bit, errmap.line_drop);
+  if (errmap.error == 0UL)
+  {
+    return;
+  }
+
+  printf("errmap: first @ offset 0x%lx: 0x%lx expected 0x%lx\n\r",
+         errmap.first_offset, errmap.first_read, errmap.first_expected);
+
+  for (i = 0U; i < errmap.test_nb; i++)
+  {
+    printf("  %-8s %s: %lu\n\r", (i == 0U) ? "test" : "",
+           (errmap.test[i].name != NULL) ? errmap.test[i].name : "-",
+           errmap.test[i].count);
+  }
+  if (errmap.test_other != 0UL)
+  {
+    printf("  %-8s others: %lu\n\r", "", errmap.test_other);
+  }
+
+  errmap_print_hist("lane", errmap.lane, ERRMAP_LANE_NB);
+  errmap_print_hist("DQ", errmap.dq, ERRMAP_DQ_NB);
+  errmap_print_hist("bank", errmap.bank, ERRMAP_BANK_NB);
+  /* columns by eighths of the column range */
+  snprintf(title, sizeof(title), "col/%lu",
+           1UL << ((errmap.col_bits > ERRMAP_COL_BUCKET_BITS) ?
+                   (errmap.col_bits - ERRMAP_COL_BUCKET_BITS) : 0U));
+  errmap_print_hist(title, errmap.col, ERRMAP_COL_BUCKET_NB);
+
+  printf("  %-8s", "row");
+  for (i = 0U; i < errmap.row_nb; i++)
+  {
+    if ((i != 0U) && ((i % ERRMAP_PRINT_LINE) == 0U))
+    {
+      printf("\n\r  %-8s", "");
+    }
+    printf(" %lu:0x%lx=%lu", (unsigned long)errmap.row[i].bank,
+           (unsigned long)errmap.row[i].row, errmap.row[i].count);
+  }
+  if (errmap.row_other != 0UL)
+  {
+    printf(" others=%lu", errmap.row_other);
+  }
+  printf("\n\r");
+}
@@ -0,0 +1,344 @@
+/**
+  ******************************************************************************
+  * @file    ddr_margin.c
+  * @author  MCD Application Team
+  * @brief   Eye margin sweep of the DDR PHY settings: each setting is stepped
+  *          around its trained value, a fast write/read kernel gives the
+  *          pass/fail result of each point and the map is printed with the
+  *          margin in ticks and ps.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stddef.h>
+
+#include "ddr_margin.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+  int32_t low;                    /* passing positions below the trained */
+  int32_t high;                   /* passing positions above the trained */
+  bool low_open;                  /* no failure found below */
+  bool high_open;                 /* no failure found above */
+} margin_window;
+
+/* Private define ------------------------------------------------------------*/
+#define MARGIN_PASS               '.'
+#define MARGIN_FAIL               'x'
+#define MARGIN_NONE               ' '   /* outside of the setting range */
+
+/* 0x5555... whatever the width of unsigned long */
+#define MARGIN_TOGGLE             (~0UL / 3UL)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/*
+ * even words: all the data lines toggle at each beat,
+ * odd words: pseudo random data
+ */
+static unsigned long margin_pattern(unsigned long i, unsigned long seed)
+{
+  unsigned long data;
+
+  if ((i & 1UL) == 0UL)
+  {
+    data = ((i & 2UL) == 0UL) ? MARGIN_TOGGLE : ~MARGIN_TOGGLE;
+  }
+  else
+  {
+    data = i * 2654435761UL;
+    data ^= data >> 13;
+  }
+
+  return data ^ seed;
+}
+
+/* error bits of one write / read pass on the kernel buffer */
+static unsigned long margin_pass(const DDR_MarginCfgTypeDef *cfg,
+                                 unsigned long seed)
+{
+  volatile unsigned long *buf = (volatile unsigned long *)cfg->addr;
+  unsigned long nb = cfg->size / sizeof(unsigned long);
+  unsigned long error = 0UL;
+  unsigned long i;
+
+  for (i = 0UL; i < nb; i++)
+  {
+    buf[i] = margin_pattern(i, seed);
+  }
+
+  if (cfg->flush != NULL)
+  {
+    cfg->flush(cfg->addr, cfg->size);
+  }
+
+  for (i = 0UL; i < nb; i++)
+  {
+    error |= buf[i] ^ margin_pattern(i, seed);
+  }
+
+  return error;
+}
+
+static bool margin_lane_pass(const DDR_MarginCfgTypeDef *cfg, uint32_t lane)
+{
+  unsigned long mask = (cfg->lane_mask != NULL) ? cfg->lane_mask(lane) : ~0UL;
+
+  return (DDR_Margin_Check(cfg) & mask) == 0UL;
+}
+
+/* passing window around the center point of a line of results */
+static void margin_get_window(const char *line, int32_t center,
+                              int32_t nb, margin_window *win)
+{
+  int32_t i;
+
+  win->low = 0;
+  win->high = 0;
+  win->low_open = false;
+  win->high_open = false;
+
+  if (line[center] != MARGIN_PASS)
+  {
+    win->low = -1;
+    win->high = -1;
+    return;
+  }
+
+  for (i = center - 1; (i >= 0) && (line[i] == MARGIN_PASS); i--)
+  {
+    win->low++;
+  }
+  win->low_open = (i < 0) || (line[i] == MARGIN_NONE);
+
+  for (i = center + 1; (i < nb) && (line[i] == MARGIN_PASS); i++)
+  {
+    win->high++;
+  }
+  win->high_open = (i >= nb) || (line[i] == MARGIN_NONE);
+}
+
+/* "-low +high ticks (-low +high ps)", '>' for a margin not fully measured */
+static void margin_print_window(const margin_window *win,
+                                const DDR_MarginAxisTypeDef *axis,
+                                int32_t step)
+{
+  uint32_t low, high;
+
+  if (win->low < 0)
+  {
+    printf(" fail at the trained value");
+    return;
+  }
+
+  low = (uint32_t)(win->low * step);
+  high = (uint32_t)(win->high * step);
+
+  printf(" %s-%lu %s+%lu ticks", win->low_open ? ">" : "",
+         (unsigned long)low, win->high_open ? ">" : "", (unsigned long)high);
+
+  if (axis->tick_fs != 0U)
+  {
+    printf(" (-%lu +%lu ps)",
+           (unsigned long)(((uint64_t)low * axis->tick_fs) / 1000U),
+           (unsigned long)(((uint64_t)high * axis->tick_fs) / 1000U));
+  }
+}
+
+/* one result per column, the x setting being restored at the end */
+static void margin_sweep_line(const DDR_MarginCfgTypeDef *cfg, uint32_t lane,
+                              char *line, int32_t nb_x)
+{
+  const DDR_MarginAxisTypeDef *x = cfg->x;
+  int32_t trained = x->get(lane);
+  int32_t pos;
+  int32_t i;
+
+  for (i = -nb_x; i <= nb_x; i++)
+  {
+    pos = trained + (i * cfg->x_step);
+    if ((pos < x->min) || (pos > x->max))
+    {
+      line[i + nb_x] = MARGIN_NONE;
+      continue;
+    }
+    x->set(lane, pos);
+    line[i + nb_x] = margin_lane_pass(cfg, lane) ? MARGIN_PASS : MARGIN_FAIL;
+  }
+  line[(2 * nb_x) + 1] = '\0';
+
+  x->set(lane, trained);
+}
+
+static void margin_print_axis(const DDR_MarginAxisTypeDef *axis,
+                              int32_t range, int32_t step)
+{
+  printf("%s: %ld..%ld, +/-%ld ticks by %ld", axis->name, (long)axis->min,
+         (long)axis->max, (long)range, (long)step);
+  if (axis->tick_fs != 0U)
+  {
+    printf(", tick %lu ps", (unsigned long)(axis->tick_fs / 1000U));
+  }
+  printf("\n\r");
+}
+
+static void margin_print_ruler(int32_t nb_x)
+{
+  int32_t i;
+
+  printf("%8s", "");
+  for (i = -nb_x; i <= nb_x; i++)
+  {
+    putchar((i == 0) ? '|' : ((i % 4) == 0) ? '+' : '-');
+  }
+  printf("\n\r");
+}
+
+/* one row per lane, x swept at the trained value of y */
+static void margin_run_lanes(const DDR_MarginCfgTypeDef *cfg, int32_t nb_x)
+{
+  char line[DDR_MARGIN_POINT_MAX + 1U];
+  margin_window win;
+  uint32_t lane;
+
+  margin_print_ruler(nb_x);
+
+  for (lane = cfg->lane; lane < (cfg->lane + cfg->nb_lane); lane++)
+  {
+    margin_sweep_line(cfg, lane, line, nb_x);
+    margin_get_window(line, nb_x, (2 * nb_x) + 1, &win);
+    printf("%4s%-4lu%s", cfg->lane_name, (unsigned long)lane, line);
+    margin_print_window(&win, cfg->x, cfg->x_step);
+    printf("\n\r");
+  }
+}
+
+/* 2D eye of each lane: one row per y position, top row at the highest */
+static void margin_run_eye(const DDR_MarginCfgTypeDef *cfg, int32_t nb_x,
+                           int32_t nb_y)
+{
+  const DDR_MarginAxisTypeDef *y = cfg->y;
+  char line[DDR_MARGIN_POINT_MAX + 1U];
+  char column[DDR_MARGIN_POINT_MAX + 1U];
+  margin_window win_x = { -1, -1, false, false };
+  margin_window win_y;
+  int32_t trained;
+  int32_t pos;
+  int32_t j;
+  uint32_t lane;
+
+  for (lane = cfg->lane; lane < (cfg->lane + cfg->nb_lane); lane++)
+  {
+    trained = y->get(lane);
+    printf("%s%lu, %s trained %ld\n\r", cfg->lane_name, (unsigned long)lane,
+           y->name, (long)trained);
+    margin_print_ruler(nb_x);
+
+    for (j = nb_y; j >= -nb_y; j--)
+    {
+      pos = trained + (j * cfg->y_step);
+      if ((pos < y->min) || (pos > y->max))
+      {
+        column[j + nb_y] = MARGIN_NONE;
+        continue;
+      }
+      y->set(lane, pos);
+      margin_sweep_line(cfg, lane, line, nb_x);
+      column[j + nb_y] = line[nb_x];
+      printf("%+7ld%c%s\n\r", (long)(j * cfg->y_step), (j == 0) ? '>' : ' ',
+             line);
+      if (j == 0)
+      {
+        margin_get_window(line, nb_x, (2 * nb_x) + 1, &win_x);
+      }
+    }
+    y->set(lane, trained);
+
+    margin_get_window(column, nb_y, (2 * nb_y) + 1, &win_y);
+    printf("  %s:", cfg->x->name);
+    margin_print_window(&win_x, cfg->x, cfg->x_step);
+    printf("\n\r  %s:", y->name);
+    margin_print_window(&win_y, y, cfg->y_step);
+    printf("\n\r");
+  }
+}
+
+/**
+  * @brief  Error bits of the pass/fail kernel: data bus toggling and pseudo
+  *         random words, written then read back with both polarities.
+  * @param  cfg: sweep configuration, only the kernel buffer is used
+  * @retval bits in error in the words of the buffer, 0 when passing
+  */
+unsigned long DDR_Margin_Check(const DDR_MarginCfgTypeDef *cfg)
+{
+  return margin_pass(cfg, 0UL) | margin_pass(cfg, ~0UL);
+}
+
+/**
+  * @brief  Sweep the settings of the lanes around their trained value and
+  *         print the pass/fail map with the margins. The trained values are
+  *         restored at the end.
+  * @param  cfg: sweep configuration
+  * @retval 0 when executed, -1 for an invalid configuration
+  */
+int DDR_Margin_Run(const DDR_MarginCfgTypeDef *cfg)
+{
+  int32_t nb_x, nb_y = 0;
+
+  if (   (cfg->x == NULL) || (cfg->x_step <= 0) || (cfg->x_range < 0)
+      || (cfg->nb_lane == 0U) || (cfg->size < (2U * sizeof(unsigned long))))
+  {
+    return -1;
+  }
+
+  nb_x = cfg->x_range / cfg->x_step;
+  if (((2 * nb_x) + 1) > (int32_t)DDR_MARGIN_POINT_MAX)
+  {
+    return -1;
+  }
+
+  if (cfg->y != NULL)
+  {
+    if ((cfg->y_step <= 0) || (cfg->y_range < 0))
+    {
+      return -1;
+    }
+    nb_y = cfg->y_range / cfg->y_step;
+    if (((2 * nb_y) + 1) > (int32_t)DDR_MARGIN_POINT_MAX)
+    {
+      return -1;
+    }
+  }
+
+  margin_print_axis(cfg->x, cfg->x_range, cfg->x_step);
+  if (cfg->y != NULL)
+  {
+    margin_print_axis(cfg->y, cfg->y_range, cfg->y_step);
+  }
+  printf("'%c' pass, '%c' fail, kernel 0x%lx bytes at 0x%lx\n\r", MARGIN_PASS,
+         MARGIN_FAIL, cfg->size, (unsigned long)cfg->addr);
+
+  if (cfg->y == NULL)
+  {
+    margin_run_lanes(cfg, nb_x);
+  }
+  else
+  {
+    margin_run_eye(cfg, nb_x, nb_y);
+  }
+
+  return 0;
+}
@@ -0,0 +1,482 @@
+/**
+  ******************************************************************************
+  * @file    ddr_pmu.c
+  * @author  MCD Application Team
+  * @brief   CPU performance monitor (PMU) around the DDR tests:
+  *          cycle counter and event counters of the Cortex-A7 (cp15
+  *          registers) and of the Cortex-A35 (AArch64 system registers)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+#include "ddr_pmu.h"
+#include "system_time.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define PMCR_E                    (1U << 0)   /* enable */
+#define PMCR_P                    (1U << 1)   /* event counters reset */
+#define PMCR_C                    (1U << 2)   /* cycle counter reset */
+#define PMCR_D                    (1U << 3)   /* cycle counter every 64 cycles */
+#define PMCR_LC                   (1U << 6)   /* 64-bit cycle counter overflow */
+#define PMCR_N_POS                11U
+#define PMCR_N_MSK                (0x1FU << PMCR_N_POS)
+
+#define PMU_CYCLE_CNT             (1U << 31)  /* cycle counter enable bit */
+
+#if defined(__AARCH64__)
+#define PMU_EVENT_MAX             0xFFFFU
+#define MDCR_EL3_SPME             (1UL << 17) /* secure event counting */
+#else
+#define PMU_EVENT_MAX             0xFFU
+/*
+ * the 32-bit cycle counter of the Cortex-A7 counts every 64 cycles:
+ * overflow after 2^38 cycles (7 minutes at 650 MHz)
+ */
+#define PMU_CYCLE_DIV             64U
+#endif
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/*
+ * default events: instructions, L1 and L2 data refills, bus accesses and,
+ * on Armv8 only, front-end and back-end stall cycles
+ */
+static uint32_t pmu_event[DDR_PMU_CNT_NB] = {
+  DDR_PMU_INST_RETIRED,
+  DDR_PMU_L1D_REFILL,
+  DDR_PMU_L2D_REFILL,
+  DDR_PMU_BUS_ACCESS,
+  DDR_PMU_STALL_FRONTEND,
+  DDR_PMU_STALL_BACKEND,
+};
+
+static const struct {
+  uint32_t event;
+  const char *name;
+} pmu_event_name[] = {
+  {DDR_PMU_L1I_REFILL, "L1I_REFILL"},
+  {DDR_PMU_L1D_REFILL, "L1D_REFILL"},
+  {DDR_PMU_L1D_ACCESS, "L1D_ACCESS"},
+  {DDR_PMU_INST_RETIRED, "INST_RETIRED"},
+  {DDR_PMU_BR_MIS_PRED, "BR_MIS_PRED"},
+  {DDR_PMU_MEM_ACCESS, "MEM_ACCESS"},
+  {DDR_PMU_L2D_ACCESS, "L2D_ACCESS"},
+  {DDR_PMU_L2D_REFILL, "L2D_REFILL"},
+  {DDR_PMU_L2D_WB, "L2D_WB"},
+  {DDR_PMU_BUS_ACCESS, "BUS_ACCESS"},
+  {DDR_PMU_STALL_FRONTEND, "STALL_FRONTEND"},
+  {DDR_PMU_STALL_BACKEND, "STALL_BACKEND"},
+  {DDR_PMU_BUS_READ, "BUS_READ"},
+  {DDR_PMU_BUS_WRITE, "BUS_WRITE"},
+};
+
+#define PMU_NB_EVENT_NAME (sizeof(pmu_event_name) / sizeof(pmu_event_name[0]))
+
+static bool pmu_enabled;
+static uint64_t pmu_start;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/*
+ * Register accesses: cp15 on Cortex-A7, system registers on Cortex-A35,
+ * no PMU in the host simulation.
+ */
+static uint32_t pmu_get_pmcr(void)
+{
+  uint32_t val = 0;
+
+#if defined(__AARCH64__)
+  uint64_t reg;
+
+  __asm volatile ("mrs %0, pmcr_el0" : "=r" (reg));
+  val = (uint32_t)reg;
+#elif defined(CORE_CA7)
+  __get_CP(15, 0, val, 9, 12, 0);
+#endif
+
+  return val;
+}
+
+static void pmu_set_pmcr(uint32_t val)
+{
+#if defined(__AARCH64__)
+  __asm volatile ("msr pmcr_el0, %0\n\tisb" : : "r" ((uint64_t)val) : "memory");
+#elif defined(CORE_CA7)
+  __set_CP(15, 0, val, 9, 12, 0);
+  __ISB();
+#else
+  (void)val;
+#endif
+}
+
+static void pmu_enable_counters(uint32_t mask, bool enable)
+{
+#if defined(__AARCH64__)
+  if (enable)
+  {
+    __asm volatile ("msr pmcntenset_el0, %0" : : "r" ((uint64_t)mask));
+  }
+  else
+  {
+    __asm volatile ("msr pmcntenclr_el0, %0" : : "r" ((uint64_t)mask));
+  }
+  __asm volatile ("isb" : : : "memory");
+#elif defined(CORE_CA7)
+  if (enable)
+  {
+    __set_CP(15, 0, mask, 9, 12, 1);
+  }
+  else
+  {
+    __set_CP(15, 0, mask, 9, 12, 2);
+  }
+  __ISB();
+#else
+  (void)mask;
+  (void)enable;
+#endif
+}
+
+/* overflow flags of the counters, cleared after the read */
+static uint32_t pmu_get_overflow(void)
+{
+  uint32_t val = 0;
+
+#if defined(__AARCH64__)
+  uint64_t reg;
+
+  __asm volatile ("mrs %0, pmovsclr_el0" : "=r" (reg));
+  val = (uint32_t)reg;
+  __asm volatile ("msr pmovsclr_el0, %0" : : "r" (reg));
+#elif defined(CORE_CA7)
+  __get_CP(15, 0, val, 9, 12, 3);
+  __set_CP(15, 0, val, 9, 12, 3);
+#endif
+
+  return val;
+}
+
+static void pmu_set_evtype(uint32_t counter, uint32_t event)
+{
+#if defined(__AARCH64__)
+  __asm volatile ("msr pmselr_el0, %0\n\tisb\n\tmsr pmxevtyper_el0, %1"
+                  : : "r" ((uint64_t)counter), "r" ((uint64_t)event));
+#elif defined(CORE_CA7)
+  __set_CP(15, 0, counter, 9, 12, 5);
+  __ISB();
+  __set_CP(15, 0, event, 9, 13, 1);
+#else
+  (void)counter;
+  (void)event;
+#endif
+}
+
+static uint32_t pmu_get_evcnt(uint32_t counter)
+{
+  uint32_t val = 0;
+
+#if defined(__AARCH64__)
+  uint64_t reg;
+
+  __asm volatile ("msr pmselr_el0, %1\n\tisb\n\tmrs %0, pmxevcntr_el0"
+                  : "=r" (reg) : "r" ((uint64_t)counter));
+  val = (uint32_t)reg;
+#elif defined(CORE_CA7)
+  __set_CP(15, 0, counter, 9, 12, 5);
+  __ISB();
+  __get_CP(15, 0, val, 9, 13, 2);
+#else
+  (void)counter;
+#endif
+
+  return val;
+}
+
+static uint64_t pmu_get_cycles(void)
+{
+  uint64_t val = 0;
+
+#if defined(__AARCH64__)
+  __asm volatile ("mrs %0, pmccntr_el0" : "=r" (val));
+#elif defined(CORE_CA7)
+  uint32_t reg;
+
+  __get_CP(15, 0, reg, 9, 13, 0);
+  val = (uint64_t)reg * PMU_CYCLE_DIV;
+#endif
+
+  return val;
+}
+
+/*
+ * Event counting in secure state: enabled by MDCR_EL3.SPME on Cortex-A35
+ * at EL3, by the SPNIDEN debug authentication signal on Cortex-A7 (secure
+ * non-invasive debug, DBGAUTHSTATUS.SNE).
+ */
+static bool pmu_secure_counting(void)
+{
+#if defined(__AARCH64__)
+  uint64_t reg;
+
+  __asm volatile ("mrs %0, CurrentEL" : "=r" (reg));
+  if (((reg >> 2) & 0x3U) == 3U)
+  {
+    __asm volatile ("mrs %0, mdcr_el3" : "=r" (reg));
+    __asm volatile ("msr mdcr_el3, %0\n\tisb" : : "r" (reg | MDCR_EL3_SPME));
+  }
+
+  return true;
+#elif defined(CORE_CA7)
+  uint32_t reg;
+
+  __get_CP(14, 0, reg, 7, 14, 6);
+
+  return (reg & (1U << 6)) != 0U;
+#else
+  return false;
+#endif
+}
+
+/**
+  * @brief  Enable or disable the PMU measure around the tests.
+  * @param  enable: true to measure each test
+  * @retval None
+  */
+void DDR_PMU_Enable(bool enable)
+{
+  pmu_enabled = enable;
+}
+
+/**
+  * @brief  Check if the PMU measure around the tests is enabled.
+  * @param  None
+  * @retval true when enabled
+  */
+bool DDR_PMU_IsEnabled(void)
+{
+  return pmu_enabled;
+}
+
+/**
+  * @brief  Number of event counters used: implemented by the CPU and
+  *         limited to DDR_PMU_CNT_NB, 0 without PMU.
+  * @param  None
+  * @retval number of counters
+  */
+uint32_t DDR_PMU_GetNbCounters(void)
+{
+  uint32_t nb = (pmu_get_pmcr() & PMCR_N_MSK) >> PMCR_N_POS;
+
+  return (nb > DDR_PMU_CNT_NB) ? DDR_PMU_CNT_NB : nb;
+}
+
+/**
+  * @brief  Select the event of one counter.
+  * @param  counter: counter index
+  * @param  event: event number (see the CPU technical reference manual)
+  * @retval 0 if OK, -1 for an invalid counter or event
+  */
+int DDR_PMU_SetEvent(uint32_t counter, uint32_t event)
+{
+  if ((counter >= DDR_PMU_GetNbCounters()) || (event > PMU_EVENT_MAX))
+  {
+    return -1;
+  }
+
+  pmu_event[counter] = event;
+
+  return 0;
+}
+
+/**
+  * @brief  Get the event of one counter.
+  * @param  counter: counter index
+  * @retval event number
+  */
+uint32_t DDR_PMU_GetEvent(uint32_t counter)
+{
+  return (counter < DDR_PMU_CNT_NB) ? pmu_event[counter] : 0U;
+}
+
+/**
+  * @brief  Name of an event.
+  * @param  event: event number
+  * @retval name, "-" for an event without name
+  */
+const char *DDR_PMU_EventName(uint32_t event)
+{
+  uint32_t i;
+
+  for (i = 0; i < PMU_NB_EVENT_NAME; i++)
+  {
+    if (pmu_event_name[i].event == event)
+    {
+      return pmu_event_name[i].name;
+    }
+  }
+
+  return "-";
+}
+
+/**
+  * @brief  Program the selected events, reset and start the counters.
+  * @param  None
+  * @retval None
+  */
+void DDR_PMU_Start(void)
+{
+  uint32_t nb = DDR_PMU_GetNbCounters();
+  uint32_t mask = PMU_CYCLE_CNT;
+  uint32_t pmcr;
+  uint32_t i;
+
+  (void)pmu_secure_counting();
+
+  pmu_enable_counters(0xFFFFFFFFU, false);
+
+#if defined(__AARCH64__)
+  /* cycles counted in all the exception levels */
+  __asm volatile ("msr pmccfiltr_el0, xzr");
+#endif
+
+  for (i = 0; i < nb; i++)
+  {
+    pmu_set_evtype(i, pmu_event[i]);
+    mask |= 1U << i;
+  }
+
+  pmcr = pmu_get_pmcr() | PMCR_E | PMCR_P | PMCR_C;
+#if defined(__AARCH64__)
+  pmcr |= PMCR_LC;
+#else
+  pmcr |= PMCR_D;
+#endif
+  pmu_set_pmcr(pmcr);
+  (void)pmu_get_overflow();
+
+  pmu_start = time_get_counter();
+  pmu_enable_counters(mask, true);
+}
+
+/**
+  * @brief  Stop the counters and read them.
+  * @param  count: counts since DDR_PMU_Start
+  * @retval None
+  */
+void DDR_PMU_Stop(DDR_PmuCountTypeDef *count)
+{
+  uint32_t nb = DDR_PMU_GetNbCounters();
+  uint32_t i;
+
+  pmu_enable_counters(0xFFFFFFFFU, false);
+  count->time_us = time_elapsed_us(pmu_start);
+
+  count->cycles = pmu_get_cycles();
+  for (i = 0; i < DDR_PMU_CNT_NB; i++)
+  {
+    count->event[i] = (i < nb) ? pmu_get_evcnt(i) : 0U;
+  }
+  count->overflow = pmu_get_overflow();
+}
+
+/**
+  * @brief  Print the counts with the ratios used to locate the limitation
+  *         of a test: instructions per cycle, events per 1000 instructions
+  *         and stall cycles in % of the cycles.
+  * @param  count: counts of the measure
+  * @retval None
+  */
+void DDR_PMU_Print(const DDR_PmuCountTypeDef *count)
+{
+  uint32_t nb = DDR_PMU_GetNbCounters();
+  uint64_t inst = 0;
+  uint64_t ratio;
+  int32_t stall = -1;
+  uint32_t event;
+  uint32_t i;
+
+  if (nb == 0U)
+  {
+    printf("  pmu: no counter, %lu us\n\r", (unsigned long)count->time_us);
+    return;
+  }
+
+  if (!pmu_secure_counting())
+  {
+    printf("  pmu: event counting prohibited in secure state (SPNIDEN)\n\r");
+  }
+
+  for (i = 0; i < nb; i++)
+  {
+    if (pmu_event[i] == DDR_PMU_INST_RETIRED)
+    {
+      inst = count->event[i];
+    }
+    if ((pmu_event[i] == DDR_PMU_STALL_BACKEND) &&
+        ((count->overflow & (1U << i)) == 0U))
+    {
+      stall = (int32_t)i;
+    }
+  }
+
+  printf("  pmu: %lu cycles, %lu MHz",
+         (unsigned long)count->cycles,
+         (count->time_us != 0U) ?
+         (unsigned long)(count->cycles / count->time_us) : 0UL);
+  if ((inst != 0U) && (count->cycles != 0U))
+  {
+    ratio = (inst * 100U) / count->cycles;
+    printf(", IPC %lu.%02lu", (unsigned long)(ratio / 100U),
+           (unsigned long)(ratio % 100U));
+  }
+  printf("%s\n\r", ((count->overflow & PMU_CYCLE_CNT) != 0U) ?
+                   " (overflow)" : "");
+
+  for (i = 0; i < nb; i++)
+  {
+    event = pmu_event[i];
+    printf("    %-14s 0x%02lx: %10lu", DDR_PMU_EventName(event),
+           (unsigned long)event, (unsigned long)count->event[i]);
+
+    if ((count->overflow & (1U << i)) != 0U)
+    {
+      printf(" (overflow)");
+    }
+    else if ((event == DDR_PMU_STALL_FRONTEND) ||
+             (event == DDR_PMU_STALL_BACKEND))
+    {
+      ratio = (count->cycles != 0U) ?
+              ((uint64_t)count->event[i] * 1000U) / count->cycles : 0U;
+      printf(" (%lu.%lu %% of cycles)", (unsigned long)(ratio / 10U),
+             (unsigned long)(ratio % 10U));
+    }
+    else if ((event != DDR_PMU_INST_RETIRED) && (inst != 0U))
+    {
+      ratio = ((uint64_t)count->event[i] * 10000U) / inst;
+      printf(" (%lu.%lu per 1000 inst)", (unsigned long)(ratio / 10U),
+             (unsigned long)(ratio % 10U));
+    }
+    printf("\n\r");
+  }
+
+  /* half of the cycles waiting for the memory system: limited by the DDR */
+  if ((stall >= 0) && (count->cycles != 0U))
+  {
+    ratio = ((uint64_t)count->event[stall] * 1000U) / count->cycles;
+    printf("  pmu: %s bound\n\r", (ratio >= 500U) ? "memory" : "CPU");
+  }
+}
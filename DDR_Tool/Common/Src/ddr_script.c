@@ -0,0 +1,480 @@
+/**
+  ******************************************************************************
+  * @file    ddr_script.c
+  * @author  MCD Application Team
+  * @brief   Batch execution of the interactive commands: a script, built in
+  *          the binary or uploaded on the console, gives the command lines
+  *          instead of the console, in loop, with a summary at its end.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/*
+ * Script syntax, one command per line:
+ *   # comment, ignored as the empty lines
+ *   loop <n>     executes n times the lines up to endloop, forever when n = 0
+ *                (then with at least one command)
+ *   endloop      the loops are not nested
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ddr_script.h"
+#include "system_time.h"
+#include "stm32mp_util_conf.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define SCRIPT_LOOP               "loop"
+#define SCRIPT_ENDLOOP            "endloop"
+#define SCRIPT_END                "end"
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+#if defined(DDR_SCRIPT_BUILTIN)
+static const char script_builtin[] = DDR_SCRIPT_BUILTIN;
+#endif /* DDR_SCRIPT_BUILTIN */
+
+static char script_upload[DDR_SCRIPT_SIZE_MAX];
+
+static struct {
+  const char *text;               /* script selected, NULL when none */
+  size_t len;
+  bool builtin;
+  bool loading;                   /* console lines copied in the upload */
+  bool overflow;                  /* upload truncated */
+  bool running;
+  bool stop_on_fail;
+  unsigned long loop;             /* script executions, 0 = forever */
+  unsigned long loop_done;
+  size_t pos;                     /* next line */
+  unsigned long line;             /* number of the next line */
+  unsigned long cmd_line;         /* line of the last command */
+  bool in_loop;                   /* between loop and endloop */
+  size_t loop_pos;                /* line after loop <n> */
+  unsigned long loop_line;
+  unsigned long loop_count;
+  unsigned long loop_iter;
+  unsigned long cmd;              /* commands executed */
+  unsigned long pass;
+  unsigned long fail;
+  unsigned long fail_line;        /* line of the first failure, 0 if none */
+  unsigned long fail_loop;
+  uint64_t start;
+} script;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/*
+ * next line of the script at *pos, without the leading and trailing blanks:
+ * returns its length, 0 for a blank line or a comment
+ */
+static size_t script_next_line(size_t *pos, const char **line)
+{
+  const char *s = &script.text[*pos];
+  size_t n = 0;
+
+  while ((*pos + n < script.len) && (s[n] != '\n'))
+  {
+    n++;
+  }
+  *pos += (*pos + n < script.len) ? n + 1U : n;
+
+  while ((n > 0U) && ((*s == ' ') || (*s == '\t')))
+  {
+    s++;
+    n--;
+  }
+  while ((n > 0U) &&
+         ((s[n - 1U] == ' ') || (s[n - 1U] == '\t') || (s[n - 1U] == '\r')))
+  {
+    n--;
+  }
+
+  if ((n > 0U) && (*s == '#'))
+  {
+    n = 0U;
+  }
+
+  *line = s;
+
+  return n;
+}
+
+static bool script_is_keyword(const char *line, size_t n, const char *key)
+{
+  size_t len = strlen(key);
+
+  return (n >= len) && !strncmp(line, key, len) &&
+         ((n == len) || (line[len] == ' ') || (line[len] == '\t'));
+}
+
+/*
+ * loop / endloop balance, and loop 0 without command which would never give
+ * a line: returns the line in error, 0 when correct, with the number of
+ * commands of the script in *nb_cmd
+ */
+static unsigned long script_check(unsigned long *nb_cmd)
+{
+  const char *line;
+  size_t pos = 0U;
+  unsigned long nb = 0UL;
+  unsigned long loop_line = 0UL;
+  unsigned long loop_cmd = 0UL;
+  bool forever = false;
+  size_t n;
+
+  *nb_cmd = 0UL;
+  while (pos < script.len)
+  {
+    n = script_next_line(&pos, &line);
+    nb++;
+    if (n == 0U)
+    {
+      continue;
+    }
+
+    if (script_is_keyword(line, n, SCRIPT_ENDLOOP))
+    {
+      if (loop_line == 0UL)
+      {
+        return nb;
+      }
+      if (forever && (loop_cmd == 0UL))
+      {
+        return loop_line;
+      }
+      loop_line = 0UL;
+    }
+    else if (script_is_keyword(line, n, SCRIPT_LOOP))
+    {
+      if (loop_line != 0UL)
+      {
+        return nb;
+      }
+      loop_line = nb;
+      loop_cmd = 0UL;
+      forever = (strtoul(&line[strlen(SCRIPT_LOOP)], NULL, 0) == 0UL);
+    }
+    else
+    {
+      (*nb_cmd)++;
+      loop_cmd++;
+    }
+  }
+
+  return loop_line;
+}
+
+static void script_rewind(void)
+{
+  script.pos = 0U;
+  script.line = 1UL;
+  script.in_loop = false;
+}
+
+static void script_summary(void)
+{
+  uint64_t time_ms = time_elapsed_us(script.start) / 1000U;
+
+  printf("script: %lu commands, %lu passed, %lu failed, %lu loops, "
+         "%lu.%03lu s\n\r", script.cmd, script.pass, script.fail,
+         script.loop_done,
+         (unsigned long)(time_ms / 1000U), (unsigned long)(time_ms % 1000U));
+
+  if (script.fail_line != 0UL)
+  {
+    printf("script: first failure at line %lu, loop %lu\n\r",
+           script.fail_line, script.fail_loop);
+  }
+}
+
+static void script_end(void)
+{
+  script.running = false;
+  script_summary();
+}
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Select the script built in the binary, DDR_SCRIPT_BUILTIN of
+  *         stm32mp_util_conf.h.
+  * @retval false when no script is built in
+  */
+bool DDR_Script_SelectBuiltin(void)
+{
+#if defined(DDR_SCRIPT_BUILTIN)
+  script.text = script_builtin;
+  script.len = strlen(script_builtin);
+  script.builtin = true;
+
+  return true;
+#else
+  return false;
+#endif /* DDR_SCRIPT_BUILTIN */
+}
+
+/**
+  * @brief  Start the upload of a script: the next console lines are copied
+  *         up to a line "end".
+  * @retval None
+  */
+void DDR_Script_BeginLoad(void)
+{
+  script.running = false;
+  script.loading = true;
+  script.overflow = false;
+  script.text = script_upload;
+  script.len = 0U;
+  script.builtin = false;
+}
+
+bool DDR_Script_IsLoading(void)
+{
+  return script.loading;
+}
+
+/**
+  * @brief  Add a console line to the uploaded script.
+  * @param  line: line without end of line, "end" to complete the upload
+  * @retval None
+  */
+void DDR_Script_LoadLine(const char *line)
+{
+  size_t n = strlen(line);
+
+  if (!strcmp(line, SCRIPT_END))
+  {
+    script.loading = false;
+    if (script.overflow)
+    {
+      printf("script truncated to %lu bytes\n\r",
+             (unsigned long)script.len);
+    }
+    DDR_Script_Print();
+    return;
+  }
+
+  if (script.len + n + 1U > sizeof(script_upload))
+  {
+    script.overflow = true;
+    return;
+  }
+
+  memcpy(&script_upload[script.len], line, n);
+  script.len += n;
+  script_upload[script.len++] = '\n';
+}
+
+/**
+  * @brief  Start the execution of the selected script.
+  * @param  loop: number of executions, 0 = until a failure or a reset
+  * @param  stop_on_fail: the script stops at the first command failure
+  * @retval 0 when started, else -1
+  */
+int DDR_Script_Start(unsigned long loop, bool stop_on_fail)
+{
+  unsigned long err;
+  unsigned long nb_cmd;
+
+  if ((script.text == NULL) || (script.len == 0U) || script.loading)
+  {
+    printf("no script\n\r");
+    return -1;
+  }
+
+  err = script_check(&nb_cmd);
+  if (err != 0UL)
+  {
+    printf("script: unbalanced loop or loop 0 without command at line %lu\n\r",
+           err);
+    return -1;
+  }
+
+  if ((loop == 0UL) && (nb_cmd == 0UL))
+  {
+    printf("script: no command to execute forever\n\r");
+    return -1;
+  }
+
+  script.loop = loop;
+  script.loop_done = 0UL;
+  script.stop_on_fail = stop_on_fail;
+  script.cmd = 0UL;
+  script.pass = 0UL;
+  script.fail = 0UL;
+  script.fail_line = 0UL;
+  script_rewind();
+  script.start = time_get_counter();
+  script.running = true;
+
+  return 0;
+}
+
+/**
+  * @brief  Stop the script in progress and print its summary.
+  * @retval None
+  */
+void DDR_Script_Stop(void)
+{
+  if (script.running)
+  {
+    script_end();
+  }
+}
+
+bool DDR_Script_IsRunning(void)
+{
+  return script.running;
+}
+
+/**
+  * @brief  Next command of the script in progress. At the end of the script,
+  *         the summary is printed.
+  * @param  line: command, NUL terminated
+  * @param  size: size of line
+  * @retval false when the script is not in progress or at its end
+  */
+bool DDR_Script_GetLine(char *line, size_t size)
+{
+  const char *s;
+  size_t n;
+
+  while (script.running)
+  {
+    if (script.pos >= script.len)
+    {
+      script.loop_done++;
+      if ((script.loop != 0UL) && (script.loop_done >= script.loop))
+      {
+        script_end();
+        return false;
+      }
+      script_rewind();
+    }
+
+    n = script_next_line(&script.pos, &s);
+    script.line++;
+
+    if (n == 0U)
+    {
+      continue;
+    }
+
+    if (script_is_keyword(s, n, SCRIPT_LOOP))
+    {
+      script.in_loop = true;
+      script.loop_pos = script.pos;
+      script.loop_line = script.line;
+      script.loop_count = strtoul(&s[strlen(SCRIPT_LOOP)], NULL, 0);
+      script.loop_iter = 0UL;
+      continue;
+    }
+
+    if (script_is_keyword(s, n, SCRIPT_ENDLOOP))
+    {
+      script.loop_iter++;
+      if ((script.loop_count == 0UL) ||
+          (script.loop_iter < script.loop_count))
+      {
+        script.pos = script.loop_pos;
+        script.line = script.loop_line;
+      }
+      else
+      {
+        script.in_loop = false;
+      }
+      continue;
+    }
+
+    if (n >= size)
+    {
+      n = size - 1U;
+    }
+    memcpy(line, s, n);
+    line[n] = '\0';
+
+    script.cmd_line = script.line - 1UL;
+    script.cmd++;
+
+    return true;
+  }
+
+  return false;
+}
+
+/**
+  * @brief  Result of the last command given by the script; ignored when no
+  *         script is in progress.
+  * @param  pass: false when the command failed
+  * @retval None
+  */
+void DDR_Script_Result(bool pass)
+{
+  if (!script.running)
+  {
+    return;
+  }
+
+  if (pass)
+  {
+    script.pass++;
+    return;
+  }
+
+  script.fail++;
+  if (script.fail_line == 0UL)
+  {
+    script.fail_line = script.cmd_line;
+    script.fail_loop = script.loop_done + 1UL;
+  }
+
+  if (script.stop_on_fail)
+  {
+    printf("script stopped at line %lu\n\r", script.cmd_line);
+    script_end();
+  }
+}
+
+/**
+  * @brief  Print the selected script and its state.
+  * @retval None
+  */
+void DDR_Script_Print(void)
+{
+  const char *s;
+  size_t pos = 0U;
+  size_t start;
+  unsigned long nb = 0UL;
+
+  if ((script.text == NULL) || script.loading)
+  {
+    printf("no script\n\r");
+    return;
+  }
+
+  printf("%s script, %lu bytes%s\n\r", script.builtin ? "builtin" : "uploaded",
+         (unsigned long)script.len, script.running ? ", running" : "");
+
+  while (pos < script.len)
+  {
+    start = pos;
+    (void)script_next_line(&pos, &s);
+    nb++;
+    printf("%3lu: %.*s\n\r", nb,
+           (int)(pos - start - ((script.text[pos - 1U] == '\n') ? 1U : 0U)),
+           &script.text[start]);
+  }
+}
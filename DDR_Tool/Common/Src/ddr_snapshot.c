@@ -0,0 +1,312 @@
+/**
+  ******************************************************************************
+  * @file    ddr_snapshot.c
+  * @author  MCD Application Team
+  * @brief   Binary snapshots of the DDR registers: the registers printed by
+  *          the print command are captured in memory slots, without any
+  *          console output, then compared, written back or dumped in hex to
+  *          be decoded on the host (Scripts/ddrsnapshot/ddr_snapshot.py).
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "stm32_device_hal.h"
+#include "stm32mp_util_conf.h"
+#include "ddr_snapshot.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+  DDR_SnapHeaderTypeDef header;
+  uint32_t value[DDR_SNAP_REG_MAX];
+} snap_blob;
+
+/* Private define ------------------------------------------------------------*/
+/* bytes per line of the hex dump */
+#define SNAP_DUMP_LINE            32U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static snap_blob snap_slot[DDR_SNAP_SLOT_NB];
+static snap_blob snap_live;
+
+/* Private function prototypes -----------------------------------------------*/
+/* CRC32 (IEEE 802.3, as zlib), shared with the PhyInit of the STM32MP2 HAL */
+uint32_t ddrphy_phyinit_crc32(uint32_t crc, const void *buf, size_t len);
+
+/* Private functions ---------------------------------------------------------*/
+/* CRC32 of the lines "<base>.<table>.<name>\n" of all the registers */
+static uint32_t snap_layout_crc(uint32_t nb)
+{
+  const char *base, *table, *name;
+  uint32_t crc = 0U;
+  uint32_t i;
+
+  for (i = 0U; i < nb; i++)
+  {
+    if (!HAL_DDR_Snapshot_Name(i, &base, &table, &name))
+    {
+      break;
+    }
+    crc = ddrphy_phyinit_crc32(crc, base, strlen(base));
+    crc = ddrphy_phyinit_crc32(crc, ".", 1U);
+    crc = ddrphy_phyinit_crc32(crc, table, strlen(table));
+    crc = ddrphy_phyinit_crc32(crc, ".", 1U);
+    crc = ddrphy_phyinit_crc32(crc, name, strlen(name));
+    crc = ddrphy_phyinit_crc32(crc, "\n", 1U);
+  }
+
+  return crc;
+}
+
+static int snap_capture(snap_blob *blob, uint32_t speed)
+{
+  uint32_t nb = HAL_DDR_Snapshot_Reg(blob->value, DDR_SNAP_REG_MAX);
+
+  if (nb > DDR_SNAP_REG_MAX)
+  {
+    printf("%lu registers, snapshot limited to %lu\n\r", (unsigned long)nb,
+           (unsigned long)DDR_SNAP_REG_MAX);
+    return -1;
+  }
+
+  blob->header.magic = DDR_SNAP_MAGIC;
+  blob->header.version = DDR_SNAP_VERSION;
+  blob->header.header_size = (uint16_t)sizeof(DDR_SnapHeaderTypeDef);
+  blob->header.layout = snap_layout_crc(nb);
+  blob->header.nb = nb;
+  blob->header.speed = speed;
+  blob->header.crc = ddrphy_phyinit_crc32(0U, blob->value, nb * sizeof(uint32_t));
+
+  return 0;
+}
+
+static const snap_blob *snap_get(uint32_t slot)
+{
+  if (slot >= DDR_SNAP_SLOT_NB)
+  {
+    printf("invalid snapshot slot %lu (max %lu)\n\r", (unsigned long)slot,
+           (unsigned long)(DDR_SNAP_SLOT_NB - 1U));
+    return NULL;
+  }
+
+  if (snap_slot[slot].header.magic != DDR_SNAP_MAGIC)
+  {
+    printf("snapshot %lu empty\n\r", (unsigned long)slot);
+    return NULL;
+  }
+
+  return &snap_slot[slot];
+}
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Capture the DDR registers in a snapshot slot.
+  * @param  slot: 0 to DDR_SNAP_SLOT_NB - 1
+  * @param  speed: DDR frequency in kHz, kept in the header
+  * @retval 0 on success, else -1
+  */
+int DDR_Snap_Save(uint32_t slot, uint32_t speed)
+{
+  if (slot >= DDR_SNAP_SLOT_NB)
+  {
+    printf("invalid snapshot slot %lu (max %lu)\n\r", (unsigned long)slot,
+           (unsigned long)(DDR_SNAP_SLOT_NB - 1U));
+    return -1;
+  }
+
+  snap_slot[slot].header.magic = 0U;
+
+  return snap_capture(&snap_slot[slot], speed);
+}
+
+/**
+  * @brief  Print the registers which differ between two snapshots.
+  * @param  slot_a: reference snapshot
+  * @param  slot_b: compared snapshot, or -1 for the current registers
+  * @retval number of registers changed, -1 on error
+  */
+int DDR_Snap_Diff(uint32_t slot_a, int32_t slot_b)
+{
+  const snap_blob *a = snap_get(slot_a);
+  const snap_blob *b;
+  const char *base, *table, *name;
+  uint32_t i;
+  int nb = 0;
+
+  if (a == NULL)
+  {
+    return -1;
+  }
+
+  if (slot_b < 0)
+  {
+    if (snap_capture(&snap_live, a->header.speed) != 0)
+    {
+      return -1;
+    }
+    b = &snap_live;
+  }
+  else
+  {
+    b = snap_get((uint32_t)slot_b);
+    if (b == NULL)
+    {
+      return -1;
+    }
+  }
+
+  if ((a->header.layout != b->header.layout) || (a->header.nb != b->header.nb))
+  {
+    printf("snapshots of different register layouts\n\r");
+    return -1;
+  }
+
+  if (a->header.speed != b->header.speed)
+  {
+    printf("speed: %lu -> %lu kHz\n\r", (unsigned long)a->header.speed,
+           (unsigned long)b->header.speed);
+  }
+
+  for (i = 0U; i < a->header.nb; i++)
+  {
+    if ((a->value[i] == b->value[i]) ||
+        !HAL_DDR_Snapshot_Name(i, &base, &table, &name))
+    {
+      continue;
+    }
+    printf("%s.%s.%s: 0x%08lx -> 0x%08lx (bits 0x%08lx)\n\r", base, table,
+           name, (unsigned long)a->value[i], (unsigned long)b->value[i],
+           (unsigned long)(a->value[i] ^ b->value[i]));
+    nb++;
+  }
+
+  printf("%d/%lu registers changed\n\r", nb, (unsigned long)a->header.nb);
+
+  return nb;
+}
+
+/**
+  * @brief  Write back the registers of a snapshot (see HAL_DDR_Restore_Reg).
+  * @param  slot: snapshot slot
+  * @retval 0 on success, else -1
+  */
+int DDR_Snap_Restore(uint32_t slot)
+{
+  const snap_blob *blob = snap_get(slot);
+
+  if (blob == NULL)
+  {
+    return -1;
+  }
+
+  if (blob->header.layout != snap_layout_crc(blob->header.nb))
+  {
+    printf("snapshot of another register layout\n\r");
+    return -1;
+  }
+
+  if (HAL_DDR_Restore_Reg(blob->value, blob->header.nb) != HAL_OK)
+  {
+    printf("restore failed\n\r");
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Print a snapshot in hex, header included, for the host decoder:
+  *         "SNAP BEGIN <slot> <bytes>", lines "SNAP <hex>", "SNAP END".
+  * @param  slot: snapshot slot
+  * @retval 0 on success, else -1
+  */
+int DDR_Snap_Dump(uint32_t slot)
+{
+  const snap_blob *blob = snap_get(slot);
+  const uint8_t *p;
+  uint32_t size;
+  uint32_t i;
+
+  if (blob == NULL)
+  {
+    return -1;
+  }
+
+  p = (const uint8_t *)blob;
+  size = sizeof(DDR_SnapHeaderTypeDef) + blob->header.nb * sizeof(uint32_t);
+
+  printf("SNAP BEGIN %lu %lu\n\r", (unsigned long)slot, (unsigned long)size);
+  for (i = 0U; i < size; i++)
+  {
+    if ((i % SNAP_DUMP_LINE) == 0U)
+    {
+      printf("SNAP ");
+    }
+    printf("%02x", p[i]);
+    if (((i % SNAP_DUMP_LINE) == (SNAP_DUMP_LINE - 1U)) || (i == (size - 1U)))
+    {
+      printf("\n\r");
+    }
+  }
+  printf("SNAP END\n\r");
+
+  return 0;
+}
+
+/**
+  * @brief  Print the names of the registers in the snapshot order, once per
+  *         firmware, for the host decoder: "LAYOUT <crc> <nb>", lines
+  *         "LAYOUT <index> <base>.<table>.<name>", "LAYOUT END".
+  * @retval None
+  */
+void DDR_Snap_Layout(void)
+{
+  const char *base, *table, *name;
+  uint32_t nb = HAL_DDR_Snapshot_Reg(NULL, 0U);
+  uint32_t i;
+
+  printf("LAYOUT %08lx %lu\n\r", (unsigned long)snap_layout_crc(nb),
+         (unsigned long)nb);
+  for (i = 0U; HAL_DDR_Snapshot_Name(i, &base, &table, &name); i++)
+  {
+    printf("LAYOUT %lu %s.%s.%s\n\r", (unsigned long)i, base, table, name);
+  }
+  printf("LAYOUT END\n\r");
+}
+
+/**
+  * @brief  Print the state of the snapshot slots.
+  * @retval None
+  */
+void DDR_Snap_Print(void)
+{
+  uint32_t i;
+
+  for (i = 0U; i < DDR_SNAP_SLOT_NB; i++)
+  {
+    if (snap_slot[i].header.magic != DDR_SNAP_MAGIC)
+    {
+      printf("snapshot %lu: empty\n\r", (unsigned long)i);
+      continue;
+    }
+    printf("snapshot %lu: %lu registers at %lu kHz, layout %08lx, "
+           "crc %08lx\n\r", (unsigned long)i, (unsigned long)snap_slot[i].header.nb,
+           (unsigned long)snap_slot[i].header.speed,
+           (unsigned long)snap_slot[i].header.layout,
+           (unsigned long)snap_slot[i].header.crc);
+  }
+}
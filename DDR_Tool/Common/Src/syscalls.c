@@ -29,6 +29,7 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include "uart_tx.h"
 
 
 /* Variables */
@@ -98,6 +99,12 @@ int _write(__attribute__((unused))int file, char *ptr, int len)
 {
     int DataIdx;
 
+    /* buffered output once the console UART is initialized */
+    if (UART_TX_Write(ptr, len) >= 0)
+    {
+        return len;
+    }
+
     for (DataIdx = 0; DataIdx < len; DataIdx++)
     {
         __io_putchar(*ptr++);
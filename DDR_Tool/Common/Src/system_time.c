@@ -36,49 +36,165 @@
 /* Private functions ---------------------------------------------------------*/
 
 /**
-  * @brief  This function handles delay service.
-  * @param  delay_us: delay in microseconds
-  * @retval None
+  * @brief  Convert a number of counts of the generic timer into a duration.
+  * @param  count: number of counts
+  * @param  unit: number of units per second (1000000 for us)
+  * @retval Duration in unit
   */
-void delay_us(unsigned long delay_us)
+static uint64_t time_counter_to_unit(uint64_t count, uint64_t unit)
+{
+  uint64_t freq = time_get_frequency();
+
+  /* Split the division to avoid the overflow of count * unit */
+  return ((count / freq) * unit) + (((count % freq) * unit) / freq);
+}
+
+/**
+  * @brief  Get the current value of the generic timer physical counter,
+  *         clocked by STGEN and shared by all the cores.
+  * @param  None
+  * @retval Counter value
+  */
+uint64_t time_get_counter(void)
+{
+#if defined(__AARCH64__)
+  uint64_t count;
+
+  __asm volatile ("isb\n\tmrs %0, cntpct_el0" : "=r" (count) : : "memory");
+
+  return count;
+#else /* __AARCH64__ */
+  return PL1_GetCurrentPhysicalValue();
+#endif /* __AARCH64__ */
+}
+
+/**
+  * @brief  Get the frequency of the generic timer counter.
+  * @param  None
+  * @retval Frequency in Hz
+  */
+uint64_t time_get_frequency(void)
 {
-  __IO uint32_t wait_loop_index = 0U;
+  uint64_t freq;
 
-  wait_loop_index = (delay_us * (SystemCoreClock / (1000000UL * 2UL)));
+#if defined(__AARCH64__)
+  __asm volatile ("mrs %0, cntfrq_el0" : "=r" (freq));
+#else /* __AARCH64__ */
+  if ((RCC->STGENCKSELR & RCC_STGENCKSELR_STGENSRC) == RCC_STGENCLKSOURCE_HSE)
+  {
+    freq = HSE_VALUE;
+  }
+  else
+  {
+    freq = HSI_VALUE;
+  }
+#endif /* __AARCH64__ */
 
-  while(wait_loop_index != 0UL)
+  /* CNTFRQ not programmed yet: STGEN is clocked by HSI after reset */
+  if (freq == 0U)
   {
-    wait_loop_index--;
+    freq = HSI_VALUE;
   }
+
+  return freq;
 }
 
 /**
-  * @brief  This function handles timeout initialization service.
-  * @param  delay_us: timeout in microseconds
-  * @retval None
+  * @brief  Convert a number of counts of the generic timer in microseconds.
+  * @param  count: number of counts
+  * @retval Duration in microseconds
+  */
+uint64_t time_counter_to_us(uint64_t count)
+{
+  return time_counter_to_unit(count, 1000000ULL);
+}
+
+/**
+  * @brief  Convert a number of counts of the generic timer in nanoseconds.
+  * @param  count: number of counts
+  * @retval Duration in nanoseconds
+  */
+uint64_t time_counter_to_ns(uint64_t count)
+{
+  return time_counter_to_unit(count, 1000000000ULL);
+}
+
+/**
+  * @brief  Get the monotonic time since the generic timer start.
+  * @param  None
+  * @retval Time in microseconds
+  */
+uint64_t time_get_us(void)
+{
+  return time_counter_to_us(time_get_counter());
+}
+
+/**
+  * @brief  Get the monotonic time since the generic timer start.
+  * @param  None
+  * @retval Time in nanoseconds
   */
-__IO uint32_t timeout_init_us(unsigned long timeout_us)
+uint64_t time_get_ns(void)
 {
-  __IO uint32_t wait_loop_index = 0U;
+  return time_counter_to_ns(time_get_counter());
+}
 
-  wait_loop_index = timeout_us * (SystemCoreClock / (1000000UL * 2UL));
+/**
+  * @brief  Get the time elapsed since a stamp taken by time_get_counter().
+  * @param  start: counter value at the start of the measure
+  * @retval Elapsed time in microseconds
+  */
+uint64_t time_elapsed_us(uint64_t start)
+{
+  return time_counter_to_us(time_get_counter() - start);
+}
 
-  return wait_loop_index;
+/**
+  * @brief  Get the time elapsed since a stamp taken by time_get_counter().
+  * @param  start: counter value at the start of the measure
+  * @retval Elapsed time in nanoseconds
+  */
+uint64_t time_elapsed_ns(uint64_t start)
+{
+  return time_counter_to_ns(time_get_counter() - start);
 }
 
 /**
-  * @brief  This function handles timeout elapsed checking service.
-  * @param  delay_us: timeout in microseconds
+  * @brief  This function handles delay service.
+  * @param  delay_us: delay in microseconds
   * @retval None
   */
-bool timeout_elapsed(__IO uint32_t timeout)
+void delay_us(unsigned long delay_us)
 {
-  if (timeout == 0U)
+  uint64_t timeout = timeout_init_us(delay_us);
+
+  while (!timeout_elapsed(timeout))
   {
-    return true;
   }
+}
+
+/**
+  * @brief  This function handles timeout initialization service.
+  * @param  timeout_us: timeout in microseconds
+  * @retval Counter value of the deadline
+  */
+uint64_t timeout_init_us(unsigned long timeout_us)
+{
+  uint64_t freq = time_get_frequency();
+
+  /* Round up so that a non null timeout lasts at least one count */
+  return time_get_counter() +
+         ((((uint64_t)timeout_us * freq) + 999999ULL) / 1000000ULL);
+}
 
-  return false;
+/**
+  * @brief  This function handles timeout elapsed checking service.
+  * @param  timeout: deadline returned by timeout_init_us()
+  * @retval true when the deadline is reached
+  */
+bool timeout_elapsed(uint64_t timeout)
+{
+  return time_get_counter() >= timeout;
 }
 
 /**
@@ -0,0 +1,267 @@
+/**
+  ******************************************************************************
+  * @file    uart_tx.c
+  * @author  MCD Application Team
+  * @brief   Buffered console output: the characters written are copied in a
+  *          ring buffer sent by the UART in background, by interrupt or by
+  *          DMA, so that printf returns without waiting for the UART.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+
+#include "uart_tx.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define UART_TX_MASK              (UART_TX_BUF_SIZE - 1U)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/*
+ * head is only written by UART_TX_Write, tail and len by the end of transfer
+ * (interrupt): len is set before starting a transfer so that its end, which
+ * may come before the HAL returns, always sees it.
+ */
+static struct {
+  UART_HandleTypeDef *huart;
+  bool irq;                       /* ends of transfer seen by the interrupt,
+                                     else by UART_TX_Poll */
+  bool drop;                      /* drop the output on a full buffer */
+  void (*flush)(uintptr_t addr, unsigned long size);  /* write back the data
+                                                         read by the DMA */
+  volatile uint32_t head;         /* next byte written */
+  volatile uint32_t tail;         /* first byte of the transfer in progress */
+  volatile uint32_t len;          /* bytes of the transfer, 0 when idle */
+  UART_TX_StatsTypeDef stats;
+  uint8_t buf[UART_TX_BUF_SIZE];
+} uart_tx;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+static uint32_t uart_tx_level(void)
+{
+  return uart_tx.head - uart_tx.tail;
+}
+
+/* send the buffered bytes up to the end of the buffer, if the UART is idle */
+static void uart_tx_start(void)
+{
+  uint32_t tail = uart_tx.tail;
+  uint32_t len = uart_tx.head - tail;
+  uint8_t *data = &uart_tx.buf[tail & UART_TX_MASK];
+  HAL_StatusTypeDef ret;
+
+  if ((uart_tx.len != 0U) || (len == 0U))
+  {
+    return;
+  }
+
+  if (len > (UART_TX_BUF_SIZE - (tail & UART_TX_MASK)))
+  {
+    len = UART_TX_BUF_SIZE - (tail & UART_TX_MASK);
+  }
+
+  uart_tx.len = len;
+
+#if defined(HAL_DMA_MODULE_ENABLED)
+  if (uart_tx.huart->hdmatx != NULL)
+  {
+    if (uart_tx.flush != NULL)
+    {
+      uart_tx.flush((uintptr_t)data, len);
+    }
+    ret = HAL_UART_Transmit_DMA(uart_tx.huart, data, (uint16_t)len);
+  }
+  else
+#endif /* HAL_DMA_MODULE_ENABLED */
+  {
+    ret = HAL_UART_Transmit_IT(uart_tx.huart, data, (uint16_t)len);
+  }
+
+  if (ret != HAL_OK)
+  {
+    uart_tx.len = 0U;
+  }
+}
+
+/**
+  * @brief  End of a transfer of the console UART: the next bytes are sent.
+  * @param  huart: UART handle
+  * @retval None
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (huart != uart_tx.huart)
+  {
+    return;
+  }
+
+  uart_tx.tail += uart_tx.len;
+  uart_tx.len = 0U;
+  uart_tx_start();
+}
+
+/**
+  * @brief  Send the console output through the buffer, the UART being
+  *         initialized. Before this call, UART_TX_Write returns -1.
+  * @param  huart: console UART, with its hdmatx DMA handle to send by DMA
+  * @param  irq: true when the UART (and DMA) interrupt handlers are called on
+  *         interrupt, false when they are polled by UART_TX_Poll
+  * @param  flush: write back a range of the buffer before a DMA transfer, or
+  *         NULL
+  * @retval None
+  */
+void UART_TX_Init(UART_HandleTypeDef *huart, bool irq,
+                  void (*flush)(uintptr_t addr, unsigned long size))
+{
+  uart_tx.irq = irq;
+  uart_tx.flush = flush;
+  uart_tx.head = 0U;
+  uart_tx.tail = 0U;
+  uart_tx.len = 0U;
+  uart_tx.huart = huart;
+}
+
+/**
+  * @brief  Copy data in the buffer, the UART sending it in background. On a
+  *         full buffer, the end of the data is dropped in drop mode, else the
+  *         UART is awaited.
+  * @param  data: bytes to send
+  * @param  len: number of bytes
+  * @retval len, or -1 when the buffer is not initialized
+  */
+int UART_TX_Write(const char *data, int len)
+{
+  uint32_t i;
+  uint32_t level;
+
+  if (uart_tx.huart == NULL)
+  {
+    return -1;
+  }
+
+  for (i = 0; i < (uint32_t)len; i++)
+  {
+    if (uart_tx_level() >= UART_TX_BUF_SIZE)
+    {
+      if (uart_tx.drop)
+      {
+        uart_tx.stats.dropped += (uint32_t)len - i;
+        uart_tx.stats.overflow++;
+        break;
+      }
+      while (uart_tx_level() >= UART_TX_BUF_SIZE)
+      {
+        UART_TX_Poll();
+      }
+    }
+    uart_tx.buf[uart_tx.head & UART_TX_MASK] = (uint8_t)data[i];
+    uart_tx.head++;
+  }
+
+  uart_tx.stats.written += i;
+  level = uart_tx_level();
+  if (level > uart_tx.stats.peak)
+  {
+    uart_tx.stats.peak = level;
+  }
+
+  UART_TX_Poll();
+
+  return len;
+}
+
+/**
+  * @brief  Handle the ends of transfer without interrupt and start the next
+  *         one. Called on each write and in the waiting loops.
+  * @retval None
+  */
+void UART_TX_Poll(void)
+{
+  if (uart_tx.huart == NULL)
+  {
+    return;
+  }
+
+  if (!uart_tx.irq)
+  {
+#if defined(HAL_DMA_MODULE_ENABLED)
+    if (uart_tx.huart->hdmatx != NULL)
+    {
+      HAL_DMA_IRQHandler(uart_tx.huart->hdmatx);
+    }
+#endif /* HAL_DMA_MODULE_ENABLED */
+    HAL_UART_IRQHandler(uart_tx.huart);
+  }
+
+  if (uart_tx.len == 0U)
+  {
+    uart_tx_start();
+  }
+}
+
+/**
+  * @brief  Wait until all the buffered bytes are sent.
+  * @retval None
+  */
+void UART_TX_Flush(void)
+{
+  if (uart_tx.huart == NULL)
+  {
+    return;
+  }
+
+  while ((uart_tx_level() != 0U) || (uart_tx.len != 0U))
+  {
+    UART_TX_Poll();
+  }
+}
+
+/**
+  * @brief  Select the behavior on a full buffer.
+  * @param  drop: true to drop the output, false to wait for the UART
+  * @retval None
+  */
+void UART_TX_SetDrop(bool drop)
+{
+  uart_tx.drop = drop;
+}
+
+bool UART_TX_GetDrop(void)
+{
+  return uart_tx.drop;
+}
+
+/**
+  * @brief  Number of bytes in the buffer, not yet sent.
+  * @retval bytes
+  */
+unsigned long UART_TX_GetLevel(void)
+{
+  return uart_tx_level();
+}
+
+void UART_TX_GetStats(UART_TX_StatsTypeDef *stats)
+{
+  *stats = uart_tx.stats;
+}
+
+void UART_TX_ResetStats(void)
+{
+  uart_tx.stats.written = 0UL;
+  uart_tx.stats.dropped = 0UL;
+  uart_tx.stats.overflow = 0UL;
+  uart_tx.stats.peak = uart_tx_level();
+}
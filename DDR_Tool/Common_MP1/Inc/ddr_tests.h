@@ -53,6 +53,8 @@ uint32_t DDR_Test_WalkingZeroes(uint32_t size, uint32_t loop_in,
                                     uint32_t addr_in);
 uint32_t DDR_Test_WalkingOnes(uint32_t size, uint32_t loop_in,
                                   uint32_t addr_in);
+uint32_t DDR_Test_Benchmark(uint32_t size_in, uint32_t stride_in,
+                            uint32_t addr_in);
 #ifdef TEST_INFINITE_ENABLE
 uint32_t DDR_Test_Infinite_write(uint32_t pattern_in,
                                   uint32_t addr_in);
@@ -24,6 +24,8 @@
 #include "string.h"
 #include "log.h"
 #include "ddr_tests.h"
+#include "ddr_errmap.h"
+#include "system_time.h"
 
 #include "stm32mp_util_conf.h"
 #include "stm32mp_util_ddr_conf.h"
@@ -42,13 +44,13 @@ static int get_addr(uint32_t addr_in, uint32_t *addr)
   {
     if (addr_in < DDR_BASE_ADDR)
     {
-      printf("Address too low: 0x%lx\n\r", addr_in);
+      printf("Address too low: 0x%lx\n\r", (unsigned long)addr_in);
       return -1;
     }
 
     if ((addr_in & 0x3) != 0)
     {
-      printf("Unaligned address: 0x%lx\n\r", addr_in);
+      printf("Unaligned address: 0x%lx\n\r", (unsigned long)addr_in);
       return -1;
     }
 
@@ -87,14 +89,16 @@ static int get_buf_size(uint32_t size_in, uint32_t *size,
   {
     if ((size_in < min_size) || (size_in > DDR_MEM_SIZE))
     {
-      printf("Invalid size: 0x%lx\n\r", size_in);
-      printf("  (range = 0x%lx..0x%x)\n\r", min_size, DDR_MEM_SIZE);
+      printf("Invalid size: 0x%lx\n\r", (unsigned long)size_in);
+      printf("  (range = 0x%lx..0x%lx)\n\r", (unsigned long)min_size,
+             (unsigned long)DDR_MEM_SIZE);
       return -1;
     }
 
     if ((size_in & (min_size - 1)) != 0)
     {
-      printf("Unaligned size: 0x%lx (min=%ld)\n\r", size_in, min_size);
+      printf("Unaligned size: 0x%lx (min=%lu)\n\r", (unsigned long)size_in,
+             (unsigned long)min_size);
       return -1;
     }
 
@@ -137,6 +141,18 @@ static int test_loop_end(uint32_t *loop, uint32_t nb_loop)
   return 0;
 }
 
+/*
+ * record the data error of the word at addr in the error map, return true
+ * when its error line is printed (see the errmap command); only called on a
+ * mismatch, kept out of line and cold so that the compare loops stay a load,
+ * a compare and a branch
+ */
+static __attribute__((noinline, cold))
+bool test_error(uint32_t addr, uint32_t expected, uint32_t read)
+{
+  return DDR_ErrMap_Record(addr - DDR_BASE_ADDR, expected, read);
+}
+
 /**
 * @brief test_databus.
 * @par Test Description
@@ -162,6 +178,8 @@ uint32_t DDR_Test_Databus(uint32_t addr_in)
 {
   uint32_t pattern;
   uint32_t addr;
+  uint32_t data;
+  uint32_t error = 0U;
 
   if (get_addr(addr_in, &addr) != 0)
   {
@@ -170,16 +188,24 @@ uint32_t DDR_Test_Databus(uint32_t addr_in)
 
   for (pattern = 1U; pattern != 0U; pattern <<= 1)
   {
-    WRITE_REG(*(volatile uint32_t*)addr, pattern);
+    WRITE_REG(*(volatile uint32_t*)(uintptr_t)addr, pattern);
 
-    if (READ_REG(*(volatile uint32_t*)addr) != pattern)
+    data = READ_REG(*(volatile uint32_t*)(uintptr_t)addr);
+    if (data != pattern)
     {
-      printf("  test_databus KO @ 0x%lx \n\r", addr);
-      return 2;
+      if (test_error(addr, pattern, data))
+      {
+        printf("  test_databus KO @ 0x%lx \n\r", (unsigned long)addr);
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 2;
+      }
+      error = 2;
     }
   }
 
-  return 0;
+  return error;
 }
 
 static int test_databuswalk(uint8_t mode, uint32_t loop_in, uint32_t addr_in)
@@ -198,25 +224,32 @@ static int test_databuswalk(uint8_t mode, uint32_t loop_in, uint32_t addr_in)
     return 1;
   }
 
-  while (error == 0U)
+  while ((error == 0U) || DDR_ErrMap_IsEnabled())
   {
     for (i = 0; i < 32; i++)
     {
       uint32_t pattern = mode ? (1 << i) : ~(1 << i);
 
-      WRITE_REG(*(volatile uint32_t*)(addr + sizeof(uint32_t) * i), pattern);
+      WRITE_REG(*(volatile uint32_t*)(uintptr_t)(addr + sizeof(uint32_t) * i),
+                pattern);
     }
 
     for (i = 0; i < 32; i++)
     {
       uint32_t pattern = mode ? (1 << i) : ~(1 << i);
 
-      data = READ_REG(*(volatile uint32_t*)(addr + sizeof(uint32_t) * i));
+      data = READ_REG(*(volatile uint32_t*)(uintptr_t)
+                      (addr + sizeof(uint32_t) * i));
       if (pattern !=  data)
       {
         error |= 1 << i;
-        printf("  %lx: error %lx expected %lx => error:%lx\n\r",
-                addr + sizeof(uint32_t) * i, data, pattern, error);
+        if (test_error(addr + sizeof(uint32_t) * i, pattern, data))
+        {
+          printf("  %lx: error %lx expected %lx => error:%lx\n\r",
+                  (unsigned long)(addr + sizeof(uint32_t) * i),
+                  (unsigned long)data, (unsigned long)pattern,
+                  (unsigned long)error);
+        }
       }
     }
 
@@ -227,7 +260,8 @@ static int test_databuswalk(uint8_t mode, uint32_t loop_in, uint32_t addr_in)
 
     for (i = 0; i < 32; i++)
     {
-      WRITE_REG(*(volatile uint32_t*)(addr + sizeof(uint32_t) * i), 0);
+      WRITE_REG(*(volatile uint32_t*)(uintptr_t)(addr + sizeof(uint32_t) * i),
+                0);
     }
   }
 
@@ -333,7 +367,7 @@ uint32_t DDR_Test_AddressBus(uint32_t size_in, uint32_t addr_in)
 
   if (!is_power_of_2(size))
   {
-    printf("size 0x%lx is not a power of 2\n\r", size);
+    printf("size 0x%lx is not a power of 2\n\r", (unsigned long)size);
     return 2;
   }
 
@@ -347,35 +381,42 @@ uint32_t DDR_Test_AddressBus(uint32_t size_in, uint32_t addr_in)
   /* Write the default pattern at each of the power-of-two offsets. */
   for (offset = sizeof(uint32_t); (offset & addressmask) != 0U; offset <<= 1)
   {
-    WRITE_REG(*(volatile uint32_t*)(addr + (uint32_t)offset), pattern);
+    WRITE_REG(*(volatile uint32_t*)(uintptr_t)(addr + (uint32_t)offset),
+              pattern);
   }
 
   /* Check for address bits stuck high. */
-  WRITE_REG(*(volatile uint32_t*)(addr + (uint32_t)testoffset), antipattern);
+  WRITE_REG(*(volatile uint32_t*)(uintptr_t)(addr + (uint32_t)testoffset),
+            antipattern);
 
   for (offset = sizeof(uint32_t);
        ((offset & addressmask) != 0U) && (offset != DDR_MEM_SIZE);
        offset <<= 1)
   {
-    if (READ_REG(*(volatile uint32_t*)(addr + (uint32_t)offset)) != pattern)
+    if (READ_REG(*(volatile uint32_t*)(uintptr_t)
+                 (addr + (uint32_t)offset)) != pattern)
     {
-      printf("  test_addrbus KO @ 0x%lx \n\r", addr + (uint32_t)offset);
+      printf("  test_addrbus KO @ 0x%lx \n\r",
+             (unsigned long)(addr + (uint32_t)offset));
       return 4;
     }
   }
 
-  WRITE_REG(*(volatile uint32_t*)(addr + (uint32_t)testoffset), pattern);
+  WRITE_REG(*(volatile uint32_t*)(uintptr_t)(addr + (uint32_t)testoffset),
+            pattern);
 
   /* Check for address bits stuck low or shorted. */
   for (testoffset = sizeof(uint32_t);
        ((testoffset & addressmask) != 0U)  && (testoffset != DDR_MEM_SIZE);
        testoffset <<= 1)
   {
-    WRITE_REG(*(volatile uint32_t*)(addr + (uint32_t)testoffset), antipattern);
+    WRITE_REG(*(volatile uint32_t*)(uintptr_t)(addr + (uint32_t)testoffset),
+              antipattern);
 
-    if (READ_REG(*(volatile uint32_t*)addr) != pattern)
+    if (READ_REG(*(volatile uint32_t*)(uintptr_t)addr) != pattern)
     {
-      printf("  test_addrbus KO @ 0x%lx \n\r", addr + (uint32_t)testoffset);
+      printf("  test_addrbus KO @ 0x%lx \n\r",
+             (unsigned long)(addr + (uint32_t)testoffset));
       return 5;
     }
 
@@ -383,15 +424,18 @@ uint32_t DDR_Test_AddressBus(uint32_t size_in, uint32_t addr_in)
          ((offset & addressmask) != 0U) && (offset != DDR_MEM_SIZE);
          offset <<= 1)
     {
-      if ((READ_REG(*(volatile uint32_t*)(addr + (uint32_t)offset)) != pattern)
+      if ((READ_REG(*(volatile uint32_t*)(uintptr_t)
+                    (addr + (uint32_t)offset)) != pattern)
           && (offset != testoffset))
       {
-        printf("  test_addrbus KO @ 0x%lx \n\r", addr + (uint32_t)offset);
+        printf("  test_addrbus KO @ 0x%lx \n\r",
+               (unsigned long)(addr + (uint32_t)offset));
         return 6;
       }
     }
 
-    WRITE_REG(*(volatile uint32_t*)(addr + (uint32_t)testoffset), pattern);
+    WRITE_REG(*(volatile uint32_t*)(uintptr_t)(addr + (uint32_t)testoffset),
+              pattern);
   }
 
   return 0;
@@ -427,6 +471,8 @@ uint32_t DDR_Test_MemDevice(uint32_t size_in, uint32_t addr_in)
   uint32_t offset;
   uint32_t pattern;
   uint32_t antipattern;
+  uint32_t data;
+  uint32_t error = 0U;
 
   if (get_buf_size(size_in, &size, 4 * 1024, 4) != 0)
   {
@@ -445,7 +491,7 @@ uint32_t DDR_Test_MemDevice(uint32_t size_in, uint32_t addr_in)
   for (pattern = 1, offset = 0; offset < nb_words;
        pattern++, offset += sizeof(uint32_t))
   {
-    WRITE_REG(*(volatile uint32_t*)(addr + offset), pattern);
+    WRITE_REG(*(volatile uint32_t*)(uintptr_t)(addr + offset), pattern);
   }
 
   log_dbg("Check and invert pattern\n\r");
@@ -453,14 +499,23 @@ uint32_t DDR_Test_MemDevice(uint32_t size_in, uint32_t addr_in)
   for (pattern = 1, offset = 0; offset < nb_words;
        pattern++, offset += sizeof(uint32_t))
   {
-    if (READ_REG(*(volatile uint32_t*)(addr + offset)) != pattern)
+    data = READ_REG(*(volatile uint32_t*)(uintptr_t)(addr + offset));
+    if (data != pattern)
     {
-      printf("  test_memdevice KO @ 0x%lx \n\r", addr + offset);
-      return 3;
+      if (test_error(addr + offset, pattern, data))
+      {
+        printf("  test_memdevice KO @ 0x%lx \n\r",
+               (unsigned long)(addr + offset));
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 3;
+      }
+      error = 3;
     }
 
     antipattern = ~pattern;
-    WRITE_REG(*(volatile uint32_t*)(addr + offset), antipattern);
+    WRITE_REG(*(volatile uint32_t*)(uintptr_t)(addr + offset), antipattern);
   }
 
   log_dbg("Check inverted pattern\n\r");
@@ -469,14 +524,23 @@ uint32_t DDR_Test_MemDevice(uint32_t size_in, uint32_t addr_in)
        pattern++, offset += sizeof(uint32_t))
   {
     antipattern = ~pattern;
-    if (READ_REG(*(volatile uint32_t*)(addr + offset)) != antipattern)
+    data = READ_REG(*(volatile uint32_t*)(uintptr_t)(addr + offset));
+    if (data != antipattern)
     {
-      printf("  test_memdevice KO @ 0x%lx \n\r", addr + offset);
-      return 4;
+      if (test_error(addr + offset, antipattern, data))
+      {
+        printf("  test_memdevice KO @ 0x%lx \n\r",
+               (unsigned long)(addr + offset));
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 4;
+      }
+      error = 4;
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -517,6 +581,8 @@ uint32_t DDR_Test_SimultaneousSwitchingOutput(uint32_t size_in,
   uint32_t remaining;
   uint32_t offset;
   uint32_t data = 0;
+  uint32_t read;
+  uint32_t error = 0U;
 
   if (get_buf_size(size_in, &size, 4 * 1024, 4) != 0)
   {
@@ -554,12 +620,20 @@ uint32_t DDR_Test_SimultaneousSwitchingOutput(uint32_t size_in,
             break;
         }
 
-        WRITE_REG(*(volatile uint32_t*)offset, data);
+        WRITE_REG(*(volatile uint32_t*)(uintptr_t)offset, data);
 
-        if (READ_REG(*(volatile uint32_t*)offset) != data)
+        read = READ_REG(*(volatile uint32_t*)(uintptr_t)offset);
+        if (read != data)
         {
-          printf("  test_sso KO @ 0x%lx \n\r", offset);
-          return 3;
+          if (test_error(offset, data, read))
+          {
+            printf("  test_sso KO @ 0x%lx \n\r", (unsigned long)offset);
+          }
+          if (!DDR_ErrMap_IsEnabled())
+          {
+            return 3;
+          }
+          error = 3;
         }
       }
     }
@@ -567,11 +641,12 @@ uint32_t DDR_Test_SimultaneousSwitchingOutput(uint32_t size_in,
     remaining -= sizeof(uint32_t);
   }
 
-  return 0;
+  return error;
 }
 
 static void do_noise(uint32_t addr, uint32_t pattern, uint32_t *result)
 {
+#if defined(__arm__)
   __asm volatile ("PUSH {r2-r10}         \n"
                   "MOV r0, %[addr]       \n"
                   "MOV r1, %[pattern]    \n"
@@ -606,6 +681,18 @@ static void do_noise(uint32_t addr, uint32_t pattern, uint32_t *result)
                     [pattern] "r" (pattern),
                     [result]  "r" (result)
                   : "r0", "r1", "r11");
+#else /* __arm__ */
+  volatile uint32_t *p = (volatile uint32_t *)(uintptr_t)addr;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+  {
+    *p = pattern;
+    result[i] = *p;
+    *p = ~pattern;
+    result[i + 1] = *p;
+  }
+#endif /* __arm__ */
 }
 
 
@@ -650,13 +737,13 @@ uint32_t DDR_Test_Noise(uint32_t pattern_in, uint32_t addr_in)
   {
     if (READ_REG(*(volatile uint32_t*)(&result[i++])) != pattern)
     {
-      printf("  test_noise KO @ 0x%lx \n\r", result[i - 1]);
+      printf("  test_noise KO @ 0x%lx \n\r", (unsigned long)result[i - 1]);
       return 2;
     }
 
     if (READ_REG(*(volatile uint32_t*)(&result[i++])) != ~pattern)
     {
-      printf("  test_noise KO @ 0x%lx \n\r", result[i - 1]);
+      printf("  test_noise KO @ 0x%lx \n\r", (unsigned long)result[i - 1]);
       return 3;
     }
   }
@@ -666,6 +753,7 @@ uint32_t DDR_Test_Noise(uint32_t pattern_in, uint32_t addr_in)
 
 static void do_noiseburst(uint32_t addr, uint32_t pattern, size_t bufsize)
 {
+#if defined(__arm__)
   __asm volatile ("PUSH {r2-r8}          \n"
                   "MOV r0, %[addr]       \n"
                   "MOV r1, %[pattern]    \n"
@@ -691,6 +779,21 @@ static void do_noiseburst(uint32_t addr, uint32_t pattern, size_t bufsize)
                     [pattern] "r" (pattern),
                     [bufsize] "r" (bufsize)
                   : "r0", "r1", "r9");
+#else /* __arm__ */
+  volatile uint32_t *p = (volatile uint32_t *)(uintptr_t)addr;
+  int32_t remaining = (int32_t)bufsize;
+  int i;
+
+  /* same as the assembly loop: 128 bytes written until remaining < 0 */
+  do
+  {
+    for (i = 0; i < 32; i++)
+    {
+      *p++ = (i & 1) ? ~pattern : pattern;
+    }
+    remaining -= 128;
+  } while (remaining >= 0);
+#endif /* __arm__ */
 }
 
 #define DDR_CHUNK_SIZE  0x08000000
@@ -723,9 +826,11 @@ uint32_t DDR_Test_NoiseBurst(uint32_t size_in, uint32_t pattern_in,
   uint32_t addr;
   uint32_t offset;
   uint32_t bufsize;
+  uint32_t data;
+  uint32_t error = 0U;
   size_t remaining;
   size_t size;
-  int i;
+  uint32_t i;
 
   if (get_buf_size(size_in, &bufsize, 4 * 1024, 128) != 0)
   {
@@ -757,24 +862,42 @@ uint32_t DDR_Test_NoiseBurst(uint32_t size_in, uint32_t pattern_in,
 
   for (i = 0; i < bufsize;)
   {
-    if (READ_REG(*(volatile uint32_t*)(addr + i)) != pattern)
+    data = READ_REG(*(volatile uint32_t*)(uintptr_t)(addr + i));
+    if (data != pattern)
     {
-      printf("  test_noiseburst KO @ 0x%lx\n\r", addr + i);
-      return 3;
+      if (test_error(addr + i, pattern, data))
+      {
+        printf("  test_noiseburst KO @ 0x%lx\n\r",
+               (unsigned long)(addr + i));
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 3;
+      }
+      error = 3;
     }
 
     i += sizeof(uint32_t);
 
-    if (READ_REG(*(volatile uint32_t*)(addr + i)) != ~pattern)
+    data = READ_REG(*(volatile uint32_t*)(uintptr_t)(addr + i));
+    if (data != ~pattern)
     {
-      printf("  test_noiseburst KO @ 0x%lx\n\r", addr + i);
-      return 4;
+      if (test_error(addr + i, ~pattern, data))
+      {
+        printf("  test_noiseburst KO @ 0x%lx\n\r",
+               (unsigned long)(addr + i));
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 4;
+      }
+      error = 4;
     }
 
     i += sizeof(uint32_t);
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -826,17 +949,18 @@ uint32_t DDR_Test_Random(uint32_t size_in, uint32_t loop_in,
 
   bufsize /= 2;
 
-  while (error == 0U)
+  while ((error == 0U) || DDR_ErrMap_IsEnabled())
   {
     seed = rand();
     srand(seed);
 
     for (offset = 0; offset < bufsize; offset += sizeof(uint32_t))
     {
-      WRITE_REG(*(volatile uint32_t*)(addr + offset), rand());
+      WRITE_REG(*(volatile uint32_t*)(uintptr_t)(addr + offset), rand());
     }
 
-    memcpy((void *)(addr + bufsize), (void *)addr, bufsize);
+    memcpy((void *)(uintptr_t)(addr + bufsize),
+           (void *)(uintptr_t)addr, bufsize);
 
     srand(seed);
 
@@ -848,13 +972,20 @@ uint32_t DDR_Test_Random(uint32_t size_in, uint32_t loop_in,
       }
 
       value = rand();
-      data = READ_REG(*(volatile uint32_t*)(addr + offset));
+      data = READ_REG(*(volatile uint32_t*)(uintptr_t)(addr + offset));
       if (data != value)
       {
         error++;
-        printf("  loop %ld: error @ 0x%lx: 0x%lx expected 0x%lx\n\r",
-               loop, offset, data, value);
-        break;
+        if (test_error(addr + offset, value, data))
+        {
+          printf("  loop %lu: error @ 0x%lx: 0x%lx expected 0x%lx\n\r",
+                 (unsigned long)loop, (unsigned long)offset,
+                 (unsigned long)data, (unsigned long)value);
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          break;
+        }
       }
     }
 
@@ -879,19 +1010,22 @@ uint32_t DDR_Test_Random(uint32_t size_in, uint32_t loop_in,
 static int test_loop(const uint32_t *pattern, uint32_t *address,
                      const uint32_t bufsize)
 {
-  int i;
+  uint32_t i;
   int j;
+  int error = 0;
+  uint32_t data;
   uint32_t offset;
   uint32_t testsize;
   uint32_t remaining;
 
-  offset = (uint32_t)address;
+  offset = (uint32_t)(uintptr_t)address;
   remaining = bufsize;
 
   while (remaining)
   {
     testsize = bufsize > 0x1000000 ? 0x1000000 : bufsize;
 
+#if defined(__arm__)
     __asm volatile ("PUSH {r3-r10}          \n"
                     "MOV r0, %[pattern]     \n"
                     "MOV r1, %[offset]      \n"
@@ -911,6 +1045,22 @@ static int test_loop(const uint32_t *pattern, uint32_t *address,
                       [offset]   "r" (offset),
                       [testsize] "r" (testsize)
                     : "r0", "r1", "r2");
+#else /* __arm__ */
+    {
+      volatile uint32_t *p = (volatile uint32_t *)(uintptr_t)offset;
+      int32_t size = (int32_t)testsize;
+
+      /* same as the assembly loop: 128 bytes written until size < 0 */
+      do
+      {
+        for (j = 0; j < 32; j++)
+        {
+          *p++ = pattern[j % DDR_PATTERN_SIZE];
+        }
+        size -= 128;
+      } while (size >= 0);
+    }
+#endif /* __arm__ */
 
     offset += testsize;
     remaining -= testsize;
@@ -920,15 +1070,24 @@ static int test_loop(const uint32_t *pattern, uint32_t *address,
   {
     for (j = 0; j < DDR_PATTERN_SIZE; j++, address++)
     {
-      if (READ_REG(*(volatile uint32_t*)address) != pattern[j])
+      data = READ_REG(*(volatile uint32_t*)(uintptr_t)address);
+      if (data != pattern[j])
       {
-        printf("  test_freqpattern KO @ 0x%lx\n\r", *address);
-        return 1;
+        if (test_error((uint32_t)(uintptr_t)address, pattern[j], data))
+        {
+          printf("  test_freqpattern KO @ 0x%lx\n\r",
+                 (unsigned long)(uintptr_t)address);
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 1;
+        }
+        error = 1;
       }
     }
   }
 
-  return 0;
+  return error;
 }
 
 const uint32_t pattern_div1_x16[DDR_PATTERN_SIZE] = {
@@ -1021,6 +1180,7 @@ uint32_t DDR_Test_FrequencySelectivePattern(uint32_t size,
   const uint32_t **patterns;
   uint32_t bufsize;
   uint32_t addr;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 128) != 0)
   {
@@ -1047,22 +1207,31 @@ uint32_t DDR_Test_FrequencySelectivePattern(uint32_t size,
 
   for (i = 0; i < DDR_NB_PATTERN; i++)
   {
-    ret = test_loop(patterns[i], (uint32_t *)addr, bufsize);
+    ret = test_loop(patterns[i], (uint32_t *)(uintptr_t)addr, bufsize);
     if (ret != 0)
     {
-      printf("  test_freqpattern KO\n\r");
-      return 3;
+      if (DDR_ErrMap_Line())
+      {
+        printf("  test_freqpattern KO\n\r");
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 3;
+      }
+      error = 3;
     }
   }
 
-  return 0;
+  return error;
 }
 
 /* pattern test with size, loop for write pattern */
 static int test_loop_size(const uint32_t *pattern, uint32_t size,
                           uint32_t *address, const uint32_t bufsize)
 {
-  int i, j;
+  uint32_t i, j;
+  int error = 0;
+  uint32_t data;
   uint32_t *p = address;
 
   for (i = 0; i < bufsize; i += (size * sizeof(uint32_t)))
@@ -1078,15 +1247,23 @@ static int test_loop_size(const uint32_t *pattern, uint32_t size,
   {
     for (j = 0; j < size; j++, p++)
     {
-      if (READ_REG(*(volatile uint32_t*)p) != pattern[j])
+      data = READ_REG(*(volatile uint32_t*)p);
+      if (data != pattern[j])
       {
-        printf("  test KO @ 0x%ln\n\r", p);
-        return 1;
+        if (test_error((uint32_t)(uintptr_t)p, pattern[j], data))
+        {
+          printf("  test KO @ 0x%lx\n\r", (unsigned long)(uintptr_t)p);
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 1;
+        }
+        error = 1;
       }
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1119,6 +1296,7 @@ uint32_t DDR_Test_BlockSequential(uint32_t size, uint32_t loop_in,
   uint32_t value;
   int i;
   int ret;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 4) != 0)
   {
@@ -1137,11 +1315,18 @@ uint32_t DDR_Test_BlockSequential(uint32_t size, uint32_t loop_in,
     for (i = 0; i < 256; i++)
     {
       value = i | i << 8 | i << 16 | i << 24;
-      ret = test_loop_size(&value, 1, (uint32_t *)addr, bufsize);
+      ret = test_loop_size(&value, 1, (uint32_t *)(uintptr_t)addr, bufsize);
       if (ret != 0)
       {
-        printf("  test_blockseq KO\n\r");
-        return 3;
+        if (DDR_ErrMap_Line())
+        {
+          printf("  test_blockseq KO\n\r");
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 3;
+        }
+        error = 3;
       }
     }
 
@@ -1151,7 +1336,7 @@ uint32_t DDR_Test_BlockSequential(uint32_t size, uint32_t loop_in,
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1184,6 +1369,7 @@ uint32_t DDR_Test_Checkerboard(uint32_t size, uint32_t loop_in,
   uint32_t checkboard[2] = {0x55555555, 0xAAAAAAAA};
   int i;
   int ret;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 8) != 0)
   {
@@ -1201,11 +1387,18 @@ uint32_t DDR_Test_Checkerboard(uint32_t size, uint32_t loop_in,
   {
     for (i = 0; i < 2; i++)
     {
-      ret = test_loop_size(checkboard, 2, (uint32_t *)addr, bufsize);
+      ret = test_loop_size(checkboard, 2, (uint32_t *)(uintptr_t)addr, bufsize);
       if (ret != 0)
       {
-        printf("  test_checkboard KO\n\r");
-        return 3;
+        if (DDR_ErrMap_Line())
+        {
+          printf("  test_checkboard KO\n\r");
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 3;
+        }
+        error = 3;
       }
 
       checkboard[0] = ~checkboard[0];
@@ -1218,7 +1411,7 @@ uint32_t DDR_Test_Checkerboard(uint32_t size, uint32_t loop_in,
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1253,6 +1446,7 @@ uint32_t DDR_Test_BitSpread(uint32_t size, uint32_t loop_in,
   int i;
   int j;
   int ret;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 32) != 0)
   {
@@ -1285,11 +1479,19 @@ uint32_t DDR_Test_BitSpread(uint32_t size, uint32_t loop_in,
         bitspread[2] = ~bitspread[0];
         bitspread[3] = ~bitspread[0];
 
-        ret = test_loop_size(bitspread, 4, (uint32_t *)addr, bufsize);
+        ret = test_loop_size(bitspread, 4,
+                             (uint32_t *)(uintptr_t)addr, bufsize);
         if (ret != 0)
         {
-          printf("  test_bitspread KO\n\r");
-          return 3;
+          if (DDR_ErrMap_Line())
+          {
+            printf("  test_bitspread KO\n\r");
+          }
+          if (!DDR_ErrMap_IsEnabled())
+          {
+            return 3;
+          }
+          error = 3;
         }
       }
     }
@@ -1300,7 +1502,7 @@ uint32_t DDR_Test_BitSpread(uint32_t size, uint32_t loop_in,
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1332,6 +1534,7 @@ uint32_t DDR_Test_BitFlip(uint32_t size, uint32_t loop_in,
   uint32_t bitflip[4];
   int i;
   int ret;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 32) != 0)
   {
@@ -1354,11 +1557,18 @@ uint32_t DDR_Test_BitFlip(uint32_t size, uint32_t loop_in,
       bitflip[2] = ~bitflip[0];
       bitflip[3] = bitflip[2];
 
-      ret = test_loop_size(bitflip, 4, (uint32_t *)addr, bufsize);
+      ret = test_loop_size(bitflip, 4, (uint32_t *)(uintptr_t)addr, bufsize);
       if (ret != 0)
       {
-        printf("  test_bitflip KO\n\r");
-        return 3;
+        if (DDR_ErrMap_Line())
+        {
+          printf("  test_bitflip KO\n\r");
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 3;
+        }
+        error = 3;
       }
     }
 
@@ -1368,7 +1578,7 @@ uint32_t DDR_Test_BitFlip(uint32_t size, uint32_t loop_in,
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1400,6 +1610,7 @@ uint32_t DDR_Test_WalkingZeroes(uint32_t size, uint32_t loop_in,
   uint32_t value;
   int i;
   int ret;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 4) != 0)
   {
@@ -1426,11 +1637,18 @@ uint32_t DDR_Test_WalkingZeroes(uint32_t size, uint32_t loop_in,
         value = 1 << (63 - i);
       }
 
-      ret = test_loop_size(&value, 1, (uint32_t *)addr, bufsize);
+      ret = test_loop_size(&value, 1, (uint32_t *)(uintptr_t)addr, bufsize);
       if (ret != 0)
       {
-        printf("  test_walkbit0 KO\n\r");
-        return 3;
+        if (DDR_ErrMap_Line())
+        {
+          printf("  test_walkbit0 KO\n\r");
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 3;
+        }
+        error = 3;
       }
     }
 
@@ -1440,7 +1658,7 @@ uint32_t DDR_Test_WalkingZeroes(uint32_t size, uint32_t loop_in,
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1472,6 +1690,7 @@ uint32_t DDR_Test_WalkingOnes(uint32_t size, uint32_t loop_in,
   uint32_t value;
   int i;
   int ret;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 4) != 0)
   {
@@ -1498,11 +1717,18 @@ uint32_t DDR_Test_WalkingOnes(uint32_t size, uint32_t loop_in,
         value = ~(1 << (63 - i));
       }
 
-      ret = test_loop_size(&value, 1, (uint32_t *)addr, bufsize);
+      ret = test_loop_size(&value, 1, (uint32_t *)(uintptr_t)addr, bufsize);
       if (ret != 0)
       {
-        printf("  test_walkbit1 KO\n\r");
-        return 3;
+        if (DDR_ErrMap_Line())
+        {
+          printf("  test_walkbit1 KO\n\r");
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 3;
+        }
+        error = 3;
       }
     }
 
@@ -1512,6 +1738,191 @@ uint32_t DDR_Test_WalkingOnes(uint32_t size, uint32_t loop_in,
     }
   }
 
+  return error;
+}
+
+/* bandwidth in MB/s for size bytes transferred in ticks */
+static uint32_t test_bandwidth(uint32_t size, uint64_t ticks)
+{
+  if (ticks == 0U)
+  {
+    return 0U;
+  }
+
+  return (uint32_t)(((uint64_t)size * time_get_frequency()) / (ticks * 1000000U));
+}
+
+/* sequential write (STMIA) or read (LDMIA), size is a multiple of 128 */
+static void test_stream(uint32_t addr, uint32_t size, bool write)
+{
+#if defined(__arm__)
+  if (write)
+  {
+    __asm volatile ("PUSH {r3-r10}          \n"
+                    "MOV r0, %[addr]        \n"
+                    "MOV r1, %[size]        \n"
+                    "loop_wr:\n"
+                    "STMIA r0!, {r3-r10}\n"
+                    "STMIA r0!, {r3-r10}\n"
+                    "STMIA r0!, {r3-r10}\n"
+                    "STMIA r0!, {r3-r10}\n"
+                    "SUBS r1, r1, #128\n"
+                    "BHI loop_wr\n"
+                    "POP {r3-r10}\n"
+                    ::[addr] "r" (addr),
+                      [size] "r" (size)
+                    : "r0", "r1", "cc", "memory");
+  }
+  else
+  {
+    __asm volatile ("PUSH {r3-r10}          \n"
+                    "MOV r0, %[addr]        \n"
+                    "MOV r1, %[size]        \n"
+                    "loop_rd:\n"
+                    "LDMIA r0!, {r3-r10}\n"
+                    "LDMIA r0!, {r3-r10}\n"
+                    "LDMIA r0!, {r3-r10}\n"
+                    "LDMIA r0!, {r3-r10}\n"
+                    "SUBS r1, r1, #128\n"
+                    "BHI loop_rd\n"
+                    "POP {r3-r10}\n"
+                    ::[addr] "r" (addr),
+                      [size] "r" (size)
+                    : "r0", "r1", "cc", "memory");
+  }
+#else /* __arm__ */
+  volatile uint32_t *p = (volatile uint32_t *)(uintptr_t)addr;
+  uint32_t i;
+
+  for (i = 0; i < (size / sizeof(uint32_t)); i++)
+  {
+    if (write)
+    {
+      p[i] = 0U;
+    }
+    else
+    {
+      (void)p[i];
+    }
+  }
+#endif /* __arm__ */
+}
+
+/* follow the pointer chain for nb loads */
+static void test_pointer_chase(uint32_t start, uint32_t nb)
+{
+#if defined(__arm__)
+  __asm volatile ("MOV r0, %[start]       \n"
+                  "MOV r1, %[nb]          \n"
+                  "loop_chase:\n"
+                  "LDR r0, [r0]\n"
+                  "SUBS r1, r1, #1\n"
+                  "BNE loop_chase\n"
+                  ::[start] "r" (start),
+                    [nb]    "r" (nb)
+                  : "r0", "r1", "cc", "memory");
+#else /* __arm__ */
+  volatile uint32_t p = start;
+
+  do
+  {
+    p = *(volatile uint32_t *)(uintptr_t)p;
+  } while (--nb != 0U);
+#endif /* __arm__ */
+}
+
+/**
+* @brief test_benchmark.
+* @par Test Description
+*   Measures the DDR performance with the generic timer (CNTPCT):
+*   + sequential write and read bandwidth (STMIA/LDMIA bursts)
+*   + copy bandwidth with memcpy from the 1st half to the 2nd half
+*   + load latency with a pointer chase, one pointer each stride bytes
+* @par Test Hardware Connection
+* - None
+* @par Required preconditions
+* - None
+* @par Expected result
+* - None
+* @par Called functions
+* - None
+* @par Used Peripherals
+* - None,...
+* @retval
+*  0: Test passed
+*  Value different from 0: Test failed
+*  None(0xFF): if the result is deduced by the user: waveform, event...
+*/
+uint32_t DDR_Test_Benchmark(uint32_t size_in, uint32_t stride_in,
+                            uint32_t addr_in)
+{
+  uint32_t addr;
+  uint32_t size;
+  uint32_t stride = 4 * 1024;
+  uint32_t nb;
+  uint32_t i;
+  uint32_t latency;
+  uint64_t start;
+  uint64_t ticks;
+
+  if (get_buf_size(size_in, &size, 1024 * 1024, 4 * 1024) != 0)
+  {
+    return 1;
+  }
+
+  if (stride_in != 0U)
+  {
+    if ((stride_in < 4U) || (stride_in >= size) || ((stride_in & 0x3U) != 0U))
+    {
+      printf("Invalid stride: 0x%lx\n\r", (unsigned long)stride_in);
+      return 2;
+    }
+    stride = stride_in;
+  }
+
+  if (get_addr(addr_in, &addr) != 0)
+  {
+    return 3;
+  }
+
+  printf("  size 0x%lx @ 0x%lx, timer %lu Hz\n\r", (unsigned long)size,
+         (unsigned long)addr, (unsigned long)time_get_frequency());
+
+  start = time_get_counter();
+  test_stream(addr, size, true);
+  ticks = time_get_counter() - start;
+  printf("  write  : %lu MB/s\n\r", (unsigned long)test_bandwidth(size, ticks));
+
+  start = time_get_counter();
+  test_stream(addr, size, false);
+  ticks = time_get_counter() - start;
+  printf("  read   : %lu MB/s\n\r", (unsigned long)test_bandwidth(size, ticks));
+
+  start = time_get_counter();
+  memcpy((void *)(uintptr_t)(addr + (size / 2)),
+         (void *)(uintptr_t)addr, size / 2);
+  ticks = time_get_counter() - start;
+  printf("  copy   : %lu MB/s\n\r",
+         (unsigned long)test_bandwidth(size / 2, ticks));
+
+  /* pointer chain: each node points to the next one, stride bytes after */
+  nb = size / stride;
+  for (i = 0; i < nb; i++)
+  {
+    WRITE_REG(*(volatile uint32_t *)(uintptr_t)(addr + (i * stride)),
+              addr + (((i + 1) % nb) * stride));
+  }
+
+  start = time_get_counter();
+  test_pointer_chase(addr, nb);
+  ticks = time_get_counter() - start;
+
+  /* latency in 0.1 ns unit */
+  latency = (uint32_t)((time_counter_to_ns(ticks) * 10U) / nb);
+  printf("  latency: %lu.%lu ns (stride 0x%lx, %lu loads)\n\r",
+         (unsigned long)(latency / 10), (unsigned long)(latency % 10),
+         (unsigned long)stride, (unsigned long)nb);
+
   return 0;
 }
 
@@ -1572,7 +1983,7 @@ uint32_t DDR_Test_Infinite_write(uint32_t pattern_in, uint32_t addr_in)
         data = rand();
       }
 
-      WRITE_REG(*(volatile uint32_t*)addr, data);
+      WRITE_REG(*(volatile uint32_t*)(uintptr_t)addr, data);
     }
 
     if (test_loop_end(&loop, nb_loop))
@@ -1628,7 +2039,7 @@ uint32_t DDR_Test_Infinite_read(uint32_t pattern_in, uint32_t addr_in)
   else
   {
     printf("running at 0x%lx with pattern 0x%lx\n\r", addr, data);
-    WRITE_REG(*(volatile uint32_t*)addr, data);
+    WRITE_REG(*(volatile uint32_t*)(uintptr_t)addr, data);
   }
 
   while (go_loop != 0U)
@@ -1638,7 +2049,7 @@ uint32_t DDR_Test_Infinite_read(uint32_t pattern_in, uint32_t addr_in)
       if (random)
         addr = (uint32_t)((rand() & (DDR_MEM_SIZE - 1) & ~0x3));
 
-      READ_REG(*(volatile uint32_t*)addr);
+      READ_REG(*(volatile uint32_t*)(uintptr_t)addr);
       printf("data @ address 0x%lx = 0x%lx \n\r", addr, data);
     }
 
@@ -23,6 +23,13 @@
 #include "stdlib.h"
 #include "ddr_tool.h"
 #include "stm32mp_util_conf.h"
+#include "system_time.h"
+#include "ddr_pmu.h"
+#include "ddr_margin.h"
+#include "uart_tx.h"
+#include "ddr_script.h"
+#include "ddr_snapshot.h"
+#include "ddr_errmap.h"
 
 /* Private typedef -----------------------------------------------------------*/
 typedef struct {
@@ -46,8 +53,16 @@ typedef enum {
   DDR_CMD_NEXT,
   DDR_CMD_GO,
   DDR_CMD_TEST,
+  DDR_CMD_PERF,
+  DDR_CMD_PMU,
+  DDR_CMD_MARGIN,
+  DDR_CMD_UART,
+  DDR_CMD_SCRIPT,
+  DDR_CMD_SNAP,
+  DDR_CMD_ERRMAP,
   DDR_CMD_UNKNOWN,
   DDR_CMD_TEST_HELP,
+  DDR_CMD_PERF_HELP,
   DDR_CMD_MAX,
 } ddr_cmd_id;
 
@@ -66,6 +81,33 @@ typedef struct {
 #define CMD_MAX_LEN 1024
 #define CMD_MAX_ARG 255
 
+#ifdef DDR_32BIT_INTERFACE
+#define PERF_BUS_BYTES 4U
+#else
+#define PERF_BUS_BYTES 2U
+#endif
+
+/*
+ * margin sweep of the PHY byte lanes: 4 or 2 DATX8 lanes with 8 DQ each,
+ * kernel of 16KB at the DDR base
+ */
+#ifdef DDR_32BIT_INTERFACE
+#define MARGIN_BYTE_NB 4U
+#else
+#define MARGIN_BYTE_NB 2U
+#endif
+#define MARGIN_DQ_NB 8U
+#define MARGIN_SIZE 0x4000U
+/* DXnDLLCR.SDPHASE: read DQS phase from 36 to 144 degrees by 18 degrees */
+#define MARGIN_PHASE_NB 7
+#define MARGIN_PHASE_PER_CLK 20U
+
+#if defined(STM32MP13)
+#define PERF_TIMER_IRQn SecurePhyTimer_IRQn
+#else
+#define PERF_TIMER_IRQn SecurePhysicalTimer_IRQn
+#endif
+
 static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr);
 
 const subcmd_desc test[] = {
@@ -105,6 +147,8 @@ const subcmd_desc test[] = {
    "test Walking Ones pattern", 3},
   {DDR_Test_WalkingOnes, "Test WalkingOnes", "[size] [loop] [addr]",
    "test Walking Zeroes pattern", 3},
+  {DDR_Test_Benchmark, "Test Benchmark", "[size] [stride] [addr]",
+   "Measure read/write/copy bandwidth (MB/s) and load latency (ns)", 3},
 #ifdef TEST_INFINITE_ENABLE
   {DDR_Test_Infinite_write, "Test infinite write for JEDEC", "[pattern] [addr]",
    "test infinite write pattern", 2},
@@ -136,19 +180,73 @@ const ddr_command ddr_cmd[DDR_CMD_MAX] = {
     [DDR_CMD_NEXT]         = { "next"       , 0, 0 },
     [DDR_CMD_GO]           = { "go"         , 0, 0 },
     [DDR_CMD_TEST]         = { "test"       , 0, CMD_MAX_ARG },
+    [DDR_CMD_PERF]         = { "perf"       , 0, CMD_MAX_ARG },
+    [DDR_CMD_PMU]          = { "pmu"        , 0, 2 },
+    [DDR_CMD_MARGIN]       = { "margin"     , 1, 2 },
+    [DDR_CMD_UART]         = { "uart"       , 0, 2 },
+    [DDR_CMD_SCRIPT]       = { "script"     , 0, 3 },
+    [DDR_CMD_SNAP]         = { "snap"       , 0, 3 },
+    [DDR_CMD_ERRMAP]       = { "errmap"     , 0, 2 },
     [DDR_CMD_TEST_HELP]    = { "test help"  , 0, 0 },
+    [DDR_CMD_PERF_HELP]    = { "perf help"  , 0, 0 },
 };
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 extern HAL_DDR_ConfigTypeDef static_ddr_config;
 
+/* read, write, activate commands and idle cycles of the DDR controller */
+static DDRPERFM_HandleTypeDef perf_handle = {
+  .Instance = DDRPERFM,
+  .Init = {
+    .Set = DDRPERFM_SET_0,
+    .Counters = DDRPERFM_CNT_ALL,
+  },
+};
+
+/* secure physical timer period for the update of the DDRPERFM counts */
+static uint32_t perf_period;
+
+/* DATX8 byte lane registers swept by the margin command */
+static __IO uint32_t * const margin_dllcr[MARGIN_BYTE_NB] = {
+  &DDRPHYC->DX0DLLCR,
+  &DDRPHYC->DX1DLLCR,
+#ifdef DDR_32BIT_INTERFACE
+  &DDRPHYC->DX2DLLCR,
+  &DDRPHYC->DX3DLLCR,
+#endif
+};
+
+static __IO uint32_t * const margin_dqtr[MARGIN_BYTE_NB] = {
+  &DDRPHYC->DX0DQTR,
+  &DDRPHYC->DX1DQTR,
+#ifdef DDR_32BIT_INTERFACE
+  &DDRPHYC->DX2DQTR,
+  &DDRPHYC->DX3DQTR,
+#endif
+};
+
+static __IO uint32_t * const margin_dqstr[MARGIN_BYTE_NB] = {
+  &DDRPHYC->DX0DQSTR,
+  &DDRPHYC->DX1DQSTR,
+#ifdef DDR_32BIT_INTERFACE
+  &DDRPHYC->DX2DQSTR,
+  &DDRPHYC->DX3DQSTR,
+#endif
+};
+
+/* SDPHASE encoding of the phases 36, 54, 72, 90, 108, 126 and 144 degrees */
+static const uint32_t margin_sdphase[MARGIN_PHASE_NB] = {
+  0x3U, 0x2U, 0x1U, 0x0U, 0x4U, 0x8U, 0xCU
+};
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
 static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr)
 {
   uint32_t ret = 0;
+  uint32_t error = 0;
   int i;
 
 #ifdef TEST_INFINITE_ENABLE
@@ -157,6 +255,14 @@ static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr)
   for (i = 1; i < (int)test_nb; i++)
 #endif
   {
+    /* performance measurement only, not a test */
+    if (test[i].fct == DDR_Test_Benchmark)
+    {
+      continue;
+    }
+
+    DDR_ErrMap_SetTest(test[i].name);
+
     switch (test[i].max_args)
     {
       case 1:
@@ -192,13 +298,22 @@ static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr)
     if (ret != 0)
     {
       printf("%s failed [%ld]\n\r", test[i].name, ret);
-      return ret;
+      /* with the error map, the next tests are executed */
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return ret;
+      }
+      if (error == 0)
+      {
+        error = ret;
+      }
+      continue;
     }
 
     printf("result %d:%s = Passed\n\r", i, test[i].name);
   }
 
-  return ret;
+  return error;
 }
 
 static void get_entry_string(char *entry)
@@ -206,6 +321,8 @@ static void get_entry_string(char *entry)
   uint8_t user_entry_valid = 0;
   char user_entry_value = 0;
   int i = 0;
+  /* command of the script in progress */
+  bool script = DDR_Script_GetLine(entry, CMD_MAX_LEN);
 
   Serial_Putchar(0xd);
   Serial_Putchar('D');
@@ -213,6 +330,12 @@ static void get_entry_string(char *entry)
   Serial_Putchar('R');
   Serial_Putchar('>');
 
+  if (script)
+  {
+    printf("%s\n\r", entry);
+    return;
+  }
+
   while(user_entry_valid == 0)
   {
     /* Scan for user entry */
@@ -341,6 +464,9 @@ static int parse_entry_string(char *entry, size_t size, int *command,
       case DDR_CMD_TEST:
             *command = DDR_CMD_TEST_HELP;
             break;
+      case DDR_CMD_PERF:
+            *command = DDR_CMD_PERF_HELP;
+            break;
       }
       return 1;
     }
@@ -384,6 +510,42 @@ static void print_usage(void)
     "go                         continues the DDR TOOL execution\n\r"
     "reset                      reboots machine\n\r"
     "test [help] | <n> [...]    lists (with help) or executes test <n>\n\r"
+    "perf [help] | <n> [...]    executes test <n> with DDR controller\n\r"
+    "                           read/write/activate/idle counters\n\r"
+    "pmu                        displays the CPU PMU events measured\n\r"
+    "                           around each test\n\r"
+    "pmu on|off                 enables or disables the PMU measure\n\r"
+    "pmu <counter> <event>      selects the event of a counter\n\r"
+    "margin rd [<byte>]         eye margin of the PHY read DQS phase\n\r"
+    "                           (SDPHASE) of each byte, with the DQS delay\n\r"
+    "                           (DQSDLY) for one byte\n\r"
+    "margin dq [<byte>]         margin of the DQ delay (DQDLY) of each bit\n\r"
+    "uart                       displays the console output buffer\n\r"
+    "uart drop on|off           drops the output on a full buffer instead\n\r"
+    "                           of waiting for the UART\n\r"
+    "uart reset                 resets the counters\n\r"
+    "script                     displays the script\n\r"
+    "script load                uploads a script: the next lines up to\n\r"
+    "                           a line \"end\"\n\r"
+    "script builtin             selects the script built in the binary\n\r"
+    "script run [<loops>] [stop]\n\r"
+    "                           executes the script <loops> times (default\n\r"
+    "                           1, 0 = forever), stopped on a failure with\n\r"
+    "                           stop, then prints a summary\n\r"
+    "script stop                stops the script\n\r"
+    "snap                       displays the register snapshots\n\r"
+    "snap save <n>              captures the registers in the snapshot <n>\n\r"
+    "snap diff <n> [<m>]        prints the registers changed from the\n\r"
+    "                           snapshot <n> to <m> or to the current ones\n\r"
+    "snap restore <n>           writes back the registers of snapshot <n>\n\r"
+    "snap dump <n>              prints the snapshot <n> in hex and\n\r"
+    "snap layout                the register names, for the host decoder\n\r"
+    "errmap                     displays the error map of the last test\n\r"
+    "errmap on [<lines>]        the tests continue after a data error and\n\r"
+    "                           count the errors per DQ, byte lane, bank,\n\r"
+    "                           row, column and test, with <lines> error\n\r"
+    "                           lines printed (default 32)\n\r"
+    "errmap off                 the tests stop at the first error\n\r"
     "\n\rwith for [type|reg]:\n\r"
     "  all registers if absent\n\r"
     "  <type> = ctl, phy\n\r"
@@ -420,6 +582,7 @@ static bool check_step(HAL_DDR_InteractStepTypeDef step,
   {
     printf("invalid step %d:%s expecting %d:%s\n\r",
            step, step_str[step], expected, step_str[expected]);
+    DDR_Script_Result(false);
     return false;
   }
 
@@ -693,6 +856,7 @@ static void do_param(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
     if (HAL_DDR_Dump_Param(&static_ddr_config, reg_name) != HAL_OK)
     {
       printf("invalid argument %s\n\r", argv[0]);
+      DDR_Script_Result(false);
     }
     break;
   case 3:
@@ -701,7 +865,8 @@ static void do_param(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
       return;
     }
     HAL_DDR_Convert_Case(argv[0], reg_name, 1); /* convert to upper case */
-    HAL_DDR_Edit_Param(&static_ddr_config, reg_name, argv[1]);
+    DDR_Script_Result(HAL_DDR_Edit_Param(&static_ddr_config, reg_name,
+                                         argv[1]) == HAL_OK);
     break;
   }
 }
@@ -757,27 +922,34 @@ static HAL_DDR_InteractStepTypeDef do_step(HAL_DDR_InteractStepTypeDef step,
         goto end;
       }
       printf("step to %d:%s\n\r", (int)value, step_str[value]);
+      DDR_Script_Result(true);
       return (HAL_DDR_InteractStepTypeDef)value;
+
+    default:
+      return step;
   };
 
 end:
+  DDR_Script_Result(false);
   return step;
 }
 
-static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
+static bool do_subcmd(int argc, char *argv[], const subcmd_desc *array,
                       const int size)
 {
   int i;
   int64_t value;
   int local_argc = argc;
   uint32_t retcode;
+  DDR_PmuCountTypeDef pmu;
+  bool pmu_on = DDR_PMU_IsEnabled();
   char arg_zero[2] = "0\0";
 
   if (local_argc == 1)
   {
     printf("Please enter a sub command number\n\r\n\r");
     print_subcmd_usage(array, size);
-    return;
+    return false;
   }
 
   /* Check sub command ID */
@@ -786,7 +958,8 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
   {
     printf("Unknown sub command [%s]\n\r\n\r", argv[0]);
     print_subcmd_usage(array, size);
-    return;
+    DDR_Script_Result(false);
+    return false;
   }
 
   /*
@@ -819,7 +992,8 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
     /* any other cases */
     printf("Incorrect number of arguments\n\r\n\r");
     print_single_subcmd_usage(array, value);
-    return;
+    DDR_Script_Result(false);
+    return false;
   }
 
   /* Check argument validity */
@@ -829,10 +1003,22 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
     {
       printf("Invalid argument #%d %s\n\r\n\r", i, argv[i]);
       print_single_subcmd_usage(array, value);
-      return;
+      DDR_Script_Result(false);
+      return false;
     }
   }
 
+  if (array == test)
+  {
+    DDR_ErrMap_Start();
+    DDR_ErrMap_SetTest(array[value].name);
+  }
+
+  if (pmu_on)
+  {
+    DDR_PMU_Start();
+  }
+
   switch (array[value].max_args)
   {
     case 0:
@@ -856,13 +1042,580 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
       break;
   }
 
+  if (pmu_on)
+  {
+    DDR_PMU_Stop(&pmu);
+    DDR_PMU_Print(&pmu);
+  }
+
+  if ((array == test) && DDR_ErrMap_IsEnabled())
+  {
+    DDR_ErrMap_Print();
+  }
+
+  DDR_Script_Result(retcode == 0);
+
   if (retcode != 0)
   {
     printf("%s failed [%ld]\n\r", array[value].name, retcode);
-    return;
+    return true;
   }
 
     printf("Result: Pass [%s]\n\r", array[value].name);
+
+  return true;
+}
+
+static void pmu_print(void)
+{
+  uint32_t nb = DDR_PMU_GetNbCounters();
+  uint32_t event;
+  uint32_t i;
+
+  printf("pmu %s, %lu event counters\n\r", DDR_PMU_IsEnabled() ? "on" : "off",
+         (unsigned long)nb);
+
+  for (i = 0; i < nb; i++)
+  {
+    event = DDR_PMU_GetEvent(i);
+    printf("  %lu: 0x%02lx %s\n\r", (unsigned long)i, (unsigned long)event,
+           DDR_PMU_EventName(event));
+  }
+}
+
+static void do_pmu(int argc, char *argv[])
+{
+  int64_t counter, event;
+
+  if (argc == 2)
+  {
+    if (!strcmp(argv[0], "on") || !strcmp(argv[0], "off"))
+    {
+      DDR_PMU_Enable(!strcmp(argv[0], "on"));
+    }
+    else
+    {
+      printf("invalid argument %s\n\r", argv[0]);
+      return;
+    }
+  }
+  else if (argc == 3)
+  {
+    counter = string_to_num(argv[0]);
+    event = string_to_num(argv[1]);
+    if ((counter < 0) || (event < 0) ||
+        (DDR_PMU_SetEvent((uint32_t)counter, (uint32_t)event) != 0))
+    {
+      printf("invalid counter %s or event %s\n\r", argv[0], argv[1]);
+      return;
+    }
+  }
+
+  pmu_print();
+}
+
+static void uart_print(void)
+{
+  UART_TX_StatsTypeDef stats;
+
+  UART_TX_GetStats(&stats);
+
+  printf("uart %s on full buffer, %lu/%lu bytes buffered, peak %lu\n\r",
+         UART_TX_GetDrop() ? "drop" : "wait", UART_TX_GetLevel(),
+         (unsigned long)UART_TX_BUF_SIZE, stats.peak);
+  printf("  written %lu, dropped %lu in %lu overflows\n\r", stats.written,
+         stats.dropped, stats.overflow);
+}
+
+static void do_uart(int argc, char *argv[])
+{
+  if ((argc == 2) && !strcmp(argv[0], "reset"))
+  {
+    UART_TX_ResetStats();
+  }
+  else if ((argc == 3) && !strcmp(argv[0], "drop") &&
+           (!strcmp(argv[1], "on") || !strcmp(argv[1], "off")))
+  {
+    UART_TX_SetDrop(!strcmp(argv[1], "on"));
+  }
+  else if (argc != 1)
+  {
+    printf("invalid uart command\n\r");
+    return;
+  }
+
+  uart_print();
+}
+
+static void do_script(int argc, char *argv[])
+{
+  uint32_t loop = 1U;
+  bool stop_on_fail = false;
+  int i;
+
+  if (argc == 1)
+  {
+    DDR_Script_Print();
+  }
+  else if ((argc == 2) && !strcmp(argv[0], "load"))
+  {
+    printf("enter the script, ended by a line \"end\"\n\r");
+    DDR_Script_BeginLoad();
+  }
+  else if ((argc == 2) && !strcmp(argv[0], "builtin"))
+  {
+    if (!DDR_Script_SelectBuiltin())
+    {
+      printf("no builtin script\n\r");
+      return;
+    }
+    DDR_Script_Print();
+  }
+  else if (!strcmp(argv[0], "run"))
+  {
+    if (DDR_Script_IsRunning())
+    {
+      printf("script already running\n\r");
+      return;
+    }
+    for (i = 1; i < (argc - 1); i++)
+    {
+      if (!strcmp(argv[i], "stop"))
+      {
+        stop_on_fail = true;
+      }
+      else if (string_to_num(argv[i]) >= 0)
+      {
+        loop = (uint32_t)string_to_num(argv[i]);
+      }
+      else
+      {
+        printf("invalid script loops [%s]\n\r", argv[i]);
+        return;
+      }
+    }
+    (void)DDR_Script_Start(loop, stop_on_fail);
+  }
+  else if ((argc == 2) && !strcmp(argv[0], "stop"))
+  {
+    DDR_Script_Stop();
+  }
+  else
+  {
+    printf("invalid script command\n\r");
+  }
+}
+
+static void do_snap(int argc, char *argv[])
+{
+  int64_t slot = -1;
+  int64_t slot_b = -1;
+
+  if (argc == 1)
+  {
+    DDR_Snap_Print();
+    return;
+  }
+
+  if ((argc == 2) && !strcmp(argv[0], "layout"))
+  {
+    DDR_Snap_Layout();
+    return;
+  }
+
+  if (argc >= 3)
+  {
+    slot = string_to_num(argv[1]);
+  }
+  if (argc == 4)
+  {
+    slot_b = string_to_num(argv[2]);
+  }
+
+  if ((slot < 0) || ((argc == 4) && (slot_b < 0)))
+  {
+    printf("invalid snap command\n\r");
+  }
+  else if ((argc == 3) && !strcmp(argv[0], "save"))
+  {
+    (void)DDR_Snap_Save((uint32_t)slot, static_ddr_config.info.speed);
+  }
+  else if (!strcmp(argv[0], "diff"))
+  {
+    (void)DDR_Snap_Diff((uint32_t)slot, (int32_t)slot_b);
+  }
+  else if ((argc == 3) && !strcmp(argv[0], "restore"))
+  {
+    (void)DDR_Snap_Restore((uint32_t)slot);
+  }
+  else if ((argc == 3) && !strcmp(argv[0], "dump"))
+  {
+    (void)DDR_Snap_Dump((uint32_t)slot);
+  }
+  else
+  {
+    printf("invalid snap command\n\r");
+  }
+}
+
+/* read DQS phase of a byte lane, position 0..6 for 36..144 degrees */
+static int32_t margin_phase_get(uint32_t lane)
+{
+  uint32_t code = (READ_REG(*margin_dllcr[lane]) &
+                   DDRPHYC_DX0DLLCR_SDPHASE_Msk) >> DDRPHYC_DX0DLLCR_SDPHASE_Pos;
+
+  /* phase = 90 + 18 * code[3:2] - 18 * code[1:0] degrees */
+  return 3 + (int32_t)(code >> 2) - (int32_t)(code & 0x3U);
+}
+
+static void margin_phase_set(uint32_t lane, int32_t pos)
+{
+  MODIFY_REG(*margin_dllcr[lane], DDRPHYC_DX0DLLCR_SDPHASE_Msk,
+             margin_sdphase[pos] << DDRPHYC_DX0DLLCR_SDPHASE_Pos);
+}
+
+/* DQS and DQS# delays of a byte lane, moved together */
+static int32_t margin_dqs_get(uint32_t lane)
+{
+  return (int32_t)((READ_REG(*margin_dqstr[lane]) &
+                    DDRPHYC_DX0DQSTR_DQSDLY_Msk) >> DDRPHYC_DX0DQSTR_DQSDLY_Pos);
+}
+
+static void margin_dqs_set(uint32_t lane, int32_t pos)
+{
+  MODIFY_REG(*margin_dqstr[lane],
+             DDRPHYC_DX0DQSTR_DQSDLY_Msk | DDRPHYC_DX0DQSTR_DQSNDLY_Msk,
+             ((uint32_t)pos << DDRPHYC_DX0DQSTR_DQSDLY_Pos) |
+             ((uint32_t)pos << DDRPHYC_DX0DQSTR_DQSNDLY_Pos));
+}
+
+/* delay of one DQ bit, lane = 8 * byte + bit */
+static int32_t margin_dq_get(uint32_t lane)
+{
+  uint32_t pos = (lane % MARGIN_DQ_NB) * 4U;
+
+  return (int32_t)((READ_REG(*margin_dqtr[lane / MARGIN_DQ_NB]) >> pos) &
+                   DDRPHYC_DX0DQTR_DQDLY0_Msk);
+}
+
+static void margin_dq_set(uint32_t lane, int32_t value)
+{
+  uint32_t pos = (lane % MARGIN_DQ_NB) * 4U;
+
+  MODIFY_REG(*margin_dqtr[lane / MARGIN_DQ_NB],
+             DDRPHYC_DX0DQTR_DQDLY0_Msk << pos, (uint32_t)value << pos);
+}
+
+/* bits of a 32-bit word of the kernel, 1 beat of the 32-bit bus, 2 of 16 */
+static uint32_t margin_bus_width(void)
+{
+  return (MARGIN_BYTE_NB * 8U) >>
+         ((READ_REG(DDRCTRL->MSTR) & DDRCTRL_MSTR_DATA_BUS_WIDTH) >>
+          DDRCTRL_MSTR_DATA_BUS_WIDTH_Pos);
+}
+
+static unsigned long margin_byte_mask(uint32_t lane)
+{
+  unsigned long mask = 0UL;
+  uint32_t bit;
+
+  for (bit = lane * 8U; bit < 32U; bit += margin_bus_width())
+  {
+    mask |= 0xFFUL << bit;
+  }
+
+  return mask;
+}
+
+static unsigned long margin_bit_mask(uint32_t lane)
+{
+  unsigned long mask = 0UL;
+  uint32_t bit;
+
+  for (bit = lane; bit < 32U; bit += margin_bus_width())
+  {
+    mask |= 1UL << bit;
+  }
+
+  return mask;
+}
+
+/*
+ * The delay line steps of DQSDLY and DQDLY are not specified: their margin
+ * is only given in ticks.
+ */
+static void do_margin(int argc, char *argv[])
+{
+  static DDR_MarginAxisTypeDef phase = {
+    "SDPHASE", 0, MARGIN_PHASE_NB - 1, 0U, margin_phase_get, margin_phase_set
+  };
+  static const DDR_MarginAxisTypeDef dqs = {
+    "DQSDLY", 0, DDRPHYC_DX0DQSTR_DQSDLY_Msk >> DDRPHYC_DX0DQSTR_DQSDLY_Pos, 0U,
+    margin_dqs_get, margin_dqs_set
+  };
+  static const DDR_MarginAxisTypeDef dq = {
+    "DQDLY", 0, DDRPHYC_DX0DQTR_DQDLY0_Msk, 0U, margin_dq_get, margin_dq_set
+  };
+  DDR_MarginCfgTypeDef cfg = {
+    .x_step = 1,
+    .y_step = 1,
+    .addr = DRAM_MEM_BASE,
+    .size = MARGIN_SIZE,
+    .flush = NULL,
+  };
+  uint32_t dllcr[MARGIN_BYTE_NB];
+  PLL2_ClocksTypeDef PLL2;
+  uint32_t nb_byte;
+  uint32_t i;
+  int64_t byte = -1;
+
+  nb_byte = margin_bus_width() / 8U;
+
+  if (argc == 3)
+  {
+    byte = string_to_num(argv[1]);
+    if ((byte < 0) || (byte >= (int64_t)nb_byte))
+    {
+      printf("invalid byte %s (max=%lu)\n\r", argv[1], nb_byte - 1U);
+      return;
+    }
+  }
+
+  if (!strcmp(argv[0], "rd"))
+  {
+    cfg.x = &phase;
+    cfg.x_range = MARGIN_PHASE_NB - 1;
+    cfg.lane_name = "DX";
+    cfg.lane_mask = margin_byte_mask;
+    cfg.lane = (byte < 0) ? 0U : (uint32_t)byte;
+    cfg.nb_lane = (byte < 0) ? nb_byte : 1U;
+    /* 2D eye of the DQS phase and delay of one byte */
+    if (byte >= 0)
+    {
+      cfg.y = &dqs;
+      cfg.y_range = dqs.max;
+    }
+  }
+  else if (!strcmp(argv[0], "dq"))
+  {
+    cfg.x = &dq;
+    cfg.x_range = dq.max;
+    cfg.lane_name = "DQ";
+    cfg.lane_mask = margin_bit_mask;
+    cfg.lane = (byte < 0) ? 0U : (uint32_t)byte * MARGIN_DQ_NB;
+    cfg.nb_lane = ((byte < 0) ? nb_byte : 1U) * MARGIN_DQ_NB;
+  }
+  else
+  {
+    printf("invalid argument %s\n\r", argv[0]);
+    return;
+  }
+
+  /* SDPHASE step of 18 degrees = 1/20 of the DDR clock period */
+  HAL_RCC_GetPLL2ClockFreq(&PLL2);
+  if (PLL2.PLL2_R_Frequency == 0U)
+  {
+    printf("invalid DDR frequency\n\r");
+    return;
+  }
+  phase.tick_fs = (uint32_t)(1000000000000000ULL /
+                             ((uint64_t)PLL2.PLL2_R_Frequency *
+                              MARGIN_PHASE_PER_CLK));
+
+  /* several SDPHASE codes give the same phase: restore the trained codes */
+  for (i = 0U; i < MARGIN_BYTE_NB; i++)
+  {
+    dllcr[i] = READ_REG(*margin_dllcr[i]);
+  }
+
+  if (DDR_Margin_Run(&cfg) != 0)
+  {
+    printf("invalid margin configuration\n\r");
+  }
+
+  for (i = 0U; i < MARGIN_BYTE_NB; i++)
+  {
+    WRITE_REG(*margin_dllcr[i], dllcr[i]);
+  }
+}
+
+/*
+ * The 32-bit DDRPERFM counters overflow after 2^32 DDR controller cycles
+ * (8 s at 533 MHz): the secure physical timer, unused by the HAL tick,
+ * moves them to the 64-bit counts of the handle every 2^31 cycles.
+ */
+static void perf_timer_handler(void)
+{
+  PL1_SetLoadValue(perf_period);
+  /* freeze, read and clear without waiting */
+  (void)HAL_DDRPERFM_Update(&perf_handle);
+}
+
+static IRQHandler_t perf_timer_start(uint32_t ddr_freq_khz)
+{
+  IRQHandler_t handler = IRQ_GetHandler(PERF_TIMER_IRQn);
+  uint64_t period;
+
+  period = (time_get_frequency() << 31) / ((uint64_t)ddr_freq_khz * 1000U);
+  perf_period = (period > INT32_MAX) ? INT32_MAX : (uint32_t)period;
+
+  PL1_SetControl(0x0);
+  IRQ_Disable(PERF_TIMER_IRQn);
+  IRQ_ClearPending(PERF_TIMER_IRQn);
+  IRQ_SetHandler(PERF_TIMER_IRQn, perf_timer_handler);
+  IRQ_SetMode(PERF_TIMER_IRQn, IRQ_MODE_TRIG_EDGE);
+  IRQ_Enable(PERF_TIMER_IRQn);
+
+  PL1_SetLoadValue(perf_period);
+  PL1_SetControl(0x1);
+
+  return handler;
+}
+
+static void perf_timer_stop(IRQHandler_t handler)
+{
+  PL1_SetControl(0x0);
+  IRQ_Disable(PERF_TIMER_IRQn);
+  IRQ_ClearPending(PERF_TIMER_IRQn);
+  IRQ_SetHandler(PERF_TIMER_IRQn, handler);
+}
+
+/* 64-bit count printed with 32-bit printf arguments */
+static void perf_print_count(const char *name, uint64_t count)
+{
+  if (count >= 1000000000U)
+  {
+    printf("  %-9s: %lu%09lu", name, (uint32_t)(count / 1000000000U),
+           (uint32_t)(count % 1000000000U));
+  }
+  else
+  {
+    printf("  %-9s: %lu", name, (uint32_t)count);
+  }
+}
+
+static void perf_print(uint32_t ddr_freq_khz)
+{
+  DDRPERFM_CountTypeDef *count = &perf_handle.Count;
+  uint32_t burst;
+  uint32_t bytes;
+  uint64_t cmd;
+  uint32_t ratio;
+
+  /* bytes and data bus cycles of one read or write command */
+  burst = 2U * ((READ_REG(DDRCTRL->MSTR) & DDRCTRL_MSTR_BURST_RDWR) >>
+                DDRCTRL_MSTR_BURST_RDWR_Pos);
+  bytes = burst * (PERF_BUS_BYTES >>
+                   ((READ_REG(DDRCTRL->MSTR) & DDRCTRL_MSTR_DATA_BUS_WIDTH) >>
+                    DDRCTRL_MSTR_DATA_BUS_WIDTH_Pos));
+
+  printf("DDR performance: %lu us at %lu kHz, BL%lu, %lu bytes per command\n\r",
+         (uint32_t)HAL_DDRPERFM_GetTimeUs(&perf_handle, ddr_freq_khz),
+         ddr_freq_khz, burst, bytes);
+
+  perf_print_count("read", count->Event[DDRPERFM_SET0_READ]);
+  printf(" (%lu MB/s)\n\r",
+         HAL_DDRPERFM_GetBandwidth(&perf_handle, DDRPERFM_SET0_READ, bytes,
+                                   ddr_freq_khz));
+
+  perf_print_count("write", count->Event[DDRPERFM_SET0_WRITE]);
+  printf(" (%lu MB/s)\n\r",
+         HAL_DDRPERFM_GetBandwidth(&perf_handle, DDRPERFM_SET0_WRITE, bytes,
+                                   ddr_freq_khz));
+
+  /* row misses: activates per read or write command */
+  cmd = count->Event[DDRPERFM_SET0_READ] + count->Event[DDRPERFM_SET0_WRITE];
+  ratio = (cmd != 0U) ?
+          (uint32_t)((count->Event[DDRPERFM_SET0_ACTIVATE] * 1000U) / cmd) : 0U;
+  if (ratio > 1000U)
+  {
+    ratio = 1000U;
+  }
+  perf_print_count("activate", count->Event[DDRPERFM_SET0_ACTIVATE]);
+  printf(" (row miss %lu.%lu %%)\n\r", ratio / 10U, ratio % 10U);
+
+  ratio = HAL_DDRPERFM_GetRatio(&perf_handle, DDRPERFM_SET0_IDLE, 1U);
+  printf("  %-9s: %lu.%lu %%\n\r", "idle", ratio / 10U, ratio % 10U);
+
+  /* a command uses the data bus during burst / 2 DDR clock cycles */
+  ratio = HAL_DDRPERFM_GetRatio(&perf_handle, DDRPERFM_SET0_READ, burst / 2U) +
+          HAL_DDRPERFM_GetRatio(&perf_handle, DDRPERFM_SET0_WRITE, burst / 2U);
+  printf("  %-9s: %lu.%lu %%\n\r", "bus usage", ratio / 10U, ratio % 10U);
+
+  if (count->Overflow != 0U)
+  {
+    printf("  counter overflow 0x%lx, counted as 2^32\n\r", count->Overflow);
+  }
+}
+
+static void do_perf(int argc, char *argv[])
+{
+  PLL2_ClocksTypeDef PLL2;
+  IRQHandler_t handler;
+  uint32_t ddr_freq_khz;
+  bool executed;
+
+  /* the DDR controller is clocked by the DDR PHY clock */
+  HAL_RCC_GetPLL2ClockFreq(&PLL2);
+  ddr_freq_khz = PLL2.PLL2_R_Frequency / 1000U;
+  if (ddr_freq_khz == 0U)
+  {
+    printf("invalid DDR frequency\n\r");
+    return;
+  }
+
+  if (HAL_DDRPERFM_Init(&perf_handle) != HAL_OK)
+  {
+    printf("DDRPERFM init failed\n\r");
+    return;
+  }
+
+  HAL_DDRPERFM_Start(&perf_handle);
+  handler = perf_timer_start(ddr_freq_khz);
+
+  executed = do_subcmd(argc, argv, test, test_nb);
+
+  perf_timer_stop(handler);
+  HAL_DDRPERFM_Stop(&perf_handle);
+
+  if (executed)
+  {
+    perf_print(ddr_freq_khz);
+  }
+
+  HAL_DDRPERFM_DeInit(&perf_handle);
+}
+
+static void do_errmap(int argc, char *argv[])
+{
+  int64_t lines = 0;
+
+  if (argc == 1)
+  {
+    DDR_ErrMap_Print();
+    return;
+  }
+
+  if (argc == 3)
+  {
+    lines = string_to_num(argv[1]);
+  }
+
+  if (!strcmp(argv[0], "on") && (lines >= 0))
+  {
+    DDR_ErrMap_Enable(true, (unsigned long)lines);
+  }
+  else if ((argc == 2) && !strcmp(argv[0], "off"))
+  {
+    DDR_ErrMap_Enable(false, 0UL);
+  }
+  else
+  {
+    printf("invalid errmap command\n\r");
+    return;
+  }
+
+  printf("error map %s\n\r", DDR_ErrMap_IsEnabled() ? "enabled" : "disabled");
 }
 
 bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
@@ -902,10 +1655,17 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
   {
     get_entry_string(buffer);
 
+    if (DDR_Script_IsLoading())
+    {
+      DDR_Script_LoadLine(buffer);
+      continue;
+    }
+
     argc = parse_entry_string(buffer, strlen(buffer), &cmd, argv);
     if (argc < 0)
     {
       printf("Error [%d]\n\r", argc);
+      DDR_Script_Result(false);
       continue;
     }
     else if (argc == 0)
@@ -920,6 +1680,7 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
       break;
 
     case DDR_CMD_TEST_HELP:
+    case DDR_CMD_PERF_HELP:
       print_subcmd_usage(test, test_nb);
       break;
 
@@ -928,13 +1689,20 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
       break;
 
     case DDR_CMD_FREQ:
-      if (do_freq(argc, argv))
+      if (!do_freq(argc, argv))
       {
-        next_step = STEP_DDR_RESET;
+        DDR_Script_Result(false);
+        break;
       }
+      if (argc == 2)
+      {
+        DDR_Script_Result(true);
+      }
+      next_step = STEP_DDR_RESET;
       break;
 
     case DDR_CMD_RESET:
+      UART_TX_Flush();
       __HAL_RCC_SYS_RESET();
       break;
 
@@ -976,6 +1744,44 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
       do_subcmd(argc, argv, test, test_nb);
       break;
 
+    case DDR_CMD_PERF:
+      if (!check_step(step, STEP_DDR_READY))
+      {
+        free_args(argc, argv);
+        continue;
+      }
+      do_perf(argc, argv);
+      break;
+
+    case DDR_CMD_PMU:
+      do_pmu(argc, argv);
+      break;
+
+    case DDR_CMD_MARGIN:
+      if (!check_step(step, STEP_DDR_READY))
+      {
+        free_args(argc, argv);
+        continue;
+      }
+      do_margin(argc, argv);
+      break;
+
+    case DDR_CMD_UART:
+      do_uart(argc, argv);
+      break;
+
+    case DDR_CMD_SCRIPT:
+      do_script(argc, argv);
+      break;
+
+    case DDR_CMD_SNAP:
+      do_snap(argc, argv);
+      break;
+
+    case DDR_CMD_ERRMAP:
+      do_errmap(argc, argv);
+      break;
+
     default:
       break;
     }
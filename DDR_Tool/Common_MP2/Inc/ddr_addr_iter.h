@@ -0,0 +1,85 @@
+/**
+  ******************************************************************************
+  * @file    ddr_addr_iter.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_addr_iter.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_ADDR_ITER_H
+#define __DDR_ADDR_ITER_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+  DDR_ADDR_ORDER_LINEAR = 0, /* increasing addresses */
+  DDR_ADDR_ORDER_BANK,       /* successive chunks in successive banks */
+  DDR_ADDR_ORDER_ROW,        /* successive chunks in other rows of a bank */
+  DDR_ADDR_ORDER_RANDOM,     /* random permutation of all the chunks */
+  DDR_ADDR_ORDER_MAX,
+} DDR_AddrOrderTypeDef;
+
+typedef struct {
+  uintptr_t base;
+  unsigned long size;
+} DDR_AddrRangeTypeDef;
+
+/* Maximum number of ranges of a sweep */
+#define DDR_ADDR_RANGE_MAX     8U
+
+typedef struct {
+  DDR_AddrRangeTypeDef range[DDR_ADDR_RANGE_MAX];
+  uint32_t nb_range;
+  unsigned long stride;       /* chunk size in bytes, power of 2 >= 64 */
+  DDR_AddrOrderTypeDef order;
+  unsigned long seed;         /* seed of the random order */
+} DDR_AddrSweepTypeDef;
+
+typedef struct {
+  const DDR_AddrSweepTypeDef *sweep;
+  unsigned long nb;           /* number of chunks */
+  unsigned long count;        /* number of chunks already returned */
+  unsigned long step;         /* address step between successive chunks */
+  uint32_t range;             /* current range */
+  unsigned long row;          /* current step index in the range */
+  unsigned long col;          /* current offset inside the step */
+  unsigned int bits;          /* random: index space of 2^bits chunks */
+  unsigned long state;        /* random: generator state */
+  unsigned long inc;          /* random: generator increment */
+} DDR_AddrIterTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define DDR_ADDR_STRIDE_MIN    64UL
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+const char *DDR_AddrIter_OrderName(DDR_AddrOrderTypeDef order);
+unsigned long DDR_AddrIter_GetStep(DDR_AddrOrderTypeDef order,
+                                   unsigned long stride);
+int DDR_AddrIter_Init(DDR_AddrIterTypeDef *it,
+                      const DDR_AddrSweepTypeDef *sweep);
+bool DDR_AddrIter_Next(DDR_AddrIterTypeDef *it, uintptr_t *addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DDR_ADDR_ITER_H */
@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file    ddr_dma.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_dma.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_DMA_H
+#define __DDR_DMA_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+  DDR_DMA_COPY = 0,             /* memory to memory copy */
+  DDR_DMA_FILL,                 /* fill with a 32-bit pattern */
+} DDR_DmaOpTypeDef;
+
+typedef struct {
+  DDR_DmaOpTypeDef op;
+  uintptr_t src;                /* source of a copy */
+  uintptr_t dst;                /* destination */
+  unsigned long size;           /* multiple of DDR_DMA_BLOCK_SIZE */
+  uint32_t pattern;             /* value of a fill */
+} DDR_DmaJobTypeDef;
+
+typedef struct {
+  uint64_t time_us;             /* duration of the last complete pass,
+                                   0 when no pass is complete */
+  unsigned long bytes;          /* bytes written and read by one pass */
+  uint32_t error;               /* DMA channel error flags */
+  unsigned long mismatch;       /* destination words different from the
+                                   source or the pattern */
+} DDR_DmaResultTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+/* one job per DMA channel with 2D addressing */
+#define DDR_DMA_CHANNEL_MAX       4U
+
+/* a job is executed by repeated blocks of DDR_DMA_BLOCK_SIZE bytes */
+#define DDR_DMA_BLOCK_SIZE        0x8000UL
+#define DDR_DMA_SIZE_MAX          (2048UL * DDR_DMA_BLOCK_SIZE)
+
+/* 32-bit AXI addresses of the DMA: source and destination below 4GB */
+#define DDR_DMA_ADDR_END          0x100000000ULL
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+int DDR_DMA_Start(const DDR_DmaJobTypeDef *job, uint32_t nb_job,
+                  bool circular);
+bool DDR_DMA_IsBusy(void);
+int DDR_DMA_Stop(DDR_DmaResultTypeDef *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DDR_DMA_H */
@@ -0,0 +1,57 @@
+/**
+  ******************************************************************************
+  * @file    ddr_mmu.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_mmu.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_MMU_H
+#define __DDR_MMU_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+  DDR_MMU_ATTR_NC = 0,      /* normal non-cacheable, mapping after reset */
+  DDR_MMU_ATTR_WB,          /* normal write-back read/write allocate */
+  DDR_MMU_ATTR_DEVICE,      /* device nGnRE */
+  DDR_MMU_ATTR_MAX,
+} DDR_MmuAttrTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+/* granularity of the DDR mapping: 2MB level 2 blocks */
+#define DDR_MMU_GRANULE           0x200000UL
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+const char *DDR_MMU_AttrName(DDR_MmuAttrTypeDef attr);
+int DDR_MMU_Map(uintptr_t addr, unsigned long size, DDR_MmuAttrTypeDef attr);
+DDR_MmuAttrTypeDef DDR_MMU_GetAttr(uintptr_t addr);
+bool DDR_MMU_IsCacheable(uintptr_t addr, unsigned long size);
+void DDR_MMU_CleanInvalidate(uintptr_t addr, unsigned long size);
+void DDR_MMU_Invalidate(uintptr_t addr, unsigned long size);
+void DDR_MMU_Sync(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DDR_MMU_H */
@@ -0,0 +1,65 @@
+/**
+  ******************************************************************************
+  * @file    ddr_multicore.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_multicore.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_MULTICORE_H
+#define __DDR_MULTICORE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+  DDR_MULTICORE_JOB_IDLE = 0,
+  DDR_MULTICORE_JOB_READY,
+  DDR_MULTICORE_JOB_DONE,
+} DDR_MultiCore_JobStateTypeDef;
+
+typedef struct {
+  uint32_t (*fct)();
+  unsigned long args[3];
+  uint8_t nb_args;
+  volatile uint32_t result;
+  volatile uint32_t state;
+} DDR_MultiCore_JobTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define DDR_MULTICORE_MAX_CORES   2U
+#define DDR_MULTICORE_STACK_SIZE  0x1000U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+uint32_t DDR_MultiCore_GetCoreId(void);
+uint32_t DDR_MultiCore_GetNbCores(void);
+uint32_t DDR_MultiCore_Exec(DDR_MultiCore_JobTypeDef *job);
+bool DDR_MultiCore_Start(uint32_t core, DDR_MultiCore_JobTypeDef *job);
+uint32_t DDR_MultiCore_Wait(uint32_t core);
+void DDR_MultiCore_Lock(void);
+void DDR_MultiCore_Unlock(void);
+int DDR_MultiCore_Printf(const char *format, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DDR_MULTICORE_H */
@@ -23,6 +23,8 @@
 #define __DDR_TESTS_H
 
 /* Includes ------------------------------------------------------------------*/
+#include "ddr_addr_iter.h"
+
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
@@ -53,6 +55,11 @@ uint32_t DDR_Test_WalkingZeroes(unsigned long size, unsigned long loop_in,
                                 unsigned long addr_in);
 uint32_t DDR_Test_WalkingOnes(unsigned long size, unsigned long loop_in,
                               unsigned long addr_in);
+uint32_t DDR_Test_Benchmark(unsigned long size_in, unsigned long stride_in,
+                            unsigned long addr_in);
+void DDR_Test_ResetTraffic(void);
+void DDR_Test_GetTraffic(unsigned long *written, unsigned long *read);
+int DDR_Test_SetSweep(const DDR_AddrSweepTypeDef *sweep);
 #ifdef TEST_INFINITE_ENABLE
 uint32_t DDR_Test_Infinite_write(unsigned long pattern_in,
                                  unsigned long addr_in);
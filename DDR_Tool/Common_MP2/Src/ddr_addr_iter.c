@@ -0,0 +1,286 @@
+/**
+  ******************************************************************************
+  * @file    ddr_addr_iter.c
+  * @author  MCD Application Team
+  * @brief   Address iterator used by the DDR tests to sweep several address
+  *          ranges by chunks, in linear, bank, row or random order.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include "ddr_addr_iter.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/*
+ * DDRCTRL address map fields giving the lowest HIF address bit of the bank,
+ * bank group and row addresses (field value + internal base)
+ */
+#define ADDRMAP1_BANK_B0_MASK    0x3FUL
+#define ADDRMAP1_BANK_B0_BASE    2U
+#define ADDRMAP5_ROW_B0_MASK     0xFUL
+#define ADDRMAP5_ROW_B0_BASE     6U
+#define ADDRMAP8_BG_B0_MASK      0x3FUL
+#define ADDRMAP8_BG_B0_BASE      2U
+#define ADDRMAP8_BG_B0_UNUSED    0x3FUL
+
+/* HIF address unit is the full DRAM data bus width (32 bits) */
+#define HIF_ADDR_SHIFT           2U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const char * const order_name[DDR_ADDR_ORDER_MAX] = {
+  [DDR_ADDR_ORDER_LINEAR] = "linear",
+  [DDR_ADDR_ORDER_BANK]   = "bank",
+  [DDR_ADDR_ORDER_ROW]    = "row",
+  [DDR_ADDR_ORDER_RANDOM] = "random",
+};
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* byte address bit of a HIF address bit, according to the data bus width */
+static unsigned int hif_to_byte_bit(unsigned int hif_bit)
+{
+  uint32_t width;
+
+  width = (READ_REG(DDRC->MSTR) & DDRC_MSTR_DATA_BUS_WIDTH_Msk) >>
+          DDRC_MSTR_DATA_BUS_WIDTH_Pos;
+
+  /* half and quarter bus width: 16 and 8 bits per HIF address */
+  return hif_bit + HIF_ADDR_SHIFT - width;
+}
+
+/*
+ * bijection of the 2^bits chunk index space used to scramble the sequence of
+ * the generator, its low bits having short periods
+ */
+static unsigned long random_mix(unsigned long x, unsigned int bits)
+{
+  unsigned long mask = (bits < 64U) ? ((1UL << bits) - 1UL) : ~0UL;
+  unsigned int shift = (bits / 2U) + 1U;
+
+  x ^= x >> shift;
+  x = (x * 0x9E3779B97F4A7C15UL) & mask;
+  x ^= x >> shift;
+
+  return x;
+}
+
+/* next index of the full period generator on 2^bits values */
+static unsigned long random_next(DDR_AddrIterTypeDef *it)
+{
+  unsigned long mask = (it->bits < 64U) ? ((1UL << it->bits) - 1UL) : ~0UL;
+
+  it->state = ((it->state * 0x5851F42D4C957F2DUL) + it->inc) & mask;
+
+  return random_mix(it->state, it->bits);
+}
+
+static bool next_random(DDR_AddrIterTypeDef *it, uintptr_t *addr)
+{
+  const DDR_AddrSweepTypeDef *sweep = it->sweep;
+  unsigned long index;
+  unsigned long nb;
+  uint32_t i;
+
+  /* indexes outside of the chunks are skipped, less than half of them */
+  do
+  {
+    index = random_next(it);
+  } while (index >= it->nb);
+
+  for (i = 0; i < sweep->nb_range; i++)
+  {
+    nb = sweep->range[i].size / sweep->stride;
+    if (index < nb)
+    {
+      break;
+    }
+    index -= nb;
+  }
+
+  *addr = sweep->range[i].base + (index * sweep->stride);
+
+  return true;
+}
+
+/*
+ * successive chunks separated by step bytes, the offset inside the step is
+ * increased by stride once the range is covered
+ */
+static bool next_step(DDR_AddrIterTypeDef *it, uintptr_t *addr)
+{
+  const DDR_AddrSweepTypeDef *sweep = it->sweep;
+  unsigned long offset;
+
+  while (1)
+  {
+    const DDR_AddrRangeTypeDef *range = &sweep->range[it->range];
+
+    offset = (it->row * it->step) + it->col;
+
+    if (offset < range->size)
+    {
+      it->row++;
+      *addr = range->base + offset;
+      return true;
+    }
+
+    /* end of the column, next offset inside the step or next range */
+    it->row = 0;
+    it->col += sweep->stride;
+    if ((it->col >= it->step) || (it->col >= range->size))
+    {
+      it->col = 0;
+      it->range++;
+    }
+  }
+}
+
+/**
+  * @brief  Get the name of an address order.
+  * @param  order: address order
+  * @retval Name of the order
+  */
+const char *DDR_AddrIter_OrderName(DDR_AddrOrderTypeDef order)
+{
+  if (order >= DDR_ADDR_ORDER_MAX)
+  {
+    return "unknown";
+  }
+
+  return order_name[order];
+}
+
+/**
+  * @brief  Get the address step between successive chunks of an order.
+  *         The bank and row steps are derived from the DDRCTRL address map:
+  *         lowest bank (or bank group) address bit, lowest row address bit.
+  * @param  order: address order
+  * @param  stride: chunk size in bytes
+  * @retval Step in bytes, at least stride
+  */
+unsigned long DDR_AddrIter_GetStep(DDR_AddrOrderTypeDef order,
+                                   unsigned long stride)
+{
+  unsigned int bit;
+  unsigned int bg_bit;
+  unsigned long step;
+
+  switch (order)
+  {
+    case DDR_ADDR_ORDER_BANK:
+      bit = (unsigned int)(READ_REG(DDRC->ADDRMAP1) & ADDRMAP1_BANK_B0_MASK) +
+            ADDRMAP1_BANK_B0_BASE;
+      if ((READ_REG(DDRC->ADDRMAP8) & ADDRMAP8_BG_B0_MASK) != ADDRMAP8_BG_B0_UNUSED)
+      {
+        bg_bit = (unsigned int)(READ_REG(DDRC->ADDRMAP8) & ADDRMAP8_BG_B0_MASK) +
+                 ADDRMAP8_BG_B0_BASE;
+        if (bg_bit < bit)
+        {
+          bit = bg_bit;
+        }
+      }
+      step = 1UL << hif_to_byte_bit(bit);
+      break;
+
+    case DDR_ADDR_ORDER_ROW:
+      bit = (unsigned int)(READ_REG(DDRC->ADDRMAP5) & ADDRMAP5_ROW_B0_MASK) +
+            ADDRMAP5_ROW_B0_BASE;
+      step = 1UL << hif_to_byte_bit(bit);
+      break;
+
+    default:
+      step = stride;
+      break;
+  }
+
+  return (step < stride) ? stride : step;
+}
+
+/**
+  * @brief  Initialize an address iterator, to restart from the first chunk.
+  * @param  it: iterator
+  * @param  sweep: address ranges and order, shall remain valid while the
+  *         iterator is used
+  * @retval 0 if OK, -1 for an invalid stride or unaligned range
+  */
+int DDR_AddrIter_Init(DDR_AddrIterTypeDef *it,
+                      const DDR_AddrSweepTypeDef *sweep)
+{
+  uint32_t i;
+
+  if ((sweep->stride < DDR_ADDR_STRIDE_MIN) ||
+      ((sweep->stride & (sweep->stride - 1UL)) != 0UL) ||
+      (sweep->nb_range == 0U) || (sweep->nb_range > DDR_ADDR_RANGE_MAX) ||
+      (sweep->order >= DDR_ADDR_ORDER_MAX))
+  {
+    return -1;
+  }
+
+  it->sweep = sweep;
+  it->nb = 0;
+
+  for (i = 0; i < sweep->nb_range; i++)
+  {
+    if (((sweep->range[i].base & (sweep->stride - 1UL)) != 0UL) ||
+        ((sweep->range[i].size & (sweep->stride - 1UL)) != 0UL))
+    {
+      return -1;
+    }
+    it->nb += sweep->range[i].size / sweep->stride;
+  }
+
+  it->count = 0;
+  it->range = 0;
+  it->row = 0;
+  it->col = 0;
+  it->step = DDR_AddrIter_GetStep(sweep->order, sweep->stride);
+
+  /* smallest power of 2 index space including all the chunks */
+  it->bits = 0;
+  while ((it->bits < 63U) && ((1UL << it->bits) < it->nb))
+  {
+    it->bits++;
+  }
+  it->state = sweep->seed;
+  it->inc = (sweep->seed << 1) | 1UL;
+
+  return 0;
+}
+
+/**
+  * @brief  Get the address of the next chunk, each chunk of the ranges is
+  *         returned once.
+  * @param  it: iterator
+  * @param  addr: address of the chunk (stride bytes)
+  * @retval false when all the chunks have been returned
+  */
+bool DDR_AddrIter_Next(DDR_AddrIterTypeDef *it, uintptr_t *addr)
+{
+  if (it->count >= it->nb)
+  {
+    return false;
+  }
+
+  it->count++;
+
+  if (it->sweep->order == DDR_ADDR_ORDER_RANDOM)
+  {
+    return next_random(it, addr);
+  }
+
+  return next_step(it, addr);
+}
@@ -0,0 +1,466 @@
+/**
+  ******************************************************************************
+  * @file    ddr_dma.c
+  * @author  MCD Application Team
+  * @brief   DDR traffic generator: HPDMA channels executing copies and fills
+  *          in the DDR in linked-list mode, once or in circular mode, while
+  *          the CPU executes a test. The destinations are verified and the
+  *          throughput of each channel measured when they are stopped.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include <string.h>
+
+#include "ddr_dma.h"
+#include "ddr_mmu.h"
+#include "system_time.h"
+#include "stm32mp_util_ddr_conf.h"
+
+#if defined(HAL_DMA_MODULE_ENABLED)
+/* Private define ------------------------------------------------------------*/
+/* largest data cache line of the Cortex-A35 and of the DMA accesses */
+#define DMA_CACHE_LINE            64U
+
+/* 16 beats of 64-bit words for the jobs */
+#define DMA_BURST_LENGTH          16U
+
+/* end of a single pass, for the largest job at the lowest DDR rate */
+#define DMA_TIMEOUT_MS            10000U
+
+/* Private typedef -----------------------------------------------------------*/
+/*
+ * Linked-list of a channel, the STGEN counter being copied by the DMA itself
+ * at the end of each pass:
+ *   DMA_NODE_START  STGEN counter -> stamp[DMA_STAMP_END]     start time
+ *   DMA_NODE_AGE    stamp[DMA_STAMP_PREV] -> stamp[DMA_STAMP_PREV2]  <--+
+ *   DMA_NODE_SHIFT  stamp[DMA_STAMP_END] -> stamp[DMA_STAMP_PREV]       |
+ *   DMA_NODE_JOB    copy or fill                                        |
+ *   DMA_NODE_END    STGEN counter -> stamp[DMA_STAMP_END]  -- circular -+
+ * so that the two last stamps which differ give the last complete pass.
+ */
+enum {
+  DMA_NODE_START = 0,
+  DMA_NODE_AGE,
+  DMA_NODE_SHIFT,
+  DMA_NODE_JOB,
+  DMA_NODE_END,
+  DMA_NODE_NB,
+};
+
+enum {
+  DMA_STAMP_END = 0,
+  DMA_STAMP_PREV,
+  DMA_STAMP_PREV2,
+  DMA_STAMP_NB,
+};
+
+/* read by the DMA: written by the CPU before the start only */
+typedef struct {
+  DMA_NodeTypeDef node[DMA_NODE_NB];
+  uint64_t pattern;                       /* source of a fill */
+} __attribute__((aligned(DMA_CACHE_LINE))) dma_list;
+
+/* written by the DMA: on their own cache line */
+typedef struct {
+  volatile uint32_t stamp[DMA_STAMP_NB];
+} __attribute__((aligned(DMA_CACHE_LINE))) dma_stamps;
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static DMA_HandleTypeDef dma_handle[DDR_DMA_CHANNEL_MAX];
+static DMA_QListTypeDef dma_queue[DDR_DMA_CHANNEL_MAX];
+static dma_list dma_lists[DDR_DMA_CHANNEL_MAX];
+static dma_stamps dma_stamp[DDR_DMA_CHANNEL_MAX];
+
+static DDR_DmaJobTypeDef dma_job[DDR_DMA_CHANNEL_MAX];
+static uint32_t dma_nb_job;
+static bool dma_circular;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* 2D addressing channels of HPDMA1 */
+static DMA_Channel_TypeDef *dma_instance(uint32_t channel)
+{
+  static DMA_Channel_TypeDef * const instance[DDR_DMA_CHANNEL_MAX] = {
+    HPDMA1_Channel12, HPDMA1_Channel13, HPDMA1_Channel14, HPDMA1_Channel15,
+  };
+
+  return instance[channel];
+}
+
+static bool dma_job_valid(const DDR_DmaJobTypeDef *job)
+{
+  uintptr_t ddr_end = (uintptr_t)DDR_MEM_BASE + DDR_MEM_SIZE;
+
+  if (   (job->size == 0UL) || (job->size > DDR_DMA_SIZE_MAX)
+      || ((job->size % DDR_DMA_BLOCK_SIZE) != 0UL)
+      || ((job->dst & 7UL) != 0UL) || (job->dst < (uintptr_t)DDR_MEM_BASE)
+      || (job->dst > (ddr_end - job->size))
+      || (((uint64_t)job->dst + job->size) > DDR_DMA_ADDR_END))
+  {
+    return false;
+  }
+
+  if (job->op == DDR_DMA_FILL)
+  {
+    return true;
+  }
+
+  return (   (job->op == DDR_DMA_COPY) && ((job->src & 7UL) == 0UL)
+          && (((uint64_t)job->src + job->size) <= DDR_DMA_ADDR_END)
+          && (   ((job->src + job->size) <= job->dst)
+              || ((job->dst + job->size) <= job->src)));
+}
+
+/*
+ * 2D node of <nb_block> blocks of <size> bytes, contiguous: 64-bit bursts
+ * for the jobs, one 32-bit word for the stamps
+ */
+static HAL_StatusTypeDef dma_build_node(DMA_NodeTypeDef *node, uintptr_t src,
+                                        bool src_inc, uintptr_t dst,
+                                        uint32_t size, uint32_t nb_block)
+{
+  DMA_NodeConfTypeDef conf;
+  bool burst = (nb_block != 0U);
+
+  memset(&conf, 0, sizeof(conf));
+
+  conf.NodeType = DMA_HPDMA_2D_NODE;
+  conf.Init.Request = DMA_REQUEST_SW;
+  conf.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  conf.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  conf.Init.SrcInc = src_inc ? DMA_SINC_INCREMENTED : DMA_SINC_FIXED;
+  conf.Init.DestInc = DMA_DINC_INCREMENTED;
+  conf.Init.SrcDataWidth = burst ? DMA_SRC_DATAWIDTH_DOUBLEWORD :
+                                   DMA_SRC_DATAWIDTH_WORD;
+  conf.Init.DestDataWidth = burst ? DMA_DEST_DATAWIDTH_DOUBLEWORD :
+                                    DMA_DEST_DATAWIDTH_WORD;
+  conf.Init.SrcBurstLength = burst ? DMA_BURST_LENGTH : 1U;
+  conf.Init.DestBurstLength = burst ? DMA_BURST_LENGTH : 1U;
+  conf.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 |
+                                    DMA_DEST_ALLOCATED_PORT0;
+  conf.Init.TransferEventMode = DMA_TCEM_LAST_LL_ITEM_TRANSFER;
+  conf.Init.Mode = DMA_NORMAL;
+  conf.DataHandlingConfig.DataExchange = DMA_EXCHANGE_NONE;
+  conf.DataHandlingConfig.DataAlignment = DMA_DATA_RIGHTALIGN_ZEROPADDED;
+  conf.TriggerConfig.TriggerPolarity = DMA_TRIG_POLARITY_MASKED;
+  conf.RepeatBlockConfig.RepeatCount = burst ? nb_block : 1U;
+  conf.SrcAddress = (uint32_t)src;
+  conf.DstAddress = (uint32_t)dst;
+  conf.DataSize = size;
+#if defined(CORTEX_IN_SECURE_STATE)
+  conf.SrcSecure = DMA_CHANNEL_SRC_SEC;
+  conf.DestSecure = DMA_CHANNEL_DEST_SEC;
+#endif /* CORTEX_IN_SECURE_STATE */
+
+  return HAL_DMAEx_List_BuildNode(&conf, node);
+}
+
+static int dma_build_list(uint32_t channel)
+{
+  const DDR_DmaJobTypeDef *job = &dma_job[channel];
+  DMA_QListTypeDef *queue = &dma_queue[channel];
+  dma_list *list = &dma_lists[channel];
+  volatile uint32_t *stamp = dma_stamp[channel].stamp;
+  uintptr_t counter = (uintptr_t)&STGENC->CNTCVL;
+  uint32_t i;
+
+  memset(queue, 0, sizeof(*queue));
+  memset(list, 0, sizeof(*list));
+  memset((void *)stamp, 0, sizeof(dma_stamps));
+  list->pattern = ((uint64_t)job->pattern << 32) | job->pattern;
+
+  if (   (dma_build_node(&list->node[DMA_NODE_START], counter, false,
+                         (uintptr_t)&stamp[DMA_STAMP_END], 4U, 0U) != HAL_OK)
+      || (dma_build_node(&list->node[DMA_NODE_AGE],
+                         (uintptr_t)&stamp[DMA_STAMP_PREV], false,
+                         (uintptr_t)&stamp[DMA_STAMP_PREV2], 4U, 0U) != HAL_OK)
+      || (dma_build_node(&list->node[DMA_NODE_SHIFT],
+                         (uintptr_t)&stamp[DMA_STAMP_END], false,
+                         (uintptr_t)&stamp[DMA_STAMP_PREV], 4U, 0U) != HAL_OK)
+      || (dma_build_node(&list->node[DMA_NODE_JOB],
+                         (job->op == DDR_DMA_COPY) ? job->src :
+                                                     (uintptr_t)&list->pattern,
+                         job->op == DDR_DMA_COPY, job->dst, DDR_DMA_BLOCK_SIZE,
+                         (uint32_t)(job->size / DDR_DMA_BLOCK_SIZE)) != HAL_OK)
+      || (dma_build_node(&list->node[DMA_NODE_END], counter, false,
+                         (uintptr_t)&stamp[DMA_STAMP_END], 4U, 0U) != HAL_OK))
+  {
+    return -1;
+  }
+
+  for (i = 0; i < DMA_NODE_NB; i++)
+  {
+    if (HAL_DMAEx_List_InsertNode_Tail(queue, &list->node[i]) != HAL_OK)
+    {
+      return -1;
+    }
+  }
+
+  if (   dma_circular
+      && (HAL_DMAEx_List_SetCircularModeConfig(queue,
+                                               &list->node[DMA_NODE_AGE])
+          != HAL_OK))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+static int dma_init_channel(uint32_t channel)
+{
+  DMA_HandleTypeDef *hdma = &dma_handle[channel];
+
+  memset(hdma, 0, sizeof(*hdma));
+  hdma->Instance = dma_instance(channel);
+  hdma->InitLinkedList.Priority = DMA_LOW_PRIORITY_HIGH_WEIGHT;
+  hdma->InitLinkedList.LinkStepMode = DMA_LSM_FULL_EXECUTION;
+  hdma->InitLinkedList.LinkAllocatedPort = DMA_LINK_ALLOCATED_PORT0;
+  hdma->InitLinkedList.TransferEventMode = DMA_TCEM_LAST_LL_ITEM_TRANSFER;
+  hdma->InitLinkedList.LinkedListMode = dma_circular ? DMA_LINKEDLIST_CIRCULAR :
+                                                       DMA_LINKEDLIST_NORMAL;
+
+  if (HAL_DMAEx_List_Init(hdma) != HAL_OK)
+  {
+    return -1;
+  }
+
+#if defined(CORTEX_IN_SECURE_STATE)
+  if (HAL_DMA_ConfigChannelAttributes(hdma, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC |
+                                            DMA_CHANNEL_SRC_SEC |
+                                            DMA_CHANNEL_DEST_SEC) != HAL_OK)
+  {
+    return -1;
+  }
+#endif /* CORTEX_IN_SECURE_STATE */
+
+  if (   (dma_build_list(channel) != 0)
+      || (HAL_DMAEx_List_LinkQ(hdma, &dma_queue[channel]) != HAL_OK))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+/* the DMA reads the lists and the sources, writes the stamps and destinations */
+static void dma_sync_start(uint32_t channel)
+{
+  const DDR_DmaJobTypeDef *job = &dma_job[channel];
+
+  DDR_MMU_CleanInvalidate((uintptr_t)&dma_lists[channel], sizeof(dma_list));
+  DDR_MMU_CleanInvalidate((uintptr_t)&dma_stamp[channel], sizeof(dma_stamps));
+
+  if (job->op == DDR_DMA_COPY)
+  {
+    DDR_MMU_CleanInvalidate(job->src, job->size);
+  }
+  DDR_MMU_CleanInvalidate(job->dst, job->size);
+}
+
+/* duration of the last complete pass */
+static uint64_t dma_pass_time_us(uint32_t channel)
+{
+  volatile uint32_t *stamp = dma_stamp[channel].stamp;
+  uint32_t end = stamp[DMA_STAMP_END];
+  uint32_t prev = stamp[DMA_STAMP_PREV];
+  uint32_t prev2 = stamp[DMA_STAMP_PREV2];
+
+  /* counter differences modulo 2^32 */
+  if ((end != prev) && (prev != 0U))
+  {
+    return time_counter_to_us((uint64_t)(uint32_t)(end - prev));
+  }
+
+  if ((prev != prev2) && (prev2 != 0U))
+  {
+    return time_counter_to_us((uint64_t)(uint32_t)(prev - prev2));
+  }
+
+  return 0U;
+}
+
+static unsigned long dma_verify(const DDR_DmaJobTypeDef *job)
+{
+  volatile const uint64_t *dst = (volatile const uint64_t *)job->dst;
+  volatile const uint64_t *src = (volatile const uint64_t *)job->src;
+  uint64_t pattern = ((uint64_t)job->pattern << 32) | job->pattern;
+  unsigned long nb = job->size / sizeof(uint64_t);
+  unsigned long mismatch = 0UL;
+  unsigned long i;
+
+  DDR_MMU_Invalidate(job->dst, job->size);
+
+  for (i = 0UL; i < nb; i++)
+  {
+    if (dst[i] != ((job->op == DDR_DMA_COPY) ? src[i] : pattern))
+    {
+      mismatch++;
+    }
+  }
+
+  return mismatch;
+}
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @brief  Start one DMA channel per job, each one executing its job once or
+  *         in loop until DDR_DMA_Stop.
+  * @param  job: jobs, destination and source in the DDR below 4GB
+  * @param  nb_job: number of jobs, up to DDR_DMA_CHANNEL_MAX
+  * @param  circular: true to repeat the jobs until stopped
+  * @retval 0 if started, -1 for an invalid job or a DMA error
+  */
+int DDR_DMA_Start(const DDR_DmaJobTypeDef *job, uint32_t nb_job,
+                  bool circular)
+{
+#if defined(HAL_DMA_MODULE_ENABLED)
+  uint32_t i;
+
+  if ((nb_job == 0U) || (nb_job > DDR_DMA_CHANNEL_MAX) || (dma_nb_job != 0U))
+  {
+    return -1;
+  }
+
+  for (i = 0; i < nb_job; i++)
+  {
+    if (!dma_job_valid(&job[i]))
+    {
+      return -1;
+    }
+    dma_job[i] = job[i];
+  }
+  dma_circular = circular;
+
+  __HAL_RCC_HPDMA1_CLK_ENABLE();
+
+  for (i = 0; i < nb_job; i++)
+  {
+    if (dma_init_channel(i) != 0)
+    {
+      return -1;
+    }
+    dma_sync_start(i);
+  }
+
+  /* the channels are started together, then run concurrently */
+  for (i = 0; i < nb_job; i++)
+  {
+    if (HAL_DMAEx_List_Start(&dma_handle[i]) != HAL_OK)
+    {
+      dma_nb_job = i;
+      (void)DDR_DMA_Stop(NULL);
+      return -1;
+    }
+  }
+  dma_nb_job = nb_job;
+
+  return 0;
+#else
+  (void)job;
+  (void)nb_job;
+  (void)circular;
+
+  return -1;
+#endif /* HAL_DMA_MODULE_ENABLED */
+}
+
+/**
+  * @brief  Check if a DMA channel is still executing its job.
+  * @retval true when a channel is running
+  */
+bool DDR_DMA_IsBusy(void)
+{
+#if defined(HAL_DMA_MODULE_ENABLED)
+  uint32_t i;
+
+  for (i = 0; i < dma_nb_job; i++)
+  {
+    if ((dma_handle[i].Instance->CSR & DMA_CSR_IDLEF) == 0U)
+    {
+      return true;
+    }
+  }
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+  return false;
+}
+
+/**
+  * @brief  Stop the DMA channels: the end of the jobs is awaited, or the
+  *         circular jobs are aborted. Then the destinations are verified
+  *         when the channel completed at least one pass.
+  * @param  result: one result per job started, or NULL
+  * @retval 0 if OK, -1 when a channel was not stopped
+  */
+int DDR_DMA_Stop(DDR_DmaResultTypeDef *result)
+{
+#if defined(HAL_DMA_MODULE_ENABLED)
+  DMA_HandleTypeDef *hdma;
+  uint64_t timeout = timeout_init_us(DMA_TIMEOUT_MS * 1000UL);
+  int ret = 0;
+  uint32_t i;
+
+  for (i = 0; i < dma_nb_job; i++)
+  {
+    hdma = &dma_handle[i];
+
+    if (!dma_circular)
+    {
+      while (   ((hdma->Instance->CSR & DMA_CSR_IDLEF) == 0U)
+             && !timeout_elapsed(timeout))
+      {
+        ;
+      }
+    }
+
+    if (   ((hdma->Instance->CSR & DMA_CSR_IDLEF) == 0U)
+        && (HAL_DMA_Abort(hdma) != HAL_OK))
+    {
+      ret = -1;
+    }
+
+    if (result == NULL)
+    {
+      continue;
+    }
+
+    result[i].error = hdma->Instance->CSR & (DMA_CSR_DTEF | DMA_CSR_ULEF |
+                                             DMA_CSR_USEF);
+    result[i].bytes = (dma_job[i].op == DDR_DMA_COPY) ?
+                      (2UL * dma_job[i].size) : dma_job[i].size;
+
+    DDR_MMU_Invalidate((uintptr_t)&dma_stamp[i], sizeof(dma_stamps));
+    result[i].time_us = dma_pass_time_us(i);
+    result[i].mismatch = (result[i].time_us != 0U) ?
+                         dma_verify(&dma_job[i]) : 0UL;
+  }
+
+  for (i = 0; i < dma_nb_job; i++)
+  {
+    (void)HAL_DMAEx_List_UnLinkQ(&dma_handle[i]);
+    (void)HAL_DMAEx_List_DeInit(&dma_handle[i]);
+  }
+  dma_nb_job = 0U;
+
+  return ret;
+#else
+  (void)result;
+
+  return -1;
+#endif /* HAL_DMA_MODULE_ENABLED */
+}
@@ -0,0 +1,476 @@
+/**
+  ******************************************************************************
+  * @file    ddr_mmu.c
+  * @author  MCD Application Team
+  * @brief   Memory attributes of the DDR ranges at EL3 and data cache
+  *          maintenance by address for the DDR tests.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include "ddr_mmu.h"
+#include "ddr_multicore.h"
+#include "stm32mp_util_ddr_conf.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/*
+ * Number of level 2 tables (4KB each in SYSRAM) used to split the 1GB blocks
+ * of the first level table, i.e. number of 1GB blocks of the DDR which can be
+ * partially remapped at the same time.
+ */
+#ifndef DDR_MMU_L2_NB
+#define DDR_MMU_L2_NB             1U
+#endif
+
+#define MMU_L1_SHIFT              30U
+#define MMU_L1_SIZE               (1UL << MMU_L1_SHIFT)
+#define MMU_L2_SHIFT              21U
+#define MMU_L2_ENTRIES            512U
+
+#define MMU_DESC_BLOCK            (1UL << 0)
+#define MMU_DESC_TABLE            (3UL << 0)
+#define MMU_DESC_TYPE_MASK        (3UL << 0)
+#define MMU_DESC_ATTR_MASK        0xFFF0000000000FFCUL
+#define MMU_DESC_TABLE_MASK       0x0000FFFFFFFFF000UL
+
+/* block attributes, same encoding and MAIR index as minimal_startup64_a35.s */
+#define MMU_AF                    (1UL << 10)
+#define MMU_OUTER_SH              (2UL << 8)
+#define MMU_INNER_SH              (3UL << 8)
+#define MMU_AP1                   (1UL << 6)
+#define MMU_IDX(n)                ((unsigned long)(n) << 2)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const char * const mmu_attr_name[DDR_MMU_ATTR_MAX] = {
+  [DDR_MMU_ATTR_NC]     = "nc",
+  [DDR_MMU_ATTR_WB]     = "wb",
+  [DDR_MMU_ATTR_DEVICE] = "device",
+};
+
+#if defined(__AARCH64__)
+static const uint64_t mmu_attr[DDR_MMU_ATTR_MAX] = {
+  /* SHARED_NC_MEMORY */
+  [DDR_MMU_ATTR_NC]     = MMU_IDX(3) | MMU_AP1 | MMU_AF | MMU_OUTER_SH,
+  /* SHARED_MEMORY */
+  [DDR_MMU_ATTR_WB]     = MMU_IDX(2) | MMU_AP1 | MMU_AF | MMU_INNER_SH,
+  /* SHARED_DEVICE */
+  [DDR_MMU_ATTR_DEVICE] = MMU_IDX(1) | MMU_AP1 | MMU_AF | MMU_OUTER_SH,
+};
+
+/* first level table of minimal_startup64_a35.s: entry n maps the n-th GB */
+extern uint64_t mp2_el3_ttb0_base[];
+
+static uint64_t mmu_l2[DDR_MMU_L2_NB][MMU_L2_ENTRIES] __attribute__((aligned(0x1000)));
+static bool mmu_l2_used[DDR_MMU_L2_NB];
+
+/* incremented on each mapping change, the other cores flush their TLB */
+static volatile uint32_t mmu_generation;
+static uint32_t mmu_core_generation[DDR_MULTICORE_MAX_CORES];
+#endif /* __AARCH64__ */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+#if defined(__AARCH64__)
+static unsigned long mmu_dcache_line(void)
+{
+  uint64_t ctr;
+
+  __asm volatile ("mrs %0, ctr_el0" : "=r" (ctr));
+
+  /* CTR_EL0.DminLine: log2 of the number of words in the smallest line */
+  return 4UL << ((ctr >> 16) & 0xFUL);
+}
+
+static void mmu_tlb_invalidate(void)
+{
+  __asm volatile ("dsb sy        \n"
+                  "tlbi alle3is  \n"
+                  "dsb sy        \n"
+                  "isb           \n"
+                  : : : "memory");
+}
+
+/*
+ * the tables are in non cacheable SYSRAM but the table walk is cacheable
+ * (TCR_EL3), the line of the descriptor is evicted after each update
+ */
+static void mmu_write_desc(uint64_t *desc, uint64_t value)
+{
+  *desc = value;
+  __asm volatile ("dc civac, %0" : : "r" (desc) : "memory");
+}
+
+static uint64_t *mmu_l1_desc(uintptr_t addr)
+{
+  return &mp2_el3_ttb0_base[addr >> MMU_L1_SHIFT];
+}
+
+static uint64_t *mmu_l2_table(uint64_t desc)
+{
+  return (uint64_t *)(uintptr_t)(desc & MMU_DESC_TABLE_MASK);
+}
+
+/* block descriptor (level 1 or level 2) translating the address */
+static uint64_t mmu_block_desc(uintptr_t addr)
+{
+  uint64_t desc = *mmu_l1_desc(addr);
+
+  if ((desc & MMU_DESC_TYPE_MASK) == MMU_DESC_TABLE)
+  {
+    desc = mmu_l2_table(desc)[(addr >> MMU_L2_SHIFT) & (MMU_L2_ENTRIES - 1U)];
+  }
+
+  return desc;
+}
+
+static uint64_t *mmu_l2_alloc(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < DDR_MMU_L2_NB; i++)
+  {
+    if (!mmu_l2_used[i])
+    {
+      mmu_l2_used[i] = true;
+      return mmu_l2[i];
+    }
+  }
+
+  return NULL;
+}
+
+static uint32_t mmu_l2_free_nb(void)
+{
+  uint32_t nb = 0;
+  uint32_t i;
+
+  for (i = 0; i < DDR_MMU_L2_NB; i++)
+  {
+    nb += mmu_l2_used[i] ? 0U : 1U;
+  }
+
+  return nb;
+}
+
+static void mmu_l2_free(const uint64_t *table)
+{
+  mmu_l2_used[(table - mmu_l2[0]) / MMU_L2_ENTRIES] = false;
+}
+
+/* break-before-make update of a level 1 descriptor */
+static void mmu_set_l1(uint64_t *desc, uint64_t value)
+{
+  mmu_write_desc(desc, 0);
+  mmu_tlb_invalidate();
+  mmu_write_desc(desc, value);
+  mmu_tlb_invalidate();
+}
+
+/* remap [start, end[, inside the same 1GB block */
+static void mmu_map_block(uintptr_t start, uintptr_t end, DDR_MmuAttrTypeDef attr)
+{
+  uint64_t *l1 = mmu_l1_desc(start);
+  uintptr_t base = start & ~(MMU_L1_SIZE - 1UL);
+  uint64_t *table = NULL;
+  uint32_t first;
+  uint32_t last;
+  uint32_t i;
+
+  /* the dirty lines are written back with the previous attributes */
+  if (DDR_MMU_IsCacheable(start, end - start))
+  {
+    DDR_MMU_CleanInvalidate(start, end - start);
+  }
+
+  if ((*l1 & MMU_DESC_TYPE_MASK) == MMU_DESC_TABLE)
+  {
+    table = mmu_l2_table(*l1);
+  }
+
+  /* whole 1GB block: level 1 block descriptor */
+  if ((start == base) && (end == (base + MMU_L1_SIZE)))
+  {
+    mmu_set_l1(l1, base | mmu_attr[attr] | MMU_DESC_BLOCK);
+    if (table != NULL)
+    {
+      mmu_l2_free(table);
+    }
+    return;
+  }
+
+  /* split the 1GB block in 2MB blocks with the same attributes */
+  if (table == NULL)
+  {
+    table = mmu_l2_alloc();
+    for (i = 0; i < MMU_L2_ENTRIES; i++)
+    {
+      table[i] = (base + ((uintptr_t)i << MMU_L2_SHIFT))
+                 | (*l1 & MMU_DESC_ATTR_MASK) | MMU_DESC_BLOCK;
+    }
+    DDR_MMU_CleanInvalidate((uintptr_t)table, sizeof(mmu_l2[0]));
+    mmu_set_l1(l1, (uintptr_t)table | MMU_DESC_TABLE);
+  }
+
+  first = (uint32_t)((start - base) >> MMU_L2_SHIFT);
+  last = (uint32_t)((end - base) >> MMU_L2_SHIFT);
+
+  for (i = first; i < last; i++)
+  {
+    mmu_write_desc(&table[i], 0);
+  }
+  mmu_tlb_invalidate();
+  for (i = first; i < last; i++)
+  {
+    mmu_write_desc(&table[i], (base + ((uintptr_t)i << MMU_L2_SHIFT))
+                              | mmu_attr[attr] | MMU_DESC_BLOCK);
+  }
+  mmu_tlb_invalidate();
+
+  /* same attributes on the whole table: back to a level 1 block */
+  for (i = 1; i < MMU_L2_ENTRIES; i++)
+  {
+    if ((table[i] & MMU_DESC_ATTR_MASK) != (table[0] & MMU_DESC_ATTR_MASK))
+    {
+      return;
+    }
+  }
+  mmu_set_l1(l1, base | (table[0] & MMU_DESC_ATTR_MASK) | MMU_DESC_BLOCK);
+  mmu_l2_free(table);
+}
+#endif /* __AARCH64__ */
+
+static bool mmu_in_ddr(uintptr_t addr, unsigned long size)
+{
+  return (   (addr >= (uintptr_t)DDR_MEM_BASE)
+          && (size <= DDR_MEM_SIZE)
+          && ((addr - (uintptr_t)DDR_MEM_BASE) <= (DDR_MEM_SIZE - size)));
+}
+
+/**
+  * @brief  Name of the memory attributes.
+  * @param  attr: memory attributes
+  * @retval name, "unknown" for attributes not managed by this driver
+  */
+const char *DDR_MMU_AttrName(DDR_MmuAttrTypeDef attr)
+{
+  if (attr >= DDR_MMU_ATTR_MAX)
+  {
+    return "unknown";
+  }
+
+  return mmu_attr_name[attr];
+}
+
+/**
+  * @brief  Change the memory attributes of a DDR range at EL3. The dirty
+  *         cache lines of the range are written back before the change.
+  *         To be called when the secondary cores are idle.
+  * @param  addr: start of the range, aligned on DDR_MMU_GRANULE
+  * @param  size: size of the range, multiple of DDR_MMU_GRANULE
+  * @param  attr: new memory attributes
+  * @retval 0 if OK, -1 for an invalid range or when more 1GB blocks are
+  *         partially remapped than level 2 tables (DDR_MMU_L2_NB)
+  */
+int DDR_MMU_Map(uintptr_t addr, unsigned long size, DDR_MmuAttrTypeDef attr)
+{
+#if defined(__AARCH64__)
+  uintptr_t start;
+  uintptr_t end;
+  uintptr_t next;
+  uint32_t nb_split = 0;
+
+  if (   (attr >= DDR_MMU_ATTR_MAX) || (size == 0UL)
+      || ((addr & (DDR_MMU_GRANULE - 1UL)) != 0UL)
+      || ((size & (DDR_MMU_GRANULE - 1UL)) != 0UL)
+      || !mmu_in_ddr(addr, size))
+  {
+    return -1;
+  }
+
+  /* first and last 1GB blocks which need a new level 2 table */
+  end = addr + size;
+  for (start = addr; start < end; start = next)
+  {
+    next = (start & ~(MMU_L1_SIZE - 1UL)) + MMU_L1_SIZE;
+    if (   (((start & (MMU_L1_SIZE - 1UL)) != 0UL) || (next > end))
+        && ((*mmu_l1_desc(start) & MMU_DESC_TYPE_MASK) != MMU_DESC_TABLE))
+    {
+      nb_split++;
+    }
+  }
+  if (nb_split > mmu_l2_free_nb())
+  {
+    return -1;
+  }
+
+  for (start = addr; start < end; start = next)
+  {
+    next = (start & ~(MMU_L1_SIZE - 1UL)) + MMU_L1_SIZE;
+    mmu_map_block(start, (next > end) ? end : next, attr);
+  }
+
+  mmu_generation++;
+  mmu_core_generation[DDR_MultiCore_GetCoreId()] = mmu_generation;
+
+  return 0;
+#else
+  (void)addr;
+  (void)size;
+  (void)attr;
+
+  return -1;
+#endif /* __AARCH64__ */
+}
+
+/**
+  * @brief  Memory attributes of a DDR address.
+  * @param  addr: address in the DDR
+  * @retval memory attributes, DDR_MMU_ATTR_MAX outside of the DDR or for
+  *         attributes not set by DDR_MMU_Map
+  */
+DDR_MmuAttrTypeDef DDR_MMU_GetAttr(uintptr_t addr)
+{
+#if defined(__AARCH64__)
+  uint64_t desc;
+  int attr;
+
+  if (!mmu_in_ddr(addr, 1UL))
+  {
+    return DDR_MMU_ATTR_MAX;
+  }
+
+  desc = mmu_block_desc(addr);
+  for (attr = 0; attr < (int)DDR_MMU_ATTR_MAX; attr++)
+  {
+    if ((desc & MMU_DESC_ATTR_MASK) == mmu_attr[attr])
+    {
+      return (DDR_MmuAttrTypeDef)attr;
+    }
+  }
+
+  return DDR_MMU_ATTR_MAX;
+#else
+  return mmu_in_ddr(addr, 1UL) ? DDR_MMU_ATTR_NC : DDR_MMU_ATTR_MAX;
+#endif /* __AARCH64__ */
+}
+
+/**
+  * @brief  Check if a part of an address range is mapped write-back.
+  * @param  addr: start of the range
+  * @param  size: size of the range in bytes
+  * @retval true when at least one byte of the range is cacheable
+  */
+bool DDR_MMU_IsCacheable(uintptr_t addr, unsigned long size)
+{
+  uintptr_t granule;
+  uintptr_t end = addr + size;
+
+  for (granule = addr & ~(DDR_MMU_GRANULE - 1UL); granule < end;
+       granule += DDR_MMU_GRANULE)
+  {
+    if (DDR_MMU_GetAttr(granule) == DDR_MMU_ATTR_WB)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+  * @brief  Clean and invalidate the data cache lines of an address range to
+  *         the point of coherency (DC CIVAC): the dirty lines are written to
+  *         the DDR and the next accesses are cache line fills.
+  * @param  addr: start of the range
+  * @param  size: size of the range in bytes
+  * @retval None
+  */
+void DDR_MMU_CleanInvalidate(uintptr_t addr, unsigned long size)
+{
+#if defined(__AARCH64__)
+  unsigned long line = mmu_dcache_line();
+  uintptr_t end = addr + size;
+
+  for (addr &= ~(line - 1UL); addr < end; addr += line)
+  {
+    __asm volatile ("dc civac, %0" : : "r" (addr) : "memory");
+  }
+  __DSB();
+#else
+  (void)addr;
+  (void)size;
+#endif /* __AARCH64__ */
+}
+
+/**
+  * @brief  Invalidate the data cache lines of an address range (DC IVAC):
+  *         the dirty data are discarded, the next accesses read the DDR.
+  *         The lines only partially inside the range are cleaned and
+  *         invalidated to keep the data around the range.
+  * @param  addr: start of the range
+  * @param  size: size of the range in bytes
+  * @retval None
+  */
+void DDR_MMU_Invalidate(uintptr_t addr, unsigned long size)
+{
+#if defined(__AARCH64__)
+  unsigned long line = mmu_dcache_line();
+  uintptr_t end = addr + size;
+
+  if ((addr & (line - 1UL)) != 0UL)
+  {
+    __asm volatile ("dc civac, %0" : : "r" (addr) : "memory");
+    addr = (addr & ~(line - 1UL)) + line;
+  }
+  if ((end & (line - 1UL)) != 0UL)
+  {
+    __asm volatile ("dc civac, %0" : : "r" (end) : "memory");
+    end &= ~(line - 1UL);
+  }
+
+  for (; addr < end; addr += line)
+  {
+    __asm volatile ("dc ivac, %0" : : "r" (addr) : "memory");
+  }
+  __DSB();
+#else
+  (void)addr;
+  (void)size;
+#endif /* __AARCH64__ */
+}
+
+/**
+  * @brief  Flush the TLB of the calling core when the mapping was changed by
+  *         another core, called by the secondary cores before each test.
+  * @retval None
+  */
+void DDR_MMU_Sync(void)
+{
+#if defined(__AARCH64__)
+  uint32_t core = DDR_MultiCore_GetCoreId();
+
+  if (mmu_core_generation[core] != mmu_generation)
+  {
+    mmu_core_generation[core] = mmu_generation;
+    __asm volatile ("dsb sy      \n"
+                    "tlbi alle3  \n"
+                    "dsb sy      \n"
+                    "isb         \n"
+                    : : : "memory");
+  }
+#endif /* __AARCH64__ */
+}
@@ -0,0 +1,254 @@
+/**
+  ******************************************************************************
+  * @file    ddr_multicore.c
+  * @author  MCD Application Team
+  * @brief   Dispatch of DDR tests on the secondary Cortex-A35 core.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include "stdio.h"
+#include "stdarg.h"
+#include "ddr_multicore.h"
+#include "ddr_mmu.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/*
+ * Mailbox polled by the secondary core from minimal_startup64_a35.s, the
+ * offsets of the fields are used by the assembly code.
+ */
+typedef struct {
+  volatile uint64_t parked;  /* 0x00: set by the secondary core when waiting */
+  volatile uint64_t entry;   /* 0x08: C entry point, released by core 0 */
+  volatile uint64_t stack;   /* 0x10: stack pointer to use for the entry */
+} ddr_multicore_boot_t;
+
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/*
+ * Placed in .data as the secondary core reaches the mailbox before the .bss
+ * section is cleared by the primary core.
+ */
+__attribute__((section(".data"))) ddr_multicore_boot_t ddr_multicore_boot = {
+  0, 0, 0
+};
+
+static uint8_t secondary_stack[DDR_MULTICORE_MAX_CORES - 1]
+                              [DDR_MULTICORE_STACK_SIZE]
+                              __attribute__((aligned(16)));
+
+static DDR_MultiCore_JobTypeDef * volatile secondary_job[DDR_MULTICORE_MAX_CORES];
+
+/* Peterson lock, both cores only access the non cacheable SYSRAM */
+static volatile uint32_t lock_flag[DDR_MULTICORE_MAX_CORES];
+static volatile uint32_t lock_turn;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+static void secondary_loop(void)
+{
+  uint32_t core = DDR_MultiCore_GetCoreId();
+  DDR_MultiCore_JobTypeDef *job;
+
+  while (1)
+  {
+    job = secondary_job[core];
+    if ((job == NULL) || (job->state != DDR_MULTICORE_JOB_READY))
+    {
+      __WFE();
+      continue;
+    }
+
+    __DMB();
+    DDR_MMU_Sync();
+    job->result = DDR_MultiCore_Exec(job);
+    __DMB();
+    job->state = DDR_MULTICORE_JOB_DONE;
+    __DSB();
+    __SEV();
+  }
+}
+
+/**
+  * @brief  Get the index of the running core.
+  * @retval Aff0 field of MPIDR_EL1
+  */
+uint32_t DDR_MultiCore_GetCoreId(void)
+{
+#if defined(__AARCH64__)
+  uint64_t mpidr;
+
+  __asm volatile ("mrs %0, mpidr_el1" : "=r" (mpidr));
+
+  return (uint32_t)(mpidr & 0xFFU);
+#else /* __AARCH64__ */
+  return 0U;
+#endif /* __AARCH64__ */
+}
+
+/**
+  * @brief  Get the number of cores able to execute a test.
+  *         The secondary core is only counted when it is waiting in the
+  *         startup code mailbox.
+  * @retval Number of available cores
+  */
+uint32_t DDR_MultiCore_GetNbCores(void)
+{
+  if (ddr_multicore_boot.parked != 0U)
+  {
+    return DDR_MULTICORE_MAX_CORES;
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Execute a job on the calling core.
+  * @param  job: test function and its arguments
+  * @retval Test function result
+  */
+uint32_t DDR_MultiCore_Exec(DDR_MultiCore_JobTypeDef *job)
+{
+  switch (job->nb_args)
+  {
+    case 0:
+      return job->fct();
+    case 1:
+      return job->fct(job->args[0]);
+    case 2:
+      return job->fct(job->args[0], job->args[1]);
+    case 3:
+      return job->fct(job->args[0], job->args[1], job->args[2]);
+    default:
+      return 0xFFFFFFFFU;
+  }
+}
+
+/**
+  * @brief  Start a job on a secondary core, the call does not wait for its end.
+  * @param  core: index of the secondary core
+  * @param  job: test function and its arguments, shall remain valid until
+  *         DDR_MultiCore_Wait() returns
+  * @retval true if the job is started, false if the core is not available
+  */
+bool DDR_MultiCore_Start(uint32_t core, DDR_MultiCore_JobTypeDef *job)
+{
+  if ((core == 0U) || (core >= DDR_MultiCore_GetNbCores()))
+  {
+    return false;
+  }
+
+  job->result = 0U;
+  job->state = DDR_MULTICORE_JOB_READY;
+  secondary_job[core] = job;
+  __DSB();
+
+  if (ddr_multicore_boot.entry == 0U)
+  {
+    ddr_multicore_boot.stack = (uintptr_t)&secondary_stack[core - 1U]
+                                                          [DDR_MULTICORE_STACK_SIZE];
+    __DSB();
+    ddr_multicore_boot.entry = (uintptr_t)secondary_loop;
+    __DSB();
+  }
+
+  __SEV();
+
+  return true;
+}
+
+/**
+  * @brief  Wait for the end of the job started on a secondary core.
+  * @param  core: index of the secondary core
+  * @retval Test function result
+  */
+uint32_t DDR_MultiCore_Wait(uint32_t core)
+{
+  DDR_MultiCore_JobTypeDef *job;
+
+  if ((core == 0U) || (core >= DDR_MULTICORE_MAX_CORES))
+  {
+    return 0xFFFFFFFFU;
+  }
+
+  job = secondary_job[core];
+  if (job == NULL)
+  {
+    return 0xFFFFFFFFU;
+  }
+
+  while (job->state != DDR_MULTICORE_JOB_DONE)
+  {
+    __WFE();
+  }
+
+  __DMB();
+  secondary_job[core] = NULL;
+  job->state = DDR_MULTICORE_JOB_IDLE;
+
+  return job->result;
+}
+
+/**
+  * @brief  Take the lock shared by the cores.
+  * @retval None
+  */
+void DDR_MultiCore_Lock(void)
+{
+  uint32_t core = DDR_MultiCore_GetCoreId();
+  uint32_t other = 1U - core;
+
+  lock_flag[core] = 1U;
+  lock_turn = other;
+  __DMB();
+
+  while ((lock_flag[other] != 0U) && (lock_turn == other))
+  {
+  }
+
+  __DMB();
+}
+
+/**
+  * @brief  Release the lock shared by the cores.
+  * @retval None
+  */
+void DDR_MultiCore_Unlock(void)
+{
+  __DMB();
+  lock_flag[DDR_MultiCore_GetCoreId()] = 0U;
+}
+
+/**
+  * @brief  printf() serialized between the cores.
+  * @param  format: printf format string
+  * @retval Number of printed characters
+  */
+int DDR_MultiCore_Printf(const char *format, ...)
+{
+  va_list args;
+  int ret;
+
+  DDR_MultiCore_Lock();
+
+  va_start(args, format);
+  ret = vprintf(format, args);
+  va_end(args);
+
+  DDR_MultiCore_Unlock();
+
+  return ret;
+}
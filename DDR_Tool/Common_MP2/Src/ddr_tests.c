@@ -24,6 +24,11 @@
 #include "string.h"
 #include "log.h"
 #include "ddr_tests.h"
+#include "ddr_addr_iter.h"
+#include "ddr_errmap.h"
+#include "ddr_mmu.h"
+#include "ddr_multicore.h"
+#include "system_time.h"
 
 #include "stm32mp_util_conf.h"
 #include "stm32mp_util_ddr_conf.h"
@@ -32,8 +37,39 @@
 /* Private define ------------------------------------------------------------*/
 #define DDR_BASE_ADDR                        0x80000000
 
+/*
+ * Kernel used to write and verify the patterns, selected at build time with
+ * DDR_TEST_KERNEL:
+ *  - DDR_TEST_KERNEL_STP: general purpose register pairs (STP/LDP)
+ *  - DDR_TEST_KERNEL_NEON: 128-bit NEON registers (ST1/LD1)
+ *  - DDR_TEST_KERNEL_NEON_NT: NEON non-temporal pairs (STNP/LDNP)
+ *  - DDR_TEST_KERNEL_C: portable C loops, default when __AARCH64__ is not
+ *    defined (host simulation build)
+ */
+#define DDR_TEST_KERNEL_STP                  0
+#define DDR_TEST_KERNEL_NEON                 1
+#define DDR_TEST_KERNEL_NEON_NT              2
+#define DDR_TEST_KERNEL_C                    3
+#ifndef DDR_TEST_KERNEL
+#if defined(__AARCH64__)
+#define DDR_TEST_KERNEL                      DDR_TEST_KERNEL_NEON
+#else /* __AARCH64__ */
+#define DDR_TEST_KERNEL                      DDR_TEST_KERNEL_C
+#endif /* __AARCH64__ */
+#endif
+
 /* Private macro -------------------------------------------------------------*/
+/* Tests may run on several cores at the same time: serialize the console */
+#define test_printf(...) DDR_MultiCore_Printf(__VA_ARGS__)
+
 /* Private variables ---------------------------------------------------------*/
+/* Bytes written and read by the tests, one counter per core */
+static volatile unsigned long test_traffic_wr[DDR_MULTICORE_MAX_CORES];
+static volatile unsigned long test_traffic_rd[DDR_MULTICORE_MAX_CORES];
+
+/* Address sweep of the pattern tests, NULL for the [addr] [size] buffer */
+static const DDR_AddrSweepTypeDef *test_sweep;
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 static int get_addr(unsigned long addr_in, uintptr_t **addr)
@@ -42,13 +78,13 @@ static int get_addr(unsigned long addr_in, uintptr_t **addr)
   {
     if (addr_in < DDR_MEM_BASE)
     {
-      printf("Address too low: 0x%lx\n\r", addr_in);
+      test_printf("Address too low: 0x%lx\n\r", addr_in);
       return -1;
     }
 
     if ((addr_in & 0x3UL) != 0UL)
     {
-      printf("Unaligned address: 0x%lx\n\r", addr_in);
+      test_printf("Unaligned address: 0x%lx\n\r", addr_in);
       return -1;
     }
 
@@ -69,12 +105,12 @@ static void get_nb_loop(unsigned long loop_in, uint32_t *nb_loop,
   {
     if (loop_in == 0xFFFFFFFF)
     {
-      printf("Warning: infinite loop requested\n\r");
+      test_printf("Warning: infinite loop requested\n\r");
     }
 
     if (loop_in > 0xFFFFFFFF)
     {
-      printf("Warning: incorrect loop_number, forced to default value\n\r");
+      test_printf("Warning: incorrect loop_number, forced to default value\n\r");
       *nb_loop = default_nb_loop;
     }
     else
@@ -95,14 +131,14 @@ static int get_buf_size(unsigned long size_in, unsigned long *size,
   {
     if ((size_in < min_size) || (size_in > (unsigned long)DDR_MEM_SIZE))
     {
-      printf("Invalid size: 0x%lx\n\r", size_in);
-      printf("  (range = 0x%lx..0x%lx)\n\r", min_size, (unsigned long)DDR_MEM_SIZE);
+      test_printf("Invalid size: 0x%lx\n\r", size_in);
+      test_printf("  (range = 0x%lx..0x%lx)\n\r", min_size, (unsigned long)DDR_MEM_SIZE);
       return -1;
     }
 
     if ((size_in & (min_size - 1)) != 0)
     {
-      printf("Unaligned size: 0x%lx (min=0x%lx)\n\r", size_in, min_size);
+      test_printf("Unaligned size: 0x%lx (min=0x%lx)\n\r", size_in, min_size);
       return -1;
     }
 
@@ -134,6 +170,15 @@ static void get_pattern(unsigned long pattern_in, unsigned long *pattern,
   }
 }
 
+/* account the bytes written and read by the running core */
+static void test_traffic(unsigned long written, unsigned long read)
+{
+  uint32_t core = DDR_MultiCore_GetCoreId();
+
+  test_traffic_wr[core] += written;
+  test_traffic_rd[core] += read;
+}
+
 static int test_loop_end(uint32_t *loop, uint32_t nb_loop)
 {
   (*loop)++;
@@ -145,6 +190,19 @@ static int test_loop_end(uint32_t *loop, uint32_t nb_loop)
   return 0;
 }
 
+/*
+ * record the data error of the word at addr in the error map, return true
+ * when its error line is printed (see the errmap command); only called on a
+ * mismatch, kept out of line and cold so that the compare loops stay a load,
+ * a compare and a branch
+ */
+static __attribute__((noinline, cold))
+bool test_error(const uintptr_t *addr, unsigned long expected,
+                unsigned long read)
+{
+  return DDR_ErrMap_Record((uintptr_t)addr - DDR_MEM_BASE, expected, read);
+}
+
 /**
 * @brief test_databus.
 * @par Test Description
@@ -169,7 +227,9 @@ static int test_loop_end(uint32_t *loop, uint32_t nb_loop)
 uint32_t DDR_Test_Databus(unsigned long addr_in)
 {
   unsigned long pattern;
+  unsigned long data;
   uintptr_t *addr = NULL;
+  uint32_t error = 0U;
 
   if (get_addr(addr_in, &addr) != 0)
   {
@@ -180,14 +240,26 @@ uint32_t DDR_Test_Databus(unsigned long addr_in)
   {
     *addr = pattern;
 
-    if (*addr != pattern)
+    data = *addr;
+    if (data != pattern)
     {
-      printf("  test_databus KO @ 0x%lx \n\r", (unsigned long)addr);
-      return 2;
+      if (test_error(addr, pattern, data))
+      {
+        test_printf("  test_databus KO @ 0x%lx \n\r", (unsigned long)addr);
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 2;
+      }
+      error = 2;
     }
   }
 
-  return 0;
+  /* one write and one read per data bit */
+  test_traffic(sizeof(unsigned long) * sizeof(unsigned long) * 8,
+               sizeof(unsigned long) * sizeof(unsigned long) * 8);
+
+  return error;
 }
 
 static int test_databuswalk(uint8_t mode, unsigned long loop_in, unsigned long addr_in)
@@ -206,7 +278,7 @@ static int test_databuswalk(uint8_t mode, unsigned long loop_in, unsigned long a
     return 1;
   }
 
-  while (error == 0U)
+  while ((error == 0U) || DDR_ErrMap_IsEnabled())
   {
     for (i = 0; i < (int)(sizeof(unsigned long) * 8); i++)
     {
@@ -223,8 +295,12 @@ static int test_databuswalk(uint8_t mode, unsigned long loop_in, unsigned long a
       if (pattern !=  data)
       {
         error |= 1 << i;
-        printf("  0x%lx: error 0x%lx expected 0x%lx => error:0x%lx\n\r",
-               (unsigned long)(addr + sizeof(unsigned long) * i), data, pattern, error);
+        if (test_error(addr + sizeof(unsigned long) * i, pattern, data))
+        {
+          test_printf("  0x%lx: error 0x%lx expected 0x%lx => error:0x%lx\n\r",
+                      (unsigned long)(addr + sizeof(unsigned long) * i), data,
+                      pattern, error);
+        }
       }
     }
 
@@ -239,9 +315,13 @@ static int test_databuswalk(uint8_t mode, unsigned long loop_in, unsigned long a
     }
   }
 
+  /* each loop writes and reads one word per data bit, then clears them */
+  test_traffic((2 * loop - 1) * sizeof(unsigned long) * sizeof(unsigned long) * 8,
+               loop * sizeof(unsigned long) * sizeof(unsigned long) * 8);
+
   if (error != 0U)
   {
-    printf("  test_databuswalk%d KO\n\r", mode);
+    test_printf("  test_databuswalk%d KO\n\r", mode);
     return 2;
   }
 
@@ -335,6 +415,7 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
   unsigned long pattern     = 0xAAAAAAAAAAAAAAAA;
   unsigned long antipattern = 0x5555555555555555;
   unsigned long data;
+  unsigned long nb_offset = 0;
 
   if (!is_power_of_2(DDR_MEM_SIZE))
   {
@@ -361,8 +442,8 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
     }
     else
     {
-      printf("DDR size too low for this test (0x%lx)\n\r",
-             (unsigned long)DDR_MEM_SIZE);
+      test_printf("DDR size too low for this test (0x%lx)\n\r",
+                  (unsigned long)DDR_MEM_SIZE);
 
       return 2;
     }
@@ -379,7 +460,7 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
 
   if (!is_power_of_2(size))
   {
-    printf("size 0x%lx is not a power of 2\n\r", size);
+    test_printf("size 0x%lx is not a power of 2\n\r", size);
     return 2;
   }
 
@@ -397,6 +478,7 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
        offset <<= 1)
   {
     *(addr + offset) = pattern;
+    nb_offset++;
   }
 
   /* Check for address bits stuck high. */
@@ -410,8 +492,8 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
     data = *(addr + offset);
     if (data != pattern)
     {
-      printf("  test_addrbus KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
-      printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
+      test_printf("  test_addrbus KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
+      test_printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
       return 4;
     }
   }
@@ -429,8 +511,8 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
     data = *addr;
     if (data != pattern)
     {
-      printf("  test_addrbus KO @ 0x%lx \n\r", (unsigned long)(addr + testoffset));
-      printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
+      test_printf("  test_addrbus KO @ 0x%lx \n\r", (unsigned long)(addr + testoffset));
+      test_printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
       return 5;
     }
 
@@ -442,8 +524,8 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
      data = *(addr + offset);
      if ((data != pattern) && (offset != testoffset))
       {
-        printf("  test_addrbus KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
-        printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
+        test_printf("  test_addrbus KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
+        test_printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
         return 6;
       }
     }
@@ -451,6 +533,13 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
     *(addr + testoffset) = pattern;
   }
 
+  /*
+   * pattern written and read at each offset, then for each offset two
+   * writes, a read at 0 and a read of all the offsets
+   */
+  test_traffic((3 * nb_offset + 2) * sizeof(unsigned long),
+               (nb_offset * (nb_offset + 2)) * sizeof(unsigned long));
+
   return 0;
 }
 
@@ -484,6 +573,9 @@ uint32_t DDR_Test_MemDevice(unsigned long size_in, unsigned long addr_in)
   unsigned long offset;
   unsigned long pattern;
   unsigned long antipattern;
+  unsigned long data;
+  unsigned long nb_bytes;
+  uint32_t error = 0U;
 
   if (get_buf_size(size_in, &size, 4 * 1024, 4) != 0)
   {
@@ -496,6 +588,9 @@ uint32_t DDR_Test_MemDevice(unsigned long size_in, unsigned long addr_in)
   }
 
   nb_words = size / sizeof(unsigned long);
+  /* one word every sizeof(unsigned long) words */
+  nb_bytes = ((nb_words + sizeof(unsigned long) - 1) / sizeof(unsigned long)) *
+             sizeof(unsigned long);
 
   /* Fill memory with a known pattern. */
   for (pattern = 1, offset = 0; offset < nb_words;
@@ -508,10 +603,19 @@ uint32_t DDR_Test_MemDevice(unsigned long size_in, unsigned long addr_in)
   for (pattern = 1, offset = 0; offset < nb_words;
        pattern++, offset += sizeof(unsigned long))
   {
-    if (*(addr + offset) != pattern)
+    data = *(addr + offset);
+    if (data != pattern)
     {
-      printf("  test_memdevice KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
-      return 3;
+      if (test_error(addr + offset, pattern, data))
+      {
+        test_printf("  test_memdevice KO @ 0x%lx \n\r",
+                    (unsigned long)(addr + offset));
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 3;
+      }
+      error = 3;
     }
 
     antipattern = ~pattern;
@@ -523,14 +627,25 @@ uint32_t DDR_Test_MemDevice(unsigned long size_in, unsigned long addr_in)
        pattern++, offset += sizeof(unsigned long))
   {
     antipattern = ~pattern;
-    if (*(addr + offset) != antipattern)
+    data = *(addr + offset);
+    if (data != antipattern)
     {
-      printf("  test_memdevice KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
-      return 4;
+      if (test_error(addr + offset, antipattern, data))
+      {
+        test_printf("  test_memdevice KO @ 0x%lx \n\r",
+                    (unsigned long)(addr + offset));
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 4;
+      }
+      error = 4;
     }
   }
 
-  return 0;
+  test_traffic(2 * nb_bytes, 2 * nb_bytes);
+
+  return error;
 }
 
 /**
@@ -571,6 +686,8 @@ uint32_t DDR_Test_SimultaneousSwitchingOutput(unsigned long size_in,
   unsigned long remaining;
   unsigned long offset;
   unsigned long data = 0;
+  unsigned long read;
+  uint32_t error = 0U;
 
   if (get_buf_size(size_in, &size, 4 * 1024, 4) != 0)
   {
@@ -610,10 +727,19 @@ uint32_t DDR_Test_SimultaneousSwitchingOutput(unsigned long size_in,
 
         *(addr + offset) = data;
 
-        if (*(addr + offset) != data)
+        read = *(addr + offset);
+        if (read != data)
         {
-          printf("  test_sso KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
-          return 3;
+          if (test_error(addr + offset, data, read))
+          {
+            test_printf("  test_sso KO @ 0x%lx \n\r",
+                        (unsigned long)(addr + offset));
+          }
+          if (!DDR_ErrMap_IsEnabled())
+          {
+            return 3;
+          }
+          error = 3;
         }
       }
     }
@@ -621,12 +747,17 @@ uint32_t DDR_Test_SimultaneousSwitchingOutput(unsigned long size_in,
     remaining -= sizeof(unsigned long);
   }
 
-  return 0;
+  /* 6 writes and 6 reads per bit of each of the offset words */
+  test_traffic(offset * 6 * sizeof(unsigned long) * sizeof(unsigned long) * 8,
+               offset * 6 * sizeof(unsigned long) * sizeof(unsigned long) * 8);
+
+  return error;
 }
 
 static void do_noise(unsigned long addr, unsigned long pattern,
                      unsigned long *result)
 {
+#if defined(__AARCH64__)
   __asm volatile (
 //                "PUSH {x2-x10}            \n"
                   "STP x2, x3, [sp, #-16]!  \n"
@@ -677,6 +808,18 @@ static void do_noise(unsigned long addr, unsigned long pattern,
                     [pattern] "r" (pattern),
                     [result]  "r" (result)
                   : "x0", "x1", "x12");
+#else /* __AARCH64__ */
+  volatile unsigned long *p = (volatile unsigned long *)addr;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+  {
+    *p = pattern;
+    result[i] = *p;
+    *p = ~pattern;
+    result[i + 1] = *p;
+  }
+#endif /* __AARCH64__ */
 }
 
 
@@ -717,18 +860,19 @@ uint32_t DDR_Test_Noise(unsigned long pattern_in, unsigned long addr_in)
   }
 
   do_noise((unsigned long)addr, pattern, result);
+  test_traffic(8 * sizeof(unsigned long), 8 * sizeof(unsigned long));
 
   for (i = 0; i < 8;)
   {
     if (*(&result[i++]) != pattern)
     {
-      printf("  test_noise KO @ 0x%lx \n\r", result[i - 1]);
+      test_printf("  test_noise KO @ 0x%lx \n\r", result[i - 1]);
       return 2;
     }
 
     if (*(&result[i++]) != ~pattern)
     {
-      printf("  test_noise KO @ 0x%lx \n\r", result[i - 1]);
+      test_printf("  test_noise KO @ 0x%lx \n\r", result[i - 1]);
       return 3;
     }
   }
@@ -739,6 +883,7 @@ uint32_t DDR_Test_Noise(unsigned long pattern_in, unsigned long addr_in)
 static void do_noiseburst(unsigned long addr, unsigned long pattern,
                           unsigned long bufsize)
 {
+#if defined(__AARCH64__)
   __asm volatile (
 //                "PUSH {x2-x8}             \n"
                   "STP x2, x3, [sp, #-16]!  \n"
@@ -796,6 +941,21 @@ static void do_noiseburst(unsigned long addr, unsigned long pattern,
                     [pattern] "r" (pattern),
                     [bufsize] "r" (bufsize)
                   : "x0", "x1", "x10");
+#else /* __AARCH64__ */
+  volatile unsigned long *p = (volatile unsigned long *)addr;
+  long remaining = (long)bufsize;
+  int i;
+
+  /* same as the assembly loop: 256 bytes written until remaining < 0 */
+  do
+  {
+    for (i = 0; i < 32; i++)
+    {
+      *p++ = (i & 1) ? ~pattern : pattern;
+    }
+    remaining -= 256;
+  } while (remaining >= 0);
+#endif /* __AARCH64__ */
 }
 
 #define DDR_CHUNK_SIZE  0x08000000
@@ -832,6 +992,7 @@ uint32_t DDR_Test_NoiseBurst(unsigned long size_in, unsigned long pattern_in,
   unsigned long remaining;
   unsigned long size;
   unsigned long i;
+  uint32_t error = 0U;
 
   if (get_buf_size(size_in, &bufsize, 4 * 1024, 128) != 0)
   {
@@ -866,9 +1027,16 @@ uint32_t DDR_Test_NoiseBurst(unsigned long size_in, unsigned long pattern_in,
     data = *(addr + i);
     if (data != pattern)
     {
-      printf("  test_noiseburst KO @ 0x%lx\n\r", (unsigned long)(addr + i));
-      printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
-      return 3;
+      if (test_error(addr + i, pattern, data))
+      {
+        test_printf("  test_noiseburst KO @ 0x%lx\n\r", (unsigned long)(addr + i));
+        test_printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 3;
+      }
+      error = 3;
     }
 
     i++;
@@ -876,15 +1044,24 @@ uint32_t DDR_Test_NoiseBurst(unsigned long size_in, unsigned long pattern_in,
     data = *(addr + i);
     if (data != ~pattern)
     {
-      printf("  test_noiseburst KO @ 0x%lx\n\r", (unsigned long)(addr + i));
-      printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
-      return 4;
+      if (test_error(addr + i, ~pattern, data))
+      {
+        test_printf("  test_noiseburst KO @ 0x%lx\n\r", (unsigned long)(addr + i));
+        test_printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 4;
+      }
+      error = 4;
     }
 
     i++;
   }
 
-  return 0;
+  test_traffic(bufsize, bufsize);
+
+  return error;
 }
 
 /**
@@ -938,7 +1115,7 @@ uint32_t DDR_Test_Random(unsigned long size_in, unsigned long loop_in,
   bufsize_bytes /= 2;
   bufsize_words = bufsize_bytes/sizeof(unsigned long);
 
-  while (error == 0U)
+  while ((error == 0U) || DDR_ErrMap_IsEnabled())
   {
     seed = rand();
     srand(seed);
@@ -965,9 +1142,15 @@ uint32_t DDR_Test_Random(unsigned long size_in, unsigned long loop_in,
       if (data != value)
       {
         error++;
-        printf("  loop %d: error @ 0x%lx: 0x%lx expected 0x%lx\n\r",
-               loop, (unsigned long)(addr + offset), data, value);
-        break;
+        if (test_error(addr + offset, value, data))
+        {
+          test_printf("  loop %d: error @ 0x%lx: 0x%lx expected 0x%lx\n\r",
+                      loop, (unsigned long)(addr + offset), data, value);
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          break;
+        }
       }
     }
 
@@ -977,9 +1160,12 @@ uint32_t DDR_Test_Random(unsigned long size_in, unsigned long loop_in,
     }
   }
 
+  /* each loop writes both halves, copies the first one and reads both */
+  test_traffic(loop * 2 * bufsize_bytes, loop * 3 * bufsize_bytes);
+
   if (error != 0U)
   {
-    printf("  test_random KO\n\r");
+    test_printf("  test_random KO\n\r");
     return 3;
   }
 
@@ -987,104 +1173,341 @@ uint32_t DDR_Test_Random(unsigned long size_in, unsigned long loop_in,
 }
 
 #define DDR_PATTERN_SIZE  8
+#define DDR_PATTERN_BYTES (DDR_PATTERN_SIZE * sizeof(unsigned long))
+/* verified block, the scalar check is only done on a failing block */
+#define DDR_CHECK_BLOCK   0x1000UL
+
+/*
+ * Pattern test kernels, 64 bytes (8 x u64) per pattern, 256 bytes per
+ * iteration of the main loop then 64 bytes per iteration for the tail.
+ * %[offset] and %[testsize] are updated by the kernels.
+ */
+#if (DDR_TEST_KERNEL == DDR_TEST_KERNEL_C)
+/* no assembly kernel */
+#elif (DDR_TEST_KERNEL == DDR_TEST_KERNEL_STP)
+#define KERNEL_LOAD_PATTERN                 \
+                  "LDP x3, x4, [%[pattern]]        \n" \
+                  "LDP x5, x6, [%[pattern], #16]   \n" \
+                  "LDP x7, x8, [%[pattern], #32]   \n" \
+                  "LDP x9, x10, [%[pattern], #48]  \n"
+#define KERNEL_WRITE_64B                    \
+                  "STP x3, x4, [%[offset]], #16    \n" \
+                  "STP x5, x6, [%[offset]], #16    \n" \
+                  "STP x7, x8, [%[offset]], #16    \n" \
+                  "STP x9, x10, [%[offset]], #16   \n"
+#define KERNEL_CHECK_INIT                   \
+                  "MOV x13, xzr                    \n"
+#define KERNEL_CHECK_16B(r1, r2)            \
+                  "LDP x11, x12, [%[offset]], #16  \n" \
+                  "EOR x11, x11, " r1 "            \n" \
+                  "EOR x12, x12, " r2 "            \n" \
+                  "ORR x13, x13, x11               \n" \
+                  "ORR x13, x13, x12               \n"
+#define KERNEL_CHECK_64B                    \
+                  KERNEL_CHECK_16B("x3", "x4")         \
+                  KERNEL_CHECK_16B("x5", "x6")         \
+                  KERNEL_CHECK_16B("x7", "x8")         \
+                  KERNEL_CHECK_16B("x9", "x10")
+#define KERNEL_CHECK_RESULT                 \
+                  "MOV %[diff], x13                \n"
+#define KERNEL_CLOBBER "x3", "x4", "x5", "x6", "x7", "x8", "x9", "x10", \
+                       "x11", "x12", "x13"
+#else
+#define KERNEL_LOAD_PATTERN                 \
+                  "LD1 {v0.2d, v1.2d, v2.2d, v3.2d}, [%[pattern]] \n"
+#if (DDR_TEST_KERNEL == DDR_TEST_KERNEL_NEON_NT)
+#define KERNEL_WRITE_64B                    \
+                  "STNP q0, q1, [%[offset]]        \n" \
+                  "STNP q2, q3, [%[offset], #32]   \n" \
+                  "ADD %[offset], %[offset], #64   \n"
+#define KERNEL_LOAD_64B                     \
+                  "LDNP q4, q5, [%[offset]]        \n" \
+                  "LDNP q6, q7, [%[offset], #32]   \n" \
+                  "ADD %[offset], %[offset], #64   \n"
+#else
+#define KERNEL_WRITE_64B                    \
+                  "ST1 {v0.2d, v1.2d, v2.2d, v3.2d}, [%[offset]], #64 \n"
+#define KERNEL_LOAD_64B                     \
+                  "LD1 {v4.2d, v5.2d, v6.2d, v7.2d}, [%[offset]], #64 \n"
+#endif
+#define KERNEL_CHECK_INIT                   \
+                  "MOVI v16.2d, #0                 \n"
+#define KERNEL_CHECK_64B                    \
+                  KERNEL_LOAD_64B                      \
+                  "EOR v4.16b, v4.16b, v0.16b      \n" \
+                  "EOR v5.16b, v5.16b, v1.16b      \n" \
+                  "EOR v6.16b, v6.16b, v2.16b      \n" \
+                  "EOR v7.16b, v7.16b, v3.16b      \n" \
+                  "ORR v4.16b, v4.16b, v5.16b      \n" \
+                  "ORR v6.16b, v6.16b, v7.16b      \n" \
+                  "ORR v16.16b, v16.16b, v4.16b    \n" \
+                  "ORR v16.16b, v16.16b, v6.16b    \n"
+#define KERNEL_CHECK_RESULT                 \
+                  "UMOV %[diff], v16.d[0]          \n" \
+                  "UMOV x3, v16.d[1]               \n" \
+                  "ORR %[diff], %[diff], x3        \n"
+#define KERNEL_CLOBBER "x3", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", \
+                       "v16"
+#endif
 
-/* pattern test, optimized loop for read/write pattern (array of 8 u32) */
+/* write the pattern (array of 8 u64), testsize shall be a multiple of 64 */
 static void test_loop_in(const unsigned long *pattern, unsigned long offset,
                          unsigned long testsize)
 {
+#if (DDR_TEST_KERNEL == DDR_TEST_KERNEL_C)
+  volatile unsigned long *p = (volatile unsigned long *)offset;
+  unsigned long i;
+
+  for (i = 0; i < (testsize / sizeof(unsigned long)); i++)
+  {
+    p[i] = pattern[i % DDR_PATTERN_SIZE];
+  }
+#else
   __asm volatile (
-//                "PUSH {x3-x10}            \n"
-                  "STP x3, x4, [sp, #-16]!  \n"
-                  "STP x5, x6, [sp, #-16]!  \n"
-                  "STP x7, x8, [sp, #-16]!  \n"
-                  "STP x9, x10, [sp, #-16]! \n"
-
-                  "MOV x0, %[pattern]       \n"
-                  "MOV x1, %[offset]        \n"
-                  "MOV x2, %[testsize]      \n"
-
-//                "LDMIA x0!, {x3-x10}      \n"
-                  "LDP x3, x4, [x0], #16    \n"
-                  "LDP x5, x6, [x0], #16    \n"
-                  "LDP x7, x8, [x0], #16    \n"
-                  "LDP x9, x10, [x0], #16   \n"
-
-                  "loop2:                   \n"
-
-//                "STMIA x1!, {x3-x10}      \n"
-                  "STP x3, x4, [x1], #16    \n"
-                  "STP x5, x6, [x1], #16    \n"
-                  "STP x7, x8, [x1], #16    \n"
-                  "STP x9, x10, [x1], #16   \n"
-
-//                "STMIA x1!, {x3-x10}      \n"
-                  "STP x3, x4, [x1], #16    \n"
-                  "STP x5, x6, [x1], #16    \n"
-                  "STP x7, x8, [x1], #16    \n"
-                  "STP x9, x10, [x1], #16   \n"
-
-//                "STMIA x1!, {x3-x10}      \n"
-                  "STP x3, x4, [x1], #16    \n"
-                  "STP x5, x6, [x1], #16    \n"
-                  "STP x7, x8, [x1], #16    \n"
-                  "STP x9, x10, [x1], #16   \n"
-
-//                "STMIA x1!, {x3-x10}      \n"
-                  "STP x3, x4, [x1], #16    \n"
-                  "STP x5, x6, [x1], #16    \n"
-                  "STP x7, x8, [x1], #16    \n"
-                  "STP x9, x10, [x1], #16   \n"
-
-                  "SUBS x2, x2, #256        \n"
-                  "BGE loop2                \n"
-
-//                "POP {x3-x10}             \n"
-                  "LDP x3, x4, [sp], #16    \n"
-                  "LDP x5, x6, [sp], #16    \n"
-                  "LDP x7, x8, [sp], #16    \n"
-                  "LDP x9, x10, [sp], #16   \n"
-                    ::[pattern]  "r" (pattern),
-                      [offset]   "r" (offset),
-                      [testsize] "r" (testsize)
-                    : "x0", "x1", "x2");
+                  KERNEL_LOAD_PATTERN
+                  "1:                              \n"
+                  "CMP %[testsize], #256           \n"
+                  "B.LO 2f                         \n"
+                  KERNEL_WRITE_64B
+                  KERNEL_WRITE_64B
+                  KERNEL_WRITE_64B
+                  KERNEL_WRITE_64B
+                  "SUB %[testsize], %[testsize], #256 \n"
+                  "B 1b                            \n"
+                  "2:                              \n"
+                  "CBZ %[testsize], 3f             \n"
+                  KERNEL_WRITE_64B
+                  "SUB %[testsize], %[testsize], #64 \n"
+                  "B 2b                            \n"
+                  "3:                              \n"
+                    : [offset]   "+r" (offset),
+                      [testsize] "+r" (testsize)
+                    : [pattern]  "r" (pattern)
+                    : KERNEL_CLOBBER, "cc", "memory");
+#endif
 }
 
-static int test_loop(const unsigned long *pattern, uintptr_t *address,
-                     const unsigned long bufsize)
+/*
+ * compare the memory with the pattern (array of 8 u64), testsize shall be a
+ * multiple of 64, return the OR of all the XOR differences (0 when no error)
+ */
+static unsigned long test_loop_check(const unsigned long *pattern,
+                                     unsigned long offset,
+                                     unsigned long testsize)
 {
+  unsigned long diff;
+
+#if (DDR_TEST_KERNEL == DDR_TEST_KERNEL_C)
+  volatile unsigned long *p = (volatile unsigned long *)offset;
   unsigned long i;
+
+  diff = 0UL;
+  for (i = 0; i < (testsize / sizeof(unsigned long)); i++)
+  {
+    diff |= p[i] ^ pattern[i % DDR_PATTERN_SIZE];
+  }
+#else
+  __asm volatile (
+                  KERNEL_LOAD_PATTERN
+                  KERNEL_CHECK_INIT
+                  "1:                              \n"
+                  "CMP %[testsize], #256           \n"
+                  "B.LO 2f                         \n"
+                  KERNEL_CHECK_64B
+                  KERNEL_CHECK_64B
+                  KERNEL_CHECK_64B
+                  KERNEL_CHECK_64B
+                  "SUB %[testsize], %[testsize], #256 \n"
+                  "B 1b                            \n"
+                  "2:                              \n"
+                  "CBZ %[testsize], 3f             \n"
+                  KERNEL_CHECK_64B
+                  "SUB %[testsize], %[testsize], #64 \n"
+                  "B 2b                            \n"
+                  "3:                              \n"
+                  KERNEL_CHECK_RESULT
+                    : [offset]   "+r" (offset),
+                      [testsize] "+r" (testsize),
+                      [diff]     "=&r" (diff)
+                    : [pattern]  "r" (pattern)
+                    : KERNEL_CLOBBER, "cc", "memory");
+#endif
+
+  return diff;
+}
+
+/*
+ * scalar check of testsize bytes, return the address of the first error;
+ * with the error map, all the errors are recorded
+ */
+static uintptr_t *test_loop_locate(const unsigned long *pattern,
+                                   unsigned long offset,
+                                   unsigned long testsize)
+{
+  uintptr_t *addr;
+  uintptr_t *first = NULL;
+  unsigned long data;
   int j;
-  unsigned long offset;
+
+  for (addr = (uintptr_t *)offset;
+       addr < (uintptr_t *)(offset + testsize);
+       addr += DDR_PATTERN_SIZE)
+  {
+    for (j = 0; j < DDR_PATTERN_SIZE; j++)
+    {
+      data = *(addr + j);
+      if (data == pattern[j])
+      {
+        continue;
+      }
+
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return addr + j;
+      }
+
+      if (first == NULL)
+      {
+        first = addr + j;
+      }
+      if (test_error(addr + j, pattern[j], data))
+      {
+        test_printf("  0x%lx: 0x%lx expected 0x%lx\n\r",
+                    (unsigned long)(addr + j), data, pattern[j]);
+      }
+    }
+  }
+
+  return first;
+}
+
+/*
+ * write back and evict the cache lines of a range mapped write-back (see the
+ * "map" command), the check then reads the DDR with cache line fills
+ */
+static void test_flush(unsigned long offset, unsigned long size)
+{
+  if (DDR_MMU_IsCacheable((uintptr_t)offset, size))
+  {
+    DDR_MMU_CleanInvalidate((uintptr_t)offset, size);
+  }
+}
+
+/*
+ * write then verify the pattern (array of 8 u64) on bufsize bytes (multiple
+ * of 64), return the address of the first error or NULL
+ */
+static uintptr_t *test_loop_pattern(const unsigned long *pattern,
+                                    uintptr_t *address, unsigned long bufsize)
+{
+  unsigned long offset = (unsigned long)address;
+  unsigned long remaining = bufsize;
   unsigned long testsize;
-  unsigned long remaining;
+  uintptr_t *addr;
+  uintptr_t *error = NULL;
 
-  offset = (unsigned long)address;
-  remaining = bufsize;
+  test_loop_in(pattern, offset, bufsize);
+  test_flush(offset, bufsize);
 
+  /* fast check by block, scalar check only to localise the error */
   while (remaining)
   {
-    testsize = bufsize > 0x1000000 ? 0x1000000 : bufsize;
+    testsize = remaining > DDR_CHECK_BLOCK ? DDR_CHECK_BLOCK : remaining;
 
-    test_loop_in(pattern, offset, testsize);
+    if (test_loop_check(pattern, offset, testsize) != 0UL)
+    {
+      addr = test_loop_locate(pattern, offset, testsize);
+      if (error == NULL)
+      {
+        error = addr;
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        break;
+      }
+    }
 
     offset += testsize;
     remaining -= testsize;
   }
 
-  offset = 0;
+  test_traffic(bufsize, bufsize);
+
+  return error;
+}
+
+/*
+ * write then verify the pattern (array of 8 u64) on all the chunks of the
+ * address sweep, in the sweep order, return the address of the first error
+ * or NULL
+ */
+static uintptr_t *test_sweep_pattern(const unsigned long *pattern)
+{
+  DDR_AddrIterTypeDef it;
+  uintptr_t chunk;
+  uintptr_t *addr;
+  uintptr_t *error = NULL;
+  uint32_t i;
+
+  if (DDR_AddrIter_Init(&it, test_sweep) != 0)
+  {
+    return NULL;
+  }
+
+  while (DDR_AddrIter_Next(&it, &chunk))
+  {
+    test_loop_in(pattern, (unsigned long)chunk, test_sweep->stride);
+  }
+
+  for (i = 0; i < test_sweep->nb_range; i++)
+  {
+    test_flush((unsigned long)test_sweep->range[i].base,
+               test_sweep->range[i].size);
+  }
+
+  test_traffic(it.nb * test_sweep->stride, it.nb * test_sweep->stride);
+
+  /* same order for the check */
+  (void)DDR_AddrIter_Init(&it, test_sweep);
 
-  for (i = 0; i < bufsize / sizeof(unsigned long); i += DDR_PATTERN_SIZE)
+  while (DDR_AddrIter_Next(&it, &chunk))
   {
-    for (j = 0; j < DDR_PATTERN_SIZE; j++, offset++)
+    if (test_loop_check(pattern, (unsigned long)chunk, test_sweep->stride) != 0UL)
     {
-      if (*(address + offset) != pattern[j])
+      addr = test_loop_locate(pattern, (unsigned long)chunk, test_sweep->stride);
+      if (error == NULL)
       {
-        printf("  test_freqpattern KO @ 0x%lx\n\r", (unsigned long)(address + offset));
-        return 1;
+        error = addr;
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        break;
       }
     }
   }
 
+  return error;
+}
+
+static int test_loop(const unsigned long *pattern, uintptr_t *address,
+                     const unsigned long bufsize)
+{
+  uintptr_t *error;
+
+  if (test_sweep != NULL)
+  {
+    error = test_sweep_pattern(pattern);
+  }
+  else
+  {
+    error = test_loop_pattern(pattern, address, bufsize);
+  }
+  if (error != NULL)
+  {
+    test_printf("  test_freqpattern KO @ 0x%lx\n\r", (unsigned long)error);
+    return 1;
+  }
+
   return 0;
 }
 
@@ -1178,6 +1601,7 @@ uint32_t DDR_Test_FrequencySelectivePattern(unsigned long size,
   const unsigned long **patterns;
   unsigned long bufsize;
   uintptr_t *addr = NULL;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 128) != 0)
   {
@@ -1207,12 +1631,19 @@ uint32_t DDR_Test_FrequencySelectivePattern(unsigned long size,
     ret = test_loop(patterns[i], addr, bufsize);
     if (ret != 0)
     {
-      printf("  test_freqpattern KO\n\r");
-      return 3;
+      if (DDR_ErrMap_Line())
+      {
+        test_printf("  test_freqpattern KO\n\r");
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 3;
+      }
+      error = 3;
     }
   }
 
-  return 0;
+  return error;
 }
 
 /* pattern test with size, loop for write pattern */
@@ -1222,9 +1653,52 @@ static int test_loop_size(const unsigned long *pattern, unsigned long size,
                           __attribute__((unused))uint32_t loop)
 {
   unsigned long i, j;
+  unsigned long pattern_64b[DDR_PATTERN_SIZE];
+  unsigned long kernel_size = 0;
+  unsigned long data;
   uintptr_t *addr = (uintptr_t *)address;
+  int error = 0;
+
+  /* pattern of 1, 2 or 4 words repeated on 64 bytes for the kernels */
+  if ((DDR_PATTERN_SIZE % size) == 0)
+  {
+    for (j = 0; j < DDR_PATTERN_SIZE; j++)
+    {
+      pattern_64b[j] = pattern[j % size];
+    }
+
+    if (test_sweep != NULL)
+    {
+      addr = test_sweep_pattern(pattern_64b);
+      if (addr != NULL)
+      {
+        test_printf("  test KO @ 0x%lx\n\r", (unsigned long)addr);
+        return 1;
+      }
+
+      return 0;
+    }
+
+    kernel_size = bufsize & ~(DDR_PATTERN_BYTES - 1);
+    addr = test_loop_pattern(pattern_64b, address, kernel_size);
+    if (addr != NULL)
+    {
+      if (DDR_ErrMap_Line())
+      {
+        test_printf("  test KO @ 0x%lx\n\r", (unsigned long)addr);
+      }
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        return 1;
+      }
+      error = 1;
+    }
+  }
 
-  for (i = 0; i < bufsize / sizeof(unsigned long); i += size)
+  /* remaining words not handled by the kernels */
+  addr = (uintptr_t *)((unsigned long)address + kernel_size);
+  for (i = kernel_size / sizeof(unsigned long);
+       i < bufsize / sizeof(unsigned long); i += size)
   {
     for (j = 0; j < size ; j++, addr++)
     {
@@ -1233,20 +1707,31 @@ static int test_loop_size(const unsigned long *pattern, unsigned long size,
 
   }
 
-  addr = address;
-  for (i = 0; i < bufsize / sizeof(unsigned long); i += size)
+  addr = (uintptr_t *)((unsigned long)address + kernel_size);
+  for (i = kernel_size / sizeof(unsigned long);
+       i < bufsize / sizeof(unsigned long); i += size)
   {
     for (j = 0; j < size; j++, addr++)
     {
-      if (*addr != pattern[j])
+      data = *addr;
+      if (data != pattern[j])
       {
-        printf("  test KO @ 0x%lx\n\r", (unsigned long)addr);
-        return 1;
+        if (test_error(addr, pattern[j], data))
+        {
+          test_printf("  test KO @ 0x%lx\n\r", (unsigned long)addr);
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 1;
+        }
+        error = 1;
       }
     }
   }
 
-  return 0;
+  test_traffic(bufsize - kernel_size, bufsize - kernel_size);
+
+  return error;
 }
 
 /**
@@ -1279,6 +1764,7 @@ uint32_t DDR_Test_BlockSequential(unsigned long size, unsigned long loop_in,
   unsigned long value;
   unsigned long i;
   int ret;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 4) != 0)
   {
@@ -1300,8 +1786,15 @@ uint32_t DDR_Test_BlockSequential(unsigned long size, unsigned long loop_in,
       ret = test_loop_size(&value, 1, addr, bufsize, 256, i);
       if (ret != 0)
       {
-        printf("  test_blockseq KO\n\r");
-        return 3;
+        if (DDR_ErrMap_Line())
+        {
+          test_printf("  test_blockseq KO\n\r");
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 3;
+        }
+        error = 3;
       }
     }
 
@@ -1311,7 +1804,7 @@ uint32_t DDR_Test_BlockSequential(unsigned long size, unsigned long loop_in,
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1344,6 +1837,7 @@ uint32_t DDR_Test_Checkerboard(unsigned long size, unsigned long loop_in,
   unsigned long checkboard[2];
   int i;
   int ret;
+  uint32_t error = 0U;
 
   checkboard[0] = 0x5555555555555555;
   checkboard[1] = 0xAAAAAAAAAAAAAAAA;
@@ -1367,8 +1861,15 @@ uint32_t DDR_Test_Checkerboard(unsigned long size, unsigned long loop_in,
       ret = test_loop_size(checkboard, 2, addr, bufsize, 2, i);
       if (ret != 0)
       {
-        printf("  test_checkboard KO\n\r");
-        return 3;
+        if (DDR_ErrMap_Line())
+        {
+          test_printf("  test_checkboard KO\n\r");
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 3;
+        }
+        error = 3;
       }
 
       checkboard[0] = ~checkboard[0];
@@ -1381,7 +1882,7 @@ uint32_t DDR_Test_Checkerboard(unsigned long size, unsigned long loop_in,
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1416,6 +1917,7 @@ uint32_t DDR_Test_BitSpread(unsigned long size, unsigned long loop_in,
   int i;
   int j;
   int ret;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 32) != 0)
   {
@@ -1451,8 +1953,15 @@ uint32_t DDR_Test_BitSpread(unsigned long size, unsigned long loop_in,
         ret = test_loop_size(bitspread, 4, addr, bufsize, 32, i);
         if (ret != 0)
         {
-          printf("  test_bitspread KO\n\r");
-          return 3;
+          if (DDR_ErrMap_Line())
+          {
+            test_printf("  test_bitspread KO\n\r");
+          }
+          if (!DDR_ErrMap_IsEnabled())
+          {
+            return 3;
+          }
+          error = 3;
         }
       }
     }
@@ -1463,7 +1972,7 @@ uint32_t DDR_Test_BitSpread(unsigned long size, unsigned long loop_in,
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1495,6 +2004,7 @@ uint32_t DDR_Test_BitFlip(unsigned long size, unsigned long loop_in,
   unsigned long bitflip[4];
   int i;
   int ret;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 32) != 0)
   {
@@ -1520,8 +2030,15 @@ uint32_t DDR_Test_BitFlip(unsigned long size, unsigned long loop_in,
       ret = test_loop_size(bitflip, 4, addr, bufsize, 32, i);
       if (ret != 0)
       {
-        printf("  test_bitflip KO\n\r");
-        return 3;
+        if (DDR_ErrMap_Line())
+        {
+          test_printf("  test_bitflip KO\n\r");
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 3;
+        }
+        error = 3;
       }
     }
 
@@ -1531,7 +2048,7 @@ uint32_t DDR_Test_BitFlip(unsigned long size, unsigned long loop_in,
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1564,6 +2081,7 @@ uint32_t DDR_Test_WalkingZeroes(unsigned long size, unsigned long loop_in,
   int i;
   int ret;
   int depth;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 4) != 0)
   {
@@ -1595,8 +2113,15 @@ uint32_t DDR_Test_WalkingZeroes(unsigned long size, unsigned long loop_in,
       ret = test_loop_size(&value, 1, addr, bufsize, (depth * 2) -1, i);
       if (ret != 0)
       {
-        printf("  test_walkbit0 KO\n\r");
-        return 3;
+        if (DDR_ErrMap_Line())
+        {
+          test_printf("  test_walkbit0 KO\n\r");
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 3;
+        }
+        error = 3;
       }
     }
 
@@ -1606,7 +2131,7 @@ uint32_t DDR_Test_WalkingZeroes(unsigned long size, unsigned long loop_in,
     }
   }
 
-  return 0;
+  return error;
 }
 
 /**
@@ -1639,6 +2164,7 @@ uint32_t DDR_Test_WalkingOnes(unsigned long size, unsigned long loop_in,
   int i;
   int ret;
   int depth;
+  uint32_t error = 0U;
 
   if (get_buf_size(size, &bufsize, 4 * 1024, 4) != 0)
   {
@@ -1670,8 +2196,15 @@ uint32_t DDR_Test_WalkingOnes(unsigned long size, unsigned long loop_in,
       ret = test_loop_size(&value, 1, addr, bufsize, (depth * 2) - 1, i);
       if (ret != 0)
       {
-        printf("  test_walkbit1 KO\n\r");
-        return 3;
+        if (DDR_ErrMap_Line())
+        {
+          test_printf("  test_walkbit1 KO\n\r");
+        }
+        if (!DDR_ErrMap_IsEnabled())
+        {
+          return 3;
+        }
+        error = 3;
       }
     }
 
@@ -1681,6 +2214,192 @@ uint32_t DDR_Test_WalkingOnes(unsigned long size, unsigned long loop_in,
     }
   }
 
+  return error;
+}
+
+/* bandwidth in MB/s for size bytes transferred in ticks */
+static unsigned long test_bandwidth(unsigned long size, uint64_t ticks)
+{
+  if (ticks == 0U)
+  {
+    return 0UL;
+  }
+
+  return (unsigned long)((size * time_get_frequency()) / (ticks * 1000000U));
+}
+
+/* follow the pointer chain for nb loads, return the last address */
+static uintptr_t test_pointer_chase(uintptr_t start, unsigned long nb)
+{
+  uintptr_t p = start;
+
+#if defined(__AARCH64__)
+  __asm volatile ("1:                    \n"
+                  "LDR %[p], [%[p]]      \n"
+                  "SUBS %[nb], %[nb], #1 \n"
+                  "B.NE 1b               \n"
+                  : [p] "+r" (p), [nb] "+r" (nb)
+                  :
+                  : "cc", "memory");
+#else /* __AARCH64__ */
+  do
+  {
+    p = *(volatile uintptr_t *)p;
+  } while (--nb != 0UL);
+#endif /* __AARCH64__ */
+
+  return p;
+}
+
+/**
+* @brief test_benchmark.
+* @par Test Description
+*   Measures the DDR performance with the generic timer (CNTPCT_EL0):
+*   + sequential write and read bandwidth with the pattern kernels
+*   + copy bandwidth with memcpy from the 1st half to the 2nd half
+*   + load latency with a pointer chase, one pointer each stride bytes
+* @par Test Hardware Connection
+* - None
+* @par Required preconditions
+* - None
+* @par Expected result
+* - None
+* @par Called functions
+* - None
+* @par Used Peripherals
+* - None,...
+* @retval
+*  0: Test passed
+*  Value different from 0: Test failed
+*  None(0xFF): if the result is deduced by the user: waveform, event...
+*/
+uint32_t DDR_Test_Benchmark(unsigned long size_in, unsigned long stride_in,
+                            unsigned long addr_in)
+{
+  const unsigned long pattern[DDR_PATTERN_SIZE] = {0};
+  uintptr_t *addr = NULL;
+  unsigned long size;
+  unsigned long stride = 4 * 1024;
+  unsigned long nb;
+  unsigned long i;
+  unsigned long latency;
+  uint64_t start;
+  uint64_t ticks;
+
+  if (get_buf_size(size_in, &size, 1024 * 1024, 4 * 1024) != 0)
+  {
+    return 1;
+  }
+
+  if (stride_in != 0UL)
+  {
+    if (   (stride_in < sizeof(uintptr_t)) || (stride_in >= size)
+        || ((stride_in & (sizeof(uintptr_t) - 1)) != 0UL))
+    {
+      test_printf("Invalid stride: 0x%lx\n\r", stride_in);
+      return 2;
+    }
+    stride = stride_in;
+  }
+
+  if (get_addr(addr_in, &addr) != 0)
+  {
+    return 3;
+  }
+
+  test_printf("  size 0x%lx @ 0x%lx, timer %lu Hz\n\r", size,
+              (unsigned long)addr, (unsigned long)time_get_frequency());
+
+  start = time_get_counter();
+  test_loop_in(pattern, (unsigned long)addr, size);
+  ticks = time_get_counter() - start;
+  test_printf("  write  : %lu MB/s\n\r", test_bandwidth(size, ticks));
+
+  start = time_get_counter();
+  (void)test_loop_check(pattern, (unsigned long)addr, size);
+  ticks = time_get_counter() - start;
+  test_printf("  read   : %lu MB/s\n\r", test_bandwidth(size, ticks));
+
+  start = time_get_counter();
+  memcpy((void *)((unsigned long)addr + (size / 2)), addr, size / 2);
+  ticks = time_get_counter() - start;
+  test_printf("  copy   : %lu MB/s\n\r", test_bandwidth(size / 2, ticks));
+
+  /* pointer chain: each node points to the next one, stride bytes after */
+  nb = size / stride;
+  for (i = 0; i < nb; i++)
+  {
+    *(uintptr_t *)((unsigned long)addr + (i * stride)) =
+      (unsigned long)addr + (((i + 1) % nb) * stride);
+  }
+
+  start = time_get_counter();
+  (void)test_pointer_chase((uintptr_t)addr, nb);
+  ticks = time_get_counter() - start;
+
+  /* latency in 0.1 ns unit */
+  latency = (unsigned long)((time_counter_to_ns(ticks) * 10U) / nb);
+  test_printf("  latency: %lu.%lu ns (stride 0x%lx, %lu loads)\n\r",
+              latency / 10, latency % 10, stride, nb);
+
+  return 0;
+}
+
+/**
+  * @brief  Clear the number of bytes written and read by the tests.
+  * @retval None
+  */
+void DDR_Test_ResetTraffic(void)
+{
+  int core;
+
+  for (core = 0; core < (int)DDR_MULTICORE_MAX_CORES; core++)
+  {
+    test_traffic_wr[core] = 0;
+    test_traffic_rd[core] = 0;
+  }
+}
+
+/**
+  * @brief  Get the number of bytes written and read by the tests on all the
+  *         cores since the last call of DDR_Test_ResetTraffic().
+  * @param  written: number of bytes written
+  * @param  read: number of bytes read
+  * @retval None
+  */
+void DDR_Test_GetTraffic(unsigned long *written, unsigned long *read)
+{
+  int core;
+
+  *written = 0;
+  *read = 0;
+
+  for (core = 0; core < (int)DDR_MULTICORE_MAX_CORES; core++)
+  {
+    *written += test_traffic_wr[core];
+    *read += test_traffic_rd[core];
+  }
+}
+
+/**
+  * @brief  Select the address sweep used by the pattern tests instead of
+  *         their [addr] [size] buffer: frequency selective, block sequential,
+  *         checkerboard, bit spread, bit flip, walking zeroes and ones.
+  * @param  sweep: address ranges and order, NULL to restore the buffer;
+  *         shall remain valid while it is selected
+  * @retval 0 if OK, -1 for an invalid sweep
+  */
+int DDR_Test_SetSweep(const DDR_AddrSweepTypeDef *sweep)
+{
+  DDR_AddrIterTypeDef it;
+
+  if ((sweep != NULL) && (DDR_AddrIter_Init(&it, sweep) != 0))
+  {
+    return -1;
+  }
+
+  test_sweep = sweep;
+
   return 0;
 }
 
@@ -1724,12 +2443,12 @@ uint32_t DDR_Test_Infinite_write(unsigned long pattern_in, unsigned long addr_in
 
   if ((unsigned long)addr == 0xC8888888)
   {
-    printf("running random\n\r");
+    test_printf("running random\n\r");
     random = true;
   }
   else
   {
-    printf("running at 0x%lx with pattern 0x%lx\n\r", (unsigned long)addr, data);
+    test_printf("running at 0x%lx with pattern 0x%lx\n\r", (unsigned long)addr, data);
   }
 
   while (go_loop != 0U)
@@ -1793,12 +2512,12 @@ uint32_t DDR_Test_Infinite_read(unsigned long pattern_in, unsigned long addr_in)
 
   if ((unsigned long)addr == 0xC8888888)
   {
-    printf("running random\n\r");
+    test_printf("running random\n\r");
     random = true;
   }
   else
   {
-    printf("running at 0x%lx with pattern 0x%lx\n\r", (unsigned long)addr, data);
+    test_printf("running at 0x%lx with pattern 0x%lx\n\r", (unsigned long)addr, data);
     *addr = data;
   }
 
@@ -1810,7 +2529,7 @@ uint32_t DDR_Test_Infinite_read(unsigned long pattern_in, unsigned long addr_in)
         addr = (uintptr_t *)(unsigned long)((rand() & (DDR_MEM_SIZE - 1) & ~0x3));
 
       data = *addr;
-      printf("data @ address 0x%lx = 0x%lx \n\r", (unsigned long)addr, data);
+      test_printf("data @ address 0x%lx = 0x%lx \n\r", (unsigned long)addr, data);
     }
 
     if (test_loop_end(&loop, nb_loop))
@@ -22,7 +22,19 @@
 #include "string.h"
 #include "stdlib.h"
 #include "ddr_tool.h"
+#include "ddr_multicore.h"
+#include "ddr_mmu.h"
+#include "system_time.h"
+#include "ddr_pmu.h"
+#include "ddr_margin.h"
+#include "uart_tx.h"
+#include "ddr_script.h"
+#include "ddr_snapshot.h"
+#include "ddr_errmap.h"
+#include "ddr_dma.h"
+#include "stm32mp2xx_hal_ddr_ddrphy_csr_all_cdefines.h"
 #include "stm32mp_util_conf.h"
+#include "stm32mp_util_ddr_conf.h"
 
 /* Private typedef -----------------------------------------------------------*/
 typedef struct {
@@ -46,6 +58,19 @@ typedef enum {
   DDR_CMD_NEXT,
   DDR_CMD_GO,
   DDR_CMD_TEST,
+  DDR_CMD_FWLOG,
+  DDR_CMD_RETREGS,
+  DDR_CMD_PSTATE,
+  DDR_CMD_SWEEP,
+  DDR_CMD_MAP,
+  DDR_CMD_PMU,
+  DDR_CMD_MARGIN,
+  DDR_CMD_SHMOO,
+  DDR_CMD_DMA,
+  DDR_CMD_UART,
+  DDR_CMD_SCRIPT,
+  DDR_CMD_SNAP,
+  DDR_CMD_ERRMAP,
   DDR_CMD_UNKNOWN,
   DDR_CMD_TEST_HELP,
   DDR_CMD_MAX,
@@ -62,10 +87,60 @@ typedef struct {
   uint8_t len;
 } ddr_arg;
 
+typedef struct {
+  int id;
+  uint32_t result;
+  uint64_t time_us;
+  unsigned long written;
+  unsigned long read;
+} test_report;
+
+typedef struct {
+  unsigned long freq;             /* DDR frequency in kHz */
+  bool trained;                   /* initialization and training passed */
+  uint32_t failed;                /* bit n: n-th test of the shmoo failed */
+  uint64_t time_us;               /* duration of the tests */
+  unsigned long bytes;            /* bytes written and read by the tests */
+} shmoo_point;
+
 /* Private define ------------------------------------------------------------*/
 #define CMD_MAX_LEN 1024
 #define CMD_MAX_ARG 5
 #define DDR_NAME_MAX_LEN 128
+#define DDR_PAR_CHUNK_ALIGN 0x1000UL
+#define DDR_REPORT_MAX 32
+
+/*
+ * margin sweep of the PHY DBYTE delays, in pstate 0: 8 DQ lanes per DBYTE
+ * (DBI/DM lane not swept), kernel of 16KB at the DDR base
+ */
+#define MARGIN_DQ_NB 8U
+#define MARGIN_SIZE 0x4000UL
+#define MARGIN_DLY_RANGE 32
+#define MARGIN_DLY_STEP 2
+#define MARGIN_VREF_RANGE 16
+#define MARGIN_VREF_STEP 2
+/* TxDqDly: fine delay [4:0] in 1/32 UI, coarse delay [8:6] in UI */
+#define MARGIN_TXDQ_FINE_NB 32
+#define MARGIN_TXDQ_COARSE_POS 6U
+
+/*
+ * frequency shmoo: the DDR is initialized and trained again at each point,
+ * default tests: data bus and address bus
+ */
+#define SHMOO_POINT_MAX 32
+#define SHMOO_TEST_MAX 8
+#define SHMOO_TEST_DFLT "1,2,3,4"
+
+/* DMA traffic generator: default fill pattern, run time without test */
+#define DMA_PATTERN_DFLT 0xA5A5A5A5U
+#define DMA_RUN_US 1000000UL
+
+/*
+ * Define DDR_TEST_REPORT_CSV to also print one CSV line per test executed
+ * by Test All:
+ * csv,<id>,<name>,<result>,<time us>,<bytes written>,<bytes read>,<MB/s>
+ */
 
 static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr);
 
@@ -106,6 +181,8 @@ const subcmd_desc test[] = {
    "test Walking Ones pattern", 3},
   {DDR_Test_WalkingOnes, "Test WalkingOnes", "[size] [loop] [addr]",
    "test Walking Zeroes pattern", 3},
+  {DDR_Test_Benchmark, "Test Benchmark", "[size] [stride] [addr]",
+   "Measure read/write/copy bandwidth (MB/s) and load latency (ns)", 3},
 #ifdef TEST_INFINITE_ENABLE
   {DDR_Test_Infinite_write, "Test infinite write for JEDEC", "[pattern] [addr]",
    "test infinite write pattern", 2},
@@ -137,6 +214,19 @@ const ddr_command ddr_cmd[DDR_CMD_MAX] = {
     [DDR_CMD_NEXT]         = { "next"       , 0, 0 },
     [DDR_CMD_GO]           = { "go"         , 0, 0 },
     [DDR_CMD_TEST]         = { "test"       , 0, CMD_MAX_ARG },
+    [DDR_CMD_FWLOG]        = { "fwlog"      , 0, 0 },
+    [DDR_CMD_RETREGS]      = { "retregs"    , 0, 0 },
+    [DDR_CMD_PSTATE]       = { "pstate"     , 0, 1 },
+    [DDR_CMD_SWEEP]        = { "sweep"      , 0, 4 },
+    [DDR_CMD_MAP]          = { "map"        , 0, 3 },
+    [DDR_CMD_PMU]          = { "pmu"        , 0, 2 },
+    [DDR_CMD_MARGIN]       = { "margin"     , 1, 3 },
+    [DDR_CMD_SHMOO]        = { "shmoo"      , 3, 5 },
+    [DDR_CMD_DMA]          = { "dma"        , 0, CMD_MAX_ARG },
+    [DDR_CMD_UART]         = { "uart"       , 0, 2 },
+    [DDR_CMD_SCRIPT]       = { "script"     , 0, 3 },
+    [DDR_CMD_SNAP]         = { "snap"       , 0, 3 },
+    [DDR_CMD_ERRMAP]       = { "errmap"     , 0, 2 },
     [DDR_CMD_TEST_HELP]    = { "test help"  , 0, 0 },
 };
 
@@ -144,20 +234,134 @@ const ddr_command ddr_cmd[DDR_CMD_MAX] = {
 /* Private variables ---------------------------------------------------------*/
 extern HAL_DDR_ConfigTypeDef static_ddr_config;
 
+static test_report report[DDR_REPORT_MAX];
+static int report_nb;
+
+/* address sweep of the pattern tests: configuration and selected sweep */
+static DDR_AddrSweepTypeDef sweep_cfg = {
+  .nb_range = 0,
+  .stride = DDR_ADDR_STRIDE_MIN,
+  .order = DDR_ADDR_ORDER_LINEAR,
+  .seed = 1,
+};
+static DDR_AddrSweepTypeDef sweep_sel;
+static bool sweep_active;
+
+/* frequency shmoo in progress, over the DDR initializations */
+static struct {
+  bool active;
+  bool restore;                   /* back to the initial frequency */
+  int test[SHMOO_TEST_MAX];       /* test[] index of the selected tests */
+  int test_nb;
+  unsigned long size;             /* [size] of the tests, 0 for default */
+  shmoo_point point[SHMOO_POINT_MAX];
+  int point_nb;
+  int current;
+  uint64_t pll2_rate;             /* initial PLL2 rate in Hz */
+  uint32_t speed;                 /* initial DDR speed in kHz */
+  int32_t uib_frequency;          /* initial PHY frequency in MHz */
+} shmoo;
+
+/* jobs of the DMA traffic generator, one per channel */
+static struct {
+  DDR_DmaJobTypeDef job[DDR_DMA_CHANNEL_MAX];
+  uint32_t nb_job;
+  bool circular;
+} dma_cfg;
+
+/* step where the console returns, -1 before the interactive mode */
+static int next_step = -1;
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
+/* effective bandwidth in MB/s (written + read bytes) */
+static unsigned long test_report_bandwidth(const test_report *rep)
+{
+  if (rep->time_us == 0U)
+  {
+    return 0UL;
+  }
+
+  return (unsigned long)((rep->written + rep->read) / rep->time_us);
+}
+
+static void test_report_start(uint64_t *start)
+{
+  DDR_Test_ResetTraffic();
+  *start = time_get_counter();
+}
+
+/* record and print the result of the test i started at start */
+static void test_report_add(int i, uint32_t result, uint64_t start)
+{
+  test_report *rep;
+  test_report last;
+
+  rep = (report_nb < DDR_REPORT_MAX) ? &report[report_nb++] : &last;
+
+  rep->time_us = time_elapsed_us(start);
+  rep->id = i;
+  rep->result = result;
+  DDR_Test_GetTraffic(&rep->written, &rep->read);
+
+  printf("  %lu.%03lu ms, write 0x%lx, read 0x%lx, %lu MB/s\n\r",
+         (unsigned long)(rep->time_us / 1000U),
+         (unsigned long)(rep->time_us % 1000U),
+         rep->written, rep->read, test_report_bandwidth(rep));
+
+#ifdef DDR_TEST_REPORT_CSV
+  printf("csv,%d,%s,%d,%lu,%lu,%lu,%lu\n\r", i, test[i].name, (int)result,
+         (unsigned long)rep->time_us, rep->written, rep->read,
+         test_report_bandwidth(rep));
+#endif
+}
+
+static void test_report_summary(void)
+{
+  uint64_t time_us = 0;
+  int i;
+
+  printf("\n\r %2s  %-32s %6s %12s %12s %12s %8s\n\r", "id", "name", "result",
+         "time (us)", "write", "read", "MB/s");
+
+  for (i = 0; i < report_nb; i++)
+  {
+    printf(" %2d  %-32s %6s %12lu %12lu %12lu %8lu\n\r", report[i].id,
+           test[report[i].id].name, (report[i].result == 0) ? "Pass" : "KO",
+           (unsigned long)report[i].time_us, report[i].written,
+           report[i].read, test_report_bandwidth(&report[i]));
+    time_us += report[i].time_us;
+  }
+
+  printf(" total time %lu.%03lu ms\n\r\n\r", (unsigned long)(time_us / 1000U),
+         (unsigned long)(time_us % 1000U));
+}
+
 static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr)
 {
   uint32_t ret = 0;
+  uint32_t error = 0;
+  uint64_t start;
   int i;
 
+  report_nb = 0;
+
 #ifdef TEST_INFINITE_ENABLE
   for (i = 1; i < (int)test_nb - 2; i++)
 #else
   for (i = 1; i < (int)test_nb; i++)
 #endif
   {
+    /* performance measurement only, not a test */
+    if (test[i].fct == DDR_Test_Benchmark)
+    {
+      continue;
+    }
+
+    test_report_start(&start);
+    DDR_ErrMap_SetTest(test[i].name);
+
     switch (test[i].max_args)
     {
       case 1:
@@ -193,13 +397,27 @@ static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr)
     if (ret != 0)
     {
       printf("%s failed [%d]\n\r", test[i].name, ret);
-      return ret;
+      test_report_add(i, ret, start);
+      /* with the error map, the next tests are executed */
+      if (!DDR_ErrMap_IsEnabled())
+      {
+        test_report_summary();
+        return ret;
+      }
+      if (error == 0)
+      {
+        error = ret;
+      }
+      continue;
     }
 
     printf("result %d:%s = Passed\n\r", i, test[i].name);
+    test_report_add(i, ret, start);
   }
 
-  return ret;
+  test_report_summary();
+
+  return error;
 }
 
 static void get_entry_string(char *entry)
@@ -207,6 +425,8 @@ static void get_entry_string(char *entry)
   uint8_t user_entry_valid = 0;
   char user_entry_value = 0;
   int i = 0;
+  /* command of the script in progress */
+  bool script = DDR_Script_GetLine(entry, CMD_MAX_LEN);
 
   Serial_Putchar(0xd);
   Serial_Putchar('D');
@@ -214,6 +434,12 @@ static void get_entry_string(char *entry)
   Serial_Putchar('R');
   Serial_Putchar('>');
 
+  if (script)
+  {
+    printf("%s\n\r", entry);
+    return;
+  }
+
   while(user_entry_valid == 0)
   {
     /* Scan for user entry */
@@ -384,6 +610,80 @@ static void print_usage(void)
     "go                         continues the DDR TOOL execution\n\r"
     "reset                      reboots machine\n\r"
     "test [help] | <n> [...]    lists (with help) or executes test <n>\n\r"
+    "test par <n> [...]         executes test <n> on all cores, [size] and\n\r"
+    "                           [addr] range split between the cores\n\r"
+    "                           (whole DDR when absent), <n>=0 for all tests\n\r"
+    "                           not supported with a write-back mapping\n\r"
+    "fwlog                      dumps the training firmware messages and\n\r"
+    "                           the duration of each training phase\n\r"
+    "retregs                    dumps the PHY retention registers and the\n\r"
+    "                           duration of their last save and restore\n\r"
+    "pstate                     displays the frequency, the training result\n\r"
+    "                           and time of each PHY pstate\n\r"
+    "pstate <n>                 switches to the trained pstate <n> and\n\r"
+    "                           displays the switch latency, when <n> runs\n\r"
+    "                           with the pstate 0 timings: not faster, same\n\r"
+    "                           DFI ratio and latency mode registers\n\r"
+    "sweep                      displays the address sweep used by the\n\r"
+    "                           pattern tests 10 to 16 instead of [size]\n\r"
+    "                           and [addr]\n\r"
+    "sweep range <addr> <size>  adds a range to the sweep (whole DDR when\n\r"
+    "                           absent) and selects it\n\r"
+    "sweep order <order> [stride] [seed]\n\r"
+    "                           selects the sweep with <order> = linear,\n\r"
+    "                           bank, row or random, by [stride] bytes\n\r"
+    "sweep off                  removes the ranges, restores [size] [addr]\n\r"
+    "map                        displays the memory attributes of the DDR\n\r"
+    "map <addr> <size> <attr>   remaps a DDR range aligned on 2MB with\n\r"
+    "                           <attr> = wb (write-back cacheable), nc\n\r"
+    "                           (non-cacheable, default) or device\n\r"
+    "pmu                        displays the CPU PMU events measured\n\r"
+    "                           around each test\n\r"
+    "pmu on|off                 enables or disables the PMU measure\n\r"
+    "pmu <counter> <event>      selects the event of a counter\n\r"
+    "margin rd|wr [<byte> [<lane>]]\n\r"
+    "                           eye margin of the PHY read (RxPBDly) or\n\r"
+    "                           write (TxDqDly) DQ delays of each lane,\n\r"
+    "                           with the read VREF (VrefDAC0) for one lane\n\r"
+    "shmoo <start> <end> <step> [<tests> [<size>]]\n\r"
+    "                           initializes and trains the DDR at each\n\r"
+    "                           frequency from <start> to <end> kHz, runs\n\r"
+    "                           the <tests> (list n,n,... default 1,2,3,4)\n\r"
+    "                           and prints the result and bandwidth table\n\r"
+    "dma                        displays the DMA jobs\n\r"
+    "dma copy <src> <dst> <size>\n\r"
+    "dma fill <dst> <size> [<pattern>]\n\r"
+    "                           adds a job executed by one DMA channel\n\r"
+    "dma mode single|circular   executes the jobs once or in loop\n\r"
+    "dma off                    removes the jobs\n\r"
+    "dma test [<n> [args]]      runs the jobs during the test <n>, or\n\r"
+    "                           alone, and prints their throughput\n\r"
+    "uart                       displays the console output buffer\n\r"
+    "uart drop on|off           drops the output on a full buffer instead\n\r"
+    "                           of waiting for the UART\n\r"
+    "uart reset                 resets the counters\n\r"
+    "script                     displays the script\n\r"
+    "script load                uploads a script: the next lines up to\n\r"
+    "                           a line \"end\"\n\r"
+    "script builtin             selects the script built in the binary\n\r"
+    "script run [<loops>] [stop]\n\r"
+    "                           executes the script <loops> times (default\n\r"
+    "                           1, 0 = forever), stopped on a failure with\n\r"
+    "                           stop, then prints a summary\n\r"
+    "script stop                stops the script\n\r"
+    "snap                       displays the register snapshots\n\r"
+    "snap save <n>              captures the registers in the snapshot <n>\n\r"
+    "snap diff <n> [<m>]        prints the registers changed from the\n\r"
+    "                           snapshot <n> to <m> or to the current ones\n\r"
+    "snap restore <n>           writes back the registers of snapshot <n>\n\r"
+    "snap dump <n>              prints the snapshot <n> in hex and\n\r"
+    "snap layout                the register names, for the host decoder\n\r"
+    "errmap                     displays the error map of the last test\n\r"
+    "errmap on [<lines>]        the tests continue after a data error and\n\r"
+    "                           count the errors per DQ, byte lane, bank,\n\r"
+    "                           row, column and test, with <lines> error\n\r"
+    "                           lines printed (default 32)\n\r"
+    "errmap off                 the tests stop at the first error\n\r"
     "\n\rwith for [type|reg]:\n\r"
     "  all registers if absent\n\r"
     "  <type> = ctl, uib, uia, uim, uis\n\r"
@@ -419,6 +719,7 @@ static bool check_step(HAL_DDR_InteractStepTypeDef step,
   {
     printf("invalid step %d:%s expecting %d:%s\n\r",
            step, step_str[step], expected, step_str[expected]);
+    DDR_Script_Result(false);
     return false;
   }
 
@@ -589,6 +890,49 @@ static bool do_freq(int argc, char *argv[])
   return ret_code;
 }
 
+static void do_pstate(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
+{
+  unsigned long pstate;
+  uint64_t start;
+  uint64_t latency;
+  char *end_ptr;
+
+  if (argc == 1)
+  {
+    HAL_DDR_Dump_PState();
+    printf("current pstate %lu, DDRPHY = %ld kHz\n\r",
+           (unsigned long)HAL_DDR_Get_PState(),
+           (2 * (unsigned long)HAL_RCCEx_GetPLL2ClockFreq()) / 1000);
+    return;
+  }
+
+  if (!check_step(step, STEP_DDR_READY))
+  {
+    return;
+  }
+
+  pstate = strtoul(argv[0], &end_ptr, 0);
+  if ((end_ptr == argv[0]) || (*end_ptr != '\0'))
+  {
+    printf("invalid argument %s\n\r", argv[0]);
+    return;
+  }
+
+  start = time_get_counter();
+  if (HAL_DDR_Set_PState((uint32_t)pstate) != HAL_OK)
+  {
+    printf("pstate %lu switch failed\n\r", pstate);
+    return;
+  }
+  latency = time_get_counter() - start;
+
+  printf("pstate %lu, DDRPHY = %ld kHz, switch in %lu us (%lu ns)\n\r",
+         (unsigned long)HAL_DDR_Get_PState(),
+         (2 * (unsigned long)HAL_RCCEx_GetPLL2ClockFreq()) / 1000,
+         (unsigned long)time_counter_to_us(latency),
+         (unsigned long)time_counter_to_ns(latency));
+}
+
 static void do_param(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
 {
   char reg_name[(argc == 1)? 0 : strlen(argv[0])];
@@ -604,6 +948,7 @@ static void do_param(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
     if (HAL_DDR_Dump_Param(&static_ddr_config, reg_name) != HAL_OK)
     {
       printf("invalid argument %s\n\r", argv[0]);
+      DDR_Script_Result(false);
     }
     break;
   case 3:
@@ -612,7 +957,8 @@ static void do_param(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
       return;
     }
     HAL_DDR_Convert_Case(argv[0], reg_name, 1); /* convert to upper case */
-    HAL_DDR_Edit_Param(&static_ddr_config, reg_name, argv[1]);
+    DDR_Script_Result(HAL_DDR_Edit_Param(&static_ddr_config, reg_name,
+                                         argv[1]) == HAL_OK);
     break;
   }
 }
@@ -668,10 +1014,15 @@ static HAL_DDR_InteractStepTypeDef do_step(HAL_DDR_InteractStepTypeDef step,
         goto end;
       }
       printf("step to %d:%s\n\r", (int)value, step_str[value]);
+      DDR_Script_Result(true);
       return (HAL_DDR_InteractStepTypeDef)value;
+
+    default:
+      return step;
   };
 
 end:
+  DDR_Script_Result(false);
   return step;
 }
 
@@ -679,6 +1030,7 @@ static char argv0[CMD_MAX_LEN / 4] = "\0";
 static char argv1[CMD_MAX_LEN / 4] = "\0";
 static char argv2[CMD_MAX_LEN / 4] = "\0";
 static char argv3[CMD_MAX_LEN / 4] = "\0";
+static char argv4[CMD_MAX_LEN / 4] = "\0";
 
 static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
                       const int size)
@@ -687,6 +1039,8 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
   int64_t value;
   int local_argc = argc;
   uint32_t retcode;
+  DDR_PmuCountTypeDef pmu;
+  bool pmu_on = DDR_PMU_IsEnabled();
 
   if (local_argc == 1)
   {
@@ -701,6 +1055,7 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
   {
     printf("Unknown sub command [%s]\n\r\n\r", argv[0]);
     print_subcmd_usage(array, size);
+    DDR_Script_Result(false);
     return;
   }
 
@@ -743,6 +1098,7 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
     /* any other cases */
     printf("Incorrect number of arguments\n\r\n\r");
     print_single_subcmd_usage(array, value);
+    DDR_Script_Result(false);
     return;
   }
 
@@ -753,10 +1109,22 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
     {
       printf("Invalid argument #%d %s\n\r\n\r", i, argv[i]);
       print_single_subcmd_usage(array, value);
+      DDR_Script_Result(false);
       return;
     }
   }
 
+  if (array == test)
+  {
+    DDR_ErrMap_Start();
+    DDR_ErrMap_SetTest(array[value].name);
+  }
+
+  if (pmu_on)
+  {
+    DDR_PMU_Start();
+  }
+
   switch (array[value].max_args)
   {
     case 0:
@@ -780,6 +1148,19 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
       break;
   }
 
+  if (pmu_on)
+  {
+    DDR_PMU_Stop(&pmu);
+    DDR_PMU_Print(&pmu);
+  }
+
+  if ((array == test) && DDR_ErrMap_IsEnabled())
+  {
+    DDR_ErrMap_Print();
+  }
+
+  DDR_Script_Result(retcode == 0);
+
   if (retcode != 0)
   {
     printf("%s failed [%d]\n\r", array[value].name, retcode);
@@ -789,126 +1170,1579 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
     printf("Result: Pass [%s]\n\r", array[value].name);
 }
 
-bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
+static void sweep_print(void)
 {
-  char buffer[CMD_MAX_LEN];
-  char *argv[CMD_MAX_ARG + 1] = {argv0, argv1, argv2, argv3}; /* NULL terminated */
-  int argc;
-  int cmd;
-  static int next_step = -1;
+  uint32_t i;
 
-  if ((next_step < 0) && (step == STEP_DDR_RESET))
+  if (!sweep_active)
   {
-    next_step = STEP_DDR_RESET;
+    printf("sweep off\n\r");
+    return;
   }
 
-//  printf("** step %d ** %s / %d\n\r", step, step_str[step], next_step);
+  printf("sweep %s, stride 0x%lx, step 0x%lx, seed 0x%lx\n\r",
+         DDR_AddrIter_OrderName(sweep_sel.order), sweep_sel.stride,
+         DDR_AddrIter_GetStep(sweep_sel.order, sweep_sel.stride),
+         sweep_sel.seed);
+  for (i = 0; i < sweep_sel.nb_range; i++)
+  {
+    printf("  range %d: 0x%lx..0x%lx\n\r", (int)i,
+           (unsigned long)sweep_sel.range[i].base,
+           (unsigned long)sweep_sel.range[i].base + sweep_sel.range[i].size - 1UL);
+  }
+}
 
-  if (next_step < 0)
+/* select the configured sweep, on the whole DDR when no range is defined */
+static void sweep_select(void)
+{
+  sweep_sel = sweep_cfg;
+  if (sweep_sel.nb_range == 0U)
   {
-    return false;
+    sweep_sel.range[0].base = (uintptr_t)DDR_MEM_BASE;
+    sweep_sel.range[0].size = DDR_MEM_SIZE & ~(sweep_sel.stride - 1UL);
+    sweep_sel.nb_range = 1U;
   }
 
-  if (step > STEP_RUN)
+  if (DDR_Test_SetSweep(&sweep_sel) != 0)
   {
-    printf("** step %d ** INVALID\n\r", step);
-    return false;
+    printf("invalid sweep: stride and ranges shall be aligned on a power of 2 >= 0x%lx\n\r",
+           DDR_ADDR_STRIDE_MIN);
+    return;
   }
 
-  printf("%d:%s\n\r", step, step_str[step]);
+  sweep_active = true;
+}
 
-  if ((HAL_DDR_InteractStepTypeDef)next_step > step)
+static void do_sweep(int argc, char *argv[])
+{
+  int64_t addr, size, value;
+  int order;
+
+  if (argc == 1)
   {
-    return false;
+    sweep_print();
+    return;
   }
 
-  while ((HAL_DDR_InteractStepTypeDef)next_step == step)
+  if (!strcmp(argv[0], "off") && (argc == 2))
   {
-    get_entry_string(buffer);
-
-    argc = parse_entry_string(buffer, strlen(buffer), &cmd, argv);
-    if (argc < 0)
+    (void)DDR_Test_SetSweep(NULL);
+    sweep_active = false;
+    sweep_cfg.nb_range = 0U;
+  }
+  else if (!strcmp(argv[0], "range") && (argc == 4))
+  {
+    addr = string_to_num(argv[1]);
+    size = string_to_num(argv[2]);
+    if (   (addr < (int64_t)DDR_MEM_BASE) || (size <= 0)
+        || ((uint64_t)(addr + size) > ((uint64_t)DDR_MEM_BASE + DDR_MEM_SIZE)))
     {
-      printf("Error [%d]\n\r", argc);
-      continue;
+      printf("invalid range %s %s\n\r", argv[1], argv[2]);
+      return;
     }
-    else if (argc == 0)
+    if (sweep_cfg.nb_range >= DDR_ADDR_RANGE_MAX)
     {
-      continue;
+      printf("too many ranges (max=%d)\n\r", DDR_ADDR_RANGE_MAX);
+      return;
     }
-
-    switch (cmd)
+    sweep_cfg.range[sweep_cfg.nb_range].base = (uintptr_t)addr;
+    sweep_cfg.range[sweep_cfg.nb_range].size = (unsigned long)size;
+    sweep_cfg.nb_range++;
+    sweep_select();
+    if (!sweep_active)
     {
-    case DDR_CMD_HELP:
-      print_usage();
-      break;
-
-    case DDR_CMD_TEST_HELP:
-      print_subcmd_usage(test, test_nb);
-      break;
-
-    case DDR_CMD_INFO:
-      do_info(step, argc, argv);
-      break;
-
-    case DDR_CMD_FREQ:
-      do_freq(argc, argv);
-      if ((argc == 2) && (step > STEP_CTL_INIT))
+      sweep_cfg.nb_range--;
+    }
+  }
+  else if (!strcmp(argv[0], "order") && (argc >= 3))
+  {
+    for (order = 0; order < (int)DDR_ADDR_ORDER_MAX; order++)
+    {
+      if (!strcmp(argv[1], DDR_AddrIter_OrderName(order)))
       {
-        printf("### Please update PLL settings and DDR timings ###\n\r");
-        printf("### in your project. Then rebuild and restart. ###\n\r");
+        break;
       }
-      break;
-
-    case DDR_CMD_RESET:
-      WRITE_REG(RCC->GRSTCSETR, 0x1U);
-      break;
+    }
+    if (order == (int)DDR_ADDR_ORDER_MAX)
+    {
+      printf("invalid order %s\n\r", argv[1]);
+      return;
+    }
+    if (argc >= 4)
+    {
+      value = string_to_num(argv[2]);
+      if (value <= 0)
+      {
+        printf("invalid stride %s\n\r", argv[2]);
+        return;
+      }
+      sweep_cfg.stride = (unsigned long)value;
+    }
+    if (argc == 5)
+    {
+      value = string_to_num(argv[3]);
+      if (value < 0)
+      {
+        printf("invalid seed %s\n\r", argv[3]);
+        return;
+      }
+      sweep_cfg.seed = (unsigned long)value;
+    }
+    sweep_cfg.order = (DDR_AddrOrderTypeDef)order;
+    sweep_select();
+  }
+  else
+  {
+    printf("invalid sweep command\n\r");
+    return;
+  }
 
-    case DDR_CMD_PARAM:
-      do_param(step, argc, argv);
-      break;
+  sweep_print();
+}
 
-    case DDR_CMD_PRINT:
-      do_print(argc, argv);
-      break;
+/* DDR ranges with the same memory attributes */
+static void map_print(void)
+{
+  uintptr_t end = (uintptr_t)DDR_MEM_BASE + DDR_MEM_SIZE;
+  uintptr_t start = (uintptr_t)DDR_MEM_BASE;
+  uintptr_t addr;
+  DDR_MmuAttrTypeDef attr = DDR_MMU_GetAttr(start);
 
-    case DDR_CMD_EDIT:
-      HAL_DDR_Edit_Reg(argv0, argv1);
-      break;
+  for (addr = start; addr < end; addr += DDR_MMU_GRANULE)
+  {
+    if (   ((addr + DDR_MMU_GRANULE) >= end)
+        || (DDR_MMU_GetAttr(addr + DDR_MMU_GRANULE) != attr))
+    {
+      printf("  0x%lx..0x%lx: %s\n\r", (unsigned long)start,
+             (unsigned long)(addr + DDR_MMU_GRANULE - 1UL),
+             DDR_MMU_AttrName(attr));
+      start = addr + DDR_MMU_GRANULE;
+      attr = DDR_MMU_GetAttr(start);
+    }
+  }
+}
 
-    case DDR_CMD_SAVE:
-      HAL_DDR_Dump_Reg(NULL, true);
-      break;
+static void do_map(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
+{
+  int64_t addr, size;
+  int attr;
 
-    case DDR_CMD_GO:
-      next_step = STEP_RUN;
-      printf("### Exit DDR INTERACTIVE mode. Please RESET the BOARD ###\n\r");
-      break;
+  if (argc == 4)
+  {
+    if (!check_step(step, STEP_DDR_READY))
+    {
+      return;
+    }
 
-    case DDR_CMD_NEXT:
-      next_step = step + 1;
-      if (next_step == STEP_RUN)
+    for (attr = 0; attr < (int)DDR_MMU_ATTR_MAX; attr++)
+    {
+      if (!strcmp(argv[2], DDR_MMU_AttrName(attr)))
       {
-        printf("### Exit DDR INTERACTIVE mode. Please RESET the BOARD ###\n\r");
+        break;
       }
-      break;
+    }
+    if (attr == (int)DDR_MMU_ATTR_MAX)
+    {
+      printf("invalid attributes %s\n\r", argv[2]);
+      return;
+    }
 
-    case DDR_CMD_STEP:
-      next_step = do_step(step, argc, argv);
-      break;
+    addr = string_to_num(argv[0]);
+    size = string_to_num(argv[1]);
+    if (   (addr < 0) || (size <= 0)
+        || (DDR_MMU_Map((uintptr_t)addr, (unsigned long)size,
+                        (DDR_MmuAttrTypeDef)attr) != 0))
+    {
+      printf("invalid range: aligned on 0x%lx inside the DDR, or too many 1GB blocks partially remapped\n\r",
+             DDR_MMU_GRANULE);
+      return;
+    }
+  }
+  else if (argc != 1)
+  {
+    printf("invalid map command\n\r");
+    return;
+  }
 
-    case DDR_CMD_TEST:
-      if (!check_step(step, STEP_DDR_READY))
-      {
-        continue;
-      }
-      do_subcmd(argc, argv, test, test_nb);
-      break;
+  map_print();
+}
 
-    default:
-      break;
+static void pmu_print(void)
+{
+  uint32_t nb = DDR_PMU_GetNbCounters();
+  uint32_t event;
+  uint32_t i;
+
+  printf("pmu %s, %lu event counters\n\r", DDR_PMU_IsEnabled() ? "on" : "off",
+         (unsigned long)nb);
+
+  for (i = 0; i < nb; i++)
+  {
+    event = DDR_PMU_GetEvent(i);
+    printf("  %lu: 0x%02lx %s\n\r", (unsigned long)i, (unsigned long)event,
+           DDR_PMU_EventName(event));
+  }
+}
+
+static void do_pmu(int argc, char *argv[])
+{
+  int64_t counter, event;
+
+  if (argc == 2)
+  {
+    if (!strcmp(argv[0], "on") || !strcmp(argv[0], "off"))
+    {
+      DDR_PMU_Enable(!strcmp(argv[0], "on"));
+    }
+    else
+    {
+      printf("invalid argument %s\n\r", argv[0]);
+      return;
+    }
+  }
+  else if (argc == 3)
+  {
+    counter = string_to_num(argv[0]);
+    event = string_to_num(argv[1]);
+    if ((counter < 0) || (event < 0) ||
+        (DDR_PMU_SetEvent((uint32_t)counter, (uint32_t)event) != 0))
+    {
+      printf("invalid counter %s or event %s\n\r", argv[0], argv[1]);
+      return;
     }
   }
 
-  return next_step == STEP_DDR_RESET;
+  pmu_print();
+}
+
+/* DBYTE CSR of a lane: DBYTE lane / 8, DQ lane % 8, pstate 0 */
+static uintptr_t margin_dq_csr(uint32_t lane, uint32_t csr)
+{
+  return DDRPHYC_BASE + (4U * (TDBYTE | P0 | ((lane / MARGIN_DQ_NB) * BB1) |
+                               ((lane % MARGIN_DQ_NB) * R1) | csr));
+}
+
+static uint16_t margin_read_16(uintptr_t addr)
+{
+  return (uint16_t)READ_REG(*(volatile uint32_t *)addr);
+}
+
+static void margin_write_16(uintptr_t addr, uint16_t value)
+{
+  MODIFY_REG(*(volatile uint32_t *)addr, 0xFFFFU, (uint32_t)value);
+}
+
+static int32_t margin_rxpbdly_get(uint32_t lane)
+{
+  return (int32_t)(margin_read_16(margin_dq_csr(lane, CSR_RXPBDLYTG0_ADDR)) &
+                   CSR_RXPBDLYTG0_MASK);
+}
+
+static void margin_rxpbdly_set(uint32_t lane, int32_t pos)
+{
+  margin_write_16(margin_dq_csr(lane, CSR_RXPBDLYTG0_ADDR), (uint16_t)pos);
+}
+
+/* coarse and fine delays seen as a number of fine steps */
+static int32_t margin_txdqdly_get(uint32_t lane)
+{
+  uint16_t value = margin_read_16(margin_dq_csr(lane, CSR_TXDQDLYTG0_ADDR));
+
+  return (int32_t)(((value & CSR_TXDQDLYTG0_MASK) >> MARGIN_TXDQ_COARSE_POS) *
+                   MARGIN_TXDQ_FINE_NB) +
+         (int32_t)(value & (MARGIN_TXDQ_FINE_NB - 1));
+}
+
+static void margin_txdqdly_set(uint32_t lane, int32_t pos)
+{
+  margin_write_16(margin_dq_csr(lane, CSR_TXDQDLYTG0_ADDR),
+                  (uint16_t)(((pos / MARGIN_TXDQ_FINE_NB) <<
+                              MARGIN_TXDQ_COARSE_POS) |
+                             (pos % MARGIN_TXDQ_FINE_NB)));
+}
+
+static int32_t margin_vref_get(uint32_t lane)
+{
+  return (int32_t)(margin_read_16(margin_dq_csr(lane, CSR_VREFDAC0_ADDR)) &
+                   CSR_VREFDAC0_MASK);
+}
+
+static void margin_vref_set(uint32_t lane, int32_t pos)
+{
+  margin_write_16(margin_dq_csr(lane, CSR_VREFDAC0_ADDR), (uint16_t)pos);
+}
+
+/*
+ * data bits of the DBYTE of a lane in the 64-bit words of the kernel, each
+ * word holding 2 beats of the 32-bit bus or 4 beats of the 16-bit bus
+ */
+static unsigned long margin_lane_mask(uint32_t lane)
+{
+  uint32_t width;
+  unsigned long mask = 0UL;
+  uint32_t bit;
+
+  width = 32U >> ((READ_REG(DDRC->MSTR) & DDRC_MSTR_DATA_BUS_WIDTH_Msk) >>
+                  DDRC_MSTR_DATA_BUS_WIDTH_Pos);
+
+  for (bit = (lane / MARGIN_DQ_NB) * 8U; bit < (sizeof(unsigned long) * 8U);
+       bit += width)
+  {
+    mask |= 0xFFUL << bit;
+  }
+
+  return mask;
+}
+
+/* the kernel reads the DDR and not the cache of a range mapped write-back */
+static void margin_flush(uintptr_t addr, unsigned long size)
+{
+  if (DDR_MMU_IsCacheable(addr, size))
+  {
+    DDR_MMU_CleanInvalidate(addr, size);
+  }
+}
+
+static void do_margin(int argc, char *argv[])
+{
+  static DDR_MarginAxisTypeDef rxpbdly = {
+    "RxPBDly", 0, CSR_RXPBDLYTG0_MASK, 0U,
+    margin_rxpbdly_get, margin_rxpbdly_set
+  };
+  static DDR_MarginAxisTypeDef txdqdly = {
+    "TxDqDly", 0, (8 * MARGIN_TXDQ_FINE_NB) - 1, 0U,
+    margin_txdqdly_get, margin_txdqdly_set
+  };
+  static const DDR_MarginAxisTypeDef vref = {
+    "VrefDAC0", 0, CSR_VREFDAC0_MASK, 0U,
+    margin_vref_get, margin_vref_set
+  };
+  DDR_MarginCfgTypeDef cfg = {
+    .x_range = MARGIN_DLY_RANGE,
+    .x_step = MARGIN_DLY_STEP,
+    .y_range = MARGIN_VREF_RANGE,
+    .y_step = MARGIN_VREF_STEP,
+    .lane_name = "DQ",
+    .lane_mask = margin_lane_mask,
+    .addr = (uintptr_t)DDR_MEM_BASE,
+    .size = MARGIN_SIZE,
+    .flush = margin_flush,
+  };
+  uint32_t nb_byte;
+  uint64_t ui_fs;
+  int64_t byte, lane;
+
+  if (!strcmp(argv[0], "rd"))
+  {
+    cfg.x = &rxpbdly;
+  }
+  else if (!strcmp(argv[0], "wr"))
+  {
+    cfg.x = &txdqdly;
+  }
+  else
+  {
+    printf("invalid argument %s\n\r", argv[0]);
+    return;
+  }
+
+  nb_byte = 4U >> ((READ_REG(DDRC->MSTR) & DDRC_MSTR_DATA_BUS_WIDTH_Msk) >>
+                   DDRC_MSTR_DATA_BUS_WIDTH_Pos);
+  cfg.lane = 0U;
+  cfg.nb_lane = nb_byte * MARGIN_DQ_NB;
+
+  if (argc >= 3)
+  {
+    byte = string_to_num(argv[1]);
+    if ((byte < 0) || (byte >= (int64_t)nb_byte))
+    {
+      printf("invalid byte %s (max=%d)\n\r", argv[1], (int)nb_byte - 1);
+      return;
+    }
+    cfg.lane = (uint32_t)byte * MARGIN_DQ_NB;
+    cfg.nb_lane = MARGIN_DQ_NB;
+  }
+
+  if (argc == 4)
+  {
+    lane = string_to_num(argv[2]);
+    if ((lane < 0) || (lane >= (int64_t)MARGIN_DQ_NB))
+    {
+      printf("invalid lane %s (max=%d)\n\r", argv[2], (int)MARGIN_DQ_NB - 1);
+      return;
+    }
+    cfg.lane += (uint32_t)lane;
+    cfg.nb_lane = 1U;
+#if !STM32MP_DDR3_TYPE
+    /* 2D eye of the read delay and of the receiver VREF of the lane */
+    if (cfg.x == &rxpbdly)
+    {
+      cfg.y = &vref;
+    }
+#endif /* !STM32MP_DDR3_TYPE */
+  }
+
+  if (HAL_RCCEx_GetPLL2ClockFreq() == 0U)
+  {
+    printf("invalid DDR frequency\n\r");
+    return;
+  }
+
+  /* fine steps of 1/32 UI, UI = half period of the DDR PHY clock (2 * PLL2) */
+  ui_fs = 1000000000000000ULL / (4ULL * HAL_RCCEx_GetPLL2ClockFreq());
+  rxpbdly.tick_fs = (uint32_t)(ui_fs / MARGIN_TXDQ_FINE_NB);
+  txdqdly.tick_fs = (uint32_t)(ui_fs / MARGIN_TXDQ_FINE_NB);
+
+  /* CSR access from the APB, as for the PHY init */
+  margin_write_16(DDRPHYC_BASE + (4U * (TAPBONLY | CSR_MICROCONTMUXSEL_ADDR)),
+                  0x0U);
+
+  if (DDR_Margin_Run(&cfg) != 0)
+  {
+    printf("invalid margin configuration\n\r");
+  }
+
+  margin_write_16(DDRPHYC_BASE + (4U * (TAPBONLY | CSR_MICROCONTMUXSEL_ADDR)),
+                  0x1U);
+}
+
+/*
+ * Tests with [size] as first argument and [addr] as last one, the address
+ * range of which can be split between the cores. DDR_Test_Random is not
+ * listed: its sequence comes from the rand() state shared by the cores.
+ */
+static bool is_test_par(int i)
+{
+  return (   (test[i].fct == DDR_Test_MemDevice)
+          || (test[i].fct == DDR_Test_SimultaneousSwitchingOutput)
+          || (test[i].fct == DDR_Test_NoiseBurst)
+          || (test[i].fct == DDR_Test_FrequencySelectivePattern)
+          || (test[i].fct == DDR_Test_BlockSequential)
+          || (test[i].fct == DDR_Test_Checkerboard)
+          || (test[i].fct == DDR_Test_BitSpread)
+          || (test[i].fct == DDR_Test_BitFlip)
+          || (test[i].fct == DDR_Test_WalkingZeroes)
+          || (test[i].fct == DDR_Test_WalkingOnes));
+}
+
+static uint32_t DDR_Test_Par(int i, const unsigned long *args)
+{
+  DDR_MultiCore_JobTypeDef job[DDR_MULTICORE_MAX_CORES];
+  uint32_t nb_cores = DDR_MultiCore_GetNbCores();
+  uint8_t addr_idx = test[i].max_args - 1;
+  unsigned long addr;
+  unsigned long size;
+  unsigned long chunk;
+  uint32_t ret = 0;
+  uint32_t core;
+  int j;
+
+  addr = (args[addr_idx] != 0UL) ? args[addr_idx] : (unsigned long)DDR_MEM_BASE;
+  if (   (addr < (unsigned long)DDR_MEM_BASE)
+      || (addr >= ((unsigned long)DDR_MEM_BASE + DDR_MEM_SIZE)))
+  {
+    printf("Invalid address: 0x%lx\n\r", addr);
+    return 1;
+  }
+
+  size = args[0];
+  if (size == 0UL)
+  {
+    size = (unsigned long)DDR_MEM_BASE + DDR_MEM_SIZE - addr;
+  }
+
+  chunk = (size / nb_cores) & ~(DDR_PAR_CHUNK_ALIGN - 1UL);
+  if (chunk == 0UL)
+  {
+    printf("Size too low for %d cores: 0x%lx\n\r", (int)nb_cores, size);
+    return 1;
+  }
+
+  for (core = 0; core < nb_cores; core++)
+  {
+    job[core].fct = test[i].fct;
+    job[core].nb_args = test[i].max_args;
+    for (j = 0; j < test[i].max_args; j++)
+    {
+      job[core].args[j] = args[j];
+    }
+    job[core].args[0] = (core == (nb_cores - 1)) ?
+                        (size - (chunk * core)) : chunk;
+    job[core].args[addr_idx] = addr + (chunk * core);
+
+    printf("core %d: %s [0x%lx..0x%lx]\n\r", (int)core, test[i].name,
+           job[core].args[addr_idx],
+           job[core].args[addr_idx] + job[core].args[0] - 1UL);
+  }
+
+  for (core = 1; core < nb_cores; core++)
+  {
+    DDR_MultiCore_Start(core, &job[core]);
+  }
+
+  job[0].result = DDR_MultiCore_Exec(&job[0]);
+
+  /* barrier: merged report once all the cores are done */
+  for (core = 1; core < nb_cores; core++)
+  {
+    job[core].result = DDR_MultiCore_Wait(core);
+  }
+  /* output of the cores flushed once per test, not on each line */
+  fflush(stdout);
+
+  for (core = 0; core < nb_cores; core++)
+  {
+    if (job[core].result != 0)
+    {
+      printf("core %d: %s failed [%d] @ 0x%lx\n\r", (int)core, test[i].name,
+             (int)job[core].result, job[core].args[addr_idx]);
+      if (ret == 0)
+      {
+        ret = job[core].result;
+      }
+    }
+  }
+
+  return ret;
+}
+
+static void do_test_par(int argc, char *argv[])
+{
+  unsigned long args[3] = {0, 0, 0};
+  unsigned long test_args[3];
+  uint32_t retcode = 0;
+  uint64_t start;
+  int64_t value;
+  int i;
+
+  if (argc == 1)
+  {
+    printf("Please enter a sub command number\n\r\n\r");
+    print_subcmd_usage(test, test_nb);
+    return;
+  }
+
+  if (sweep_active)
+  {
+    printf("Parallel mode not supported with an address sweep (sweep off)\n\r");
+    return;
+  }
+
+  if (DDR_ErrMap_IsEnabled())
+  {
+    printf("Parallel mode not supported with the error map (errmap off)\n\r");
+    return;
+  }
+
+  /* the cores run with SMPEN cleared: their data caches are not coherent */
+  if (DDR_MMU_IsCacheable((uintptr_t)DDR_MEM_BASE, DDR_MEM_SIZE))
+  {
+    printf("Parallel mode not supported with a write-back mapping (map ... nc)\n\r");
+    return;
+  }
+
+  value = string_to_num(argv[0]);
+  if (   (value < 0) || (value >= test_nb)
+      || ((test[value].fct != DDR_Test_All) && !is_test_par(value)))
+  {
+    printf("Sub command [%s] not supported in parallel mode\n\r", argv[0]);
+    return;
+  }
+
+  if ((argc - 2) > test[value].max_args)
+  {
+    printf("Incorrect number of arguments\n\r\n\r");
+    print_single_subcmd_usage(test, value);
+    return;
+  }
+
+  /* missing arguments are set to 0, the default value of the tests */
+  for (i = 1; i <= (argc - 2); i++)
+  {
+    if (string_to_num(argv[i]) < 0)
+    {
+      printf("Invalid argument #%d %s\n\r\n\r", i, argv[i]);
+      print_single_subcmd_usage(test, value);
+      return;
+    }
+    args[i - 1] = (unsigned long)string_to_num(argv[i]);
+  }
+
+  if (DDR_MultiCore_GetNbCores() == 1U)
+  {
+    printf("Secondary core not available, test executed on core 0\n\r");
+  }
+
+  if (test[value].fct != DDR_Test_All)
+  {
+    retcode = DDR_Test_Par(value, args);
+  }
+  else
+  {
+    /* Test All arguments: [loop] [size] [addr] */
+    report_nb = 0;
+    for (i = 1; i < test_nb; i++)
+    {
+      if (!is_test_par(i))
+      {
+        continue;
+      }
+
+      test_args[0] = args[1];
+      test_args[1] = (test[i].fct == DDR_Test_NoiseBurst) ? 0UL : args[0];
+      test_args[test[i].max_args - 1] = args[2];
+
+      test_report_start(&start);
+      retcode = DDR_Test_Par(i, test_args);
+      if (retcode != 0)
+      {
+        test_report_add(i, retcode, start);
+        break;
+      }
+
+      printf("result %d:%s = Passed\n\r", i, test[i].name);
+      test_report_add(i, retcode, start);
+    }
+
+    test_report_summary();
+  }
+
+  DDR_Script_Result(retcode == 0);
+
+  if (retcode != 0)
+  {
+    printf("%s failed [%d]\n\r", test[value].name, retcode);
+    return;
+  }
+
+  printf("Result: Pass [%s]\n\r", test[value].name);
+}
+
+static bool is_test_shmoo(int i)
+{
+#ifdef TEST_INFINITE_ENABLE
+  if (   (test[i].fct == DDR_Test_Infinite_write)
+      || (test[i].fct == DDR_Test_Infinite_read))
+  {
+    return false;
+  }
+#endif
+
+  return test[i].fct != DDR_Test_All;
+}
+
+/* test list "n,n,..." */
+static bool shmoo_parse_tests(const char *list)
+{
+  const char *ptr = list;
+  char *end_ptr;
+  unsigned long id;
+
+  shmoo.test_nb = 0;
+
+  while (*ptr != '\0')
+  {
+    id = strtoul(ptr, &end_ptr, 0);
+    if (   (end_ptr == ptr) || (id >= (unsigned long)test_nb)
+        || !is_test_shmoo((int)id) || (shmoo.test_nb >= SHMOO_TEST_MAX))
+    {
+      return false;
+    }
+    shmoo.test[shmoo.test_nb++] = (int)id;
+
+    ptr = end_ptr;
+    if (*ptr == ',')
+    {
+      ptr++;
+    }
+    else if (*ptr != '\0')
+    {
+      return false;
+    }
+  }
+
+  return shmoo.test_nb != 0;
+}
+
+/* DDR speed, PHY frequency and PLL2 rate of the next initialization */
+static bool shmoo_set_freq(unsigned long freq)
+{
+  static_ddr_config.info.speed = (uint32_t)freq;
+  static_ddr_config.p_uib.frequency[0] = (int32_t)(freq / 1000UL);
+
+  /* DDR freq = PLL2 freq * 2 */
+  return pll2_set_rate(((uint64_t)freq * 1000U) / 2U);
+}
+
+static void shmoo_set_initial(void)
+{
+  static_ddr_config.info.speed = shmoo.speed;
+  static_ddr_config.p_uib.frequency[0] = shmoo.uib_frequency;
+
+  if (!pll2_set_rate(shmoo.pll2_rate))
+  {
+    printf("shmoo: initial frequency not restored\n\r");
+  }
+}
+
+/* select the next point, or the initial frequency after the last one */
+static void shmoo_next(void)
+{
+  while (++shmoo.current < shmoo.point_nb)
+  {
+    printf("shmoo point %d/%d: %lu kHz\n\r", shmoo.current + 1,
+           shmoo.point_nb, shmoo.point[shmoo.current].freq);
+    if (shmoo_set_freq(shmoo.point[shmoo.current].freq))
+    {
+      return;
+    }
+    printf("PLL2 setting failed\n\r");
+  }
+
+  shmoo.restore = true;
+  shmoo_set_initial();
+}
+
+static uint32_t shmoo_exec_test(int i)
+{
+  switch (test[i].max_args)
+  {
+    case 1:
+      return test[i].fct(0UL);
+    case 2:
+      if (   (test[i].fct == DDR_Test_DatabusWalk0)
+          || (test[i].fct == DDR_Test_DatabusWalk1)
+          || (test[i].fct == DDR_Test_Noise))
+      {
+        return test[i].fct(0UL, 0UL);
+      }
+      return test[i].fct(shmoo.size, 0UL);
+    default:
+      return test[i].fct(shmoo.size, 0UL, 0UL);
+  }
+}
+
+/* selected tests at the current point, with default arguments */
+static void shmoo_run(shmoo_point *point)
+{
+  unsigned long written;
+  unsigned long read;
+  uint64_t start;
+  uint32_t ret;
+  int i;
+
+  point->trained = true;
+
+  for (i = 0; i < shmoo.test_nb; i++)
+  {
+    test_report_start(&start);
+    ret = shmoo_exec_test(shmoo.test[i]);
+    point->time_us += time_elapsed_us(start);
+    DDR_Test_GetTraffic(&written, &read);
+    point->bytes += written + read;
+
+    printf("result %d:%s = %s\n\r", shmoo.test[i], test[shmoo.test[i]].name,
+           (ret == 0) ? "Passed" : "Failed");
+    if (ret != 0)
+    {
+      point->failed |= 1U << i;
+    }
+  }
+}
+
+static bool shmoo_point_pass(const shmoo_point *point)
+{
+  return point->trained && (point->failed == 0U);
+}
+
+/*
+ * table of the points and highest stable frequency: passing with all the
+ * lower frequencies of the shmoo
+ */
+static void shmoo_print(void)
+{
+  unsigned long stable = 0UL;
+  unsigned long fail = ~0UL;
+  const shmoo_point *point;
+  int i;
+  int j;
+
+  printf("\n\r %10s %5s", "freq (kHz)", "train");
+  for (i = 0; i < shmoo.test_nb; i++)
+  {
+    printf(" %4d", shmoo.test[i]);
+  }
+  printf(" %8s\n\r", "MB/s");
+
+  for (i = 0; i < shmoo.point_nb; i++)
+  {
+    point = &shmoo.point[i];
+    printf(" %10lu %5s", point->freq, point->trained ? "Pass" : "KO");
+    for (j = 0; j < shmoo.test_nb; j++)
+    {
+      printf(" %4s", !point->trained ? "-" :
+                     ((point->failed & (1U << j)) != 0U) ? "KO" : "Pass");
+    }
+    printf(" %8lu\n\r", (point->time_us != 0U) ?
+                        (unsigned long)(point->bytes / point->time_us) : 0UL);
+
+    if (!shmoo_point_pass(point) && (point->freq < fail))
+    {
+      fail = point->freq;
+    }
+  }
+
+  for (i = 0; i < shmoo.point_nb; i++)
+  {
+    point = &shmoo.point[i];
+    if (   shmoo_point_pass(point) && (point->freq < fail)
+        && (point->freq > stable))
+    {
+      stable = point->freq;
+    }
+  }
+
+  if (stable == 0UL)
+  {
+    printf(" no stable frequency\n\r\n\r");
+    return;
+  }
+
+  printf(" highest stable frequency: %lu kHz\n\r\n\r", stable);
+}
+
+/* shmoo <start> <end> <step> [<tests> [<size>]], true when started */
+static bool do_shmoo(int argc, char *argv[])
+{
+  unsigned long value[3];
+  unsigned long freq;
+  unsigned long range;
+  int i;
+
+  /* <start> <end> <step> in kHz */
+  for (i = 0; i < 3; i++)
+  {
+    if (string_to_num(argv[i]) <= 0)
+    {
+      printf("invalid argument %s\n\r", argv[i]);
+      return false;
+    }
+    value[i] = (unsigned long)string_to_num(argv[i]);
+  }
+
+  if (!shmoo_parse_tests((argc > 4) ? argv[3] : SHMOO_TEST_DFLT))
+  {
+    printf("invalid test list %s (max %d tests)\n\r", argv[3],
+           SHMOO_TEST_MAX);
+    return false;
+  }
+
+  shmoo.size = 0UL;
+  if (argc > 5)
+  {
+    if (string_to_num(argv[4]) < 0)
+    {
+      printf("invalid size %s\n\r", argv[4]);
+      return false;
+    }
+    shmoo.size = (unsigned long)string_to_num(argv[4]);
+  }
+
+  range = (value[1] >= value[0]) ? (value[1] - value[0]) :
+                                   (value[0] - value[1]);
+  if ((range / value[2]) >= SHMOO_POINT_MAX)
+  {
+    printf("too many points (max=%d)\n\r", SHMOO_POINT_MAX);
+    return false;
+  }
+
+  shmoo.pll2_rate = (uint64_t)HAL_RCCEx_GetPLL2ClockFreq();
+  if (shmoo.pll2_rate == 0U)
+  {
+    printf("Frequency has never been set before, no shmoo.\n\r");
+    return false;
+  }
+  shmoo.speed = static_ddr_config.info.speed;
+  shmoo.uib_frequency = static_ddr_config.p_uib.frequency[0];
+
+  shmoo.point_nb = (int)(range / value[2]) + 1;
+  for (i = 0; i < shmoo.point_nb; i++)
+  {
+    freq = (unsigned long)i * value[2];
+    memset(&shmoo.point[i], 0, sizeof(shmoo_point));
+    shmoo.point[i].freq = (value[1] >= value[0]) ? (value[0] + freq) :
+                                                   (value[0] - freq);
+  }
+
+  printf("shmoo from %lu to %lu kHz, %d points\n\r", value[0],
+         shmoo.point[shmoo.point_nb - 1].freq, shmoo.point_nb);
+
+  shmoo.active = true;
+  shmoo.restore = false;
+  shmoo.current = -1;
+  shmoo_next();
+
+  return true;
+}
+
+/* shmoo at DDR_READY: true to initialize the DDR at the next point */
+static bool shmoo_step(void)
+{
+  if (shmoo.restore)
+  {
+    shmoo.active = false;
+    shmoo_print();
+    return false;
+  }
+
+  shmoo_run(&shmoo.point[shmoo.current]);
+  shmoo_next();
+
+  return true;
+}
+
+static void dma_print(void)
+{
+  const DDR_DmaJobTypeDef *job;
+  uint32_t i;
+
+  printf("dma %s, %lu job(s)\n\r", dma_cfg.circular ? "circular" : "single",
+         (unsigned long)dma_cfg.nb_job);
+
+  for (i = 0; i < dma_cfg.nb_job; i++)
+  {
+    job = &dma_cfg.job[i];
+    if (job->op == DDR_DMA_COPY)
+    {
+      printf("  %lu: copy 0x%lx -> 0x%lx, 0x%lx bytes\n\r", (unsigned long)i,
+             (unsigned long)job->src, (unsigned long)job->dst, job->size);
+    }
+    else
+    {
+      printf("  %lu: fill 0x%lx, 0x%lx bytes with 0x%08lx\n\r",
+             (unsigned long)i, (unsigned long)job->dst, job->size,
+             (unsigned long)job->pattern);
+    }
+  }
+}
+
+/* dma copy <src> <dst> <size> | dma fill <dst> <size> [<pattern>] */
+static void dma_add_job(int argc, char *argv[])
+{
+  DDR_DmaJobTypeDef *job;
+  bool copy = !strcmp(argv[0], "copy");
+  int64_t value[3];
+  int nb = argc - 2;
+  int i;
+
+  if (dma_cfg.nb_job >= DDR_DMA_CHANNEL_MAX)
+  {
+    printf("too many jobs (max=%lu)\n\r", (unsigned long)DDR_DMA_CHANNEL_MAX);
+    return;
+  }
+
+  if ((copy && (nb != 3)) || (!copy && (nb < 2)))
+  {
+    printf("invalid dma %s command\n\r", argv[0]);
+    return;
+  }
+
+  for (i = 0; i < nb; i++)
+  {
+    value[i] = string_to_num(argv[i + 1]);
+    if (value[i] < 0)
+    {
+      printf("invalid argument %s\n\r", argv[i + 1]);
+      return;
+    }
+  }
+
+  job = &dma_cfg.job[dma_cfg.nb_job];
+  memset(job, 0, sizeof(*job));
+  job->op = copy ? DDR_DMA_COPY : DDR_DMA_FILL;
+  if (copy)
+  {
+    job->src = (uintptr_t)value[0];
+    job->dst = (uintptr_t)value[1];
+    job->size = (unsigned long)value[2];
+  }
+  else
+  {
+    job->dst = (uintptr_t)value[0];
+    job->size = (unsigned long)value[1];
+    job->pattern = (nb > 2) ? (uint32_t)value[2] : DMA_PATTERN_DFLT;
+  }
+
+  if (   (job->size == 0UL) || (job->size > DDR_DMA_SIZE_MAX)
+      || ((job->size % DDR_DMA_BLOCK_SIZE) != 0UL))
+  {
+    printf("invalid size: multiple of 0x%lx up to 0x%lx\n\r",
+           DDR_DMA_BLOCK_SIZE, DDR_DMA_SIZE_MAX);
+    return;
+  }
+
+  if (   (((uint64_t)job->dst + job->size) > DDR_DMA_ADDR_END)
+      || (copy && (((uint64_t)job->src + job->size) > DDR_DMA_ADDR_END)))
+  {
+    printf("invalid range: DMA addresses up to 0x%llx\n\r",
+           (unsigned long long)DDR_DMA_ADDR_END);
+    return;
+  }
+  dma_cfg.nb_job++;
+
+  dma_print();
+}
+
+/* MB/s = bytes per us */
+static unsigned long dma_rate(unsigned long bytes, uint64_t time_us)
+{
+  return (time_us != 0U) ? (unsigned long)(bytes / time_us) : 0UL;
+}
+
+/*
+ * dma test [<n> [args]]: the jobs run during the test n, or alone until
+ * their end (single) or during DMA_RUN_US (circular)
+ */
+static void dma_test(int argc, char *argv[])
+{
+  DDR_DmaResultTypeDef result[DDR_DMA_CHANNEL_MAX];
+  unsigned long rate, total = 0UL;
+  unsigned long written, read;
+  uint64_t start, time_us;
+  int64_t id = -1;
+  uint32_t i;
+  int ret;
+
+  if (dma_cfg.nb_job == 0U)
+  {
+    printf("no dma job\n\r");
+    return;
+  }
+
+  if (argc > 2)
+  {
+    id = string_to_num(argv[1]);
+    /* Test All completes its arguments at fixed positions */
+    if ((id < 0) || (id >= test_nb) || (test[id].fct == DDR_Test_All))
+    {
+      printf("invalid test %s\n\r", argv[1]);
+      return;
+    }
+  }
+
+  if (DDR_DMA_Start(dma_cfg.job, dma_cfg.nb_job, dma_cfg.circular) != 0)
+  {
+    printf("dma start failed\n\r");
+    return;
+  }
+
+  test_report_start(&start);
+  if (id >= 0)
+  {
+    do_subcmd(argc - 1, &argv[1], test, test_nb);
+  }
+  else if (dma_cfg.circular)
+  {
+    delay_us(DMA_RUN_US);
+  }
+  time_us = time_elapsed_us(start);
+  DDR_Test_GetTraffic(&written, &read);
+
+  ret = DDR_DMA_Stop(result);
+
+  for (i = 0; i < dma_cfg.nb_job; i++)
+  {
+    rate = dma_rate(result[i].bytes, result[i].time_us);
+    total += rate;
+    printf("dma %lu: ", (unsigned long)i);
+    if (result[i].time_us == 0U)
+    {
+      printf("no complete pass");
+    }
+    else
+    {
+      printf("%lu MB/s, %s", rate,
+             (result[i].mismatch == 0UL) ? "Passed" : "Failed");
+      if (result[i].mismatch != 0UL)
+      {
+        printf(" (%lu words)", result[i].mismatch);
+      }
+    }
+    if (result[i].error != 0U)
+    {
+      printf(", error 0x%lx", (unsigned long)result[i].error);
+    }
+    printf("\n\r");
+  }
+
+  if (id >= 0)
+  {
+    rate = dma_rate(written + read, time_us);
+    total += rate;
+    printf("cpu: %lu MB/s\n\r", rate);
+  }
+  printf("total: %lu MB/s\n\r", total);
+
+  if (ret != 0)
+  {
+    printf("dma not stopped\n\r");
+  }
+}
+
+static void do_dma(int argc, char *argv[])
+{
+  if (argc == 1)
+  {
+    dma_print();
+  }
+  else if (!strcmp(argv[0], "copy") || !strcmp(argv[0], "fill"))
+  {
+    dma_add_job(argc, argv);
+  }
+  else if (!strcmp(argv[0], "mode") && (argc == 3) &&
+           (!strcmp(argv[1], "single") || !strcmp(argv[1], "circular")))
+  {
+    dma_cfg.circular = !strcmp(argv[1], "circular");
+    dma_print();
+  }
+  else if (!strcmp(argv[0], "off") && (argc == 2))
+  {
+    dma_cfg.nb_job = 0U;
+    dma_print();
+  }
+  else if (!strcmp(argv[0], "test"))
+  {
+    dma_test(argc, argv);
+  }
+  else
+  {
+    printf("invalid dma command\n\r");
+  }
+}
+
+static void uart_print(void)
+{
+  UART_TX_StatsTypeDef stats;
+
+  UART_TX_GetStats(&stats);
+
+  printf("uart %s on full buffer, %lu/%lu bytes buffered, peak %lu\n\r",
+         UART_TX_GetDrop() ? "drop" : "wait", UART_TX_GetLevel(),
+         (unsigned long)UART_TX_BUF_SIZE, stats.peak);
+  printf("  written %lu, dropped %lu in %lu overflows\n\r", stats.written,
+         stats.dropped, stats.overflow);
+}
+
+static void do_uart(int argc, char *argv[])
+{
+  if ((argc == 2) && !strcmp(argv[0], "reset"))
+  {
+    UART_TX_ResetStats();
+  }
+  else if ((argc == 3) && !strcmp(argv[0], "drop") &&
+           (!strcmp(argv[1], "on") || !strcmp(argv[1], "off")))
+  {
+    UART_TX_SetDrop(!strcmp(argv[1], "on"));
+  }
+  else if (argc != 1)
+  {
+    printf("invalid uart command\n\r");
+    return;
+  }
+
+  uart_print();
+}
+
+static void do_script(int argc, char *argv[])
+{
+  unsigned long loop = 1UL;
+  bool stop_on_fail = false;
+  int i;
+
+  if (argc == 1)
+  {
+    DDR_Script_Print();
+  }
+  else if ((argc == 2) && !strcmp(argv[0], "load"))
+  {
+    printf("enter the script, ended by a line \"end\"\n\r");
+    DDR_Script_BeginLoad();
+  }
+  else if ((argc == 2) && !strcmp(argv[0], "builtin"))
+  {
+    if (!DDR_Script_SelectBuiltin())
+    {
+      printf("no builtin script\n\r");
+      return;
+    }
+    DDR_Script_Print();
+  }
+  else if (!strcmp(argv[0], "run"))
+  {
+    if (DDR_Script_IsRunning())
+    {
+      printf("script already running\n\r");
+      return;
+    }
+    for (i = 1; i < (argc - 1); i++)
+    {
+      if (!strcmp(argv[i], "stop"))
+      {
+        stop_on_fail = true;
+      }
+      else if (string_to_num(argv[i]) >= 0)
+      {
+        loop = (unsigned long)string_to_num(argv[i]);
+      }
+      else
+      {
+        printf("invalid script loops [%s]\n\r", argv[i]);
+        return;
+      }
+    }
+    (void)DDR_Script_Start(loop, stop_on_fail);
+  }
+  else if ((argc == 2) && !strcmp(argv[0], "stop"))
+  {
+    DDR_Script_Stop();
+  }
+  else
+  {
+    printf("invalid script command\n\r");
+  }
+}
+
+static void do_snap(int argc, char *argv[])
+{
+  int64_t slot = -1;
+  int64_t slot_b = -1;
+
+  if (argc == 1)
+  {
+    DDR_Snap_Print();
+    return;
+  }
+
+  if ((argc == 2) && !strcmp(argv[0], "layout"))
+  {
+    DDR_Snap_Layout();
+    return;
+  }
+
+  if (argc >= 3)
+  {
+    slot = string_to_num(argv[1]);
+  }
+  if (argc == 4)
+  {
+    slot_b = string_to_num(argv[2]);
+  }
+
+  if ((slot < 0) || ((argc == 4) && (slot_b < 0)))
+  {
+    printf("invalid snap command\n\r");
+  }
+  else if ((argc == 3) && !strcmp(argv[0], "save"))
+  {
+    (void)DDR_Snap_Save((uint32_t)slot, static_ddr_config.info.speed);
+  }
+  else if (!strcmp(argv[0], "diff"))
+  {
+    (void)DDR_Snap_Diff((uint32_t)slot, (int32_t)slot_b);
+  }
+  else if ((argc == 3) && !strcmp(argv[0], "restore"))
+  {
+    (void)DDR_Snap_Restore((uint32_t)slot);
+  }
+  else if ((argc == 3) && !strcmp(argv[0], "dump"))
+  {
+    (void)DDR_Snap_Dump((uint32_t)slot);
+  }
+  else
+  {
+    printf("invalid snap command\n\r");
+  }
+}
+
+static void do_errmap(int argc, char *argv[])
+{
+  int64_t lines = 0;
+
+  if (argc == 1)
+  {
+    DDR_ErrMap_Print();
+    return;
+  }
+
+  if (argc == 3)
+  {
+    lines = string_to_num(argv[1]);
+  }
+
+  if (!strcmp(argv[0], "on") && (lines >= 0))
+  {
+    DDR_ErrMap_Enable(true, (unsigned long)lines);
+  }
+  else if ((argc == 2) && !strcmp(argv[0], "off"))
+  {
+    DDR_ErrMap_Enable(false, 0UL);
+  }
+  else
+  {
+    printf("invalid errmap command\n\r");
+    return;
+  }
+
+  printf("error map %s\n\r", DDR_ErrMap_IsEnabled() ? "enabled" : "disabled");
+}
+
+bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
+{
+  char buffer[CMD_MAX_LEN];
+  char *argv[CMD_MAX_ARG + 1] = {argv0, argv1, argv2, argv3, argv4}; /* NULL terminated */
+  int argc;
+  int cmd;
+
+  if ((next_step < 0) && (step == STEP_DDR_RESET))
+  {
+    next_step = STEP_DDR_RESET;
+  }
+
+//  printf("** step %d ** %s / %d\n\r", step, step_str[step], next_step);
+
+  if (next_step < 0)
+  {
+    return false;
+  }
+
+  if (step > STEP_RUN)
+  {
+    printf("** step %d ** INVALID\n\r", step);
+    return false;
+  }
+
+  printf("%d:%s\n\r", step, step_str[step]);
+
+  if (shmoo.active && (step == STEP_DDR_READY) && shmoo_step())
+  {
+    return true;
+  }
+
+  if ((HAL_DDR_InteractStepTypeDef)next_step > step)
+  {
+    return false;
+  }
+
+  while ((HAL_DDR_InteractStepTypeDef)next_step == step)
+  {
+    get_entry_string(buffer);
+
+    if (DDR_Script_IsLoading())
+    {
+      DDR_Script_LoadLine(buffer);
+      continue;
+    }
+
+    argc = parse_entry_string(buffer, strlen(buffer), &cmd, argv);
+    if (argc < 0)
+    {
+      printf("Error [%d]\n\r", argc);
+      DDR_Script_Result(false);
+      continue;
+    }
+    else if (argc == 0)
+    {
+      continue;
+    }
+
+    switch (cmd)
+    {
+    case DDR_CMD_HELP:
+      print_usage();
+      break;
+
+    case DDR_CMD_TEST_HELP:
+      print_subcmd_usage(test, test_nb);
+      break;
+
+    case DDR_CMD_INFO:
+      do_info(step, argc, argv);
+      break;
+
+    case DDR_CMD_FREQ:
+      if (!do_freq(argc, argv))
+      {
+        DDR_Script_Result(false);
+      }
+      else if (argc == 2)
+      {
+        DDR_Script_Result(true);
+      }
+      if ((argc == 2) && (step > STEP_CTL_INIT))
+      {
+        printf("### Please update PLL settings and DDR timings ###\n\r");
+        printf("### in your project. Then rebuild and restart. ###\n\r");
+      }
+      break;
+
+    case DDR_CMD_RESET:
+      UART_TX_Flush();
+      WRITE_REG(RCC->GRSTCSETR, 0x1U);
+      break;
+
+    case DDR_CMD_PARAM:
+      do_param(step, argc, argv);
+      break;
+
+    case DDR_CMD_PRINT:
+      do_print(argc, argv);
+      break;
+
+    case DDR_CMD_EDIT:
+      HAL_DDR_Edit_Reg(argv0, argv1);
+      break;
+
+    case DDR_CMD_SAVE:
+      HAL_DDR_Dump_Reg(NULL, true);
+      break;
+
+    case DDR_CMD_GO:
+      next_step = STEP_RUN;
+      printf("### Exit DDR INTERACTIVE mode. Please RESET the BOARD ###\n\r");
+      break;
+
+    case DDR_CMD_NEXT:
+      next_step = step + 1;
+      if (next_step == STEP_RUN)
+      {
+        printf("### Exit DDR INTERACTIVE mode. Please RESET the BOARD ###\n\r");
+      }
+      break;
+
+    case DDR_CMD_STEP:
+      next_step = do_step(step, argc, argv);
+      break;
+
+    case DDR_CMD_TEST:
+      if (!check_step(step, STEP_DDR_READY))
+      {
+        continue;
+      }
+      if ((argc >= 2) && !strcmp(argv[0], "par"))
+      {
+        do_test_par(argc - 1, &argv[1]);
+        break;
+      }
+      do_subcmd(argc, argv, test, test_nb);
+      break;
+
+    case DDR_CMD_FWLOG:
+      HAL_DDR_Dump_FwLog();
+      break;
+
+    case DDR_CMD_RETREGS:
+      HAL_DDR_Dump_RetRegs();
+      break;
+
+    case DDR_CMD_PSTATE:
+      do_pstate(step, argc, argv);
+      break;
+
+    case DDR_CMD_SWEEP:
+      do_sweep(argc, argv);
+      break;
+
+    case DDR_CMD_MAP:
+      do_map(step, argc, argv);
+      break;
+
+    case DDR_CMD_PMU:
+      do_pmu(argc, argv);
+      break;
+
+    case DDR_CMD_MARGIN:
+      if (!check_step(step, STEP_DDR_READY))
+      {
+        continue;
+      }
+      do_margin(argc, argv);
+      break;
+
+    case DDR_CMD_SHMOO:
+      if (!check_step(step, STEP_DDR_READY))
+      {
+        continue;
+      }
+      if (do_shmoo(argc, argv))
+      {
+        /* initialization of the first point */
+        next_step = STEP_DDR_READY;
+        return true;
+      }
+      break;
+
+    case DDR_CMD_DMA:
+      if ((argc > 1) && !strcmp(argv[0], "test") &&
+          !check_step(step, STEP_DDR_READY))
+      {
+        continue;
+      }
+      do_dma(argc, argv);
+      break;
+
+    case DDR_CMD_UART:
+      do_uart(argc, argv);
+      break;
+
+    case DDR_CMD_SCRIPT:
+      do_script(argc, argv);
+      break;
+
+    case DDR_CMD_SNAP:
+      do_snap(argc, argv);
+      break;
+
+    case DDR_CMD_ERRMAP:
+      do_errmap(argc, argv);
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  return next_step == STEP_DDR_RESET;
+}
+
+bool HAL_DDR_Interactive_Error(HAL_DDR_InteractStepTypeDef step)
+{
+  if (!shmoo.active)
+  {
+    if (!DDR_Script_IsRunning())
+    {
+      return false;
+    }
+
+    /* initialization failure given by the script: back to DDR_RESET */
+    printf("%d:%s not reached\n\r", step, step_str[step]);
+    DDR_Script_Result(false);
+    next_step = STEP_DDR_RESET;
+
+    return true;
+  }
+
+  printf("%d:%s not reached\n\r", step, step_str[step]);
+
+  if (shmoo.restore)
+  {
+    shmoo.active = false;
+    shmoo_print();
+    printf("initialization failed at the initial frequency\n\r");
+    return false;
+  }
+
+  /* any initialization failure: point not trained, next point */
+  shmoo_next();
+
+  return true;
 }
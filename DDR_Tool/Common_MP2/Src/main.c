@@ -19,6 +19,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "stm32mp_util_conf.h"
+#include "uart_tx.h"
 
 /** @addtogroup STM32MP2xx_HAL_Examples
   * @{
@@ -105,16 +106,22 @@ int main(void)
   iddr.self_refresh = false;
   iddr.zdata = 0;
   iddr.clear_bkp = false;
+  iddr.trained_state = NULL;
+  iddr.csr_stream = NULL;
 
   if (HAL_DDR_Init(&iddr) != HAL_OK)
   {
     printf("DDR Initialization KO\n\r");
+    UART_TX_Flush();
     return 1;
   }
 
   /* Infinite loop */
   while (1)
   {
+  /* Send the buffered output */
+  UART_TX_Poll();
+
   /* Toggle LED3 ON */
   BSP_LED_Toggle(LED_GREEN);
 
@@ -153,7 +160,7 @@ void Mon_A35SystemClockConfig( void )
    /* Set CNTFRQ_EL0 register according to STGEN frequency in Hz */
    /* see ARM DDI0487B.a page 2673 #D7.5.1 "CNTFRQ_EL0" */
    reg32_val = READ_REG(STGENC->CNTFID0);
-   asm volatile("MSR CNTFRQ_EL0, %0" : "=r" (reg32_val));
+   asm volatile("MSR CNTFRQ_EL0, %0" : : "r" ((uint64_t)reg32_val));
 
    return;
 }
@@ -603,9 +603,24 @@ after_neon:
         b       exit
 
 servant_core1:
-        /* A35_1 core : Branch to its own main function */
-//        b       main_a35_1
-        b      servant_core1
+        /* A35_1 core : Wait in the ddr_multicore_boot mailbox (see      */
+        /* ddr_multicore.c) until A35_0 provides an entry point and stack */
+        ldr     x1, =ddr_multicore_boot
+        mov     x0, #1
+        str     x0, [x1]               /* parked = 1 */
+        dsb     sy
+        sev
+servant_core1_wait:
+        ldr     x0, [x1, #8]           /* entry */
+        cbnz    x0, servant_core1_run
+        wfe
+        b       servant_core1_wait
+servant_core1_run:
+        dmb     sy
+        ldr     x2, [x1, #16]          /* stack */
+        mov     sp, x2
+        blr     x0
+        b       servant_core1_wait
 
 
 /*============================================================================*/
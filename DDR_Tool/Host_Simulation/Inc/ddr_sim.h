@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    ddr_sim.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_sim.c file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_SIM_H
+#define __DDR_SIM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+  DDR_SIM_FAULT_STUCK0 = 0, /* bits of a 64-bit word stuck at 0 */
+  DDR_SIM_FAULT_STUCK1,     /* bits of a 64-bit word stuck at 1 */
+  DDR_SIM_FAULT_ALIAS,      /* address bit ignored: aliasing of 2 blocks */
+  DDR_SIM_FAULT_COUPLING,   /* change of a word inverts bits of another one */
+  DDR_SIM_FAULT_MAX,
+} DDR_SimFaultTypeDef;
+
+typedef struct {
+  DDR_SimFaultTypeDef type;
+  uintptr_t addr;           /* stuck word or coupling aggressor */
+  uintptr_t victim;         /* coupling victim word */
+  uint64_t mask;            /* stuck or inverted bits */
+  uint32_t bit;             /* alias: ignored address bit */
+} DDR_SimFaultDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define DDR_SIM_FAULT_NB_MAX      16U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+int DDR_Sim_Init(const DDR_SimFaultDef *faults, uint32_t nb_faults);
+void DDR_Sim_DeInit(void);
+int DDR_Sim_ParseFault(const char *string, DDR_SimFaultDef *fault);
+void DDR_Sim_PrintFault(const DDR_SimFaultDef *fault);
+uint64_t DDR_Sim_GetCounter(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DDR_SIM_H */
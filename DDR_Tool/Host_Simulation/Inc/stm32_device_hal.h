@@ -0,0 +1,134 @@
+/**
+  ******************************************************************************
+  * @file    stm32_device_hal.h
+  * @author  MCD Application Team
+  * @brief   Simulated device HAL for the host build of the DDR tests: the
+  *          registers used by the tests are plain variables and the DDR is
+  *          provided by ddr_sim.c.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32_DEVICE_HAL_H
+#define __STM32_DEVICE_HAL_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "ddr_sim.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+  HAL_OK       = 0x00,
+  HAL_ERROR    = 0x01,
+  HAL_BUSY     = 0x02,
+  HAL_TIMEOUT  = 0x03
+} HAL_StatusTypeDef;
+
+typedef struct {
+  volatile uint32_t MSTR;
+  volatile uint32_t ADDRMAP1;
+  volatile uint32_t ADDRMAP2;
+  volatile uint32_t ADDRMAP3;
+  volatile uint32_t ADDRMAP4;
+  volatile uint32_t ADDRMAP5;
+  volatile uint32_t ADDRMAP6;
+  volatile uint32_t ADDRMAP8;
+  volatile uint32_t ADDRMAP9;
+  volatile uint32_t ADDRMAP10;
+  volatile uint32_t ADDRMAP11;
+} DDRC_TypeDef;
+
+/* console UART: a transfer is written on stdout when started */
+typedef struct {
+  bool busy;                      /* end of transfer not yet handled */
+} UART_HandleTypeDef;
+
+typedef struct {
+  volatile uint32_t GRSTCSETR;
+  volatile uint32_t STGENCKSELR;
+} RCC_TypeDef;
+
+extern DDRC_TypeDef sim_ddrc;
+extern RCC_TypeDef sim_rcc;
+extern uint32_t sim_ddrphyc[];
+
+/* Exported constants --------------------------------------------------------*/
+#if defined(DDR_SIM_MP1)
+#define DDR_MEM_BASE                    0xC0000000UL
+#else /* DDR_SIM_MP1 */
+#define DDR_MEM_BASE                    0x80000000UL
+#endif /* DDR_SIM_MP1 */
+
+/* STGEN clocked at 1 GHz on the simulated HSE: counter in nanoseconds */
+#define HSI_VALUE                       64000000U
+#define HSE_VALUE                       1000000000U
+
+#define DDRC                            (&sim_ddrc)
+#define DDRCTRL                         (&sim_ddrc)
+#define RCC                             (&sim_rcc)
+/* DDR PHY CSRs of pstate 0, one 32-bit word per 16-bit CSR */
+#define DDRPHYC_BASE                    ((uintptr_t)sim_ddrphyc)
+#define DDRPHYC_CSR_NB                  0x100000U
+
+#define DDRC_MSTR_DATA_BUS_WIDTH_Pos    12U
+#define DDRC_MSTR_DATA_BUS_WIDTH_Msk    (0x3UL << DDRC_MSTR_DATA_BUS_WIDTH_Pos)
+#define DDRC_MSTR_DATA_BUS_WIDTH_0      (0x1UL << DDRC_MSTR_DATA_BUS_WIDTH_Pos)
+#define DDRC_MSTR_DATA_BUS_WIDTH_1      (0x2UL << DDRC_MSTR_DATA_BUS_WIDTH_Pos)
+#define DDRCTRL_MSTR_DATA_BUS_WIDTH_Pos DDRC_MSTR_DATA_BUS_WIDTH_Pos
+#define DDRCTRL_MSTR_DATA_BUS_WIDTH_Msk DDRC_MSTR_DATA_BUS_WIDTH_Msk
+#define DDRCTRL_MSTR_DATA_BUS_WIDTH_0   DDRC_MSTR_DATA_BUS_WIDTH_0
+#define DDRCTRL_MSTR_DATA_BUS_WIDTH_1   DDRC_MSTR_DATA_BUS_WIDTH_1
+
+#define RCC_STGENCKSELR_STGENSRC        0x3U
+#define RCC_STGENCLKSOURCE_HSE          0x1U
+
+/* Exported macro ------------------------------------------------------------*/
+#define __IO                            volatile
+#define __weak                          __attribute__((weak))
+
+#define __DMB()                         __sync_synchronize()
+#define __DSB()                         __sync_synchronize()
+#define __ISB()                         __sync_synchronize()
+#define __WFE()                         do { } while (0)
+#define __SEV()                         do { } while (0)
+
+#define READ_REG(REG)                   ((REG))
+#define WRITE_REG(REG, VAL)             ((REG) = (VAL))
+#define SET_BIT(REG, BIT)               ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)             ((REG) &= ~(BIT))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) \
+  WRITE_REG((REG), (((READ_REG(REG)) & (~(CLEARMASK))) | (SETMASK)))
+
+/* generic timer physical counter used by system_time.c */
+#define PL1_GetCurrentPhysicalValue()   DDR_Sim_GetCounter()
+
+/* Exported functions ------------------------------------------------------- */
+uint32_t HAL_GetTick(void);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart,
+                                       const uint8_t *data, uint16_t size);
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32_DEVICE_HAL_H */
@@ -0,0 +1,98 @@
+/**
+  ******************************************************************************
+  * @file    stm32mp_util_conf.h
+  * @author  MCD Application Team
+  * @brief   Utilities configuration of the host simulation build: DDR HAL
+  *          and RCC services used by the DDR tool, provided by sim_hal.c.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32MP_UTIL_CONF_H
+#define __STM32MP_UTIL_CONF_H
+
+#include "stm32_device_hal.h"
+
+#define UTIL_MODEL                "HOST SIMULATION"
+
+/* script of the command "script builtin", one command per line */
+#define DDR_SCRIPT_BUILTIN        "# quick check\n" \
+                                  "test 1 0\n" \
+                                  "loop 2\n" \
+                                  "test 3 1 0\n" \
+                                  "endloop\n"
+
+/* DDR HAL interactive services */
+typedef enum {
+  STEP_DDR_RESET = 0,
+  STEP_CTL_INIT,
+  STEP_PHY_INIT,
+  STEP_DDR_READY,
+  STEP_RUN,
+} HAL_DDR_InteractStepTypeDef;
+
+typedef struct {
+  const char *name;
+  uint32_t speed;   /* in kHz */
+  size_t size;      /* in bytes */
+} HAL_DDR_InfoTypeDef;
+
+typedef struct {
+  int32_t frequency[1];   /* in MHz */
+} HAL_DDR_BasicUiTypeDef;
+
+typedef struct {
+  HAL_DDR_InfoTypeDef info;
+  HAL_DDR_BasicUiTypeDef p_uib;
+} HAL_DDR_ConfigTypeDef;
+
+void HAL_DDR_Convert_Case(const char *in_str, char *out_str, bool ToUpper);
+bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step);
+bool HAL_DDR_Interactive_Error(HAL_DDR_InteractStepTypeDef step);
+HAL_StatusTypeDef HAL_DDR_Dump_Param(HAL_DDR_ConfigTypeDef *config,
+                                     const char *name);
+HAL_StatusTypeDef HAL_DDR_Dump_Reg(const char *name, bool save);
+HAL_StatusTypeDef HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
+                                     char *string);
+void HAL_DDR_Edit_Reg(char *name, char *string);
+void HAL_DDR_Dump_FwLog(void);
+void HAL_DDR_Dump_RetRegs(void);
+void HAL_DDR_Dump_PState(void);
+HAL_StatusTypeDef HAL_DDR_Set_PState(uint32_t pstate);
+uint32_t HAL_DDR_Get_PState(void);
+uint32_t HAL_DDR_Snapshot_Reg(uint32_t *value, uint32_t size);
+bool HAL_DDR_Snapshot_Name(uint32_t index, const char **base,
+                           const char **table, const char **name);
+HAL_StatusTypeDef HAL_DDR_Restore_Reg(const uint32_t *value, uint32_t nb);
+
+/* RCC PLL2 services */
+#define RCC_PLLSOURCE_HSI         0x0U
+#define RCC_PLLSOURCE_HSE         0x1U
+#define RCC_PLL_OFF               0x0U
+#define RCC_PLL_ON                0x1U
+
+typedef struct {
+  uint32_t PLLState;
+  uint32_t PLLSource;
+  uint32_t FREFDIV;
+  uint32_t FBDIV;
+  uint32_t FRACIN;
+  uint32_t POSTDIV1;
+  uint32_t POSTDIV2;
+} RCC_PLLInitTypeDef;
+
+void HAL_RCCEx_GetPLL2Config(RCC_PLLInitTypeDef *pll_config);
+HAL_StatusTypeDef HAL_RCCEx_PLL2Config(RCC_PLLInitTypeDef *pll_config);
+uint32_t HAL_RCCEx_GetPLL2ClockFreq(void);
+
+#endif /* __STM32MP_UTIL_CONF_H */
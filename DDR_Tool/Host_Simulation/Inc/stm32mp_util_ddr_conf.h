@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    stm32mp_util_ddr_conf.h
+  * @author  MCD Application Team
+  * @brief   DDR configuration of the host simulation build.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32MP_UTIL_DDR_CONF_H
+#define __STM32MP_UTIL_DDR_CONF_H
+
+/* simulated DDR size, a power of 2 mapped at DDR_MEM_BASE */
+#ifndef DDR_MEM_SIZE
+#define DDR_MEM_SIZE              0x10000000UL
+#endif
+
+#define DDR_MEM_NAME              "Simulated DDR"
+#define DDR_MEM_SPEED             533000
+
+#endif /* __STM32MP_UTIL_DDR_CONF_H */
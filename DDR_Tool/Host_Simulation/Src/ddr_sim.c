@@ -0,0 +1,502 @@
+/**
+  ******************************************************************************
+  * @file    ddr_sim.c
+  * @author  MCD Application Team
+  * @brief   Simulated DDR of the host build: memory file mapped at
+  *          DDR_MEM_BASE with fault injection.
+  *          - alias: the blocks of an ignored address bit are mapped on the
+  *            same file offset
+  *          - stuck and coupling: the pages of the faulty words are read
+  *            only, a write is single-stepped (x86_64 trap flag) then the
+  *            faults are applied before the page is protected again
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+
+#include "stm32_device_hal.h"
+#include "stm32mp_util_ddr_conf.h"
+#include "ddr_sim.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#if defined(__x86_64__)
+#define SIM_TRAP_SUPPORTED        1
+#define SIM_TRAP_FLAG             0x100ULL
+#else
+#define SIM_TRAP_SUPPORTED        0
+#endif
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE       0x100000
+#endif
+
+/* maximum number of mappings used to alias the blocks */
+#define SIM_ALIAS_MAP_MAX         16384UL
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const char * const sim_fault_name[DDR_SIM_FAULT_MAX] = {
+  [DDR_SIM_FAULT_STUCK0]   = "stuck0",
+  [DDR_SIM_FAULT_STUCK1]   = "stuck1",
+  [DDR_SIM_FAULT_ALIAS]    = "alias",
+  [DDR_SIM_FAULT_COUPLING] = "coupling",
+};
+
+static int sim_fd = -1;
+static bool sim_trap;
+static uintptr_t sim_page_size;
+static DDR_SimFaultDef sim_faults[DDR_SIM_FAULT_NB_MAX];
+static uint32_t sim_nb_faults;
+/* last value of the coupling aggressors */
+static uint64_t sim_shadow[DDR_SIM_FAULT_NB_MAX];
+static struct sigaction sim_old_segv;
+static struct sigaction sim_old_trap;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+static volatile uint64_t *sim_word(uintptr_t addr)
+{
+  return (volatile uint64_t *)(addr & ~(uintptr_t)(sizeof(uint64_t) - 1U));
+}
+
+static uintptr_t sim_page(uintptr_t addr)
+{
+  return addr & ~(sim_page_size - 1U);
+}
+
+static bool sim_is_trapped_fault(const DDR_SimFaultDef *fault)
+{
+  return fault->type != DDR_SIM_FAULT_ALIAS;
+}
+
+static bool sim_is_trapped_page(uintptr_t page)
+{
+  uint32_t i;
+
+  for (i = 0; i < sim_nb_faults; i++)
+  {
+    if (sim_is_trapped_fault(&sim_faults[i]) &&
+        (sim_page(sim_faults[i].addr) == page))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void sim_protect(int prot)
+{
+  uint32_t i;
+
+  for (i = 0; i < sim_nb_faults; i++)
+  {
+    if (sim_is_trapped_fault(&sim_faults[i]))
+    {
+      (void)mprotect((void *)sim_page(sim_faults[i].addr), sim_page_size, prot);
+    }
+  }
+}
+
+/* called after each write in a trapped page, and at init */
+static void sim_apply(void)
+{
+  volatile uint64_t *word;
+  uint32_t i;
+
+  sim_protect(PROT_READ | PROT_WRITE);
+
+  /* coupling first: the stuck bits are also stuck for the victims */
+  for (i = 0; i < sim_nb_faults; i++)
+  {
+    if (sim_faults[i].type == DDR_SIM_FAULT_COUPLING)
+    {
+      word = sim_word(sim_faults[i].addr);
+      if (*word != sim_shadow[i])
+      {
+        sim_shadow[i] = *word;
+        *sim_word(sim_faults[i].victim) ^= sim_faults[i].mask;
+      }
+    }
+  }
+
+  for (i = 0; i < sim_nb_faults; i++)
+  {
+    word = sim_word(sim_faults[i].addr);
+    if (sim_faults[i].type == DDR_SIM_FAULT_STUCK0)
+    {
+      *word &= ~sim_faults[i].mask;
+    }
+    else if (sim_faults[i].type == DDR_SIM_FAULT_STUCK1)
+    {
+      *word |= sim_faults[i].mask;
+    }
+  }
+
+  sim_protect(PROT_READ);
+}
+
+#if SIM_TRAP_SUPPORTED
+/* write in a trapped page: allow it for one instruction */
+static void sim_segv_handler(int sig, siginfo_t *info, void *context)
+{
+  ucontext_t *uc = (ucontext_t *)context;
+  uintptr_t page = sim_page((uintptr_t)info->si_addr);
+
+  (void)sig;
+
+  if (!sim_is_trapped_page(page))
+  {
+    /* real segmentation fault, raised again on return */
+    (void)sigaction(SIGSEGV, &sim_old_segv, NULL);
+    return;
+  }
+
+  (void)mprotect((void *)page, sim_page_size, PROT_READ | PROT_WRITE);
+  uc->uc_mcontext.gregs[REG_EFL] |= SIM_TRAP_FLAG;
+}
+
+/* end of the single-stepped write */
+static void sim_trap_handler(int sig, siginfo_t *info, void *context)
+{
+  ucontext_t *uc = (ucontext_t *)context;
+
+  (void)sig;
+  (void)info;
+
+  uc->uc_mcontext.gregs[REG_EFL] &= ~SIM_TRAP_FLAG;
+  sim_apply();
+}
+
+static int sim_trap_install(void)
+{
+  struct sigaction sa;
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_flags = SA_SIGINFO;
+  sigemptyset(&sa.sa_mask);
+
+  sa.sa_sigaction = sim_segv_handler;
+  if (sigaction(SIGSEGV, &sa, &sim_old_segv) != 0)
+  {
+    return -1;
+  }
+
+  sa.sa_sigaction = sim_trap_handler;
+  if (sigaction(SIGTRAP, &sa, &sim_old_trap) != 0)
+  {
+    (void)sigaction(SIGSEGV, &sim_old_segv, NULL);
+    return -1;
+  }
+
+  return 0;
+}
+
+static void sim_trap_remove(void)
+{
+  (void)sigaction(SIGSEGV, &sim_old_segv, NULL);
+  (void)sigaction(SIGTRAP, &sim_old_trap, NULL);
+}
+#else /* SIM_TRAP_SUPPORTED */
+static int sim_trap_install(void)
+{
+  printf("stuck and coupling faults are only supported on x86_64 hosts\n\r");
+  return -1;
+}
+
+static void sim_trap_remove(void)
+{
+}
+#endif /* SIM_TRAP_SUPPORTED */
+
+static bool sim_in_ddr(uintptr_t addr)
+{
+  return (addr >= DDR_MEM_BASE) && (addr < (DDR_MEM_BASE + DDR_MEM_SIZE));
+}
+
+static int sim_check_fault(const DDR_SimFaultDef *fault)
+{
+  switch (fault->type)
+  {
+    case DDR_SIM_FAULT_STUCK0:
+    case DDR_SIM_FAULT_STUCK1:
+      return sim_in_ddr(fault->addr) ? 0 : -1;
+
+    case DDR_SIM_FAULT_COUPLING:
+      return (sim_in_ddr(fault->addr) && sim_in_ddr(fault->victim)) ? 0 : -1;
+
+    case DDR_SIM_FAULT_ALIAS:
+      if ((fault->bit >= 63U) ||
+          ((1UL << fault->bit) < sim_page_size) ||
+          ((1UL << fault->bit) >= DDR_MEM_SIZE) ||
+          ((DDR_MEM_SIZE >> fault->bit) > SIM_ALIAS_MAP_MAX))
+      {
+        return -1;
+      }
+      return 0;
+
+    default:
+      return -1;
+  }
+}
+
+/**
+  * @brief  Map the simulated DDR at DDR_MEM_BASE, cleared, with faults.
+  * @param  faults: faults to inject, NULL for a fault-free DDR
+  * @param  nb_faults: number of faults
+  * @retval 0 if OK, -1 for an invalid fault or a mapping error
+  */
+int DDR_Sim_Init(const DDR_SimFaultDef *faults, uint32_t nb_faults)
+{
+  unsigned long block = DDR_MEM_SIZE;
+  unsigned long alias = 0;
+  unsigned long offset;
+  void *ptr;
+  uint32_t i;
+
+  sim_page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+  sim_trap = false;
+
+  if (nb_faults > DDR_SIM_FAULT_NB_MAX)
+  {
+    printf("too many faults (max=%d)\n\r", DDR_SIM_FAULT_NB_MAX);
+    return -1;
+  }
+
+  for (i = 0; i < nb_faults; i++)
+  {
+    if (sim_check_fault(&faults[i]) != 0)
+    {
+      printf("invalid fault: ");
+      DDR_Sim_PrintFault(&faults[i]);
+      return -1;
+    }
+
+    if (faults[i].type == DDR_SIM_FAULT_ALIAS)
+    {
+      /* each block is the image of the block without the alias bit */
+      alias |= 1UL << faults[i].bit;
+      if ((1UL << faults[i].bit) < block)
+      {
+        block = 1UL << faults[i].bit;
+      }
+    }
+    else
+    {
+      sim_trap = true;
+    }
+  }
+
+  sim_fd = memfd_create("ddr_sim", 0);
+  if ((sim_fd < 0) || (ftruncate(sim_fd, DDR_MEM_SIZE) != 0))
+  {
+    perror("ddr_sim");
+    DDR_Sim_DeInit();
+    return -1;
+  }
+
+  for (offset = 0; offset < DDR_MEM_SIZE; offset += block)
+  {
+    ptr = mmap((void *)(DDR_MEM_BASE + offset), block, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_FIXED_NOREPLACE, sim_fd, offset & ~alias);
+    if (ptr != (void *)(DDR_MEM_BASE + offset))
+    {
+      printf("DDR mapping at 0x%lx failed\n\r", DDR_MEM_BASE + offset);
+      if (ptr != MAP_FAILED)
+      {
+        (void)munmap(ptr, block);
+      }
+      (void)munmap((void *)DDR_MEM_BASE, offset);
+      close(sim_fd);
+      sim_fd = -1;
+      return -1;
+    }
+  }
+
+  memcpy(sim_faults, faults, nb_faults * sizeof(DDR_SimFaultDef));
+  sim_nb_faults = nb_faults;
+  memset(sim_shadow, 0, sizeof(sim_shadow));
+
+  if (sim_trap)
+  {
+    if (sim_trap_install() != 0)
+    {
+      sim_trap = false;
+      DDR_Sim_DeInit();
+      return -1;
+    }
+    sim_apply();
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Unmap the simulated DDR and remove the faults.
+  * @retval None
+  */
+void DDR_Sim_DeInit(void)
+{
+  if (sim_trap)
+  {
+    sim_trap_remove();
+    sim_trap = false;
+  }
+
+  if (sim_fd >= 0)
+  {
+    (void)munmap((void *)DDR_MEM_BASE, DDR_MEM_SIZE);
+    close(sim_fd);
+    sim_fd = -1;
+  }
+
+  sim_nb_faults = 0;
+}
+
+/**
+  * @brief  Parse a fault description:
+  *         stuck0:<addr>:<mask>, stuck1:<addr>:<mask>, alias:<bit>,
+  *         coupling:<aggressor addr>:<victim addr>:<mask>
+  * @param  string: fault description
+  * @param  fault: parsed fault
+  * @retval 0 if OK, -1 for an invalid description
+  */
+int DDR_Sim_ParseFault(const char *string, DDR_SimFaultDef *fault)
+{
+  unsigned long long val[3];
+  const char *p;
+  char *end;
+  int nb_val;
+  int i;
+
+  memset(fault, 0, sizeof(*fault));
+
+  for (i = 0; i < (int)DDR_SIM_FAULT_MAX; i++)
+  {
+    size_t len = strlen(sim_fault_name[i]);
+
+    if (!strncmp(string, sim_fault_name[i], len) && (string[len] == ':'))
+    {
+      break;
+    }
+  }
+
+  if (i == (int)DDR_SIM_FAULT_MAX)
+  {
+    return -1;
+  }
+
+  fault->type = (DDR_SimFaultTypeDef)i;
+  p = string + strlen(sim_fault_name[i]);
+
+  for (nb_val = 0; (nb_val < 3) && (*p == ':'); nb_val++)
+  {
+    val[nb_val] = strtoull(p + 1, &end, 0);
+    if (end == (p + 1))
+    {
+      return -1;
+    }
+    p = end;
+  }
+
+  if (*p != '\0')
+  {
+    return -1;
+  }
+
+  switch (fault->type)
+  {
+    case DDR_SIM_FAULT_STUCK0:
+    case DDR_SIM_FAULT_STUCK1:
+      if (nb_val != 2)
+      {
+        return -1;
+      }
+      fault->addr = (uintptr_t)val[0];
+      fault->mask = val[1];
+      break;
+
+    case DDR_SIM_FAULT_ALIAS:
+      if (nb_val != 1)
+      {
+        return -1;
+      }
+      fault->bit = (uint32_t)val[0];
+      break;
+
+    default:
+      if (nb_val != 3)
+      {
+        return -1;
+      }
+      fault->addr = (uintptr_t)val[0];
+      fault->victim = (uintptr_t)val[1];
+      fault->mask = val[2];
+      break;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Print a fault description.
+  * @param  fault: fault
+  * @retval None
+  */
+void DDR_Sim_PrintFault(const DDR_SimFaultDef *fault)
+{
+  switch (fault->type)
+  {
+    case DDR_SIM_FAULT_STUCK0:
+    case DDR_SIM_FAULT_STUCK1:
+      printf("%s:0x%lx:0x%llx\n\r", sim_fault_name[fault->type],
+             (unsigned long)fault->addr, (unsigned long long)fault->mask);
+      break;
+
+    case DDR_SIM_FAULT_ALIAS:
+      printf("alias:%u\n\r", (unsigned int)fault->bit);
+      break;
+
+    case DDR_SIM_FAULT_COUPLING:
+      printf("coupling:0x%lx:0x%lx:0x%llx\n\r", (unsigned long)fault->addr,
+             (unsigned long)fault->victim, (unsigned long long)fault->mask);
+      break;
+
+    default:
+      printf("unknown fault\n\r");
+      break;
+  }
+}
+
+/**
+  * @brief  Simulated generic timer counter, clocked at 1 GHz.
+  * @retval Monotonic time in nanoseconds
+  */
+uint64_t DDR_Sim_GetCounter(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
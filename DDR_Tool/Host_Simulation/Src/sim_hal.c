@@ -0,0 +1,359 @@
+/**
+  ******************************************************************************
+  * @file    sim_hal.c
+  * @author  MCD Application Team
+  * @brief   HAL services of the host simulation build: registers, console
+  *          on stdin/stdout, DDR HAL interactive services and PLL2.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32_device_hal.h"
+#include "stm32mp_util_conf.h"
+#include "stm32mp_util_ddr_conf.h"
+#include "uart_tx.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+  const char *name;
+  volatile uint32_t *reg;
+} sim_reg_desc;
+
+/* Private define ------------------------------------------------------------*/
+#define SIM_REG(x)                { #x, &sim_ddrc.x }
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/*
+ * full data bus width, 10 column bits, bank address from HIF bit 10 and
+ * 12 row bits from HIF bit 13 (DDRCTRL address map fields), no bank group
+ */
+DDRC_TypeDef sim_ddrc = {
+  .MSTR = 0x0U,
+  .ADDRMAP1 = 0x00080808U,
+  .ADDRMAP4 = 0x00001F1FU,
+  .ADDRMAP5 = 0x07070707U,
+  .ADDRMAP6 = 0x0F0F0F0FU,
+  .ADDRMAP8 = 0x00003F3FU,
+};
+
+/* registers of the print, edit and snap commands, all in ctl.map */
+static const sim_reg_desc sim_reg[] = {
+  SIM_REG(MSTR),
+  SIM_REG(ADDRMAP1),
+  SIM_REG(ADDRMAP2),
+  SIM_REG(ADDRMAP3),
+  SIM_REG(ADDRMAP4),
+  SIM_REG(ADDRMAP5),
+  SIM_REG(ADDRMAP6),
+  SIM_REG(ADDRMAP8),
+};
+
+#define SIM_REG_NB                (sizeof(sim_reg) / sizeof(sim_reg[0]))
+
+/* STGEN clocked by HSE */
+RCC_TypeDef sim_rcc = {
+  .GRSTCSETR = 0x0U,
+  .STGENCKSELR = RCC_STGENCLKSOURCE_HSE,
+};
+
+/* DDR PHY CSRs, read back as written */
+uint32_t sim_ddrphyc[DDRPHYC_CSR_NB];
+
+HAL_DDR_ConfigTypeDef static_ddr_config = {
+  .info = {
+    .name = DDR_MEM_NAME,
+    .speed = DDR_MEM_SPEED,
+    .size = DDR_MEM_SIZE,
+  },
+  .p_uib = {
+    .frequency = { DDR_MEM_SPEED / 1000 },
+  },
+};
+
+/* PLL2 output frequency in Hz, DDR PHY clock at the half of the DDR rate */
+static uint64_t sim_pll2_rate = (DDR_MEM_SPEED * 1000ULL) / 2U;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Milliseconds since the simulated timer start.
+  * @retval Tick value
+  */
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(DDR_Sim_GetCounter() / 1000000ULL);
+}
+
+/**
+  * @brief  Read one character of the console, end of line converted to CR.
+  *         The simulation ends with the console input.
+  * @param  value: timeout, unused
+  * @retval Character
+  */
+uint32_t Serial_Scanf(uint32_t value)
+{
+  int c;
+
+  (void)value;
+
+  c = getchar();
+  if (c == EOF)
+  {
+    printf("\n\r");
+    DDR_Sim_DeInit();
+    exit(0);
+  }
+
+  if (c == '\n')
+  {
+    c = 0xd;
+  }
+
+  return (uint32_t)c;
+}
+
+/**
+  * @brief  Write one character on the console, through the buffered output
+  *         when initialized.
+  * @param  value: character
+  * @retval None
+  */
+void Serial_Putchar(char value)
+{
+  if (UART_TX_Write(&value, 1) < 0)
+  {
+    putchar((value == 0xd) ? '\n' : value);
+    fflush(stdout);
+  }
+}
+
+/**
+  * @brief  Start a transfer of the console UART: the data is written at once,
+  *         the end of transfer is handled by the next HAL_UART_IRQHandler.
+  * @param  huart: UART handle
+  * @param  data: bytes to send
+  * @param  size: number of bytes
+  * @retval HAL_BUSY when the previous transfer is not ended
+  */
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart,
+                                       const uint8_t *data, uint16_t size)
+{
+  uint16_t i;
+
+  if (huart->busy)
+  {
+    return HAL_BUSY;
+  }
+
+  for (i = 0; i < size; i++)
+  {
+    putchar((data[i] == 0xd) ? '\n' : data[i]);
+  }
+  fflush(stdout);
+  huart->busy = true;
+
+  return HAL_OK;
+}
+
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
+{
+  if (huart->busy)
+  {
+    huart->busy = false;
+    HAL_UART_TxCpltCallback(huart);
+  }
+}
+
+void HAL_DDR_Convert_Case(const char *in_str, char *out_str, bool ToUpper)
+{
+  while (*in_str != '\0')
+  {
+    *out_str++ = ToUpper ? (char)toupper((unsigned char)*in_str) :
+                           (char)tolower((unsigned char)*in_str);
+    in_str++;
+  }
+
+  *out_str = '\0';
+}
+
+HAL_StatusTypeDef HAL_DDR_Dump_Param(HAL_DDR_ConfigTypeDef *config,
+                                     const char *name)
+{
+  (void)config;
+  (void)name;
+
+  printf("no DDR parameter in simulation\n\r");
+
+  return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_DDR_Dump_Reg(const char *name, bool save)
+{
+  HAL_StatusTypeDef result = HAL_ERROR;
+  unsigned int i;
+
+  (void)save;
+
+  for (i = 0; i < SIM_REG_NB; i++)
+  {
+    if ((name == NULL) || !strcmp(name, sim_reg[i].name))
+    {
+      printf("%s= 0x%08X\n\r", sim_reg[i].name, *sim_reg[i].reg);
+      result = HAL_OK;
+    }
+  }
+
+  return result;
+}
+
+HAL_StatusTypeDef HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
+                                     char *string)
+{
+  (void)string;
+
+  return HAL_DDR_Dump_Param(config, name);
+}
+
+void HAL_DDR_Edit_Reg(char *name, char *string)
+{
+  char reg_name[strlen(name) + 1];
+  unsigned int i;
+
+  HAL_DDR_Convert_Case(name, reg_name, true);
+
+  for (i = 0; i < SIM_REG_NB; i++)
+  {
+    if (!strcmp(reg_name, sim_reg[i].name))
+    {
+      *sim_reg[i].reg = (uint32_t)strtoul(string, NULL, 0);
+      (void)HAL_DDR_Dump_Reg(reg_name, false);
+      return;
+    }
+  }
+
+  printf("%s not found\n\r", name);
+}
+
+uint32_t HAL_DDR_Snapshot_Reg(uint32_t *value, uint32_t size)
+{
+  unsigned int i;
+
+  for (i = 0; (value != NULL) && (i < SIM_REG_NB) && (i < size); i++)
+  {
+    value[i] = *sim_reg[i].reg;
+  }
+
+  return SIM_REG_NB;
+}
+
+bool HAL_DDR_Snapshot_Name(uint32_t index, const char **base,
+                           const char **table, const char **name)
+{
+  if (index >= SIM_REG_NB)
+  {
+    return false;
+  }
+
+  *base = "ctl";
+  *table = "map";
+  *name = sim_reg[index].name;
+
+  return true;
+}
+
+HAL_StatusTypeDef HAL_DDR_Restore_Reg(const uint32_t *value, uint32_t nb)
+{
+  unsigned int i;
+
+  if (nb != SIM_REG_NB)
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0; i < SIM_REG_NB; i++)
+  {
+    *sim_reg[i].reg = value[i];
+  }
+
+  return HAL_OK;
+}
+
+void HAL_DDR_Dump_FwLog(void)
+{
+  printf("no training firmware in simulation\n\r");
+}
+
+void HAL_DDR_Dump_RetRegs(void)
+{
+  printf("no retention registers in simulation\n\r");
+}
+
+void HAL_DDR_Dump_PState(void)
+{
+  printf("no PHY pstate in simulation\n\r");
+}
+
+HAL_StatusTypeDef HAL_DDR_Set_PState(uint32_t pstate)
+{
+  return (pstate == 0U) ? HAL_OK : HAL_ERROR;
+}
+
+uint32_t HAL_DDR_Get_PState(void)
+{
+  return 0U;
+}
+
+void HAL_RCCEx_GetPLL2Config(RCC_PLLInitTypeDef *pll_config)
+{
+  pll_config->PLLState = RCC_PLL_ON;
+  pll_config->PLLSource = RCC_PLLSOURCE_HSE;
+  pll_config->FREFDIV = 1U;
+  pll_config->POSTDIV1 = 1U;
+  pll_config->POSTDIV2 = 1U;
+  pll_config->FBDIV = (uint32_t)(sim_pll2_rate / HSE_VALUE);
+  pll_config->FRACIN = (uint32_t)(((sim_pll2_rate % HSE_VALUE) << 24) / HSE_VALUE);
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PLL2Config(RCC_PLLInitTypeDef *pll_config)
+{
+  uint64_t div;
+
+  if (pll_config->PLLState != RCC_PLL_ON)
+  {
+    return HAL_OK;
+  }
+
+  div = (uint64_t)pll_config->FREFDIV * pll_config->POSTDIV1 *
+        pll_config->POSTDIV2;
+  if (div == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  sim_pll2_rate = (((uint64_t)HSE_VALUE * pll_config->FBDIV) +
+                   (((uint64_t)HSE_VALUE * pll_config->FRACIN) >> 24)) / div;
+
+  return HAL_OK;
+}
+
+uint32_t HAL_RCCEx_GetPLL2ClockFreq(void)
+{
+  return (uint32_t)sim_pll2_rate;
+}
@@ -0,0 +1,355 @@
+/**
+  ******************************************************************************
+  * @file    sim_main.c
+  * @author  MCD Application Team
+  * @brief   Host simulation of the DDR tests:
+  *          - DDR tool command shell on stdin (STM32MP2 only)
+  *          - regression: detection of the injected faults by each test
+  *          - benchmark: duration and throughput of each test
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "stm32_device_hal.h"
+#include "stm32mp_util_conf.h"
+#include "stm32mp_util_ddr_conf.h"
+#include "ddr_tests.h"
+#include "system_time.h"
+#include "uart_tx.h"
+
+/* Private typedef -----------------------------------------------------------*/
+#if defined(DDR_SIM_MP1)
+typedef uint32_t sim_arg;
+#else
+typedef unsigned long sim_arg;
+#endif
+
+typedef struct {
+  uint32_t (*fct)();
+  const char *name;
+  uint8_t nb_args;
+  sim_arg args[3];
+} sim_test;
+
+/* Private define ------------------------------------------------------------*/
+#define SIM_ADDR                  ((sim_arg)DDR_MEM_BASE)
+#define SIM_SIZE                  ((sim_arg)0x100000U)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Tests with their arguments in a 1MB window at the DDR base */
+static const sim_test sim_tests[] = {
+  {DDR_Test_Databus, "Databus", 1, {SIM_ADDR}},
+  {DDR_Test_DatabusWalk0, "DatabusWalk0", 2, {1, SIM_ADDR}},
+  {DDR_Test_DatabusWalk1, "DatabusWalk1", 2, {1, SIM_ADDR}},
+  {DDR_Test_AddressBus, "AddressBus", 2, {0, SIM_ADDR}},
+  {DDR_Test_MemDevice, "MemDevice", 2, {SIM_SIZE, SIM_ADDR}},
+  {DDR_Test_SimultaneousSwitchingOutput, "SimultaneousSwitchingOutput", 2,
+   {SIM_SIZE, SIM_ADDR}},
+  {DDR_Test_Noise, "Noise", 2, {0, SIM_ADDR}},
+  {DDR_Test_NoiseBurst, "NoiseBurst", 3, {SIM_SIZE, 0, SIM_ADDR}},
+  {DDR_Test_Random, "Random", 3, {SIM_SIZE, 1, SIM_ADDR}},
+  {DDR_Test_FrequencySelectivePattern, "FrequencySelectivePattern", 2,
+   {SIM_SIZE, SIM_ADDR}},
+  {DDR_Test_BlockSequential, "BlockSequential", 3, {SIM_SIZE, 1, SIM_ADDR}},
+  {DDR_Test_Checkerboard, "Checkerboard", 3, {SIM_SIZE, 1, SIM_ADDR}},
+  {DDR_Test_BitSpread, "BitSpread", 3, {SIM_SIZE, 1, SIM_ADDR}},
+  {DDR_Test_BitFlip, "BitFlip", 3, {SIM_SIZE, 1, SIM_ADDR}},
+  {DDR_Test_WalkingZeroes, "WalkingZeroes", 3, {SIM_SIZE, 1, SIM_ADDR}},
+  {DDR_Test_WalkingOnes, "WalkingOnes", 3, {SIM_SIZE, 1, SIM_ADDR}},
+};
+
+#define SIM_NB_TESTS              (sizeof(sim_tests) / sizeof(sim_tests[0]))
+
+/*
+ * Faults of the regression when none is given: stuck data bits, coupling
+ * and address bit 16 ignored, all inside the test window
+ */
+static const char * const sim_dflt_faults[] = {
+  "stuck1:0x100:0x1",
+  "stuck0:0x2000:0x80000000",
+  "coupling:0x40:0x4000:0x100",
+  "alias:16",
+};
+
+#define SIM_NB_DFLT_FAULTS        (sizeof(sim_dflt_faults) / sizeof(sim_dflt_faults[0]))
+
+static DDR_SimFaultDef sim_faults[DDR_SIM_FAULT_NB_MAX];
+static uint32_t sim_nb_faults;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+static void sim_usage(const char *name)
+{
+  printf("usage: %s [-f <fault>]... [-c | -b]\n"
+         "  -f <fault>  injects a fault, addresses relative to the DDR base:\n"
+         "              stuck0:<addr>:<mask>, stuck1:<addr>:<mask>,\n"
+         "              alias:<bit>, coupling:<aggressor>:<victim>:<mask>\n"
+         "  -c          regression: each test on the fault-free DDR then\n"
+         "              with each fault (default faults when none is given)\n"
+         "  -b          benchmark: duration and throughput of each test\n"
+#if defined(DDR_SIM_TOOL)
+         "  without -c and -b, DDR tool commands are read on stdin\n"
+#endif
+         , name);
+}
+
+static uint32_t sim_run(const sim_test *test)
+{
+  switch (test->nb_args)
+  {
+    case 1:
+      return test->fct(test->args[0]);
+    case 2:
+      return test->fct(test->args[0], test->args[1]);
+    default:
+      return test->fct(test->args[0], test->args[1], test->args[2]);
+  }
+}
+
+/* relative addresses of the faults in the DDR */
+static void sim_fault_rebase(DDR_SimFaultDef *fault)
+{
+  if (fault->type != DDR_SIM_FAULT_ALIAS)
+  {
+    fault->addr += DDR_MEM_BASE;
+    fault->victim += DDR_MEM_BASE;
+  }
+}
+
+static int sim_regression(void)
+{
+  static uint32_t result[DDR_SIM_FAULT_NB_MAX + 1][SIM_NB_TESTS];
+  uint32_t nb_scenarios = sim_nb_faults + 1U;
+  uint32_t detected;
+  uint32_t s;
+  uint32_t i;
+  int ret = 0;
+
+  /* scenario 0 is the fault-free DDR, then one fault per scenario */
+  for (s = 0; s < nb_scenarios; s++)
+  {
+    printf("\n\r== scenario %u: ", (unsigned int)s);
+    if (s == 0U)
+    {
+      printf("no fault\n\r");
+    }
+    else
+    {
+      DDR_Sim_PrintFault(&sim_faults[s - 1U]);
+    }
+
+    if (DDR_Sim_Init((s == 0U) ? NULL : &sim_faults[s - 1U],
+                     (s == 0U) ? 0U : 1U) != 0)
+    {
+      return 2;
+    }
+
+    for (i = 0; i < SIM_NB_TESTS; i++)
+    {
+      result[s][i] = sim_run(&sim_tests[i]);
+    }
+
+    DDR_Sim_DeInit();
+  }
+
+  printf("\n\r %-28s %6s", "test", "clean");
+  for (s = 1; s < nb_scenarios; s++)
+  {
+    printf("  f%-3u", (unsigned int)s);
+  }
+  printf("\n\r");
+
+  for (i = 0; i < SIM_NB_TESTS; i++)
+  {
+    printf(" %-28s %6s", sim_tests[i].name, (result[0][i] == 0U) ? "Pass" : "KO");
+    for (s = 1; s < nb_scenarios; s++)
+    {
+      printf("  %-4s", (result[s][i] != 0U) ? "det" : "-");
+    }
+    printf("\n\r");
+
+    if (result[0][i] != 0U)
+    {
+      ret = 1;
+    }
+  }
+
+  /* coverage: number of tests detecting each fault */
+  printf(" %-28s %6s", "detected by", "");
+  for (s = 1; s < nb_scenarios; s++)
+  {
+    detected = 0;
+    for (i = 0; i < SIM_NB_TESTS; i++)
+    {
+      detected += (result[s][i] != 0U) ? 1U : 0U;
+    }
+    printf("  %-4u", (unsigned int)detected);
+  }
+  printf("\n\r");
+
+  return ret;
+}
+
+static int sim_benchmark(void)
+{
+  uint64_t start;
+  uint64_t time_us;
+  uint32_t ret;
+  uint32_t i;
+#if !defined(DDR_SIM_MP1)
+  unsigned long written;
+  unsigned long read;
+#endif
+
+  if (DDR_Sim_Init(sim_faults, sim_nb_faults) != 0)
+  {
+    return 2;
+  }
+
+  printf("\n\r %-28s %6s %12s", "test", "result", "time (us)");
+#if !defined(DDR_SIM_MP1)
+  printf(" %12s %12s %8s", "write", "read", "MB/s");
+#endif
+  printf("\n\r");
+
+  for (i = 0; i < SIM_NB_TESTS; i++)
+  {
+#if !defined(DDR_SIM_MP1)
+    DDR_Test_ResetTraffic();
+#endif
+    start = time_get_counter();
+    ret = sim_run(&sim_tests[i]);
+    time_us = time_elapsed_us(start);
+
+    printf(" %-28s %6s %12lu", sim_tests[i].name, (ret == 0U) ? "Pass" : "KO",
+           (unsigned long)time_us);
+#if !defined(DDR_SIM_MP1)
+    DDR_Test_GetTraffic(&written, &read);
+    printf(" %12lu %12lu %8lu", written, read,
+           (time_us != 0U) ? (unsigned long)((written + read) / time_us) : 0UL);
+#endif
+    printf("\n\r");
+  }
+
+  printf("\n\rBenchmark:\n\r");
+  ret = DDR_Test_Benchmark(0x1000000U, 0, SIM_ADDR);
+
+  DDR_Sim_DeInit();
+
+  return (ret == 0U) ? 0 : 1;
+}
+
+#if defined(DDR_SIM_TOOL)
+/* DDR tool on stdin, the DDR initialization steps are simulated */
+static int sim_tool(void)
+{
+  static UART_HandleTypeDef sim_huart;
+  HAL_DDR_InteractStepTypeDef step = STEP_DDR_RESET;
+
+  if (DDR_Sim_Init(sim_faults, sim_nb_faults) != 0)
+  {
+    return 2;
+  }
+
+  /* console input echo and prompt through the buffered output */
+  UART_TX_Init(&sim_huart, false, NULL);
+
+  printf("=============== UTILITIES-DDR Tool (%s) ===============\n\r",
+         UTIL_MODEL);
+
+  while (step <= STEP_RUN)
+  {
+    if (HAL_DDR_Interactive(step))
+    {
+      step = STEP_DDR_RESET;
+      continue;
+    }
+    step++;
+  }
+
+  DDR_Sim_DeInit();
+
+  return 0;
+}
+#endif /* DDR_SIM_TOOL */
+
+int main(int argc, char *argv[])
+{
+  bool regression = false;
+  bool benchmark = false;
+  uint32_t i;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "f:cbh")) != -1)
+  {
+    switch (opt)
+    {
+      case 'f':
+        if (sim_nb_faults >= DDR_SIM_FAULT_NB_MAX)
+        {
+          printf("too many faults (max=%d)\n", DDR_SIM_FAULT_NB_MAX);
+          return 2;
+        }
+        if (DDR_Sim_ParseFault(optarg, &sim_faults[sim_nb_faults]) != 0)
+        {
+          printf("invalid fault: %s\n", optarg);
+          sim_usage(argv[0]);
+          return 2;
+        }
+        sim_fault_rebase(&sim_faults[sim_nb_faults]);
+        sim_nb_faults++;
+        break;
+      case 'c':
+        regression = true;
+        break;
+      case 'b':
+        benchmark = true;
+        break;
+      default:
+        sim_usage(argv[0]);
+        return (opt == 'h') ? 0 : 2;
+    }
+  }
+
+  if (regression)
+  {
+    if (sim_nb_faults == 0U)
+    {
+      for (i = 0; i < SIM_NB_DFLT_FAULTS; i++)
+      {
+        (void)DDR_Sim_ParseFault(sim_dflt_faults[i], &sim_faults[i]);
+        sim_fault_rebase(&sim_faults[i]);
+      }
+      sim_nb_faults = SIM_NB_DFLT_FAULTS;
+    }
+    return sim_regression();
+  }
+
+  if (benchmark)
+  {
+    return sim_benchmark();
+  }
+
+#if defined(DDR_SIM_TOOL)
+  return sim_tool();
+#else
+  sim_usage(argv[0]);
+  return 2;
+#endif
+}
@@ -46,21 +46,25 @@
   #define USARTx_CLK_ENABLE()              __HAL_RCC_UART4_CLK_ENABLE()
   #define USARTx_FORCE_RESET()             __HAL_RCC_UART4_FORCE_RESET()
   #define USARTx_RELEASE_RESET()           __HAL_RCC_UART4_RELEASE_RESET()
+  #define USARTx_IRQn                      UART4_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_UART5)
   #define USARTx                           UART5
   #define USARTx_CLK_ENABLE()              __HAL_RCC_UART5_CLK_ENABLE()
   #define USARTx_FORCE_RESET()             __HAL_RCC_UART5_FORCE_RESET()
   #define USARTx_RELEASE_RESET()           __HAL_RCC_UART5_RELEASE_RESET()
+  #define USARTx_IRQn                      UART5_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_UART7)
   #define USARTx                           UART7
   #define USARTx_CLK_ENABLE()              __HAL_RCC_UART7_CLK_ENABLE()
   #define USARTx_FORCE_RESET()             __HAL_RCC_UART7_FORCE_RESET()
   #define USARTx_RELEASE_RESET()           __HAL_RCC_UART7_RELEASE_RESET()
+  #define USARTx_IRQn                      UART7_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_UART8)
   #define USARTx                           UART8
   #define USARTx_CLK_ENABLE()              __HAL_RCC_UART8_CLK_ENABLE()
   #define USARTx_FORCE_RESET()             __HAL_RCC_UART8_FORCE_RESET()
   #define USARTx_RELEASE_RESET()           __HAL_RCC_UART8_RELEASE_RESET()
+  #define USARTx_IRQn                      UART8_IRQn
 #else
   #error "unknown UTIL_UART_INSTANCE definition."
 #endif
@@ -40,6 +40,7 @@
 //#define HAL_DAC_MODULE_ENABLED
 //#define HAL_DCMI_MODULE_ENABLED
 #define HAL_DDR_MODULE_ENABLED
+#define HAL_DDRPERFM_MODULE_ENABLED
 //#define HAL_DFSDM_MODULE_ENABLED
 #define HAL_DMA_MODULE_ENABLED
 //#define HAL_DSI_MODULE_ENABLED
@@ -235,6 +236,10 @@
  #include "stm32mp13xx_hal_ddr.h"
 #endif /* HAL_DDR_MODULE_ENABLED */
 
+#ifdef HAL_DDRPERFM_MODULE_ENABLED
+ #include "stm32mp13xx_hal_ddrperfm.h"
+#endif /* HAL_DDRPERFM_MODULE_ENABLED */
+
 #ifdef HAL_DFSDM_MODULE_ENABLED
  #include "stm32mp13xx_hal_dfsdm.h"
 #endif /* HAL_DFSDM_MODULE_ENABLED */
@@ -25,6 +25,7 @@
 #include "stm32mp15xx_disco.h"
 
 #include "ddr_tool_util.h"
+#include "uart_tx.h"
 #include "main.h"
 #include "stm32mp_util_conf.h"
 #include "stm32mp_util_ddr_conf.h"
@@ -39,10 +40,15 @@
 UART_HandleTypeDef huart;
 
 /* Private function prototypes -----------------------------------------------*/
+static void USARTx_IRQHandler(void);
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
+static void USARTx_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&huart);
+}
 
 /**
   * @brief  This function is executed to configure in case of error occurrence.
@@ -101,6 +107,13 @@ void UART_Config(void)
     Error_Handler();
   }
 
+  /* Buffered output, sent by the UART interrupt */
+  IRQ_Disable(USARTx_IRQn);
+  IRQ_SetHandler(USARTx_IRQn, USARTx_IRQHandler);
+  IRQ_SetMode(USARTx_IRQn, IRQ_MODE_TRIG_LEVEL);
+  IRQ_Enable(USARTx_IRQn);
+  UART_TX_Init(&huart, true, NULL);
+
   /* Output a message on Hyperterminal using printf function */
   printf("\n\r=============== UTILITIES-DDR Tool ===============\r");
   printf("\n\rModel: %s \r", UTIL_MODEL);
@@ -132,6 +145,8 @@ uint32_t Serial_Scanf(uint32_t value)
   uint16_t tmp = 0;
 
 #ifndef __TERMINAL_IO__
+  /* the prompt is fully sent before waiting */
+  UART_TX_Flush();
   __HAL_UART_CLEAR_OREFLAG(&huart);
   /* e.g. read a character from the EVAL_COM1 and Loop until RXNE = 1 */
   HAL_UART_Receive(&huart, (uint8_t *)&tmp, 1, HAL_TIMEOUT_VALUE);
@@ -154,8 +169,8 @@ uint32_t Serial_Scanf(uint32_t value)
 void Serial_Putchar(char value)
 {
 #ifndef __TERMINAL_IO__
-  /* e.g. read a character from the EVAL_COM1 and Loop until RXNE = 1 */
-  HAL_UART_Transmit(&huart, (uint8_t *)&value, 1, HAL_TIMEOUT_VALUE);
+  /* buffered, sent in background */
+  UART_TX_Write(&value, 1);
 #endif
 }
 
@@ -167,8 +182,8 @@ void Serial_Putchar(char value)
 void Serial_Printf(char *value, int len)
 {
 #ifndef __TERMINAL_IO__
-  /* e.g. read a character from the EVAL_COM1 and Loop until RXNE = 1 */
-  HAL_UART_Transmit(&huart, (uint8_t *)value, len, HAL_TIMEOUT_VALUE);
+  /* buffered, sent in background */
+  UART_TX_Write(value, len);
 #endif
 }
 
@@ -24,6 +24,8 @@
 #include "stm32mp235f_disco.h"
 
 #include "ddr_tool_util.h"
+#include "ddr_mmu.h"
+#include "uart_tx.h"
 #include "main.h"
 #include "stm32mp_util_conf.h"
 #include "stm32mp_util_ddr_conf.h"
@@ -37,11 +39,56 @@
 /* UART handler declaration, used for logging */
 UART_HandleTypeDef huart;
 
+/* DMA of the console output */
+static DMA_HandleTypeDef hdma_tx;
+
 /* Private function prototypes -----------------------------------------------*/
+static void UART_DMA_Config(UART_HandleTypeDef *uart);
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
+/*
+ * No interrupt in the tool: the DMA and UART flags are polled by UART_TX_Poll.
+ * Without DMA channel, the UART FIFO is filled by the polled UART handler.
+ */
+static void UART_DMA_Config(UART_HandleTypeDef *uart)
+{
+  __HAL_RCC_HPDMA1_CLK_ENABLE();
+
+  hdma_tx.Instance                         = UTIL_UART_DMA_CHANNEL;
+  hdma_tx.Init.Request                     = UTIL_UART_DMA_REQUEST;
+  hdma_tx.Init.BlkHWRequest                = DMA_BREQ_SINGLE_BURST;
+  hdma_tx.Init.Direction                   = DMA_MEMORY_TO_PERIPH;
+  hdma_tx.Init.SrcInc                      = DMA_SINC_INCREMENTED;
+  hdma_tx.Init.DestInc                     = DMA_DINC_FIXED;
+  hdma_tx.Init.SrcDataWidth                = DMA_SRC_DATAWIDTH_BYTE;
+  hdma_tx.Init.DestDataWidth               = DMA_DEST_DATAWIDTH_BYTE;
+  hdma_tx.Init.Priority                    = DMA_LOW_PRIORITY_LOW_WEIGHT;
+  hdma_tx.Init.SrcBurstLength              = 1;
+  hdma_tx.Init.DestBurstLength             = 1;
+  hdma_tx.Init.TransferAllocatedPort       = DMA_SRC_ALLOCATED_PORT0 |
+                                             DMA_DEST_ALLOCATED_PORT0;
+  hdma_tx.Init.TransferEventMode           = DMA_TCEM_BLOCK_TRANSFER;
+  hdma_tx.Init.Mode                        = DMA_NORMAL;
+
+  if (HAL_DMA_Init(&hdma_tx) != HAL_OK)
+  {
+    return;
+  }
+
+#if defined(CORTEX_IN_SECURE_STATE)
+  if (HAL_DMA_ConfigChannelAttributes(&hdma_tx, DMA_CHANNEL_PRIV |
+                                                DMA_CHANNEL_SEC |
+                                                DMA_CHANNEL_SRC_SEC |
+                                                DMA_CHANNEL_DEST_SEC) != HAL_OK)
+  {
+    return;
+  }
+#endif /* CORTEX_IN_SECURE_STATE */
+
+  __HAL_LINKDMA(uart, hdmatx, hdma_tx);
+}
 
 /**
   * @brief  This function is executed to configure in case of error occurrence.
@@ -78,6 +125,10 @@ void UART_Config(void)
     Error_Handler();
   }
 
+  /* Buffered output, sent by DMA */
+  UART_DMA_Config(&hcom_uart[COM1]);
+  UART_TX_Init(&hcom_uart[COM1], false, DDR_MMU_CleanInvalidate);
+
   /* Output a message on Hyperterminal using printf function */
   printf("\n\r=============== UTILITIES-DDR Tool ===============\r");
   printf("\n\rModel: %s \r", UTIL_MODEL);
@@ -109,6 +160,8 @@ uint32_t Serial_Scanf(uint32_t value)
   uint16_t tmp = 0;
 
 #ifndef __TERMINAL_IO__
+  /* the prompt is fully sent before waiting */
+  UART_TX_Flush();
   __HAL_UART_CLEAR_OREFLAG(&hcom_uart[COM1]);
   /* e.g. read a character from the EVAL_COM1 and Loop until RXNE = 1 */
   HAL_UART_Receive(&hcom_uart[COM1], (uint8_t *)&tmp, 1, HAL_TIMEOUT_VALUE);
@@ -131,8 +184,8 @@ uint32_t Serial_Scanf(uint32_t value)
 void Serial_Putchar(char value)
 {
 #ifndef __TERMINAL_IO__
-  /* e.g. read a character from the EVAL_COM1 and Loop until RXNE = 1 */
-  HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)&value, 1, HAL_TIMEOUT_VALUE);
+  /* buffered, sent in background */
+  UART_TX_Write(&value, 1);
 #endif
 }
 
@@ -144,8 +197,8 @@ void Serial_Putchar(char value)
 void Serial_Printf(char *value, int len)
 {
 #ifndef __TERMINAL_IO__
-  /* e.g. read a character from the EVAL_COM1 and Loop until RXNE = 1 */
-  HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)value, len, HAL_TIMEOUT_VALUE);
+  /* buffered, sent in background */
+  UART_TX_Write(value, len);
 #endif
 }
 
@@ -166,6 +219,7 @@ void Error_Handler(void)
     HAL_Delay(5000);
     printf("\n\r Error Handler \n\r");
     log_dbg("\n\r Why is there an error? \n\r");
+    UART_TX_Flush();
   }
 }
 
@@ -39,6 +39,9 @@
 #define UTIL_UART_STOPBITS      UART_STOPBITS_1
 #define UTIL_UART_PARITY        UART_PARITY_NONE
 #define UTIL_UART_HWFLOWCTL     UART_HWCONTROL_NONE
+/* buffered output sent by DMA */
+#define UTIL_UART_DMA_CHANNEL   HPDMA1_Channel11
+#define UTIL_UART_DMA_REQUEST   HPDMA_REQUEST_USART2_TX
 
 /* PMIC related configuration */
 #define UTIL_USE_PMIC                     1
@@ -0,0 +1,216 @@
+/**
+  ******************************************************************************
+  * @file    stm32mp13xx_hal_ddrperfm.h
+  * @author  MCD Application Team
+  * @brief   Header file of DDRPERFM HAL module.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef STM32MP13xx_HAL_DDRPERFM_H
+#define STM32MP13xx_HAL_DDRPERFM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32mp13xx_hal_def.h"
+
+#if defined (DDRPERFM)
+
+/** @addtogroup STM32MP13xx_HAL_Driver
+  * @{
+  */
+
+/** @addtogroup DDRPERFM
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup DDRPERFM_Exported_Constants DDRPERFM Exported Constants
+  * @{
+  */
+
+/** @defgroup DDRPERFM_Counters DDRPERFM event counters
+  * @{
+  */
+#define DDRPERFM_CNT_NB        4U
+#define DDRPERFM_CNT_0         DDRPERFM_CFG_EN_0
+#define DDRPERFM_CNT_1         DDRPERFM_CFG_EN_1
+#define DDRPERFM_CNT_2         DDRPERFM_CFG_EN_2
+#define DDRPERFM_CNT_3         DDRPERFM_CFG_EN_3
+#define DDRPERFM_CNT_ALL       DDRPERFM_CFG_EN
+/**
+  * @}
+  */
+
+/** @defgroup DDRPERFM_Sets DDRPERFM signal sets
+  * @{
+  */
+#define DDRPERFM_SET_0         0U
+#define DDRPERFM_SET_1         1U
+#define DDRPERFM_SET_2         2U
+#define DDRPERFM_SET_3         3U
+/**
+  * @}
+  */
+
+/** @defgroup DDRPERFM_Set0_Events DDRPERFM counter index of the set 0 events
+  * @{
+  */
+#define DDRPERFM_SET0_READ     0U  /*!< read commands (perf_op_is_rd) */
+#define DDRPERFM_SET0_WRITE    1U  /*!< write commands (perf_op_is_wr) */
+#define DDRPERFM_SET0_ACTIVATE 2U  /*!< activate commands (perf_op_is_activate) */
+#define DDRPERFM_SET0_IDLE     3U  /*!< controller idle cycles (ctl_idle) */
+/**
+  * @}
+  */
+
+/** @defgroup DDRPERFM_Overflow DDRPERFM overflow flags
+  * @{
+  */
+#define DDRPERFM_OVF_CNT       DDRPERFM_STATUS_COVF  /*!< event counter x overflow */
+#define DDRPERFM_OVF_TIME      DDRPERFM_STATUS_TOVF  /*!< time counter overflow */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup DDRPERFM_Exported_Types DDRPERFM Exported Types
+  * @{
+  */
+
+/**
+  * @brief  HAL DDRPERFM state definition
+  */
+typedef enum
+{
+  HAL_DDRPERFM_STATE_RESET = 0x00U,  /*!< DDRPERFM not initialized */
+  HAL_DDRPERFM_STATE_READY = 0x01U,  /*!< DDRPERFM initialized, counters stopped */
+  HAL_DDRPERFM_STATE_BUSY  = 0x02U,  /*!< DDRPERFM counting */
+} HAL_DDRPERFM_StateTypeDef;
+
+/**
+  * @brief  DDRPERFM configuration definition
+  */
+typedef struct
+{
+  uint32_t Set;       /*!< signal set, a value of @ref DDRPERFM_Sets */
+  uint32_t Counters;  /*!< enabled event counters, combination of
+                           @ref DDRPERFM_Counters */
+} DDRPERFM_InitTypeDef;
+
+/**
+  * @brief  DDRPERFM counts accumulated since the start
+  */
+typedef struct
+{
+  uint64_t Time;                      /*!< DDR controller clock cycles */
+  uint64_t Event[DDRPERFM_CNT_NB];    /*!< events of each counter */
+  uint32_t Overflow;                  /*!< @ref DDRPERFM_Overflow flags seen
+                                           since the start, each overflow
+                                           between two updates is counted
+                                           as 2^32 */
+} DDRPERFM_CountTypeDef;
+
+/**
+  * @brief  DDRPERFM handle definition
+  */
+typedef struct
+{
+  DDRPERFM_TypeDef                   *Instance;  /*!< register base address */
+  DDRPERFM_InitTypeDef               Init;       /*!< configuration */
+  DDRPERFM_CountTypeDef              Count;      /*!< accumulated counts */
+  __IO HAL_DDRPERFM_StateTypeDef     State;      /*!< state */
+} DDRPERFM_HandleTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup DDRPERFM_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup DDRPERFM_Exported_Functions_Group1
+  * @{
+  */
+HAL_StatusTypeDef HAL_DDRPERFM_Init(DDRPERFM_HandleTypeDef *hddrperfm);
+HAL_StatusTypeDef HAL_DDRPERFM_DeInit(DDRPERFM_HandleTypeDef *hddrperfm);
+/**
+  * @}
+  */
+
+/** @addtogroup DDRPERFM_Exported_Functions_Group2
+  * @{
+  */
+HAL_StatusTypeDef HAL_DDRPERFM_Start(DDRPERFM_HandleTypeDef *hddrperfm);
+HAL_StatusTypeDef HAL_DDRPERFM_Stop(DDRPERFM_HandleTypeDef *hddrperfm);
+HAL_StatusTypeDef HAL_DDRPERFM_Update(DDRPERFM_HandleTypeDef *hddrperfm);
+void HAL_DDRPERFM_IRQHandler(DDRPERFM_HandleTypeDef *hddrperfm);
+void HAL_DDRPERFM_OverflowCallback(DDRPERFM_HandleTypeDef *hddrperfm);
+/**
+  * @}
+  */
+
+/** @addtogroup DDRPERFM_Exported_Functions_Group3
+  * @{
+  */
+uint64_t HAL_DDRPERFM_GetTimeUs(const DDRPERFM_HandleTypeDef *hddrperfm,
+                                uint32_t ddr_freq_khz);
+uint32_t HAL_DDRPERFM_GetBandwidth(const DDRPERFM_HandleTypeDef *hddrperfm,
+                                   uint32_t counter, uint32_t bytes_per_event,
+                                   uint32_t ddr_freq_khz);
+uint32_t HAL_DDRPERFM_GetRatio(const DDRPERFM_HandleTypeDef *hddrperfm,
+                               uint32_t counter, uint32_t cycles_per_event);
+HAL_DDRPERFM_StateTypeDef HAL_DDRPERFM_GetState(const DDRPERFM_HandleTypeDef *hddrperfm);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Private macros ------------------------------------------------------------*/
+/** @defgroup DDRPERFM_Private_Macros DDRPERFM Private Macros
+  * @{
+  */
+#define IS_DDRPERFM_SET(__SET__)           ((__SET__) <= DDRPERFM_SET_3)
+#define IS_DDRPERFM_COUNTERS(__CNT__)      (((__CNT__) & ~DDRPERFM_CNT_ALL) == 0U)
+#define IS_DDRPERFM_COUNTER_INDEX(__IDX__) ((__IDX__) < DDRPERFM_CNT_NB)
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* DDRPERFM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32MP13xx_HAL_DDRPERFM_H */
@@ -559,51 +559,67 @@ HAL_DDR_ConfigTypeDef static_ddr_config =
 };
 
 /* Private function prototypes -----------------------------------------------*/
+static void start_sw_done(void);
+static HAL_StatusTypeDef wait_sw_done_ack(void);
+
 /** @defgroup DDR_Private_Functions DDR Private Functions
   * @{
   */
 
-static void ddr_delay_us(uint32_t delay_us)
+/**
+  * @brief  Convert a duration in us into generic timer counts
+  * @param  time_us duration in us
+  * @retval Number of counts, rounded up
+  */
+static uint64_t ddr_us_to_counter(uint32_t time_us)
 {
-  __IO uint32_t wait_loop_index = 0U;
-
-  wait_loop_index = (delay_us * (SystemCoreClock / (1000000UL * 2UL)));
-
+  uint64_t freq;
 
-  while (wait_loop_index != 0UL)
+  /* Generic timer is clocked by STGEN, same source selection as HAL_GetTick */
+  if ((RCC->STGENCKSELR & RCC_STGENCKSELR_STGENSRC) == RCC_STGENCLKSOURCE_HSE)
   {
-    wait_loop_index--;
+    freq = HSE_VALUE;
   }
+  else
+  {
+    freq = HSI_VALUE;
+  }
+
+  return (((uint64_t)time_us * freq) + 999999U) / 1000000U;
 }
 
 /**
   * @brief  Initialize DDR timeout in us
   * @param  timeout_us timeout in us
-  * @retval wait_loop_index
+  * @retval Counter value of the deadline
   */
-static __IO uint32_t ddr_timeout_init_us(uint32_t timeout_us)
+static uint64_t ddr_timeout_init_us(uint32_t timeout_us)
 {
-  __IO uint32_t wait_loop_index = 0U;
-
-  wait_loop_index = timeout_us * (SystemCoreClock / (1000000UL * 2UL));
-
-
-  return wait_loop_index;
+  return PL1_GetCurrentPhysicalValue() + ddr_us_to_counter(timeout_us);
 }
 
 /**
   * @brief  Check if timeout has expired
-  * @param  timeout timeout in us
+  * @param  timeout deadline returned by ddr_timeout_init_us
   * @retval Timeout status
   */
-static bool ddr_timeout_elapsed(__IO uint32_t timeout)
+static bool ddr_timeout_elapsed(uint64_t timeout)
+{
+  return PL1_GetCurrentPhysicalValue() >= timeout;
+}
+
+/**
+  * @brief  Wait a delay expressed in us
+  * @param  delay_us delay in us
+  * @retval None
+  */
+static void ddr_delay_us(uint32_t delay_us)
 {
-  if (timeout == 0U)
+  uint64_t timeout = ddr_timeout_init_us(delay_us);
+
+  while (!ddr_timeout_elapsed(timeout))
   {
-    return true;
   }
-
-  return false;
 }
 
 #ifndef DDR_INTERACTIVE
@@ -776,14 +792,13 @@ static HAL_StatusTypeDef set_reg(reg_type type, uint32_t param)
 #ifdef DDR_INTERACTIVE
 HAL_StatusTypeDef HAL_DDR_ASS_Set_Clksrc(uint32_t clksrc)
 {
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_200_MS);
+  uint64_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_200_MS);
 
   /* Set AXI Sub-System Clock Source */
   MODIFY_REG(RCC->ASSCKSELR, (RCC_ASSCKSELR_AXISSRC), clksrc);
 
   while ((RCC->ASSCKSELR & RCC_ASSCKSELR_AXISSRCRDY_Msk) != RCC_ASSCKSELR_AXISSRCRDY )
   {
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return HAL_TIMEOUT; /* Timeout setting clock source */
@@ -969,6 +984,117 @@ void HAL_DDR_Edit_Reg(char *name, char *string)
   printf("%s= 0x%08lx\n\r", desc->name, READ_REG(*(volatile uint32_t*)ptr));
 }
 
+/**
+  * @brief  Read the registers of all the tables of the print command, in the
+  *         order of HAL_DDR_Snapshot_Name(), for a binary snapshot.
+  * @param  value: destination of the values, NULL to count the registers
+  * @param  size: number of values of the destination
+  * @retval Number of registers
+  */
+uint32_t HAL_DDR_Snapshot_Reg(uint32_t *value, uint32_t size)
+{
+  unsigned int i, j;
+  uint32_t nb = 0U;
+  uint32_t base_addr;
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
+  {
+    base_addr = get_base_addr(ddr_registers[i].base);
+    for (j = 0; j < ddr_registers[i].size; j++)
+    {
+      if ((value != NULL) && (nb < size))
+      {
+        value[nb] = READ_REG(*(volatile uint32_t *)
+                             (base_addr + ddr_registers[i].desc[j].offset));
+      }
+      nb++;
+    }
+  }
+
+  return nb;
+}
+
+/**
+  * @brief  Name of a register of the snapshot.
+  * @param  index: position of the register in the snapshot
+  * @param  base: "ctl" or "phy"
+  * @param  table: name of the register table ("static", "timing"...)
+  * @param  name: name of the register
+  * @retval false when index is beyond the last register
+  */
+bool HAL_DDR_Snapshot_Name(uint32_t index, const char **base,
+                           const char **table, const char **name)
+{
+  unsigned int i;
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
+  {
+    if (index < ddr_registers[i].size)
+    {
+      *base = base_name[ddr_registers[i].base];
+      *table = ddr_registers[i].name;
+      *name = ddr_registers[i].desc[index].name;
+      return true;
+    }
+    index -= ddr_registers[i].size;
+  }
+
+  return false;
+}
+
+/**
+  * @brief  Write back the registers of a snapshot which differ from their
+  *         current value, the dynamic registers excepted. The DDRCTRL
+  *         registers are written under the SWCTL.sw_done handshake.
+  * @param  value: values read by HAL_DDR_Snapshot_Reg()
+  * @param  nb: number of values
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DDR_Restore_Reg(const uint32_t *value, uint32_t nb)
+{
+  unsigned int i, j;
+  uint32_t n = 0U;
+  uint32_t ptr;
+  HAL_StatusTypeDef ret;
+
+  if (nb != HAL_DDR_Snapshot_Reg(NULL, 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
+  {
+    for (j = 0; j < ddr_registers[i].size; j++, n++)
+    {
+      ptr = get_base_addr(ddr_registers[i].base) +
+            ddr_registers[i].desc[j].offset;
+      if ((i == REG_DYN) || (i == REGPHY_DYN) ||
+          (READ_REG(*(volatile uint32_t *)ptr) == value[n]))
+      {
+        continue;
+      }
+
+      if (ddr_registers[i].base == BASE_DDRCTRL)
+      {
+        start_sw_done();
+      }
+
+      WRITE_REG(*(volatile uint32_t *)ptr, value[n]);
+
+      if (ddr_registers[i].base == BASE_DDRCTRL)
+      {
+        ret = wait_sw_done_ack();
+        if (ret != HAL_OK)
+        {
+          return ret;
+        }
+      }
+    }
+  }
+
+  return HAL_OK;
+}
+
 static uint32_t get_par_addr(HAL_DDR_ConfigTypeDef *config, reg_type type)
 {
   uint32_t par_addr = 0x0;
@@ -1064,8 +1190,8 @@ HAL_StatusTypeDef HAL_DDR_Dump_Param(HAL_DDR_ConfigTypeDef *config,
   return result;
 }
 
-void HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
-                        char *string)
+HAL_StatusTypeDef HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
+                                     char *string)
 {
   uint32_t ptr;
   uint32_t value;
@@ -1078,20 +1204,20 @@ void HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
   if (!desc)
   {
     printf("%s not found\n\r", name);
-    return;
+    return HAL_ERROR;
   }
 
   value = (uint32_t)strtoll(string, &end_ptr, 0);
   if (end_ptr == string)
   {
     printf("invalid value %s\n\r", string);
-    return;
+    return HAL_ERROR;
   }
 
   par_addr = get_par_addr(config, type);
   if (!par_addr) {
     printf("no parameter %s\n\r", name);
-    return;
+    return HAL_ERROR;
   }
 
   ptr = (uint32_t)(par_addr + desc->par_offset);
@@ -1103,6 +1229,8 @@ void HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
     HAL_DDR_Convert_Case(desc->name, reg_name, 0); /* convert to lower case */
     printf("%s= 0x%08lx\n\r", reg_name, READ_REG(*(volatile uint32_t*)ptr));
   }
+
+  return HAL_OK;
 }
 #endif /* DDR_INTERACTIVE */
 
@@ -1120,13 +1248,12 @@ static HAL_StatusTypeDef ddrphy_idone_wait(void)
   uint32_t errormask = DDRPHYC_PGSR_DTERR | DDRPHYC_PGSR_DTIERR
                        | DDRPHYC_PGSR_DFTERR | DDRPHYC_PGSR_RVERR
                        | DDRPHYC_PGSR_RVEIRR;
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_50_US);
+  uint64_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_1S);
 
   do
   {
     pgsr = READ_REG(DDRPHYC->PGSR);
 
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return HAL_TIMEOUT; /* Timeout initialising DRAM */
@@ -1196,7 +1323,7 @@ static void start_sw_done(void)
 static HAL_StatusTypeDef wait_sw_done_ack(void)
 {
   uint32_t swstat;
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_1_US);
+  uint64_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_500_US);
 
   SET_BIT(DDRCTRL->SWCTL, DDRCTRL_SWCTL_SW_DONE);
 
@@ -1204,7 +1331,6 @@ static HAL_StatusTypeDef wait_sw_done_ack(void)
   {
     swstat = READ_REG(DDRCTRL->SWSTAT);
 
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return HAL_TIMEOUT; /* Timeout initialising DRAM */
@@ -1219,7 +1345,7 @@ static HAL_StatusTypeDef wait_operating_mode(uint32_t mode)
 {
   uint32_t stat;
   uint32_t break_loop = 0U;
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_1_US);
+  uint64_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_500_US);
 
   for (; ;)
   {
@@ -1230,7 +1356,6 @@ static HAL_StatusTypeDef wait_operating_mode(uint32_t mode)
     operating_mode = stat & DDRCTRL_STAT_OPERATING_MODE_Msk;
     selref_type = stat & DDRCTRL_STAT_SELFREF_TYPE_Msk;
 
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return HAL_TIMEOUT; /* Timeout initialising DRAM */
@@ -1286,7 +1411,7 @@ static void enable_axi_port(void)
 
 static int32_t disable_axi_port(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
 
   /* Disable uMCTL2 AXI port 0 */
   CLEAR_BIT(DDRCTRL->PCTRL_0, DDRCTRL_PCTRL_0_PORT_EN);
@@ -1301,7 +1426,6 @@ static int32_t disable_axi_port(void)
   timeout = ddr_timeout_init_us(DDR_TIMEOUT_1S);
   while (READ_REG(DDRCTRL->PSTAT) != 0U)
   {
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return -1;
@@ -1318,7 +1442,7 @@ static void enable_host_interface(void)
 
 static int32_t disable_host_interface(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t dbgcam;
   uint32_t count = 0;
 
@@ -1338,7 +1462,6 @@ static int32_t disable_host_interface(void)
   do
   {
     dbgcam = READ_REG(DDRCTRL->DBGCAM);
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return -1;
@@ -1352,7 +1475,7 @@ static int32_t disable_host_interface(void)
 
 static int32_t sw_selfref_entry(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t stat;
   uint32_t operating_mode;
   uint32_t selref_type;
@@ -1372,7 +1495,6 @@ static int32_t sw_selfref_entry(void)
     stat = READ_REG(DDRCTRL->STAT);
     operating_mode = stat & DDRCTRL_STAT_OPERATING_MODE_Msk;
     selref_type = stat & DDRCTRL_STAT_SELFREF_TYPE_Msk;
-    timeout--;
 
     if ((operating_mode == DDRCTRL_STAT_OPERATING_MODE_SR)
         && (selref_type == DDRCTRL_STAT_SELFREF_TYPE_SR))
@@ -1421,7 +1543,7 @@ static HAL_StatusTypeDef unset_qd3_update_conditions(void)
 
 static int32_t wait_refresh_update_done_ack(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t rfshctl3;
   uint32_t refresh_update_level  = DDRCTRL_RFSHCTL3_REFRESH_UPDATE_LEVEL;
 
@@ -1441,7 +1563,6 @@ static int32_t wait_refresh_update_done_ack(void)
   do
   {
     rfshctl3 = READ_REG(DDRCTRL->RFSHCTL3);
-    timeout--;
 
     if (ddr_timeout_elapsed(timeout))
     {
@@ -1457,7 +1578,7 @@ static int32_t wait_refresh_update_done_ack(void)
 static HAL_StatusTypeDef mode_register_write(uint32_t addr, uint32_t data)
 {
   uint32_t mrctrl0;
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_200_MS);
+  uint64_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_200_MS);
 
   /*
    * 1. Poll MRSTAT.mr_wr_busy until it is '0'.
@@ -1467,7 +1588,6 @@ static HAL_StatusTypeDef mode_register_write(uint32_t addr, uint32_t data)
    */
   while ((READ_REG(DDRCTRL->MRSTAT) & DDRCTRL_MRSTAT_MR_WR_BUSY) != 0U)
   {
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return HAL_TIMEOUT;
@@ -1499,7 +1619,6 @@ static HAL_StatusTypeDef mode_register_write(uint32_t addr, uint32_t data)
   timeout = ddr_timeout_init_us(DDR_TIMEOUT_200_MS);
   while ((READ_REG(DDRCTRL->MRSTAT) & DDRCTRL_MRSTAT_MR_WR_BUSY) != 0U)
   {
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return HAL_TIMEOUT;
@@ -1516,7 +1635,7 @@ static HAL_StatusTypeDef ddr3_dll_off(void)
   uint32_t mr1 = READ_REG(DDRPHYC->MR1);
   uint32_t mr2 = READ_REG(DDRPHYC->MR2);
   uint32_t dbgcam;
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_200_MS);
+  uint64_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_200_MS);
 
   /*
    * 1. Set the DBG1.dis_hif = 1.
@@ -1534,7 +1653,6 @@ static HAL_StatusTypeDef ddr3_dll_off(void)
    */
   do
   {
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return HAL_TIMEOUT;
@@ -1772,11 +1890,10 @@ static uint32_t get_timer(uint32_t base)
 static HAL_StatusTypeDef refresh_cmd(void)
 {
   uint32_t dbgstat;
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_200_MS);
+  uint64_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_200_MS);
 
   do
   {
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return HAL_TIMEOUT;
@@ -2754,7 +2871,7 @@ HAL_StatusTypeDef HAL_DDR_SR_Entry(uint32_t *zq0cr0_zdata)
 HAL_StatusTypeDef HAL_DDR_SR_Exit(void)
 {
   HAL_StatusTypeDef ret;
-  __IO uint32_t timeout;
+  uint64_t timeout;
 
   /* Enable all clocks */
   ddr_enable_clock();
@@ -2813,7 +2930,6 @@ HAL_StatusTypeDef HAL_DDR_SR_Exit(void)
 
   while ((READ_REG(DDRPHYC->PGSR) & DDRPHYC_PGSR_IDONE) == 0U)
   {
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return HAL_TIMEOUT;
@@ -2869,7 +2985,6 @@ HAL_StatusTypeDef HAL_DDR_SR_Exit(void)
   while ((READ_REG(DDRCTRL->STAT) & DDRCTRL_STAT_OPERATING_MODE_Msk)
          != DDRCTRL_STAT_OPERATING_MODE_NORMAL)
   {
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return HAL_TIMEOUT;
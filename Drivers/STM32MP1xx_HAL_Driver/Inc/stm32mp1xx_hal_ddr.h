@@ -279,9 +279,13 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step);
 HAL_StatusTypeDef HAL_DDR_Dump_Param(HAL_DDR_ConfigTypeDef *config,
                                      const char *name);
 HAL_StatusTypeDef HAL_DDR_Dump_Reg(const char *name, bool save);
-void HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
-                        char *string);
+HAL_StatusTypeDef HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
+                                     char *string);
 void HAL_DDR_Edit_Reg(char *name, char *string);
+uint32_t HAL_DDR_Snapshot_Reg(uint32_t *value, uint32_t size);
+bool HAL_DDR_Snapshot_Name(uint32_t index, const char **base,
+                           const char **table, const char **name);
+HAL_StatusTypeDef HAL_DDR_Restore_Reg(const uint32_t *value, uint32_t nb);
 #endif
 
 /**
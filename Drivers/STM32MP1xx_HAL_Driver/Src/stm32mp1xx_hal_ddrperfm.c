@@ -0,0 +1,515 @@
+/**
+  ******************************************************************************
+  * @file    stm32mp1xx_hal_ddrperfm.c
+  * @author  MCD Application Team
+  * @brief   DDRPERFM HAL module driver.
+  *          This file provides firmware functions to manage the following
+  *          functionalities of the DDR performance monitor (DDRPERFM):
+  *           + Initialization and de-initialization functions
+  *           + Counting functions
+  *           + Conversion functions
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  @verbatim
+  ==============================================================================
+                    ##### DDRPERFM Peripheral features #####
+  ==============================================================================
+  [..]
+    The DDRPERFM counts the events of one signal set of the DDR controller
+    on 4 event counters, with a time counter of the DDR controller clock
+    cycles. All the counters are 32-bit wide: at 533 MHz the time counter
+    overflows after about 8 s.
+
+  [..]
+    Signal set 0 counts the read commands, the write commands, the activate
+    commands and the controller idle cycles (@ref DDRPERFM_Set0_Events).
+
+                     ##### How to use this driver #####
+  ==============================================================================
+  [..]
+    (#) Fill the Instance and the Init structure of a DDRPERFM_HandleTypeDef
+        and call HAL_DDRPERFM_Init(), the peripheral clock is enabled.
+
+    (#) Count with HAL_DDRPERFM_Start() and HAL_DDRPERFM_Stop(): the counts
+        are accumulated on 64 bits in the Count member of the handle.
+
+    (#) For measurements longer than the counter overflow period, call
+        HAL_DDRPERFM_Update() periodically (about every 4 s at 533 MHz) to
+        move the counts of the hardware counters to the handle, it does not
+        wait and can be called from an interrupt handler.
+        A counter overflow between two updates adds 2^32 to its count and is
+        reported in Count.Overflow; when the DDRPERFM interrupt is used,
+        HAL_DDRPERFM_IRQHandler() updates the counts and calls
+        HAL_DDRPERFM_OverflowCallback().
+
+    (#) Convert the counts with HAL_DDRPERFM_GetTimeUs(),
+        HAL_DDRPERFM_GetBandwidth() and HAL_DDRPERFM_GetRatio().
+
+  @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32mp1xx_hal.h"
+
+#include <string.h>
+
+/** @addtogroup STM32MP1xx_HAL_Driver
+  * @{
+  */
+
+/** @defgroup DDRPERFM DDRPERFM
+  * @brief DDRPERFM HAL module driver
+  * @{
+  */
+
+#ifdef HAL_DDRPERFM_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines ------------------------------------------------------------*/
+/** @addtogroup DDRPERFM_Private_Constants DDRPERFM Private Constants
+  * @{
+  */
+#define DDRPERFM_TIMEOUT_VALUE  10U   /* 10 ms */
+#define DDRPERFM_WRAP           0x100000000ULL  /* counts of one overflow */
+/**
+  * @}
+  */
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup DDRPERFM_Private_Functions
+  * @{
+  */
+static HAL_StatusTypeDef DDRPERFM_WaitNotBusy(const DDRPERFM_HandleTypeDef *hddrperfm);
+static uint32_t DDRPERFM_ReadCounter(const DDRPERFM_HandleTypeDef *hddrperfm,
+                                     uint32_t counter);
+static void DDRPERFM_Accumulate(DDRPERFM_HandleTypeDef *hddrperfm);
+static void DDRPERFM_Clear(const DDRPERFM_HandleTypeDef *hddrperfm);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup DDRPERFM_Exported_Functions DDRPERFM Exported Functions
+  * @{
+  */
+
+/** @defgroup DDRPERFM_Exported_Functions_Group1 Initialization and de-initialization functions
+ *  @brief    Initialization and Configuration functions
+ *
+@verbatim
+ ===============================================================================
+              ##### Initialization and de-initialization functions #####
+ ===============================================================================
+  [..]
+    This section provides functions allowing to initialize and de-initialize
+    the DDRPERFM.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize the DDRPERFM: clock, signal set and enabled counters.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DDRPERFM_Init(DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  if (hddrperfm == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  assert_param(IS_DDRPERFM_SET(hddrperfm->Init.Set));
+  assert_param(IS_DDRPERFM_COUNTERS(hddrperfm->Init.Counters));
+
+  __HAL_RCC_DDRPERFM_CLK_ENABLE();
+
+  hddrperfm->Instance->CTL = DDRPERFM_CTL_STOP;
+  if (DDRPERFM_WaitNotBusy(hddrperfm) != HAL_OK)
+  {
+    return HAL_TIMEOUT;
+  }
+
+  hddrperfm->Instance->IER = 0U;
+  hddrperfm->Instance->ICR = DDRPERFM_ICR_OVF;
+  hddrperfm->Instance->CFG =
+    ((hddrperfm->Init.Set << DDRPERFM_CFG_SEL_Pos) & DDRPERFM_CFG_SEL) |
+    (hddrperfm->Init.Counters & DDRPERFM_CFG_EN);
+  DDRPERFM_Clear(hddrperfm);
+
+  memset(&hddrperfm->Count, 0, sizeof(hddrperfm->Count));
+  hddrperfm->State = HAL_DDRPERFM_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  De-initialize the DDRPERFM: counters stopped and clock disabled.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DDRPERFM_DeInit(DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  if (hddrperfm == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  hddrperfm->Instance->CTL = DDRPERFM_CTL_STOP;
+  (void)DDRPERFM_WaitNotBusy(hddrperfm);
+  hddrperfm->Instance->IER = 0U;
+  hddrperfm->Instance->CFG = 0U;
+
+  __HAL_RCC_DDRPERFM_CLK_DISABLE();
+
+  hddrperfm->State = HAL_DDRPERFM_STATE_RESET;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup DDRPERFM_Exported_Functions_Group2 Counting functions
+ *  @brief    Start, stop and update of the counts
+ *
+@verbatim
+ ===============================================================================
+                      ##### Counting functions #####
+ ===============================================================================
+  [..]
+    This section provides functions allowing to count the DDR controller
+    events and to accumulate them on 64 bits.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Clear the counts and start the counters.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DDRPERFM_Start(DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  if (hddrperfm->State != HAL_DDRPERFM_STATE_READY)
+  {
+    return HAL_ERROR;
+  }
+
+  DDRPERFM_Clear(hddrperfm);
+  memset(&hddrperfm->Count, 0, sizeof(hddrperfm->Count));
+
+  hddrperfm->State = HAL_DDRPERFM_STATE_BUSY;
+  hddrperfm->Instance->CTL = DDRPERFM_CTL_START;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the counters and add their values to the counts.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DDRPERFM_Stop(DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  if (hddrperfm->State != HAL_DDRPERFM_STATE_BUSY)
+  {
+    return HAL_ERROR;
+  }
+
+  hddrperfm->Instance->CTL = DDRPERFM_CTL_STOP;
+  if (DDRPERFM_WaitNotBusy(hddrperfm) != HAL_OK)
+  {
+    return HAL_TIMEOUT;
+  }
+
+  DDRPERFM_Accumulate(hddrperfm);
+  DDRPERFM_Clear(hddrperfm);
+
+  hddrperfm->State = HAL_DDRPERFM_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Add the values of the counters to the counts and restart them
+  *         from 0, to be called before the overflow of the time counter.
+  *         The counters are frozen, read and cleared without waiting: this
+  *         function can be called from an interrupt handler.
+  *         The few cycles of the stop and restart are not counted.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DDRPERFM_Update(DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  if (hddrperfm->State != HAL_DDRPERFM_STATE_BUSY)
+  {
+    return HAL_ERROR;
+  }
+
+  hddrperfm->Instance->CTL = DDRPERFM_CTL_STOP;
+
+  DDRPERFM_Accumulate(hddrperfm);
+  DDRPERFM_Clear(hddrperfm);
+
+  hddrperfm->Instance->CTL = DDRPERFM_CTL_START;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Handle the DDRPERFM overflow interrupt: counts updated and
+  *         overflow callback called.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval None
+  */
+void HAL_DDRPERFM_IRQHandler(DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  if ((hddrperfm->Instance->ISR & DDRPERFM_ISR_OVFF) == 0U)
+  {
+    return;
+  }
+
+  (void)HAL_DDRPERFM_Update(hddrperfm);
+  hddrperfm->Instance->ICR = DDRPERFM_ICR_OVF;
+
+  HAL_DDRPERFM_OverflowCallback(hddrperfm);
+}
+
+/**
+  * @brief  DDRPERFM overflow callback.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval None
+  */
+__weak void HAL_DDRPERFM_OverflowCallback(DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hddrperfm);
+
+  /* NOTE: This function should not be modified, when the callback is needed,
+           the HAL_DDRPERFM_OverflowCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup DDRPERFM_Exported_Functions_Group3 Conversion functions
+ *  @brief    Conversion of the counts
+ *
+@verbatim
+ ===============================================================================
+                      ##### Conversion functions #####
+ ===============================================================================
+  [..]
+    This section provides functions converting the accumulated counts in
+    duration, bandwidth and utilisation of the DDR controller.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Duration of the counts.
+  * @param  hddrperfm: DDRPERFM handle
+  * @param  ddr_freq_khz: DDR controller clock frequency in kHz
+  * @retval duration in us
+  */
+uint64_t HAL_DDRPERFM_GetTimeUs(const DDRPERFM_HandleTypeDef *hddrperfm,
+                                uint32_t ddr_freq_khz)
+{
+  if (ddr_freq_khz == 0U)
+  {
+    return 0U;
+  }
+
+  return (hddrperfm->Count.Time * 1000U) / ddr_freq_khz;
+}
+
+/**
+  * @brief  Bandwidth of the events of one counter.
+  * @param  hddrperfm: DDRPERFM handle
+  * @param  counter: index of the counter (0 to 3)
+  * @param  bytes_per_event: bytes transferred by each event
+  * @param  ddr_freq_khz: DDR controller clock frequency in kHz
+  * @retval bandwidth in MB/s (10^6 bytes per second)
+  */
+uint32_t HAL_DDRPERFM_GetBandwidth(const DDRPERFM_HandleTypeDef *hddrperfm,
+                                   uint32_t counter, uint32_t bytes_per_event,
+                                   uint32_t ddr_freq_khz)
+{
+  uint64_t time_us;
+
+  assert_param(IS_DDRPERFM_COUNTER_INDEX(counter));
+
+  time_us = HAL_DDRPERFM_GetTimeUs(hddrperfm, ddr_freq_khz);
+  if (time_us == 0U)
+  {
+    return 0U;
+  }
+
+  return (uint32_t)((hddrperfm->Count.Event[counter] * bytes_per_event) /
+                    time_us);
+}
+
+/**
+  * @brief  Ratio of the DDR controller cycles used by the events of one
+  *         counter.
+  * @param  hddrperfm: DDRPERFM handle
+  * @param  counter: index of the counter (0 to 3)
+  * @param  cycles_per_event: DDR controller cycles of each event, 1 for the
+  *         events counting cycles (idle)
+  * @retval ratio in per-mille, limited to 1000
+  */
+uint32_t HAL_DDRPERFM_GetRatio(const DDRPERFM_HandleTypeDef *hddrperfm,
+                               uint32_t counter, uint32_t cycles_per_event)
+{
+  uint64_t ratio;
+
+  assert_param(IS_DDRPERFM_COUNTER_INDEX(counter));
+
+  if (hddrperfm->Count.Time == 0U)
+  {
+    return 0U;
+  }
+
+  ratio = (hddrperfm->Count.Event[counter] * cycles_per_event * 1000U) /
+          hddrperfm->Count.Time;
+
+  return (ratio > 1000U) ? 1000U : (uint32_t)ratio;
+}
+
+/**
+  * @brief  Return the DDRPERFM state.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval HAL state
+  */
+HAL_DDRPERFM_StateTypeDef HAL_DDRPERFM_GetState(const DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  return hddrperfm->State;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup DDRPERFM_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Wait for the end of the counters start or stop.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef DDRPERFM_WaitNotBusy(const DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while ((hddrperfm->Instance->STATUS & DDRPERFM_STATUS_BUSY) != 0U)
+  {
+    if ((HAL_GetTick() - tickstart) > DDRPERFM_TIMEOUT_VALUE)
+    {
+      return HAL_TIMEOUT;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Read one event counter.
+  * @param  hddrperfm: DDRPERFM handle
+  * @param  counter: index of the counter (0 to 3)
+  * @retval counter value
+  */
+static uint32_t DDRPERFM_ReadCounter(const DDRPERFM_HandleTypeDef *hddrperfm,
+                                     uint32_t counter)
+{
+  switch (counter)
+  {
+    case 0:
+      return hddrperfm->Instance->CNT0;
+    case 1:
+      return hddrperfm->Instance->CNT1;
+    case 2:
+      return hddrperfm->Instance->CNT2;
+    default:
+      return hddrperfm->Instance->CNT3;
+  }
+}
+
+/**
+  * @brief  Add the stopped counters to the counts, with 2^32 for each
+  *         counter which overflowed since its last clear.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval None
+  */
+static void DDRPERFM_Accumulate(DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  uint32_t status = hddrperfm->Instance->STATUS;
+  uint32_t i;
+
+  hddrperfm->Count.Time += hddrperfm->Instance->TCNT;
+  if ((status & DDRPERFM_OVF_TIME) != 0U)
+  {
+    hddrperfm->Count.Time += DDRPERFM_WRAP;
+  }
+
+  for (i = 0; i < DDRPERFM_CNT_NB; i++)
+  {
+    if ((hddrperfm->Init.Counters & (DDRPERFM_CNT_0 << i)) != 0U)
+    {
+      hddrperfm->Count.Event[i] += DDRPERFM_ReadCounter(hddrperfm, i);
+      if ((status & (DDRPERFM_STATUS_COVF_0 << i)) != 0U)
+      {
+        hddrperfm->Count.Event[i] += DDRPERFM_WRAP;
+      }
+    }
+  }
+
+  hddrperfm->Count.Overflow |= status & (DDRPERFM_OVF_CNT | DDRPERFM_OVF_TIME);
+}
+
+/**
+  * @brief  Clear the time and event counters, with their overflow flags.
+  * @param  hddrperfm: DDRPERFM handle
+  * @retval None
+  */
+static void DDRPERFM_Clear(const DDRPERFM_HandleTypeDef *hddrperfm)
+{
+  hddrperfm->Instance->CCR = DDRPERFM_CCR_TCLR | DDRPERFM_CCR_CCLR;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_DDRPERFM_MODULE_ENABLED */
+/**
+  * @}
+  */
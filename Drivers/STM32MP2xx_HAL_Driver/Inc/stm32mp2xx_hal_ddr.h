@@ -43,12 +43,29 @@ extern "C" {
   * @{
   */
 
-/* Maximum number of PHY pstates used by the driver */
+/*
+ * Maximum number of PHY pstates used by the driver: 2 with
+ * STM32MP_DDR_NB_PSTATES=2 to train a low-power frequency in pstate 1
+ */
+#ifdef STM32MP_DDR_NB_PSTATES
+#define HAL_DDR_MAX_PSTATE STM32MP_DDR_NB_PSTATES
+#else /* STM32MP_DDR_NB_PSTATES */
 #define HAL_DDR_MAX_PSTATE 1
+#endif /* STM32MP_DDR_NB_PSTATES */
+
+#if (HAL_DDR_MAX_PSTATE < 1) || (HAL_DDR_MAX_PSTATE > 2)
+#error "STM32MP_DDR_NB_PSTATES shall be 1 or 2"
+#endif /* HAL_DDR_MAX_PSTATE */
 
 /* Maximum Number of swizzling parameters */
 #define HAL_DDR_MAX_SWIZZLE_PARAM 44
 
+/* Size of the trained state snapshot area */
+#define HAL_DDR_TRAINED_STATE_SIZE (0x1000U * HAL_DDR_MAX_PSTATE)
+
+/* Size of the recorded PHY initialization area */
+#define HAL_DDR_CSR_STREAM_SIZE   (0x4000U * HAL_DDR_MAX_PSTATE)
+
 /**
   * @brief  HAL DDR type definition
   */
@@ -365,6 +382,47 @@ typedef struct
                                  Specifies if backup should be cleared after
                                  DDR initialization (DDR lost content case).
                                  Clear requested if true. */
+
+  void *trained_state;      /*!< [input]
+                                 Specifies the address of a trained state
+                                 snapshot area of HAL_DDR_TRAINED_STATE_SIZE
+                                 bytes, in retention memory or provided by the
+                                 host. NULL to always execute the training.
+                                 When the snapshot matches the DDR settings,
+                                 the PHY training is skipped and its results
+                                 are restored from the snapshot. Otherwise the
+                                 snapshot is updated after the training. Not
+                                 used if wakeup_from_standby is true. */
+
+  bool trained_state_restored; /*!< [output]
+                                 Specifies if the training results have been
+                                 restored from the trained state snapshot,
+                                 validated by the data/addr tests (when the
+                                 core is TDCID). */
+
+  bool trained_state_retrained; /*!< [output]
+                                 Specifies if the restored training results
+                                 failed: the snapshot has been invalidated
+                                 and the DDR successfully initialized again
+                                 with the training, updating the snapshot. */
+
+  void *csr_stream;         /*!< [input]
+                                 Specifies the address of an area of
+                                 HAL_DDR_CSR_STREAM_SIZE bytes, in retention
+                                 memory or provided by the host, recording
+                                 the PHY register writes of an initialization
+                                 without training. NULL to always execute
+                                 the PhyInit sequence. When the recording
+                                 matches the DDR settings, it is replayed
+                                 instead of the sequence, otherwise it is
+                                 updated. Used when the training is skipped:
+                                 standby exit or trained state restored. */
+
+  bool csr_stream_replayed; /*!< [output]
+                                 Specifies if the PHY register writes have
+                                 been replayed from the recording. The
+                                 recording is invalidated if the DDR
+                                 initialization fails in this case. */
 } DDR_InitTypeDef;
 
 /**
@@ -401,16 +459,29 @@ HAL_StatusTypeDef HAL_DDR_SR_Exit(void);
 HAL_StatusTypeDef HAL_DDR_SR_SetMode(HAL_DDR_SelfRefreshModeTypeDef mode);
 HAL_DDR_SelfRefreshModeTypeDef HAL_DDR_SR_ReadMode(void);
 HAL_StatusTypeDef HAL_DDR_SetRetentionAreaBase(uint64_t base);
+HAL_StatusTypeDef HAL_DDR_Set_PState(uint32_t pstate);
+uint32_t HAL_DDR_Get_PState(void);
+uint64_t HAL_DDR_Get_Counter(void);
+uint64_t HAL_DDR_Us_To_Counter(uint64_t time_us);
+uint64_t HAL_DDR_Counter_To_Us(uint64_t count);
 
 #ifdef DDR_INTERACTIVE
 void HAL_DDR_Convert_Case(const char *in_str, char *out_str, bool ToUpper);
 bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step);
+bool HAL_DDR_Interactive_Error(HAL_DDR_InteractStepTypeDef step);
 HAL_StatusTypeDef HAL_DDR_Dump_Param(HAL_DDR_ConfigTypeDef *config,
                                      const char *name);
 HAL_StatusTypeDef HAL_DDR_Dump_Reg(const char *name, bool save);
-void HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
-                        char *string);
+HAL_StatusTypeDef HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
+                                     char *string);
 void HAL_DDR_Edit_Reg(char *name, char *string);
+void HAL_DDR_Dump_FwLog(void);
+void HAL_DDR_Dump_RetRegs(void);
+void HAL_DDR_Dump_PState(void);
+uint32_t HAL_DDR_Snapshot_Reg(uint32_t *value, uint32_t size);
+bool HAL_DDR_Snapshot_Name(uint32_t index, const char **base,
+                           const char **table, const char **name);
+HAL_StatusTypeDef HAL_DDR_Restore_Reg(const uint32_t *value, uint32_t nb);
 #endif /* DDR_INTERACTIVE */
 
 /**
@@ -22,7 +22,12 @@
  * correctly for your PHY variant and process technology.
  */
 
+/* Number of PHY pstates, up to 2 with STM32MP_DDR_NB_PSTATES */
+#ifdef STM32MP_DDR_NB_PSTATES
+#define NB_PS STM32MP_DDR_NB_PSTATES
+#else /* STM32MP_DDR_NB_PSTATES */
 #define NB_PS 1
+#endif /* STM32MP_DDR_NB_PSTATES */
 
 /* Enumerator for DRAM Type */
 /* DRAM Type definitions */
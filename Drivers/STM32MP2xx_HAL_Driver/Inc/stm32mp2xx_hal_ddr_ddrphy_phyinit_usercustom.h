@@ -16,9 +16,15 @@
 #define DDRPHY_PHYINIT_USERCUSTOM_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#ifdef DDRPHY_PHYINIT_HOST
+/* Host build of PhyInit by the generator of Scripts/ddrphyinit */
+#include "ddrphy_phyinit_host.h"
+#else /* DDRPHY_PHYINIT_HOST */
 #include "stm32mp2xx_hal.h"
+#endif /* DDRPHY_PHYINIT_HOST */
 #include "stm32mp2xx_hal_ddr_ddrphy_phyinit_struct.h"
 
 #include "stm32mp2xx_hal_ddr_ddrphy_csr_all_cdefines.h"
@@ -79,6 +85,18 @@ extern uint32_t FW_DDR_START;
  */
 #define SR_IMEM_SIZE          16384
 
+/*
+ * Number of entries of the training firmware message log printed by
+ * ddrphy_phyinit_usercustom_fwlog_dump(), 0 to disable the log.
+ */
+#ifndef DDRPHY_PHYINIT_FW_LOG_SIZE
+#ifdef DDR_INTERACTIVE
+#define DDRPHY_PHYINIT_FW_LOG_SIZE 256U
+#else /* DDR_INTERACTIVE */
+#define DDRPHY_PHYINIT_FW_LOG_SIZE 0U
+#endif /* DDR_INTERACTIVE */
+#endif /* DDRPHY_PHYINIT_FW_LOG_SIZE */
+
 /*
  * ------------------
  * Type definitions
@@ -101,6 +119,48 @@ typedef struct {
   uint16_t  value;   /* Register value */
 } reg_addr_val_t;
 
+/*
+ * Header of a serialized copy of the retention registers, followed by
+ * numregs reg_addr_val_t address, value pairs.
+ */
+typedef struct {
+  uint32_t  magic;    /* RETREGS_SNAPSHOT_MAGIC */
+  uint32_t  hash;     /* Configuration hash provided by the caller */
+  uint32_t  numregs;  /* Number of address, value pairs */
+  uint32_t  checksum; /* CRC32 of header (checksum = 0) and pairs */
+} retregs_snapshot_t;
+
+#define RETREGS_SNAPSHOT_MAGIC     0x53525444U /* "DTRS" */
+
+/*
+ * Header of a recorded PHY initialization, followed by size bytes of
+ * encoded register writes, replayed by ddrphy_phyinit_replaycsrs().
+ */
+typedef struct {
+  uint32_t  magic;     /* CSRSTREAM_MAGIC */
+  uint32_t  hash;      /* Configuration hash provided by the caller */
+  uint32_t  numwrites; /* Number of recorded register writes */
+  uint32_t  size;      /* Size of the encoded writes in bytes */
+  uint32_t  checksum;  /* CRC32 of header (magic = checksum = 0) and writes */
+} csrstream_t;
+
+#define CSRSTREAM_MAGIC            0x53525343U /* "CSRS" */
+
+/*
+ * Results of ddrphy_phyinit_initstruct(), ddrphy_phyinit_calcmb() and
+ * ddrphy_phyinit_c_initphyconfig() computed on the host by Scripts/ddrphyinit
+ * for a static configuration, loaded by ddrphy_phyinit_loadprecomp().
+ */
+typedef struct {
+  uint32_t  uihash;                     /* ddrphy_phyinit_uihash() of the user inputs */
+  uint32_t  mbsize;                     /* Size of pmu_smb_ddr_1d_t in bytes */
+  const uint16_t *mb;                   /* mb_ddr_1d[NB_PS] */
+  const uint16_t *shdw;                 /* shdw_ddr_1d[NB_PS] */
+  int32_t   ardptrinitval[NB_PS];       /* ardptrinitval[NB_PS] */
+  uint32_t  numregs;                    /* Number of register writes */
+  const reg_addr_val_t *regs;           /* Register index, value of each write */
+} phyinit_precomp_t;
+
 /* TargetCSR Target CSR for the impedance value for ddrphy_phyinit_mapdrvstren() */
 typedef enum {
   DRVSTRENFSDQP,
@@ -138,7 +198,16 @@ typedef enum {
  */
 
 extern int32_t ardptrinitval[NB_PS];
+extern bool csrstream_record;
+
+void ddrphy_phyinit_recordcsr(uintptr_t addr, uint32_t value);
 
+#ifdef DDRPHY_PHYINIT_HOST
+/* Register accesses implemented by the host generator */
+void mmio_write_16(uintptr_t addr, uint16_t value);
+uint16_t mmio_read_16(uintptr_t addr);
+void mmio_write_32(uintptr_t addr, uint32_t value);
+#else /* DDRPHY_PHYINIT_HOST */
 static inline void mmio_write_16(uintptr_t addr, uint16_t value)
 {
   uint32_t data;
@@ -147,6 +216,11 @@ static inline void mmio_write_16(uintptr_t addr, uint16_t value)
   data &= 0xFFFF0000U;
   data |= (uint32_t)value;
   WRITE_REG(*(volatile uint32_t*)addr, data);
+
+  if (csrstream_record)
+  {
+    ddrphy_phyinit_recordcsr(addr, data);
+  }
 }
 
 static inline uint16_t mmio_read_16(uintptr_t addr)
@@ -157,7 +231,13 @@ static inline uint16_t mmio_read_16(uintptr_t addr)
 static inline void mmio_write_32(uintptr_t addr, uint32_t value)
 {
   WRITE_REG(*(volatile uint32_t*)addr, value);
+
+  if (csrstream_record)
+  {
+    ddrphy_phyinit_recordcsr(addr, value);
+  }
 }
+#endif /* DDRPHY_PHYINIT_HOST */
 
 #define VERBOSE(...)
 #define ERROR(...)
@@ -187,10 +267,26 @@ int32_t ddrphy_phyinit_isdbytedisabled(int32_t dbytenumber);
 int32_t ddrphy_phyinit_setretreglistbase(uintptr_t base);
 int32_t ddrphy_phyinit_trackreg(uint32_t adr);
 int32_t ddrphy_phyinit_reginterface(reginstr myreginstr, uint32_t adr, uint16_t dat);
+int32_t ddrphy_phyinit_getretregs(const reg_addr_val_t **list, int32_t *numtracked,
+                                  uint32_t *save_us, uint32_t *restore_us);
+uint32_t ddrphy_phyinit_crc32(uint32_t crc, const void *buf, size_t len);
+int32_t ddrphy_phyinit_exportretregs(void *buf, size_t size, uint32_t hash);
+int32_t ddrphy_phyinit_importretregs(const void *buf, uint32_t hash);
+void ddrphy_phyinit_startcsrrecord(void *buf, size_t size);
+int32_t ddrphy_phyinit_stopcsrrecord(bool valid, uint32_t hash);
+int32_t ddrphy_phyinit_replaycsrs(const void *buf, size_t size, uint32_t hash);
+uint32_t ddrphy_phyinit_uihash(void);
+void ddrphy_phyinit_setprecomp(const phyinit_precomp_t *table);
+int32_t ddrphy_phyinit_loadprecomp(void);
 
 extern void ddrphy_phyinit_usercustom_pretrain(void);
 extern void ddrphy_phyinit_usercustom_posttrain(void);
+extern int32_t ddrphy_phyinit_usercustom_e_setdficlk(int32_t pstate);
 extern int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void);
+extern void ddrphy_phyinit_usercustom_g_trainresult(int32_t pstate, int32_t result);
+extern const char *ddrphy_phyinit_usercustom_fwstring(uint32_t id);
+extern void ddrphy_phyinit_usercustom_fwlog_dump(void);
+extern void ddrphy_phyinit_usercustom_pstate_dump(void);
 extern int32_t ddrphy_phyinit_usercustom_saveretregs(void);
 
 #endif /* DDRPHY_PHYINIT_USERCUSTOM_H */
@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file    stm32mp2xx_hal_ddr_pstate.h
+  * @author  MCD Application Team
+  * @brief   Default DDR settings of the PHY pstate 1 (NB_PS = 2), included
+  *          after the DDR settings header.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef STM32MP2xx_HAL_DDR_PSTATE_H
+#define STM32MP2xx_HAL_DDR_PSTATE_H
+
+/*
+ * Pstate 1 not described by the DDR settings: low-power pstate at half of the
+ * pstate 0 frequency, trained with the pstate 0 settings. The LPDDR4 latencies
+ * of the pstate 0 mode registers remain valid at a lower frequency; the DDR3
+ * and DDR4 settings shall provide the DDR_UIx_<param>_1 values of pstate 1.
+ */
+#if (NB_PS > 1) && !defined(DDR_UIB_FREQUENCY_1)
+#if !STM32MP_LPDDR4_TYPE
+#error "DDR settings of pstate 1 (DDR_UIB_FREQUENCY_1...) are missing"
+#endif /* !STM32MP_LPDDR4_TYPE */
+#undef DDR_UIB_NUMPSTATES
+#define DDR_UIB_NUMPSTATES                 NB_PS
+#define DDR_UIB_FREQUENCY_1                (DDR_UIB_FREQUENCY_0 / 2)
+#define DDR_UIB_PLLBYPASS_1                DDR_UIB_PLLBYPASS_0
+#define DDR_UIB_DFIFREQRATIO_1             DDR_UIB_DFIFREQRATIO_0
+#define DDR_UIB_READDBIENABLE_1            DDR_UIB_READDBIENABLE_0
+#define DDR_UIA_LP4RXPREAMBLEMODE_1        DDR_UIA_LP4RXPREAMBLEMODE_0
+#define DDR_UIA_LP4POSTAMBLEEXT_1          DDR_UIA_LP4POSTAMBLEEXT_0
+#define DDR_UIA_D4RXPREAMBLELENGTH_1       DDR_UIA_D4RXPREAMBLELENGTH_0
+#define DDR_UIA_D4TXPREAMBLELENGTH_1       DDR_UIA_D4TXPREAMBLELENGTH_0
+#define DDR_UIA_IS2TTIMING_1               DDR_UIA_IS2TTIMING_0
+#define DDR_UIA_ODTIMPEDANCE_1             DDR_UIA_ODTIMPEDANCE_0
+#define DDR_UIA_TXIMPEDANCE_1              DDR_UIA_TXIMPEDANCE_0
+#define DDR_UIA_DISDYNADRTRI_1             DDR_UIA_DISDYNADRTRI_0
+#define DDR_UIA_PHYMSTRTRAININTERVAL_1     DDR_UIA_PHYMSTRTRAININTERVAL_0
+#define DDR_UIA_PHYMSTRMAXREQTOACK_1       DDR_UIA_PHYMSTRMAXREQTOACK_0
+#define DDR_UIA_LP4RL_1                    DDR_UIA_LP4RL_0
+#define DDR_UIA_LP4WL_1                    DDR_UIA_LP4WL_0
+#define DDR_UIA_LP4WLS_1                   DDR_UIA_LP4WLS_0
+#define DDR_UIA_LP4DBIRD_1                 DDR_UIA_LP4DBIRD_0
+#define DDR_UIA_LP4DBIWR_1                 DDR_UIA_LP4DBIWR_0
+#define DDR_UIA_LP4NWR_1                   DDR_UIA_LP4NWR_0
+#define DDR_UIA_SNPSUMCTLF0RC5X_1          DDR_UIA_SNPSUMCTLF0RC5X_0
+#define DDR_UIA_TXSLEWRISEDQ_1             DDR_UIA_TXSLEWRISEDQ_0
+#define DDR_UIA_TXSLEWFALLDQ_1             DDR_UIA_TXSLEWFALLDQ_0
+#define DDR_UIA_SEQUENCECTRL_1             DDR_UIA_SEQUENCECTRL_0
+#define DDR_UIM_MR0_1                      DDR_UIM_MR0_0
+#define DDR_UIM_MR1_1                      DDR_UIM_MR1_0
+#define DDR_UIM_MR2_1                      DDR_UIM_MR2_0
+#define DDR_UIM_MR3_1                      DDR_UIM_MR3_0
+#define DDR_UIM_MR4_1                      DDR_UIM_MR4_0
+#define DDR_UIM_MR5_1                      DDR_UIM_MR5_0
+#define DDR_UIM_MR6_1                      DDR_UIM_MR6_0
+#define DDR_UIM_MR11_1                     DDR_UIM_MR11_0
+#define DDR_UIM_MR12_1                     DDR_UIM_MR12_0
+#define DDR_UIM_MR13_1                     DDR_UIM_MR13_0
+#define DDR_UIM_MR14_1                     DDR_UIM_MR14_0
+#define DDR_UIM_MR22_1                     DDR_UIM_MR22_0
+#endif /* (NB_PS > 1) && !defined(DDR_UIB_FREQUENCY_1) */
+
+#endif /* STM32MP2xx_HAL_DDR_PSTATE_H */
@@ -132,6 +132,14 @@
 #endif /* (STM32MP_LPDDR4_TYPE && (DDR_SIZE_Gb == 32)) && !defined(STM32MP_DDR_16_BIT_INTERFACE) */
 #endif /* DDR_INTERACTIVE */
 
+/* Settings of pstate 1 not provided by the DDR settings */
+#include "stm32mp2xx_hal_ddr_pstate.h"
+
+#ifdef DDRPHY_PHYINIT_PRECOMPUTED
+/* PhyInit results of the DDR settings, generated by Scripts/ddrphyinit */
+#include "stm32mp_util_ddr_phyinit.h"
+#endif /* DDRPHY_PHYINIT_PRECOMPUTED */
+
 /** @addtogroup STM32MP2xx_HAL_Driver
   * @{
   */
@@ -367,6 +375,12 @@ static const reg_desc_t phy_uib_desc[] =
   PHY_UIB_PARAM(hardmacrover),
   PHY_UIB_PARAM_INDEX(readdbienable, 0),
   PHY_UIB_PARAM(dfimode),
+#if HAL_DDR_MAX_PSTATE > 1
+  PHY_UIB_PARAM_INDEX(frequency, 1),
+  PHY_UIB_PARAM_INDEX(pllbypass, 1),
+  PHY_UIB_PARAM_INDEX(dfifreqratio, 1),
+  PHY_UIB_PARAM_INDEX(readdbienable, 1),
+#endif /* HAL_DDR_MAX_PSTATE > 1 */
 };
 
 #define PHY_UIA_PARAM(x) \
@@ -428,6 +442,28 @@ static const reg_desc_t phy_uia_desc[] =
   PHY_UIA_PARAM(enabledficspolarityfix),
   PHY_UIA_PARAM(phyvref),
   PHY_UIA_PARAM_INDEX(sequencectrl, 0),
+#if HAL_DDR_MAX_PSTATE > 1
+  PHY_UIA_PARAM_INDEX(lp4rxpreamblemode, 1),
+  PHY_UIA_PARAM_INDEX(lp4postambleext, 1),
+  PHY_UIA_PARAM_INDEX(d4rxpreamblelength, 1),
+  PHY_UIA_PARAM_INDEX(d4txpreamblelength, 1),
+  PHY_UIA_PARAM_INDEX(is2ttiming, 1),
+  PHY_UIA_PARAM_INDEX(odtimpedance, 1),
+  PHY_UIA_PARAM_INDEX(tximpedance, 1),
+  PHY_UIA_PARAM_INDEX(disdynadrtri, 1),
+  PHY_UIA_PARAM_INDEX(phymstrtraininterval, 1),
+  PHY_UIA_PARAM_INDEX(phymstrmaxreqtoack, 1),
+  PHY_UIA_PARAM_INDEX(lp4rl, 1),
+  PHY_UIA_PARAM_INDEX(lp4wl, 1),
+  PHY_UIA_PARAM_INDEX(lp4wls, 1),
+  PHY_UIA_PARAM_INDEX(lp4dbird, 1),
+  PHY_UIA_PARAM_INDEX(lp4dbiwr, 1),
+  PHY_UIA_PARAM_INDEX(lp4nwr, 1),
+  PHY_UIA_PARAM_INDEX(snpsumctlf0rc5x, 1),
+  PHY_UIA_PARAM_INDEX(txslewrisedq, 1),
+  PHY_UIA_PARAM_INDEX(txslewfalldq, 1),
+  PHY_UIA_PARAM_INDEX(sequencectrl, 1),
+#endif /* HAL_DDR_MAX_PSTATE > 1 */
 };
 
 #define PHY_UIM_PARAM_INDEX(x, y) \
@@ -451,6 +487,20 @@ static const reg_desc_t phy_uim_desc[] =
   PHY_UIM_PARAM_INDEX(mr13, 0),
   PHY_UIM_PARAM_INDEX(mr14, 0),
   PHY_UIM_PARAM_INDEX(mr22, 0),
+#if HAL_DDR_MAX_PSTATE > 1
+  PHY_UIM_PARAM_INDEX(mr0, 1),
+  PHY_UIM_PARAM_INDEX(mr1, 1),
+  PHY_UIM_PARAM_INDEX(mr2, 1),
+  PHY_UIM_PARAM_INDEX(mr3, 1),
+  PHY_UIM_PARAM_INDEX(mr4, 1),
+  PHY_UIM_PARAM_INDEX(mr5, 1),
+  PHY_UIM_PARAM_INDEX(mr6, 1),
+  PHY_UIM_PARAM_INDEX(mr11, 1),
+  PHY_UIM_PARAM_INDEX(mr12, 1),
+  PHY_UIM_PARAM_INDEX(mr13, 1),
+  PHY_UIM_PARAM_INDEX(mr14, 1),
+  PHY_UIM_PARAM_INDEX(mr22, 1),
+#endif /* HAL_DDR_MAX_PSTATE > 1 */
 };
 
 #define PHY_UIS_PARAM_INDEX(x) \
@@ -941,7 +991,13 @@ HAL_DDR_ConfigTypeDef static_ddr_config =
     .train2d            = DDR_UIB_TRAIN2D,
     .hardmacrover       = DDR_UIB_HARDMACROVER,
     .readdbienable[0]   = DDR_UIB_READDBIENABLE_0,
-    .dfimode            = DDR_UIB_DFIMODE
+    .dfimode            = DDR_UIB_DFIMODE,
+#if HAL_DDR_MAX_PSTATE > 1
+    .frequency[1]       = DDR_UIB_FREQUENCY_1,
+    .pllbypass[1]       = DDR_UIB_PLLBYPASS_1,
+    .dfifreqratio[1]    = DDR_UIB_DFIFREQRATIO_1,
+    .readdbienable[1]   = DDR_UIB_READDBIENABLE_1
+#endif /* HAL_DDR_MAX_PSTATE > 1 */
   },
 
   .p_uia = {
@@ -987,7 +1043,29 @@ HAL_DDR_ConfigTypeDef static_ddr_config =
     .phyinitsequencenum      = DDR_UIA_PHYINITSEQUENCENUM,
     .enabledficspolarityfix  = DDR_UIA_ENABLEDFICSPOLARITYFIX,
     .phyvref                 = DDR_UIA_PHYVREF,
-    .sequencectrl[0]         = DDR_UIA_SEQUENCECTRL_0
+    .sequencectrl[0]         = DDR_UIA_SEQUENCECTRL_0,
+#if HAL_DDR_MAX_PSTATE > 1
+    .lp4rxpreamblemode[1]    = DDR_UIA_LP4RXPREAMBLEMODE_1,
+    .lp4postambleext[1]      = DDR_UIA_LP4POSTAMBLEEXT_1,
+    .d4rxpreamblelength[1]   = DDR_UIA_D4RXPREAMBLELENGTH_1,
+    .d4txpreamblelength[1]   = DDR_UIA_D4TXPREAMBLELENGTH_1,
+    .is2ttiming[1]           = DDR_UIA_IS2TTIMING_1,
+    .odtimpedance[1]         = DDR_UIA_ODTIMPEDANCE_1,
+    .tximpedance[1]          = DDR_UIA_TXIMPEDANCE_1,
+    .disdynadrtri[1]         = DDR_UIA_DISDYNADRTRI_1,
+    .phymstrtraininterval[1] = DDR_UIA_PHYMSTRTRAININTERVAL_1,
+    .phymstrmaxreqtoack[1]   = DDR_UIA_PHYMSTRMAXREQTOACK_1,
+    .lp4rl[1]                = DDR_UIA_LP4RL_1,
+    .lp4wl[1]                = DDR_UIA_LP4WL_1,
+    .lp4wls[1]               = DDR_UIA_LP4WLS_1,
+    .lp4dbird[1]             = DDR_UIA_LP4DBIRD_1,
+    .lp4dbiwr[1]             = DDR_UIA_LP4DBIWR_1,
+    .lp4nwr[1]               = DDR_UIA_LP4NWR_1,
+    .snpsumctlf0rc5x[1]      = DDR_UIA_SNPSUMCTLF0RC5X_1,
+    .txslewrisedq[1]         = DDR_UIA_TXSLEWRISEDQ_1,
+    .txslewfalldq[1]         = DDR_UIA_TXSLEWFALLDQ_1,
+    .sequencectrl[1]         = DDR_UIA_SEQUENCECTRL_1
+#endif /* HAL_DDR_MAX_PSTATE > 1 */
   },
 
   .p_uim = {
@@ -1002,7 +1080,21 @@ HAL_DDR_ConfigTypeDef static_ddr_config =
     .mr12[0] = DDR_UIM_MR12_0,
     .mr13[0] = DDR_UIM_MR13_0,
     .mr14[0] = DDR_UIM_MR14_0,
-    .mr22[0] = DDR_UIM_MR22_0
+    .mr22[0] = DDR_UIM_MR22_0,
+#if HAL_DDR_MAX_PSTATE > 1
+    .mr0[1]  = DDR_UIM_MR0_1,
+    .mr1[1]  = DDR_UIM_MR1_1,
+    .mr2[1]  = DDR_UIM_MR2_1,
+    .mr3[1]  = DDR_UIM_MR3_1,
+    .mr4[1]  = DDR_UIM_MR4_1,
+    .mr5[1]  = DDR_UIM_MR5_1,
+    .mr6[1]  = DDR_UIM_MR6_1,
+    .mr11[1] = DDR_UIM_MR11_1,
+    .mr12[1] = DDR_UIM_MR12_1,
+    .mr13[1] = DDR_UIM_MR13_1,
+    .mr14[1] = DDR_UIM_MR14_1,
+    .mr22[1] = DDR_UIM_MR22_1
+#endif /* HAL_DDR_MAX_PSTATE > 1 */
   },
 
   .p_uis = {
@@ -1071,6 +1163,7 @@ HAL_DDR_ConfigTypeDef static_ddr_config =
 
 static bool axi_port_reenable_request;
 static bool host_interface_reenable_request;
+static uint32_t ddr_pstate; /* Current PHY pstate */
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -1231,57 +1324,114 @@ static uintptr_t ddr_check_size(void)
 }
 
 /**
-  * @brief  Wait a delay expressed in us
-  * @param  delay_us delay in us
-  * @retval None
+  * @brief  Get the frequency of the DDR driver time base
+  * @param  None
+  * @retval Frequency in Hz
   */
-static void ddr_delay_us(uint32_t delay_us)
+static uint64_t ddr_get_counter_freq(void)
 {
-  __IO uint32_t wait_loop_index = 0U;
-
-  wait_loop_index = (delay_us * (SystemCoreClock / (1000000UL * 2UL)));
+#ifdef __AARCH64__
+  uint64_t freq;
 
-#ifdef USE_STM32MP257CXX_EMU
-  wait_loop_index *= 10U;
-#endif /* USE_STM32MP257CXX_EMU */
+  __asm volatile ("mrs %0, cntfrq_el0" : "=r" (freq));
 
-  while (wait_loop_index != 0UL)
+  if (freq == 0U)
   {
-    wait_loop_index--;
+    freq = HSI_VALUE;
   }
+
+  return freq;
+#else /* __AARCH64__ */
+  /* HAL tick: 1 ms */
+  return 1000U;
+#endif /* __AARCH64__ */
 }
 
 /**
-  * @brief  Initialize DDR timeout in us
-  * @param  timeout_us timeout in us
-  * @retval wait_loop_index
+  * @brief  Get the DDR driver time base counter: the generic timer, clocked
+  *         by STGEN, on AArch64, else the HAL tick
+  * @param  None
+  * @retval Counter value
   */
-static __IO uint32_t ddr_timeout_init_us(uint32_t timeout_us)
+uint64_t HAL_DDR_Get_Counter(void)
 {
-  __IO uint32_t wait_loop_index = 0U;
+#ifdef __AARCH64__
+  uint64_t count;
 
-  wait_loop_index = timeout_us * (SystemCoreClock / (1000000UL * 2UL));
+  __asm volatile ("isb\n\tmrs %0, cntpct_el0" : "=r" (count) : : "memory");
 
+  return count;
+#else /* __AARCH64__ */
+  return HAL_GetTick();
+#endif /* __AARCH64__ */
+}
+
+/**
+  * @brief  Convert a duration in us into counts of HAL_DDR_Get_Counter()
+  * @param  time_us duration in us
+  * @retval Number of counts, rounded up
+  */
+uint64_t HAL_DDR_Us_To_Counter(uint64_t time_us)
+{
+  uint64_t freq = ddr_get_counter_freq();
+  uint64_t count = ((time_us * freq) + 999999U) / 1000000U;
+
+#ifndef __AARCH64__
+  /* The current HAL tick is already partly elapsed */
+  count++;
+#endif /* __AARCH64__ */
+
+  return count;
+}
+
+/**
+  * @brief  Convert counts of HAL_DDR_Get_Counter() into a duration in us
+  * @param  count number of counts
+  * @retval Duration in us
+  */
+uint64_t HAL_DDR_Counter_To_Us(uint64_t count)
+{
+  uint64_t freq = ddr_get_counter_freq();
+
+  return ((count / freq) * 1000000U) + (((count % freq) * 1000000U) / freq);
+}
+
+/**
+  * @brief  Initialize DDR timeout in us
+  * @param  timeout_us timeout in us
+  * @retval Counter value of the deadline
+  */
+static uint64_t ddr_timeout_init_us(uint32_t timeout_us)
+{
 #ifdef USE_STM32MP257CXX_EMU
-  wait_loop_index *= 10U;
+  timeout_us *= 10U;
 #endif /* USE_STM32MP257CXX_EMU */
 
-  return wait_loop_index;
+  return HAL_DDR_Get_Counter() + HAL_DDR_Us_To_Counter(timeout_us);
 }
 
 /**
   * @brief  Check if timeout has expired
-  * @param  timeout timeout in us
+  * @param  timeout deadline returned by ddr_timeout_init_us
   * @retval Timeout status
   */
-static bool ddr_timeout_elapsed(__IO uint32_t timeout)
+static bool ddr_timeout_elapsed(uint64_t timeout)
+{
+  return HAL_DDR_Get_Counter() >= timeout;
+}
+
+/**
+  * @brief  Wait a delay expressed in us
+  * @param  delay_us delay in us
+  * @retval None
+  */
+static void ddr_delay_us(uint32_t delay_us)
 {
-  if (timeout == 0U)
+  uint64_t timeout = ddr_timeout_init_us(delay_us);
+
+  while (!ddr_timeout_elapsed(timeout))
   {
-    return true;
   }
-
-  return false;
 }
 
 /**
@@ -1302,7 +1452,7 @@ static void start_sw_done(void)
 static int32_t wait_sw_done_ack(void)
 {
   uint32_t swstat;
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_1_US);
+  uint64_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_500_US);
 
   SET_BIT(DDRC->SWCTL, DDRC_SWCTL_SW_DONE);
 
@@ -1310,7 +1460,6 @@ static int32_t wait_sw_done_ack(void)
   {
     swstat = READ_REG(DDRC->SWSTAT);
 
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       /* Timeout initialising DRAM */
@@ -1345,7 +1494,7 @@ static void enable_axi_port(void)
   */
 static int32_t disable_axi_port(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
 
   /* Disable uMCTL2 AXI port 0 */
   CLEAR_BIT(DDRC->PCTRL_0, DDRC_PCTRL_0_PORT_EN);
@@ -1362,7 +1511,6 @@ static int32_t disable_axi_port(void)
   timeout = ddr_timeout_init_us(DDR_TIMEOUT_US_1S);
   while (READ_REG(DDRC->PSTAT) != 0U)
   {
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return -1;
@@ -1400,7 +1548,7 @@ static void enable_host_interface(void)
   */
 static int32_t disable_host_interface(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t dbgcam;
   uint32_t count = 0U;
 
@@ -1421,7 +1569,6 @@ static int32_t disable_host_interface(void)
   {
     dbgcam = READ_REG(DDRC->DBGCAM);
 
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return -1;
@@ -1451,7 +1598,7 @@ static bool ddr_is_host_interface_enabled(void)
   */
 static int32_t sw_selfref_entry(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t stat;
   uint32_t operating_mode;
   uint32_t selref_type;
@@ -1472,7 +1619,6 @@ static int32_t sw_selfref_entry(void)
     stat = READ_REG(DDRC->STAT);
     operating_mode = stat & DDRC_STAT_OPERATING_MODE_Msk;
     selref_type = stat & DDRC_STAT_SELFREF_TYPE_Msk;
-    timeout--;
 
     if ((operating_mode == DDRC_STAT_OPERATING_MODE_SR)
         && (selref_type == DDRC_STAT_SELFREF_TYPE_SR))
@@ -1589,7 +1735,7 @@ static int32_t unset_qd1_qd3_update_conditions(void)
   */
 static int32_t wait_dfi_init_complete(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t dfistat;
 
   timeout = ddr_timeout_init_us(DDR_TIMEOUT_US_1S);
@@ -1597,7 +1743,6 @@ static int32_t wait_dfi_init_complete(void)
   {
     dfistat = READ_REG(DDRC->DFISTAT);
 
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return -1;
@@ -1614,7 +1759,7 @@ static int32_t wait_dfi_init_complete(void)
   */
 static int32_t disable_dfi_low_power_interface(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t dfistat;
   uint32_t stat;
 
@@ -1626,7 +1771,6 @@ static int32_t disable_dfi_low_power_interface(void)
     dfistat = READ_REG(DDRC->DFISTAT);
     stat = READ_REG(DDRC->STAT);
 
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return -1;
@@ -1655,7 +1799,9 @@ static int32_t activate_controller(bool sr_entry)
   }
   else
   {
-    CLEAR_BIT(DDRC->DFIMISC, DDRC_DFIMISC_DFI_FREQUENCY);
+    /* Mission mode in the current pstate */
+    MODIFY_REG(DDRC->DFIMISC, DDRC_DFIMISC_DFI_FREQUENCY,
+               ddr_pstate << DDRC_DFIMISC_DFI_FREQUENCY_Pos);
   }
 
   SET_BIT(DDRC->DFIMISC, DDRC_DFIMISC_DFI_INIT_START);
@@ -1694,7 +1840,7 @@ static int32_t activate_controller(bool sr_entry)
   */
 static int32_t wait_lp3_mode(bool state)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint16_t phyinlpx;
   bool repeat_loop = false;
 
@@ -1708,7 +1854,6 @@ static int32_t wait_lp3_mode(bool state)
   {
     phyinlpx = READ_REG(*(volatile uint32_t *)(DDRPHYC_BASE + DDRPHY_INITENG0_P0_PHYINLPX));
 
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return -1;
@@ -1864,7 +2009,7 @@ static int32_t sr_loop(bool is_entry)
 #if STM32MP_LPDDR4_TYPE
   uint32_t state;
 #endif /* STM32MP_LPDDR4_TYPE */
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_1_US);
+  uint64_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_500_US);
   bool repeat_loop = false;
 
   /* Wait for DDRCTRL to be out of or back to "normal/mission mode" */
@@ -1875,7 +2020,6 @@ static int32_t sr_loop(bool is_entry)
     state = READ_REG(DDRC->STAT) & DDRC_STAT_SELFREF_STATE_Msk;
 #endif /* STM32MP_LPDDR4_TYPE */
 
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return -1;
@@ -2247,7 +2391,7 @@ static void ddr_reset(void)
 static int32_t ddr_pll2_configure(void)
 {
 #if defined(USE_STM32MP257CXX_EMU)
-  __IO uint32_t timeout;
+  uint64_t timeout;
 
   WRITE_REG(RCC->PLL2CFGR4, RCC_PLL2CFGR4_VAL);
   WRITE_REG(RCC->PLL2CFGR1, RCC_PLL2CFGR1_VAL1);
@@ -2264,7 +2408,6 @@ static int32_t ddr_pll2_configure(void)
   while ((READ_REG(DDRDBG->FRAC_PLL_LOCK) & DDRDBG_FRAC_PLL_LOCK_LOCK) !=
          DDRDBG_FRAC_PLL_LOCK_LOCK)
   {
-    timeout--;
 
     if (ddr_timeout_elapsed(timeout))
     {
@@ -2362,7 +2505,7 @@ static int32_t ddr_sysconf_configuration(void)
   */
 static int32_t wait_refresh_update_done_ack(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t rfshctl3;
   uint32_t refresh_update_level = DDRC_RFSHCTL3_REFRESH_UPDATE_LEVEL;
 
@@ -2383,7 +2526,6 @@ static int32_t wait_refresh_update_done_ack(void)
   {
     rfshctl3 = READ_REG(DDRC->RFSHCTL3);
 
-    timeout--;
     if (ddr_timeout_elapsed(timeout))
     {
       return -1;
@@ -2870,6 +3012,160 @@ void HAL_DDR_Edit_Reg(char *name, char *string)
   }
 }
 
+static void snapshot_pll(HAL_DDR_PllTypeDef *pll)
+{
+  RCC_PLLInitTypeDef PLL2;
+
+  HAL_RCCEx_GetPLL2Config(&PLL2);
+
+  pll->source = (int32_t)PLL2.PLLSource;
+  pll->mode = (int32_t)DDR_PLL_MODE;
+  pll->fbdiv = (int32_t)PLL2.FBDIV;
+  pll->frefdiv = (int32_t)PLL2.FREFDIV;
+  pll->fracin = (int32_t)PLL2.FRACIN;
+  pll->postdiv1 = (int32_t)PLL2.POSTDIV1;
+  pll->postdiv2 = (int32_t)PLL2.POSTDIV2;
+  pll->state = (int32_t)PLL2.PLLState;
+  pll->ssm_mode = (int32_t)DDR_PLL_SSM_MODE;
+  pll->ssm_spread = (int32_t)DDR_PLL_SSM_SPREAD;
+  pll->ssm_divval = (int32_t)DDR_PLL_SSM_DIVVAL;
+}
+
+static uint32_t snapshot_read(reg_type type, const reg_desc_t *desc,
+                              const HAL_DDR_PllTypeDef *pll)
+{
+  void *base_addr = get_base_addr(ddr_registers[type].base);
+
+  if (type == PLL_SETTINGS)
+  {
+    return *(const uint32_t *)((uintptr_t)pll + desc->par_offset);
+  }
+
+  if (base_addr == (void *)DDRC_BASE)
+  {
+    return READ_REG(*(volatile uint32_t *)(base_addr + desc->offset));
+  }
+
+  return (uint32_t)*(int *)(base_addr + desc->offset);
+}
+
+/**
+  * @brief  Read the registers of all the tables of the print command, in the
+  *         order of HAL_DDR_Snapshot_Name(), for a binary snapshot.
+  * @param  value: destination of the values, NULL to count the registers
+  * @param  size: number of values of the destination
+  * @retval Number of registers
+  */
+uint32_t HAL_DDR_Snapshot_Reg(uint32_t *value, uint32_t size)
+{
+  unsigned int i, j;
+  uint32_t nb = 0U;
+  HAL_DDR_PllTypeDef pll;
+
+  if (value != NULL)
+  {
+    snapshot_pll(&pll);
+  }
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
+  {
+    for (j = 0; j < ddr_registers[i].size; j++)
+    {
+      if ((value != NULL) && (nb < size))
+      {
+        value[nb] = snapshot_read(i, &ddr_registers[i].desc[j], &pll);
+      }
+      nb++;
+    }
+  }
+
+  return nb;
+}
+
+/**
+  * @brief  Name of a register of the snapshot.
+  * @param  index: position of the register in the snapshot
+  * @param  base: "ctl", "uib", "uia", "uim", "uis" or "pll"
+  * @param  table: name of the register table ("static", "timing"...)
+  * @param  name: name of the register
+  * @retval false when index is beyond the last register
+  */
+bool HAL_DDR_Snapshot_Name(uint32_t index, const char **base,
+                           const char **table, const char **name)
+{
+  unsigned int i;
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
+  {
+    if (index < ddr_registers[i].size)
+    {
+      *base = base_name[ddr_registers[i].base];
+      *table = ddr_registers[i].name;
+      *name = ddr_registers[i].desc[index].name;
+      return true;
+    }
+    index -= ddr_registers[i].size;
+  }
+
+  return false;
+}
+
+/**
+  * @brief  Write back the registers of a snapshot which differ from their
+  *         current value. The PLL settings (see freq command) and the
+  *         dynamic registers are not written.
+  * @param  value: values read by HAL_DDR_Snapshot_Reg()
+  * @param  nb: number of values
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DDR_Restore_Reg(const uint32_t *value, uint32_t nb)
+{
+  unsigned int i, j;
+  uint32_t n = 0U;
+  const reg_desc_t *desc;
+  void *base_addr;
+
+  if (nb != HAL_DDR_Snapshot_Reg(NULL, 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
+  {
+    base_addr = get_base_addr(ddr_registers[i].base);
+    for (j = 0; j < ddr_registers[i].size; j++, n++)
+    {
+      desc = &ddr_registers[i].desc[j];
+      if ((i == PLL_SETTINGS) || (i == REG_DYN) ||
+          (snapshot_read(i, desc, NULL) == value[n]))
+      {
+        continue;
+      }
+
+      if (base_addr == (void *)DDRC_BASE)
+      {
+        if (desc->qd)
+        {
+          start_sw_done();
+        }
+
+        WRITE_REG(*(volatile uint32_t *)(base_addr + desc->offset), value[n]);
+
+        if (desc->qd && (wait_sw_done_ack() != 0))
+        {
+          return HAL_TIMEOUT;
+        }
+      }
+      else
+      {
+        *(int *)(base_addr + desc->offset) = (int)value[n];
+      }
+    }
+  }
+
+  return HAL_OK;
+}
+
 static unsigned long get_par_addr(HAL_DDR_ConfigTypeDef *config, reg_type type)
 {
   uint32_t par_addr = 0x0;
@@ -2966,8 +3262,8 @@ HAL_StatusTypeDef HAL_DDR_Dump_Param(HAL_DDR_ConfigTypeDef *config,
   return result;
 }
 
-void HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
-                        char *string)
+HAL_StatusTypeDef HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
+                                     char *string)
 {
   uintptr_t ptr;
   uint32_t value;
@@ -2980,20 +3276,20 @@ void HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
   if (!desc)
   {
     printf("%s not found\n\r", name);
-    return;
+    return HAL_ERROR;
   }
 
   value = (uint32_t)strtoll(string, &end_ptr, 0);
   if (end_ptr == string)
   {
     printf("invalid value %s\n\r", string);
-    return;
+    return HAL_ERROR;
   }
 
   par_addr = get_par_addr(config, type);
   if (!par_addr) {
     printf("no parameter %s\n\r", name);
-    return;
+    return HAL_ERROR;
   }
 
   ptr = (uintptr_t)(par_addr + desc->par_offset);
@@ -3009,6 +3305,59 @@ void HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
     printf("%s= 0x%08lX\n\r", reg_name, READ_REG(*(volatile uint32_t*)ptr));
 #endif
   }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Print the training firmware messages log and the duration of
+  *         each training phase.
+  * @param  None
+  * @retval None
+  */
+void HAL_DDR_Dump_FwLog(void)
+{
+  ddrphy_phyinit_usercustom_fwlog_dump();
+}
+
+/**
+  * @brief  Print the PHY retention registers saved for the standby exit and
+  *         the duration of their last save and restore.
+  * @param  None
+  * @retval None
+  */
+void HAL_DDR_Dump_RetRegs(void)
+{
+  const reg_addr_val_t *list;
+  int32_t numtracked;
+  int32_t numsaved;
+  int32_t regindx;
+  uint32_t save_us;
+  uint32_t restore_us;
+
+  numsaved = ddrphy_phyinit_getretregs(&list, &numtracked, &save_us, &restore_us);
+
+  printf("retention registers: %ld tracked, %ld saved\n\r", (long)numtracked,
+         (long)numsaved);
+  printf("save %lu us, restore %lu us\n\r", (unsigned long)save_us,
+         (unsigned long)restore_us);
+
+  for (regindx = 0; regindx < numsaved; regindx++)
+  {
+    printf("  0x%05lx = 0x%04x\n\r", (unsigned long)list[regindx].address,
+           (unsigned int)list[regindx].value);
+  }
+}
+
+/**
+  * @brief  Print the frequency, the training result and the training duration
+  *         of each PHY pstate.
+  * @param  None
+  * @retval None
+  */
+void HAL_DDR_Dump_PState(void)
+{
+  ddrphy_phyinit_usercustom_pstate_dump();
 }
 
 __weak bool HAL_DDR_Interactive(__attribute__((unused))HAL_DDR_InteractStepTypeDef step)
@@ -3016,9 +3365,86 @@ __weak bool HAL_DDR_Interactive(__attribute__((unused))HAL_DDR_InteractStepTypeD
   return false;
 }
 
+/* initialization failed before the step: true to restart it */
+__weak bool HAL_DDR_Interactive_Error(__attribute__((unused))HAL_DDR_InteractStepTypeDef step)
+{
+  return false;
+}
+
 #define INTERACTIVE(step) HAL_DDR_Interactive(step)
 #endif /* DDR_INTERACTIVE */
 
+/**
+  * @brief  Compute the hash of the DDR settings, identifying the trained
+  *         state snapshot which can be restored.
+  * @param  None
+  * @retval CRC32 of the DDR settings.
+  */
+static uint32_t ddr_config_hash(void)
+{
+  uint32_t hash;
+
+  hash = ddrphy_phyinit_crc32(0U, static_ddr_config.info.name,
+                              strlen(static_ddr_config.info.name));
+  hash = ddrphy_phyinit_crc32(hash, &static_ddr_config.info.speed,
+                              sizeof(static_ddr_config.info.speed));
+  hash = ddrphy_phyinit_crc32(hash, &static_ddr_config.info.size,
+                              sizeof(static_ddr_config.info.size));
+  hash = ddrphy_phyinit_crc32(hash, &static_ddr_config.c_reg,
+                              sizeof(static_ddr_config.c_reg));
+  hash = ddrphy_phyinit_crc32(hash, &static_ddr_config.c_timing,
+                              sizeof(static_ddr_config.c_timing));
+  hash = ddrphy_phyinit_crc32(hash, &static_ddr_config.c_map,
+                              sizeof(static_ddr_config.c_map));
+  hash = ddrphy_phyinit_crc32(hash, &static_ddr_config.c_perf,
+                              sizeof(static_ddr_config.c_perf));
+  hash = ddrphy_phyinit_crc32(hash, &static_ddr_config.p_uib,
+                              sizeof(static_ddr_config.p_uib));
+  hash = ddrphy_phyinit_crc32(hash, &static_ddr_config.p_uia,
+                              sizeof(static_ddr_config.p_uia));
+  hash = ddrphy_phyinit_crc32(hash, &static_ddr_config.p_uim,
+                              sizeof(static_ddr_config.p_uim));
+  hash = ddrphy_phyinit_crc32(hash, &static_ddr_config.p_uis,
+                              sizeof(static_ddr_config.p_uis));
+
+  return hash;
+}
+
+/*
+ * PHY initialization without training: the register writes recorded on a
+ * previous boot are replayed when they match the DDR settings, otherwise the
+ * PhyInit sequence is executed and recorded for the next boot.
+ * HAL_DDR_Init() invalidates a replayed stream when the initialization fails
+ * and initializes again, with the PhyInit sequence.
+ */
+static int32_t ddr_phyinit_skiptrain(DDR_InitTypeDef *iddr)
+{
+  uint32_t hash;
+  int32_t iret;
+
+  if (iddr->csr_stream == NULL)
+  {
+    return ddrphy_phyinit_sequence(true, false);
+  }
+
+  hash = ddr_config_hash();
+
+  if (ddrphy_phyinit_replaycsrs(iddr->csr_stream, HAL_DDR_CSR_STREAM_SIZE, hash) == 0)
+  {
+    iddr->csr_stream_replayed = true;
+    return 0;
+  }
+
+  ddrphy_phyinit_startcsrrecord(iddr->csr_stream, HAL_DDR_CSR_STREAM_SIZE);
+
+  iret = ddrphy_phyinit_sequence(true, false);
+
+  /* Recording too large for the area is not an error, replay is not possible */
+  (void)ddrphy_phyinit_stopcsrrecord(iret == 0, hash);
+
+  return iret;
+}
+
 /* Exported functions ---------------------------------------------------------*/
 
 /** @defgroup DDR_Exported_Functions DDR Exported Functions
@@ -3027,15 +3453,11 @@ __weak bool HAL_DDR_Interactive(__attribute__((unused))HAL_DDR_InteractStepTypeD
 
 
 /**
-  * @brief  DDR init sequence, including
-  *         - reset/clock/power management (i.e. access to other IPs),
-  *         - DDRCTRL and DDRPHY configuration and initialization,
-  *         - self-refresh mode setup,
-  *         - data/addr tests execution after training.
+  * @brief  DDR init sequence, see HAL_DDR_Init().
   * @param  DDR initialisation structure
-  * @retval None.
+  * @retval HAL status.
   */
-HAL_StatusTypeDef HAL_DDR_Init(DDR_InitTypeDef *iddr)
+static HAL_StatusTypeDef ddr_init(DDR_InitTypeDef *iddr)
 {
   int32_t iret  = -1;
   uint32_t uret;
@@ -3145,6 +3567,9 @@ HAL_StatusTypeDef HAL_DDR_Init(DDR_InitTypeDef *iddr)
 start:
 #endif /* DDR_INTERACTIVE */
 
+  /* PLL2 and PhyInit end in pstate 0 */
+  ddr_pstate = 0U;
+
   if (iddr->wakeup_from_standby)
   {
     WRITE_REG(RCC->DDRCPCFGR, RCC_DDRCPCFGR_DDRCPEN | RCC_DDRCPCFGR_DDRCPLPEN |
@@ -3171,7 +3596,7 @@ start:
 
     if (ddr_pll2_configure() != 0)
     {
-      return HAL_ERROR;
+      INIT_ERROR(STEP_CTL_INIT);
     }
   }
   else
@@ -3187,7 +3612,7 @@ start:
 
     if (ddr_sysconf_configuration() != 0)
     {
-      return HAL_ERROR;
+      INIT_ERROR(STEP_CTL_INIT);
     }
   }
 
@@ -3204,7 +3629,7 @@ start:
       (set_reg(REG_MAP, (uintptr_t)&static_ddr_config.c_map) != 0) ||
       (set_reg(REG_PERF, (uintptr_t)&static_ddr_config.c_perf) != 0))
   {
-    return HAL_ERROR;
+    INIT_ERROR(STEP_CTL_INIT);
   }
 
 #ifdef DDR_INTERACTIVE
@@ -3221,7 +3646,7 @@ start:
 
     if (disable_refresh() != 0)
     {
-      return HAL_ERROR;
+      INIT_ERROR(STEP_PHY_INIT);
     }
   }
 
@@ -3230,9 +3655,13 @@ start:
       (set_reg(PHY_UI_MODE_REGISTER, (uintptr_t)&static_ddr_config.p_uim) != 0) ||
       (set_reg(PHY_UI_SWIZZLE, (uintptr_t)&static_ddr_config.p_uis) != 0))
   {
-    return HAL_ERROR;
+    INIT_ERROR(STEP_PHY_INIT);
   }
 
+#ifdef DDRPHY_PHYINIT_PRECOMPUTED
+  ddrphy_phyinit_setprecomp(&ddrphy_phyinit_precomp);
+#endif /* DDRPHY_PHYINIT_PRECOMPUTED */
+
   if (iddr->wakeup_from_standby)
   {
     WRITE_REG(RCC->DDRCPCFGR, RCC_DDRCPCFGR_DDRCPEN | RCC_DDRCPCFGR_DDRCPLPEN);
@@ -3241,7 +3670,7 @@ start:
     WRITE_REG(RCC->DDRCFGR, RCC_DDRCFGR_DDRCFGEN | RCC_DDRCFGR_DDRCFGLPEN);
 
     /* Initialize DDR by skipping training and disabling result saving */
-    iret = ddrphy_phyinit_sequence(true, false);
+    iret = ddr_phyinit_skiptrain(iddr);
 
     if (iret == 0)
     {
@@ -3251,7 +3680,20 @@ start:
     /* Poll on ddrphy_initeng0_phyinlpx.phyinlp3 = 0 */
     if (wait_lp3_mode(false) != 0)
     {
-      return HAL_ERROR;
+      INIT_ERROR(STEP_PHY_INIT);
+    }
+  }
+  else if ((iddr->trained_state != NULL) &&
+           (ddrphy_phyinit_importretregs(iddr->trained_state, ddr_config_hash()) == 0))
+  {
+    iddr->trained_state_restored = true;
+
+    /* Initialize DDR by skipping training and restoring the snapshot results */
+    iret = ddr_phyinit_skiptrain(iddr);
+
+    if (iret == 0)
+    {
+      iret = ddrphy_phyinit_restore_sequence();
     }
   }
   else
@@ -3266,12 +3708,20 @@ start:
 #else /* STM32MP_DISABLE_SAVE_RETENTION_REGISTERS */
     /* Initialize DDR including training and result saving */
     iret = ddrphy_phyinit_sequence(false, true);
+
+    if ((iret == 0) && (iddr->trained_state != NULL))
+    {
+      /* Update the snapshot for the next boot, training is not impacted */
+      (void)ddrphy_phyinit_exportretregs(iddr->trained_state,
+                                         HAL_DDR_TRAINED_STATE_SIZE,
+                                         ddr_config_hash());
+    }
 #endif /* STM32MP_DISABLE_SAVE_RETENTION_REGISTERS */
   }
 
   if (iret != 0)
   {
-    return HAL_ERROR;
+    INIT_ERROR(STEP_PHY_INIT);
   }
 
 #ifdef DDR_INTERACTIVE
@@ -3283,7 +3733,7 @@ start:
 
   if (activate_controller(false) != 0)
   {
-    return HAL_ERROR;
+    INIT_ERROR(STEP_DDR_READY);
   }
 
   if (iddr->wakeup_from_standby)
@@ -3293,7 +3743,7 @@ start:
 
     if (sr_exit_loop() != 0)
     {
-      return HAL_ERROR;
+      INIT_ERROR(STEP_DDR_READY);
     }
 
     /* Re-enable DFI low-power interface */
@@ -3305,7 +3755,7 @@ start:
     if (restore_refresh(static_ddr_config.c_reg.RFSHCTL3,
                         static_ddr_config.c_reg.PWRCTL) != 0)
     {
-      return HAL_ERROR;
+      INIT_ERROR(STEP_DDR_READY);
     }
   }
 
@@ -3386,6 +3836,60 @@ start:
   return HAL_DDR_SR_SetMode(mode);
 }
 
+/**
+  * @brief  DDR init sequence, including
+  *         - reset/clock/power management (i.e. access to other IPs),
+  *         - DDRCTRL and DDRPHY configuration and initialization,
+  *         - replay of the recorded PHY register writes when not training,
+  *           PhyInit sequence again when the initialization then fails,
+  *         - training or restore of the trained state snapshot,
+  *         - self-refresh mode setup,
+  *         - data/addr tests execution after training,
+  *         - training again when the restored training results fail the
+  *           data/addr tests.
+  * @param  DDR initialisation structure
+  * @retval HAL status.
+  */
+HAL_StatusTypeDef HAL_DDR_Init(DDR_InitTypeDef *iddr)
+{
+  HAL_StatusTypeDef ret;
+
+  iddr->trained_state_restored = false;
+  iddr->trained_state_retrained = false;
+  iddr->csr_stream_replayed = false;
+
+  ret = ddr_init(iddr);
+
+  if ((ret != HAL_OK) && iddr->csr_stream_replayed)
+  {
+    /* Replayed register writes are not usable: execute PhyInit */
+    ((csrstream_t *)iddr->csr_stream)->magic = 0U;
+    iddr->csr_stream_replayed = false;
+
+    if (!iddr->trained_state_restored)
+    {
+      /* Same initialization, the PhyInit sequence is recorded again */
+      ret = ddr_init(iddr);
+    }
+  }
+
+  if ((ret != HAL_OK) && iddr->trained_state_restored)
+  {
+    /* Restored training results are not usable: train */
+    ((retregs_snapshot_t *)iddr->trained_state)->magic = 0U;
+
+    /* Full initialization, the snapshot is updated after the training */
+    iddr->trained_state_restored = false;
+    iddr->csr_stream_replayed = false;
+
+    ret = ddr_init(iddr);
+
+    iddr->trained_state_retrained = (ret == HAL_OK);
+  }
+
+  return ret;
+}
+
 /**
   * @brief  Enable DDR Self-Refresh, when entering in CSTOP.
   * @param  zq0cr0_zdata IO calibration value.
@@ -3587,6 +4091,121 @@ HAL_StatusTypeDef HAL_DDR_SetRetentionAreaBase(uint64_t base)
   return HAL_OK;
 }
 
+/**
+  * @brief  Check that the controller timings of pstate 0 are valid in a pstate.
+  *         They are counted in DDR clock cycles, so the DRAM minimum times
+  *         stay met at a lower frequency with the same DFI frequency ratio.
+  *         The read/write latencies (DRAMTMG, DFITMG) follow the latencies
+  *         of the mode registers, which shall be those of pstate 0.
+  * @param  pstate PHY pstate
+  * @retval true when the pstate can run with the pstate 0 timings
+  */
+static bool pstate_timings_valid(uint32_t pstate)
+{
+  if ((userinputbasic.frequency[pstate] > userinputbasic.frequency[0]) ||
+      (userinputbasic.dfifreqratio[pstate] != userinputbasic.dfifreqratio[0]))
+  {
+    return false;
+  }
+
+#if STM32MP_LPDDR4_TYPE
+  /* MR1: nWR and preambles, MR2: RL and WL */
+  return (userinputmoderegister.mr1[pstate] == userinputmoderegister.mr1[0]) &&
+         (userinputmoderegister.mr2[pstate] == userinputmoderegister.mr2[0]);
+#else /* STM32MP_LPDDR4_TYPE */
+  /* MR0: CL and WR, MR2: CWL */
+  return (userinputmoderegister.mr0[pstate] == userinputmoderegister.mr0[0]) &&
+         (userinputmoderegister.mr2[pstate] == userinputmoderegister.mr2[0]);
+#endif /* STM32MP_LPDDR4_TYPE */
+}
+
+/**
+  * @brief  Switch the DDR to another PHY pstate trained by HAL_DDR_Init.
+  *         The DDR is put in software self-refresh with the PHY in LP3 state,
+  *         PLL2 is set to the pstate frequency and the PHY leaves LP3 state
+  *         in the new pstate (DFIMISC.dfi_frequency).
+  *         The controller has a single set of timings, programmed for the
+  *         pstate 0: only the refresh interval is scaled to the pstate
+  *         frequency, the other timings are kept. So the pstate shall not
+  *         be faster than pstate 0 and shall use its DFI frequency ratio
+  *         and its latency mode registers (DDR3/DDR4 MR0 and MR2, LPDDR4
+  *         MR1 and MR2), else an error is returned.
+  *         The DDR shall not be accessed by other masters during the switch.
+  *         On a PLL2 or refresh update error, the current pstate is restored
+  *         and the DDR leaves self-refresh before the error is returned.
+  * @param  pstate PHY pstate, lower than the number of trained pstates.
+  * @retval HAL status.
+  */
+HAL_StatusTypeDef HAL_DDR_Set_PState(uint32_t pstate)
+{
+  uint32_t rfshtmg;
+  uint32_t t_rfc_nom;
+
+  if ((pstate >= (uint32_t)userinputbasic.numpstates) ||
+      (sr_mode != HAL_DDR_SW_SELF_REFRESH_MODE) ||
+      !pstate_timings_valid(pstate))
+  {
+    return HAL_ERROR;
+  }
+
+  if (pstate == ddr_pstate)
+  {
+    return HAL_OK;
+  }
+
+  if (ssr_entry(false) != 0)
+  {
+    return HAL_ERROR;
+  }
+
+  rfshtmg = READ_REG(DDRC->RFSHTMG);
+
+  if (ddrphy_phyinit_usercustom_e_setdficlk((int32_t)pstate) != 0)
+  {
+    goto restore;
+  }
+
+  /* Refresh interval of pstate 0 scaled to the pstate frequency */
+  t_rfc_nom = (static_ddr_config.c_timing.RFSHTMG & DDRC_RFSHTMG_T_RFC_NOM_X1_X32_Msk) >>
+              DDRC_RFSHTMG_T_RFC_NOM_X1_X32_Pos;
+  t_rfc_nom = (t_rfc_nom * (uint32_t)userinputbasic.frequency[pstate]) /
+              (uint32_t)userinputbasic.frequency[0];
+  MODIFY_REG(DDRC->RFSHTMG, DDRC_RFSHTMG_T_RFC_NOM_X1_X32_Msk,
+             t_rfc_nom << DDRC_RFSHTMG_T_RFC_NOM_X1_X32_Pos);
+  if (wait_refresh_update_done_ack() != 0)
+  {
+    goto restore;
+  }
+
+  ddr_pstate = pstate;
+
+  if (sr_ssr_exit() != 0)
+  {
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+
+restore:
+  /* Back to the current pstate, its PLL2 rate and refresh interval */
+  (void)ddrphy_phyinit_usercustom_e_setdficlk((int32_t)ddr_pstate);
+  WRITE_REG(DDRC->RFSHTMG, rfshtmg);
+  (void)wait_refresh_update_done_ack();
+  (void)sr_ssr_exit();
+
+  return HAL_ERROR;
+}
+
+/**
+  * @brief  Get the current PHY pstate.
+  * @param  None
+  * @retval PHY pstate.
+  */
+uint32_t HAL_DDR_Get_PState(void)
+{
+  return ddr_pstate;
+}
+
 /**
   * @}
   */
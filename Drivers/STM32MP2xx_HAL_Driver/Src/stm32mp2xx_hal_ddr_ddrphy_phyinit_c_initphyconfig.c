@@ -14,7 +14,9 @@
 
 #include <stdlib.h>
 
+#ifndef DDRPHY_PHYINIT_HOST
 #include "stm32mp2xx_hal.h"
+#endif /* DDRPHY_PHYINIT_HOST */
 #include "stm32mp2xx_hal_ddr_ddrphy_phyinit.h"
 #include "stm32mp2xx_hal_ddr_ddrphy_wrapper.h"
 
@@ -0,0 +1,60 @@
+/**
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/*
+ * This file provides the CRC32 of the trained state snapshot, of the recorded
+ * register writes and of the user input hashes. It has no dependency on the
+ * PHY: Scripts/ddrphyinit builds it on the host for the hash of the
+ * precomputed table and the DDR tool uses it for its register snapshots, on
+ * all the series.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint32_t ddrphy_phyinit_crc32(uint32_t crc, const void *buf, size_t len);
+
+/* CRC32 (IEEE 802.3 reflected polynomial) lookup table, one nibble per step */
+static const uint32_t crc32_nibble[16] = {
+  0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+  0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+  0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+  0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+};
+
+/*
+ * Computes the CRC32 of a buffer, same result as zlib crc32().
+ *
+ * \param crc  CRC32 of the previous data, 0 for the first buffer.
+ * \param buf  data to add to the CRC.
+ * \param len  size of the data in bytes.
+ *
+ * \return updated CRC32.
+ */
+uint32_t ddrphy_phyinit_crc32(uint32_t crc, const void *buf, size_t len)
+{
+  const uint8_t *data = (const uint8_t *)buf;
+  size_t i;
+
+  crc = ~crc;
+
+  for (i = 0U; i < len; i++)
+  {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ crc32_nibble[crc & 0xFU];
+    crc = (crc >> 4) ^ crc32_nibble[crc & 0xFU];
+  }
+
+  return ~crc;
+}
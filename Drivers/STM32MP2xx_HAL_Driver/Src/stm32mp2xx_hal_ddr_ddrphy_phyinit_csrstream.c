@@ -0,0 +1,258 @@
+/**
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/*
+ * This file provides a recorder of the register writes issued by PhyInit
+ * through mmio_write_16() and mmio_write_32(), and a replay of the recorded
+ * stream.  A PHY initialization without training only depends on the user
+ * inputs, so its writes can be recorded once and replayed on a next boot for
+ * the same configuration, without computing the message block, the PHY
+ * configuration and the PIE image again.
+ *
+ * The writes are encoded in 16-bit words after a csrstream_t header:
+ * - run:  CSRSTREAM_RUN | n, signed distance in registers from the register
+ *         following the previous write, then n values of successive registers
+ * - far:  CSRSTREAM_FAR | n, 32-bit register index, then n values of
+ *         successive registers
+ * - wide: CSRSTREAM_WIDE, 32-bit register index, 32-bit value
+ * A register index is the register address divided by 4; the 32-bit values
+ * written by mmio_write_16() are recorded, so the replay does not read the
+ * registers.
+ */
+
+#include <string.h>
+
+#include "stm32mp2xx_hal_ddr_ddrphy_phyinit.h"
+
+#define CSRSTREAM_RUN   0x0000U
+#define CSRSTREAM_FAR   0x4000U
+#define CSRSTREAM_WIDE  0x8000U
+#define CSRSTREAM_KIND  0xC000U
+#define CSRSTREAM_COUNT 0x3FFFU
+
+static csrstream_t *stream;   /* Stream being recorded */
+static uint16_t *nextword;    /* First free word of the stream */
+static uint16_t *endword;     /* End of the stream area */
+static uint16_t *runword;     /* Header of the current run, NULL if none */
+static uint32_t nextindex;    /* Register following the last write */
+static bool overflow;         /* Stream area too small */
+
+/* Appends words to the stream, recording stops when the area is full */
+static bool csrstream_put(const uint16_t *words, uint32_t nb)
+{
+  if ((uint32_t)(endword - nextword) < nb)
+  {
+    overflow = true;
+    csrstream_record = false;
+    return false;
+  }
+
+  (void)memcpy(nextword, words, nb * sizeof(uint16_t));
+  nextword += nb;
+
+  return true;
+}
+
+/*
+ * Records a register write, called by mmio_write_16() and mmio_write_32()
+ * while the recording is started.
+ *
+ * \param addr   register address.
+ * \param value  32-bit value written in the register.
+ */
+void ddrphy_phyinit_recordcsr(uintptr_t addr, uint32_t value)
+{
+  uint32_t index = (uint32_t)(addr / 4U);
+  int32_t delta = (int32_t)(index - nextindex);
+  uint16_t words[5];
+  uint16_t *header = nextword;
+
+  stream->numwrites++;
+
+  if (value > 0xFFFFU)
+  {
+    words[0] = CSRSTREAM_WIDE;
+    words[1] = (uint16_t)index;
+    words[2] = (uint16_t)(index >> 16);
+    words[3] = (uint16_t)value;
+    words[4] = (uint16_t)(value >> 16);
+    (void)csrstream_put(words, 5U);
+    runword = NULL;
+  }
+  else if ((runword != NULL) && (delta == 0) &&
+           ((*runword & CSRSTREAM_COUNT) != CSRSTREAM_COUNT))
+  {
+    words[0] = (uint16_t)value;
+    if (csrstream_put(words, 1U))
+    {
+      (*runword)++;
+    }
+  }
+  else if ((delta >= INT16_MIN) && (delta <= INT16_MAX))
+  {
+    words[0] = CSRSTREAM_RUN | 1U;
+    words[1] = (uint16_t)delta;
+    words[2] = (uint16_t)value;
+    runword = csrstream_put(words, 3U) ? header : NULL;
+  }
+  else
+  {
+    words[0] = CSRSTREAM_FAR | 1U;
+    words[1] = (uint16_t)index;
+    words[2] = (uint16_t)(index >> 16);
+    words[3] = (uint16_t)value;
+    runword = csrstream_put(words, 4U) ? header : NULL;
+  }
+
+  nextindex = index + 1U;
+}
+
+/*
+ * Starts the recording of the register writes in a stream area.
+ *
+ * The stream is invalid until ddrphy_phyinit_stopcsrrecord() is called.
+ *
+ * \param buf   stream area, 16-bit aligned.
+ * \param size  size of the stream area in bytes.
+ */
+void ddrphy_phyinit_startcsrrecord(void *buf, size_t size)
+{
+  stream = (csrstream_t *)buf;
+  (void)memset(stream, 0, sizeof(csrstream_t));
+
+  nextword = (uint16_t *)(stream + 1);
+  endword = nextword + ((size - sizeof(csrstream_t)) / sizeof(uint16_t));
+  runword = NULL;
+  nextindex = 0U;
+  overflow = (size < sizeof(csrstream_t));
+
+  csrstream_record = !overflow;
+}
+
+/*
+ * Stops the recording of the register writes.
+ *
+ * \param valid  false when the recorded sequence failed, the stream is then
+ *               left invalid.
+ * \param hash   hash of the configuration of the recorded sequence.
+ *
+ * \return 0 when the stream is valid, -1 if invalid or if the area is too
+ * small for the recorded writes.
+ */
+int32_t ddrphy_phyinit_stopcsrrecord(bool valid, uint32_t hash)
+{
+  csrstream_record = false;
+
+  if (!valid || overflow)
+  {
+    return -1;
+  }
+
+  stream->hash = hash;
+  stream->size = (uint32_t)((uintptr_t)nextword - (uintptr_t)(stream + 1));
+  stream->checksum = ddrphy_phyinit_crc32(0U, stream, sizeof(csrstream_t) + stream->size);
+
+  /* Stream is only valid once completely written */
+  stream->magic = CSRSTREAM_MAGIC;
+
+  VERBOSE("%s %u writes in %u bytes\n", __func__, stream->numwrites, stream->size);
+
+  return 0;
+}
+
+/*
+ * Replays a stream recorded by ddrphy_phyinit_startcsrrecord() and
+ * ddrphy_phyinit_stopcsrrecord().
+ *
+ * No register is written when the stream is invalid or recorded for another
+ * configuration: the PhyInit sequence shall then be executed.
+ *
+ * \param buf   stream area.
+ * \param size  size of the stream area in bytes.
+ * \param hash  hash of the current configuration.
+ *
+ * \return 0 on success, -1 if the stream is invalid or recorded for another
+ * configuration.
+ */
+int32_t ddrphy_phyinit_replaycsrs(const void *buf, size_t size, uint32_t hash)
+{
+  const csrstream_t *header = (const csrstream_t *)buf;
+  const uint16_t *word = (const uint16_t *)(header + 1);
+  const uint16_t *end;
+  csrstream_t copy;
+  uint32_t checksum;
+  uint32_t index = 0U;
+  uint32_t count;
+
+  if ((size < sizeof(csrstream_t)) || (header->magic != CSRSTREAM_MAGIC) ||
+      (header->hash != hash) || (header->size > (size - sizeof(csrstream_t))) ||
+      ((header->size % sizeof(uint16_t)) != 0U))
+  {
+    return -1;
+  }
+
+  copy = *header;
+  copy.magic = 0U;
+  copy.checksum = 0U;
+  checksum = ddrphy_phyinit_crc32(0U, &copy, sizeof(copy));
+  checksum = ddrphy_phyinit_crc32(checksum, word, header->size);
+  if (checksum != header->checksum)
+  {
+    return -1;
+  }
+
+  end = word + (header->size / sizeof(uint16_t));
+
+  while (word < end)
+  {
+    count = (uint32_t)(*word & CSRSTREAM_COUNT);
+
+    switch (*word & CSRSTREAM_KIND)
+    {
+      case CSRSTREAM_RUN:
+        index += (uint32_t)(int32_t)(int16_t)word[1];
+        word += 2;
+        break;
+      case CSRSTREAM_FAR:
+        index = (uint32_t)word[1] | ((uint32_t)word[2] << 16);
+        word += 3;
+        break;
+      case CSRSTREAM_WIDE:
+        index = (uint32_t)word[1] | ((uint32_t)word[2] << 16);
+        mmio_write_32((uintptr_t)index * 4U, (uint32_t)word[3] | ((uint32_t)word[4] << 16));
+        index++;
+        word += 5;
+        continue;
+      default:
+        return -1;
+    }
+
+    if ((uint32_t)(end - word) < count)
+    {
+      return -1;
+    }
+
+    /* Successive registers, values written without reading the registers */
+    for (; count > 0U; count--)
+    {
+      mmio_write_32((uintptr_t)index * 4U, *word);
+      index++;
+      word++;
+    }
+  }
+
+  VERBOSE("%s %u writes replayed\n", __func__, header->numwrites);
+
+  return 0;
+}
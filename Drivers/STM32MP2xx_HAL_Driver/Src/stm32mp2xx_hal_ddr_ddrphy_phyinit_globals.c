@@ -36,3 +36,6 @@ pmu_smb_ddr_1d_t shdw_ddr_1d[NB_PS];
  * function does not require a PHY read register implementation.
  */
 int32_t ardptrinitval[NB_PS];
+
+/* Register writes are recorded, see ddrphy_phyinit_startcsrrecord() */
+bool csrstream_record;
@@ -0,0 +1,172 @@
+/**
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/*
+ * This file loads the PhyInit results computed on the host for a static
+ * configuration: the message blocks, ardptrinitval and the register writes of
+ * ddrphy_phyinit_c_initphyconfig() only depend on the user inputs, so they
+ * are generated at build time by Scripts/ddrphyinit from the same sources.
+ *
+ * The table is only used when the hash of the current user inputs matches
+ * the hash of the generation; otherwise, as for the user inputs modified by
+ * the interactive mode, the PhyInit sequence computes them again.
+ */
+
+#include <string.h>
+
+#include "stm32mp2xx_hal_ddr_ddrphy_phyinit.h"
+
+static const phyinit_precomp_t *precomp; /* Table of the static configuration */
+
+/* Adds one user input field to the hash, the structure padding is not hashed */
+#define UIHASH(field) \
+  hash = ddrphy_phyinit_crc32(hash, &(field), sizeof(field))
+
+/*
+ * Computes the hash identifying the user inputs of a precomputed table.
+ *
+ * \return CRC32 of the fields of the basic, advanced, mode register and swizzle
+ * user inputs.
+ */
+uint32_t ddrphy_phyinit_uihash(void)
+{
+  uint32_t hash = 0U;
+
+  UIHASH(userinputbasic.dramtype);
+  UIHASH(userinputbasic.dimmtype);
+  UIHASH(userinputbasic.lp4xmode);
+  UIHASH(userinputbasic.numdbyte);
+  UIHASH(userinputbasic.numactivedbytedfi0);
+  UIHASH(userinputbasic.numactivedbytedfi1);
+  UIHASH(userinputbasic.numanib);
+  UIHASH(userinputbasic.numrank_dfi0);
+  UIHASH(userinputbasic.numrank_dfi1);
+  UIHASH(userinputbasic.dramdatawidth);
+  UIHASH(userinputbasic.numpstates);
+  UIHASH(userinputbasic.frequency);
+  UIHASH(userinputbasic.pllbypass);
+  UIHASH(userinputbasic.dfifreqratio);
+  UIHASH(userinputbasic.dfi1exists);
+  UIHASH(userinputbasic.train2d);
+  UIHASH(userinputbasic.hardmacrover);
+  UIHASH(userinputbasic.readdbienable);
+  UIHASH(userinputbasic.dfimode);
+
+  UIHASH(userinputadvanced.lp4rxpreamblemode);
+  UIHASH(userinputadvanced.lp4postambleext);
+  UIHASH(userinputadvanced.d4rxpreamblelength);
+  UIHASH(userinputadvanced.d4txpreamblelength);
+  UIHASH(userinputadvanced.extcalresval);
+  UIHASH(userinputadvanced.is2ttiming);
+  UIHASH(userinputadvanced.odtimpedance);
+  UIHASH(userinputadvanced.tximpedance);
+  UIHASH(userinputadvanced.atximpedance);
+  UIHASH(userinputadvanced.memalerten);
+  UIHASH(userinputadvanced.memalertpuimp);
+  UIHASH(userinputadvanced.memalertvreflevel);
+  UIHASH(userinputadvanced.memalertsyncbypass);
+  UIHASH(userinputadvanced.disdynadrtri);
+  UIHASH(userinputadvanced.phymstrtraininterval);
+  UIHASH(userinputadvanced.phymstrmaxreqtoack);
+  UIHASH(userinputadvanced.wdqsext);
+  UIHASH(userinputadvanced.calinterval);
+  UIHASH(userinputadvanced.calonce);
+  UIHASH(userinputadvanced.lp4rl);
+  UIHASH(userinputadvanced.lp4wl);
+  UIHASH(userinputadvanced.lp4wls);
+  UIHASH(userinputadvanced.lp4dbird);
+  UIHASH(userinputadvanced.lp4dbiwr);
+  UIHASH(userinputadvanced.lp4nwr);
+  UIHASH(userinputadvanced.lp4lowpowerdrv);
+  UIHASH(userinputadvanced.drambyteswap);
+  UIHASH(userinputadvanced.rxenbackoff);
+  UIHASH(userinputadvanced.trainsequencectrl);
+  UIHASH(userinputadvanced.snpsumctlopt);
+  UIHASH(userinputadvanced.snpsumctlf0rc5x);
+  UIHASH(userinputadvanced.txslewrisedq);
+  UIHASH(userinputadvanced.txslewfalldq);
+  UIHASH(userinputadvanced.txslewriseac);
+  UIHASH(userinputadvanced.txslewfallac);
+  UIHASH(userinputadvanced.disableretraining);
+  UIHASH(userinputadvanced.disablephyupdate);
+  UIHASH(userinputadvanced.enablehighclkskewfix);
+  UIHASH(userinputadvanced.disableunusedaddrlns);
+  UIHASH(userinputadvanced.phyinitsequencenum);
+  UIHASH(userinputadvanced.enabledficspolarityfix);
+  UIHASH(userinputadvanced.phyvref);
+  UIHASH(userinputadvanced.sequencectrl);
+
+  UIHASH(userinputmoderegister.mr0);
+  UIHASH(userinputmoderegister.mr1);
+  UIHASH(userinputmoderegister.mr2);
+  UIHASH(userinputmoderegister.mr3);
+  UIHASH(userinputmoderegister.mr4);
+  UIHASH(userinputmoderegister.mr5);
+  UIHASH(userinputmoderegister.mr6);
+  UIHASH(userinputmoderegister.mr11);
+  UIHASH(userinputmoderegister.mr12);
+  UIHASH(userinputmoderegister.mr13);
+  UIHASH(userinputmoderegister.mr14);
+  UIHASH(userinputmoderegister.mr22);
+
+  UIHASH(userinputswizzle.swizzle);
+
+  return hash;
+}
+
+/*
+ * Sets the precomputed table used by ddrphy_phyinit_sequence().
+ *
+ * \param table  generated table, NULL to always compute the PHY configuration.
+ */
+void ddrphy_phyinit_setprecomp(const phyinit_precomp_t *table)
+{
+  precomp = table;
+}
+
+/*
+ * Loads the precomputed table in place of ddrphy_phyinit_initstruct(),
+ * ddrphy_phyinit_calcmb() and ddrphy_phyinit_c_initphyconfig().
+ *
+ * Nothing is written when no table is set or when the table was generated for
+ * other user inputs.
+ *
+ * \return 0 on success, -1 if the PHY configuration shall be computed.
+ */
+int32_t ddrphy_phyinit_loadprecomp(void)
+{
+  uint32_t i;
+
+  if ((precomp == NULL) || (precomp->mbsize != (uint32_t)sizeof(pmu_smb_ddr_1d_t)) ||
+      (precomp->uihash != ddrphy_phyinit_uihash()))
+  {
+    return -1;
+  }
+
+  VERBOSE("%s Start\n", __func__);
+
+  (void)memcpy(mb_ddr_1d, precomp->mb, sizeof(mb_ddr_1d));
+  (void)memcpy(shdw_ddr_1d, precomp->shdw, sizeof(shdw_ddr_1d));
+  (void)memcpy(ardptrinitval, precomp->ardptrinitval, sizeof(ardptrinitval));
+
+  for (i = 0U; i < precomp->numregs; i++)
+  {
+    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * precomp->regs[i].address),
+                  precomp->regs[i].value);
+  }
+
+  VERBOSE("%s End\n", __func__);
+
+  return 0;
+}
@@ -20,7 +20,9 @@
  * programing in any function during PHY initialization.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "stm32mp2xx_hal_ddr_ddrphy_phyinit.h"
 
@@ -29,14 +31,29 @@
  *
  * This define is only used by the PhyInit Register interface to define the max
  * amount of registered that can be saved. The user may increase this variable
- * as desired if a larger number of registers need to be restored.
+ * as desired if a larger number of registers need to be restored. The count
+ * is given for one pstate, the registers of each trained pstate are tracked.
  */
 #if STM32MP_DDR3_TYPE || STM32MP_DDR4_TYPE
-#define MAX_NUM_RET_REGS 129
+#define MAX_NUM_RET_REGS (129 * NB_PS)
 #elif STM32MP_LPDDR4_TYPE
-#define MAX_NUM_RET_REGS 283
+#define MAX_NUM_RET_REGS (283 * NB_PS)
 #endif /* STM32MP_LPDDR4_TYPE */
 
+/*
+ * RETREG_INDEX_BITS size of the index of the tracked registers
+ *
+ * The index is a hash table of at least twice the number of registers, so
+ * the search of an address only probes a few entries.
+ */
+#if STM32MP_DDR3_TYPE || STM32MP_DDR4_TYPE
+#define RETREG_INDEX_BITS (9 + NB_PS - 1)
+#elif STM32MP_LPDDR4_TYPE
+#define RETREG_INDEX_BITS (10 + NB_PS - 1)
+#endif /* STM32MP_LPDDR4_TYPE */
+
+#define RETREG_INDEX_SIZE (1U << RETREG_INDEX_BITS)
+
 /*
  * Array of Address/value pairs used to store register values for the purpose
  * of retention restore.
@@ -50,6 +67,29 @@ static reg_addr_val_t *retreglist = (reg_addr_val_t *)(RETREG_BASE + sizeof(int3
 static int32_t numregsaved; /* Current Number of registers saved. */
 static int32_t tracken = 1; /* Enabled tracking of registers */
 
+/*
+ * Index of the tracked registers, hashed on the register address with linear
+ * probing: position in retreglist + 1, 0 for a free entry.
+ */
+static uint16_t retregindex[RETREG_INDEX_SIZE];
+
+/* Duration of the last SAVEREGS and RESTOREREGS, in HAL_DDR_Get_Counter() counts */
+static uint64_t savetime;
+static uint64_t restoretime;
+
+/* Fibonacci hashing of the register address on RETREG_INDEX_BITS */
+static uint32_t reginterface_hash(uint32_t adr)
+{
+  return (adr * 0x9E3779B1U) >> (32U - RETREG_INDEX_BITS);
+}
+
+/* Forgets the tracked registers, when the list is replaced */
+static void reginterface_clearindex(void)
+{
+  (void)memset(retregindex, 0, sizeof(retregindex));
+  numregsaved = 0;
+}
+
 int32_t ddrphy_phyinit_setretreglistbase(uintptr_t base)
 {
   int32_t *value = (int32_t *)base;
@@ -69,6 +109,8 @@ int32_t ddrphy_phyinit_setretreglistbase(uintptr_t base)
   retregsize = (int32_t *)base;
   retreglist = (reg_addr_val_t *)(base + 4);
 
+  reginterface_clearindex();
+
   return 0;
 }
 
@@ -86,7 +128,7 @@ int32_t ddrphy_phyinit_setretreglistbase(uintptr_t base)
  */
 int32_t ddrphy_phyinit_trackreg(uint32_t adr)
 {
-  int32_t regindx = 0;
+  uint32_t slot;
 
   /* Return if tracking is disabled */
   if (tracken == 0)
@@ -94,10 +136,11 @@ int32_t ddrphy_phyinit_trackreg(uint32_t adr)
     return 0;
   }
 
-  /* Search register address within the array */
-  for (regindx = 0; regindx < numregsaved; regindx++)
+  /* Search register address within the index */
+  for (slot = reginterface_hash(adr); retregindex[slot] != 0U;
+       slot = (slot + 1U) & (RETREG_INDEX_SIZE - 1U))
   {
-    if (retreglist[regindx].address == adr)
+    if (retreglist[retregindex[slot] - 1U].address == adr)
     {
       /* Register found */
       return 0;
@@ -113,8 +156,9 @@ int32_t ddrphy_phyinit_trackreg(uint32_t adr)
     return -1;
   }
 
-  retreglist[regindx].address = adr;
+  retreglist[numregsaved].address = adr;
   numregsaved++;
+  retregindex[slot] = (uint16_t)numregsaved;
 
   return 0;
 }
@@ -153,40 +197,48 @@ int32_t ddrphy_phyinit_trackreg(uint32_t adr)
 int32_t ddrphy_phyinit_reginterface(reginstr myreginstr, __unused uint32_t adr,
                                     __unused uint16_t dat)
 {
+  volatile uint32_t *phy = (volatile uint32_t *)DDRPHYC_BASE;
+
   if (myreginstr == SAVEREGS)
   {
-    int32_t regindx;
+    reg_addr_val_t *reg = retreglist;
+    reg_addr_val_t *end = retreglist + numregsaved;
+    uint64_t start = HAL_DDR_Get_Counter();
 
     /*
      * go through all the tracked registers, issue a register read and place
-     * the result in the data structure for future recovery.
+     * the result in the data structure for future recovery, in one pass
+     * without address computation per register.
      */
-    for (regindx = 0; regindx < numregsaved; regindx++)
+    for (; reg < end; reg++)
     {
-      uint16_t data;
-
-      data = mmio_read_16((uintptr_t)(DDRPHYC_BASE + (4U * retreglist[regindx].address)));
-      retreglist[regindx].value = data;
+      reg->value = (uint16_t)READ_REG(phy[reg->address]);
     }
 
     *retregsize = numregsaved;
 
+    savetime = HAL_DDR_Get_Counter() - start;
+
     return 0;
   }
   else if (myreginstr == RESTOREREGS)
   {
-    int32_t regindx;
+    const reg_addr_val_t *reg = retreglist;
+    const reg_addr_val_t *end = retreglist + *retregsize;
+    uint64_t start = HAL_DDR_Get_Counter();
 
     /*
      * write PHY registers based on Address, Data value pairs stores in
-     * retreglist
+     * retreglist, without reading them: the upper half of the 32-bit slots
+     * is not used by the 16-bit PHY registers.
      */
-    for (regindx = 0; regindx < *retregsize; regindx++)
+    for (; reg < end; reg++)
     {
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * retreglist[regindx].address)),
-                    retreglist[regindx].value);
+      WRITE_REG(phy[reg->address], (uint32_t)reg->value);
     }
 
+    restoretime = HAL_DDR_Get_Counter() - start;
+
     return 0;
   }
   else if (myreginstr == STARTTRACK)
@@ -219,3 +271,128 @@ int32_t ddrphy_phyinit_reginterface(reginstr myreginstr, __unused uint32_t adr,
     return -1;
   }
 }
+
+/*
+ * Gets the saved retention registers and the duration of their last save and
+ * restore, printed by HAL_DDR_Dump_RetRegs().
+ *
+ * \param list        address, value pairs saved by SAVEREGS.
+ * \param numtracked  number of tracked registers.
+ * \param save_us     duration of the last SAVEREGS in us.
+ * \param restore_us  duration of the last RESTOREREGS in us.
+ *
+ * \return number of saved registers.
+ */
+int32_t ddrphy_phyinit_getretregs(const reg_addr_val_t **list, int32_t *numtracked,
+                                  uint32_t *save_us, uint32_t *restore_us)
+{
+  *list = retreglist;
+  *numtracked = numregsaved;
+  *save_us = (uint32_t)HAL_DDR_Counter_To_Us(savetime);
+  *restore_us = (uint32_t)HAL_DDR_Counter_To_Us(restoretime);
+
+  return *retregsize;
+}
+
+/*
+ * Serializes the saved retention registers in a snapshot.
+ *
+ * The snapshot contains a header with the configuration hash provided by
+ * the caller and a checksum, followed by the address, value pairs saved by
+ * the SAVEREGS instruction. It can be stored in a retention memory or by the
+ * host and given back to ddrphy_phyinit_importretregs() on a next boot to
+ * restore the training results without executing the training firmware.
+ *
+ * \param buf   snapshot area.
+ * \param size  size of the snapshot area in bytes.
+ * \param hash  hash of the configuration used for the training.
+ *
+ * \return 0 on success, -1 if no registers are saved or if the area is too small.
+ */
+int32_t ddrphy_phyinit_exportretregs(void *buf, size_t size, uint32_t hash)
+{
+  retregs_snapshot_t *snapshot = (retregs_snapshot_t *)buf;
+  reg_addr_val_t *list = (reg_addr_val_t *)(snapshot + 1);
+  int32_t numregs = *retregsize;
+  int32_t regindx;
+
+  if ((numregs <= 0) || (numregs > (MAX_NUM_RET_REGS + 1)) ||
+      (size < (sizeof(retregs_snapshot_t) + ((size_t)numregs * sizeof(reg_addr_val_t)))))
+  {
+    return -1;
+  }
+
+  /* Clear the padding of the pairs, part of the checksum */
+  (void)memset(buf, 0, sizeof(retregs_snapshot_t) + ((size_t)numregs * sizeof(reg_addr_val_t)));
+
+  for (regindx = 0; regindx < numregs; regindx++)
+  {
+    list[regindx].address = retreglist[regindx].address;
+    list[regindx].value = retreglist[regindx].value;
+  }
+
+  snapshot->hash = hash;
+  snapshot->numregs = (uint32_t)numregs;
+  snapshot->checksum = ddrphy_phyinit_crc32(0U, buf, sizeof(retregs_snapshot_t) +
+                                            ((size_t)numregs * sizeof(reg_addr_val_t)));
+
+  /* Snapshot is only valid once completely written */
+  snapshot->magic = RETREGS_SNAPSHOT_MAGIC;
+
+  return 0;
+}
+
+/*
+ * Loads the retention registers from a snapshot built by
+ * ddrphy_phyinit_exportretregs().
+ *
+ * On success, the registers are available for the RESTOREREGS instruction
+ * and for a next retention exit. The snapshot area shall not overlap the
+ * retention register list.
+ *
+ * \param buf   snapshot area.
+ * \param hash  hash of the current configuration.
+ *
+ * \return 0 on success, -1 if the snapshot is invalid or built for another
+ * configuration.
+ */
+int32_t ddrphy_phyinit_importretregs(const void *buf, uint32_t hash)
+{
+  const retregs_snapshot_t *snapshot = (const retregs_snapshot_t *)buf;
+  const reg_addr_val_t *list = (const reg_addr_val_t *)(snapshot + 1);
+  retregs_snapshot_t header;
+  uint32_t checksum;
+  uint32_t regindx;
+
+  if ((snapshot->magic != RETREGS_SNAPSHOT_MAGIC) || (snapshot->hash != hash) ||
+      (snapshot->numregs == 0U) || (snapshot->numregs > (uint32_t)(MAX_NUM_RET_REGS + 1)))
+  {
+    return -1;
+  }
+
+  header = *snapshot;
+  header.magic = 0U;
+  header.checksum = 0U;
+  checksum = ddrphy_phyinit_crc32(0U, &header, sizeof(header));
+  checksum = ddrphy_phyinit_crc32(checksum, list, snapshot->numregs * sizeof(reg_addr_val_t));
+  if (checksum != snapshot->checksum)
+  {
+    return -1;
+  }
+
+  for (regindx = 0U; regindx < snapshot->numregs; regindx++)
+  {
+    retreglist[regindx].address = list[regindx].address;
+    retreglist[regindx].value = list[regindx].value;
+  }
+
+  *retregsize = (int32_t)snapshot->numregs;
+
+  /* Imported list replaces the tracked registers, tracked again if needed */
+  reginterface_clearindex();
+
+  /* Saved registers available for ddrphy_phyinit_restore_sequence() */
+  retention_enable = true;
+
+  return 0;
+}
@@ -34,27 +34,34 @@ int32_t ddrphy_phyinit_sequence(bool skip_training, bool reten)
 
   VERBOSE("%s Start\n", __func__);
 
-  /* Initialize structures */
-  ddrphy_phyinit_initstruct();
-
-  /* Re-calculate Firmware Message Block input based on final user input */
-  ret = ddrphy_phyinit_calcmb();
-  if (ret != 0)
-  {
-    return ret;
-  }
-
   /* (A) Bring up VDD, VDDQ, and VAA */
   /* call ddrphy_phyinit_usercustom_a_bringuppower() if needed */
 
   /* (B) Start Clocks and Reset the PHY */
   /* call ddrphy_phyinit_usercustom_b_startclockresetphy() if needed */
 
-  /* (C) Initialize PHY Configuration */
-  ret = ddrphy_phyinit_c_initphyconfig();
-  if (ret != 0)
+  /*
+   * Message Block and step (C) generated on the host for these user inputs,
+   * computed when there is no table or when it does not match the user inputs
+   */
+  if (ddrphy_phyinit_loadprecomp() != 0)
   {
-    return ret;
+    /* Initialize structures */
+    ddrphy_phyinit_initstruct();
+
+    /* Re-calculate Firmware Message Block input based on final user input */
+    ret = ddrphy_phyinit_calcmb();
+    if (ret != 0)
+    {
+      return ret;
+    }
+
+    /* (C) Initialize PHY Configuration */
+    ret = ddrphy_phyinit_c_initphyconfig();
+    if (ret != 0)
+    {
+      return ret;
+    }
   }
   /*
    * Customize any register write desired; This can include any CSR not covered by PhyInit
@@ -91,7 +98,14 @@ int32_t ddrphy_phyinit_sequence(bool skip_training, bool reten)
     for (pstate = 0; pstate < userinputbasic.numpstates; pstate++)
     {
       /* (E) Set the PHY input clocks to the desired frequency */
-      /* call ddrphy_phyinit_usercustom_e_setdficlk(pstate) if needed */
+      if (userinputbasic.numpstates > 1)
+      {
+        ret = ddrphy_phyinit_usercustom_e_setdficlk(pstate);
+        if (ret != 0)
+        {
+          return ret;
+        }
+      }
 
       /*
        * Note: this routine implies other items such as dfifreqratio, DfiCtlClk
@@ -110,6 +124,17 @@ int32_t ddrphy_phyinit_sequence(bool skip_training, bool reten)
 
       /* (G) Execute the Training Firmware */
       ret = ddrphy_phyinit_g_execfw();
+      ddrphy_phyinit_usercustom_g_trainresult(pstate, ret);
+      if (ret != 0)
+      {
+        return ret;
+      }
+    }
+
+    /* Mission mode starts in pstate 0 */
+    if (userinputbasic.numpstates > 1)
+    {
+      ret = ddrphy_phyinit_usercustom_e_setdficlk(0);
       if (ret != 0)
       {
         return ret;
@@ -0,0 +1,94 @@
+/**
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include "stm32mp2xx_hal_ddr_ddrphy_phyinit_usercustom.h"
+#include "stm32mp2xx_hal_ddr_ddrphy_phyinit.h"
+
+/*
+ * Sets the PHY input clocks to the frequency of a pstate.
+ *
+ * The DDR PHY, the DFI and the DDR controller are clocked by PLL2 with a DDR
+ * frequency equal to 2 x PLL2 frequency. The PLL2 rate is computed from
+ * user_input_basic.frequency[pstate] (MHz) with the current source, FREFDIV,
+ * POSTDIV1, POSTDIV2 and spread spectrum settings: only FBDIV and FRACIN are
+ * changed. PLL2 is not modified when it already provides this rate.
+ *
+ * This function is called by ddrphy_phyinit_sequence() before the training of
+ * each pstate when several pstates are trained, and by HAL_DDR_Set_PState()
+ * while the PHY is in LP3 state: the PHY and the controller shall not use the
+ * clock during the change.
+ *
+ * \param pstate  pstate of the user inputs.
+ *
+ * \return 0 on success, -1 on error.
+ */
+int32_t ddrphy_phyinit_usercustom_e_setdficlk(int32_t pstate)
+{
+  RCC_PLLInitTypeDef pll2;
+  uint64_t fck_ref;
+  uint64_t fvco;
+  uint32_t fbdiv;
+  uint32_t fracin;
+
+  if ((pstate < 0) || (pstate >= userinputbasic.numpstates) ||
+      (userinputbasic.frequency[pstate] <= 0))
+  {
+    return -1;
+  }
+
+  HAL_RCCEx_GetPLL2Config(&pll2);
+
+  switch (pll2.PLLSource)
+  {
+    case RCC_PLLSOURCE_HSI:
+      fck_ref = HSI_VALUE;
+      break;
+    case RCC_PLLSOURCE_HSE:
+      fck_ref = HSE_VALUE;
+      break;
+    default:
+      return -1;
+  }
+
+  /* DDR freq = PLL2 freq * 2 */
+  fvco = (((uint64_t)userinputbasic.frequency[pstate] * 1000000U) / 2U) *
+         pll2.POSTDIV1 * pll2.POSTDIV2 * pll2.FREFDIV;
+  fbdiv = (uint32_t)(fvco / fck_ref);
+  fracin = (uint32_t)(((fvco % fck_ref) << 24) / fck_ref);
+
+  if ((pll2.PLLState == RCC_PLL_ON) && (pll2.FBDIV == fbdiv) && (pll2.FRACIN == fracin))
+  {
+    return 0;
+  }
+
+  VERBOSE("%s pstate %d: %d MHz\n", __func__, pstate, userinputbasic.frequency[pstate]);
+
+  /* Disable the PLL2 */
+  pll2.PLLState = RCC_PLL_OFF;
+  if (HAL_RCCEx_PLL2Config(&pll2) != HAL_OK)
+  {
+    return -1;
+  }
+
+  /* Configure and enable the PLL2 */
+  pll2.FBDIV = fbdiv;
+  pll2.FRACIN = fracin;
+  pll2.PLLState = RCC_PLL_ON;
+  if (HAL_RCCEx_PLL2Config(&pll2) != HAL_OK)
+  {
+    return -1;
+  }
+
+  return 0;
+}
@@ -12,8 +12,11 @@
   ******************************************************************************
   */
 
+#include <stdio.h>
+
 #include "stm32mp2xx_hal.h"
 #include "stm32mp2xx_hal_ddr_ddrphy_phyinit_usercustom.h"
+#include "stm32mp2xx_hal_ddr_ddrphy_phyinit.h"
 
 /* Firmware major messages */
 #define FW_MAJ_MSG_TRAINING_SUCCESS 0x0000007U
@@ -24,56 +27,116 @@
 #define PHYINIT_DELAY_10US    10UL
 #define PHYINIT_TIMEOUT_US_1S 1000000UL
 
+/* Maximum number of phases recorded for one firmware execution */
+#define FW_PHASE_MAX          32U
+
+/* Maximum number of streaming message arguments used for the decoding */
+#define FW_STREAM_ARG_MAX     8U
+
+/* Firmware log entry types */
+#define FW_LOG_START          0U /* firmware execution start */
+#define FW_LOG_MAJOR          1U /* major message */
+#define FW_LOG_STREAM_ID      2U /* streaming message string index */
+#define FW_LOG_STREAM_ARG     3U /* streaming message argument */
+
+typedef struct {
+  uint32_t id;
+  const char *name;
+} fw_major_msg_t;
+
+typedef struct {
+  uint32_t msg;      /* major message ending the phase */
+  uint64_t duration; /* counter ticks since the previous major message */
+} fw_phase_t;
+
+typedef struct {
+  int32_t result;    /* 0 if trained, error code else */
+  uint64_t duration; /* counter ticks of the firmware execution */
+} fw_pstate_t;
+
+#if DDRPHY_PHYINIT_FW_LOG_SIZE > 0
+typedef struct {
+  uint64_t timestamp; /* counter ticks since the firmware start */
+  uint32_t value;
+  uint32_t type;
+} fw_log_t;
+#endif /* DDRPHY_PHYINIT_FW_LOG_SIZE > 0 */
+
+/* Major messages, named after the training step they end */
+static const fw_major_msg_t fw_major_msg[] = {
+  {0x00U, "Init"},
+  {0x01U, "WrLvl"},
+  {0x02U, "RxEn"},
+  {0x03U, "RdDQS"},
+  {0x04U, "WrDQ"},
+  {0x05U, "RdEye2D"},
+  {0x06U, "WrEye2D"},
+  {0x07U, "Success"},
+  {0x08U, "Streaming"},
+  {0x09U, "MaxRdLat"},
+  {0x0AU, "RdDeskew"},
+  {0x0CU, "LRDIMM"},
+  {0x0DU, "CATrain"},
+  {0xFDU, "MprRdDQS"},
+  {0xFEU, "WrLvlCoarse"},
+  {0xFFU, "Failed"},
+};
+
+/* Phases of the last firmware execution */
+static fw_phase_t fw_phase[FW_PHASE_MAX];
+static uint32_t fw_phase_nb;
+static uint64_t fw_start;
+static uint64_t fw_end;
+
+/* Training of each pstate of the last firmware executions */
+static fw_pstate_t fw_pstate[NB_PS];
+static int32_t fw_pstate_nb;
+
+#if DDRPHY_PHYINIT_FW_LOG_SIZE > 0
+/* Raw message log, the oldest entries are overwritten */
+static fw_log_t fw_log[DDRPHY_PHYINIT_FW_LOG_SIZE];
+static uint32_t fw_log_nb;
+#endif /* DDRPHY_PHYINIT_FW_LOG_SIZE > 0 */
+
 static void phyinit_udelay(uint64_t delay_us)
 {
-  __IO uint64_t wait_loop_index = 0U;
-
-  wait_loop_index = (delay_us * ((uint64_t)SystemCoreClock / (1000000UL * 2UL)));
+  uint64_t timeout;
 
 #ifdef USE_STM32MP257CXX_EMU
-  wait_loop_index /= 100;
+  delay_us /= 100;
 #endif /* USE_STM32MP257CXX_EMU */
 
-  while(wait_loop_index != 0UL)
+  timeout = HAL_DDR_Get_Counter() + HAL_DDR_Us_To_Counter(delay_us);
+
+  while (HAL_DDR_Get_Counter() < timeout)
   {
-    wait_loop_index--;
   }
 }
 
-static __IO uint64_t phyinit_timeout_init_us(uint64_t timeout_us)
+static uint64_t phyinit_timeout_init_us(uint64_t timeout_us)
 {
-  __IO uint64_t wait_loop_index = 0U;
-
-  wait_loop_index = timeout_us * ((uint64_t)SystemCoreClock / (1000000UL * 2UL));
-
 #ifdef USE_STM32MP257CXX_EMU
-  wait_loop_index *= 10;
+  timeout_us *= 10;
 #endif /* USE_STM32MP257CXX_EMU */
 
-  return wait_loop_index;
+  return HAL_DDR_Get_Counter() + HAL_DDR_Us_To_Counter(timeout_us);
 }
 
-static bool phyinit_timeout_elapsed(__IO uint64_t timeout)
+static bool phyinit_timeout_elapsed(uint64_t timeout)
 {
-  if (timeout == 0U)
-  {
-    return true;
-  }
-
-  return false;
+  return HAL_DDR_Get_Counter() >= timeout;
 }
 
 static int32_t wait_uctwriteprotshadow(bool state)
 {
   uint16_t read_data;
   uint16_t value = state ? 1U : 0U;
-  __IO uint64_t timeout = phyinit_timeout_init_us(PHYINIT_TIMEOUT_US_1S);
+  uint64_t timeout = phyinit_timeout_init_us(PHYINIT_TIMEOUT_US_1S);
 
   do
   {
     read_data = mmio_read_16((uintptr_t)(DDRPHYC_BASE + ((4U * (TAPBONLY |
                                                                 CSR_UCTSHADOWREGS_ADDR)))));
-    timeout--;
     if (phyinit_timeout_elapsed(timeout))
     {
       return -1;
@@ -106,6 +169,89 @@ static int32_t ack_message_receipt(void)
   return 0;
 }
 
+static const char *fw_major_msg_name(uint32_t msg)
+{
+  uint32_t i;
+
+  for (i = 0U; i < (sizeof(fw_major_msg) / sizeof(fw_major_msg[0])); i++)
+  {
+    if (fw_major_msg[i].id == msg)
+    {
+      return fw_major_msg[i].name;
+    }
+  }
+
+  return "Unknown";
+}
+
+static void fw_log_add(uint32_t type, uint32_t value, uint64_t timestamp)
+{
+#if DDRPHY_PHYINIT_FW_LOG_SIZE > 0
+  fw_log_t *entry = &fw_log[fw_log_nb % DDRPHY_PHYINIT_FW_LOG_SIZE];
+
+  entry->timestamp = timestamp - fw_start;
+  entry->value = value;
+  entry->type = type;
+  fw_log_nb++;
+#else /* DDRPHY_PHYINIT_FW_LOG_SIZE > 0 */
+  (void)type;
+  (void)value;
+  (void)timestamp;
+#endif /* DDRPHY_PHYINIT_FW_LOG_SIZE > 0 */
+}
+
+/* Record the end of the training phase ended by the major message msg */
+static void fw_phase_add(uint32_t msg, uint64_t timestamp)
+{
+  if (fw_phase_nb < FW_PHASE_MAX)
+  {
+    fw_phase[fw_phase_nb].msg = msg;
+    fw_phase[fw_phase_nb].duration = timestamp - fw_end;
+    fw_phase_nb++;
+  }
+
+  fw_end = timestamp;
+}
+
+static void fw_phase_print(void)
+{
+  uint32_t i;
+
+  printf("training phases:\n\r");
+
+  for (i = 0U; i < fw_phase_nb; i++)
+  {
+    printf("  %-12s %8lu us\n\r", fw_major_msg_name(fw_phase[i].msg),
+           (unsigned long)HAL_DDR_Counter_To_Us(fw_phase[i].duration));
+  }
+
+  printf("  %-12s %8lu us\n\r", "total",
+         (unsigned long)HAL_DDR_Counter_To_Us(fw_end - fw_start));
+}
+
+#ifdef DDRPHY_PHYINIT_FW_TRACE
+static void fw_stream_print(uint32_t id, const uint32_t *args, uint32_t nb_args)
+{
+  const char *fmt = ddrphy_phyinit_usercustom_fwstring(id);
+  uint32_t i;
+
+  if ((fmt != NULL) && (nb_args <= FW_STREAM_ARG_MAX))
+  {
+    printf(fmt, args[0], args[1], args[2], args[3],
+           args[4], args[5], args[6], args[7]);
+    printf("\n\r");
+    return;
+  }
+
+  printf("  stream 0x%08x", (unsigned int)id);
+  for (i = 0U; (i < nb_args) && (i < FW_STREAM_ARG_MAX); i++)
+  {
+    printf(" 0x%x", (unsigned int)args[i]);
+  }
+  printf("\n\r");
+}
+#endif /* DDRPHY_PHYINIT_FW_TRACE */
+
 static int32_t get_major_message(uint32_t *msg)
 {
   uint32_t message_number;
@@ -182,10 +328,16 @@ static int32_t get_streaming_message(uint32_t *msg)
 int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void)
 {
   uint32_t fw_major_message;
+  uint64_t timestamp;
   int32_t ret;
 
   VERBOSE("%s Start\n", __func__);
 
+  fw_start = HAL_DDR_Get_Counter();
+  fw_end = fw_start;
+  fw_phase_nb = 0U;
+  fw_log_add(FW_LOG_START, 0U, fw_start);
+
   do
   {
     ret = get_major_message(&fw_major_message);
@@ -194,6 +346,9 @@ int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void)
       return ret;
     }
 
+    timestamp = HAL_DDR_Get_Counter();
+    fw_log_add(FW_LOG_MAJOR, fw_major_message, timestamp);
+
     VERBOSE("fw_major_message = %x\n", fw_major_message);
 
     if (fw_major_message == FW_MAJ_MSG_START_STREAMING)
@@ -201,6 +356,10 @@ int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void)
       uint32_t i;
       uint32_t read_data;
       uint32_t stream_len;
+#ifdef DDRPHY_PHYINIT_FW_TRACE
+      uint32_t args[FW_STREAM_ARG_MAX] = {0U};
+      uint32_t id;
+#endif /* DDRPHY_PHYINIT_FW_TRACE */
 
       ret = get_streaming_message(&read_data);
       if (ret != 0)
@@ -208,7 +367,12 @@ int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void)
         return ret;
       }
 
+      fw_log_add(FW_LOG_STREAM_ID, read_data, timestamp);
+
       stream_len = read_data & 0xFFFFU;
+#ifdef DDRPHY_PHYINIT_FW_TRACE
+      id = read_data;
+#endif /* DDRPHY_PHYINIT_FW_TRACE */
 
       for (i = 0U; i < stream_len; i++)
       {
@@ -218,14 +382,41 @@ int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void)
           return ret;
         }
 
+        fw_log_add(FW_LOG_STREAM_ARG, read_data, timestamp);
+
         VERBOSE("streaming message = %x\n", read_data);
+#ifdef DDRPHY_PHYINIT_FW_TRACE
+        if (i < FW_STREAM_ARG_MAX)
+        {
+          args[i] = read_data;
+        }
+#endif /* DDRPHY_PHYINIT_FW_TRACE */
       }
+
+#ifdef DDRPHY_PHYINIT_FW_TRACE
+      fw_stream_print(id, args, stream_len);
+#endif /* DDRPHY_PHYINIT_FW_TRACE */
+    }
+    else
+    {
+      /* Streaming messages are part of the current phase */
+      fw_phase_add(fw_major_message, timestamp);
+
+#ifdef DDRPHY_PHYINIT_FW_TRACE
+      printf("[%8lu us] %s (0x%02x)\n\r",
+             (unsigned long)HAL_DDR_Counter_To_Us(timestamp - fw_start),
+             fw_major_msg_name(fw_major_message), (unsigned int)fw_major_message);
+#endif /* DDRPHY_PHYINIT_FW_TRACE */
     }
   } while ((fw_major_message != FW_MAJ_MSG_TRAINING_SUCCESS) &&
            (fw_major_message != FW_MAJ_MSG_TRAINING_FAILED));
 
   phyinit_udelay(PHYINIT_DELAY_10US);
 
+#ifdef DDRPHY_PHYINIT_FW_TRACE
+  fw_phase_print();
+#endif /* DDRPHY_PHYINIT_FW_TRACE */
+
   if (fw_major_message == FW_MAJ_MSG_TRAINING_FAILED)
   {
     ERROR("%s Training has failed.\n", __func__);
@@ -236,3 +427,125 @@ int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void)
 
   return 0;
 }
+
+/*
+ * Returns the format string of a training firmware streaming message.
+ *
+ * The streaming messages are identified by their first word, the string index
+ * with the number of arguments in the lower 16 bits. The strings are delivered
+ * with the training firmware: the user can implement this function to decode
+ * the messages, printed with their arguments (without end of line) when
+ * DDRPHY_PHYINIT_FW_TRACE is defined.
+ *
+ * \return printf format string, NULL if the message is unknown.
+ */
+__weak const char *ddrphy_phyinit_usercustom_fwstring(__unused uint32_t id)
+{
+  return NULL;
+}
+
+/*
+ * Prints the phases of the last training firmware execution and the messages
+ * stored in the log (DDRPHY_PHYINIT_FW_LOG_SIZE entries, the older ones are
+ * lost).
+ */
+void ddrphy_phyinit_usercustom_fwlog_dump(void)
+{
+#if DDRPHY_PHYINIT_FW_LOG_SIZE > 0
+  uint32_t first = 0U;
+  uint32_t i;
+
+  if (fw_log_nb > DDRPHY_PHYINIT_FW_LOG_SIZE)
+  {
+    first = fw_log_nb - DDRPHY_PHYINIT_FW_LOG_SIZE;
+    printf("%lu older messages lost\n\r", (unsigned long)first);
+  }
+
+  for (i = first; i < fw_log_nb; i++)
+  {
+    const fw_log_t *entry = &fw_log[i % DDRPHY_PHYINIT_FW_LOG_SIZE];
+    const char *fmt;
+
+    switch (entry->type)
+    {
+      case FW_LOG_START:
+        printf("firmware start\n\r");
+        break;
+      case FW_LOG_MAJOR:
+        printf("[%8lu us] %s (0x%02x)\n\r",
+               (unsigned long)HAL_DDR_Counter_To_Us(entry->timestamp),
+               fw_major_msg_name(entry->value), (unsigned int)entry->value);
+        break;
+      case FW_LOG_STREAM_ID:
+        fmt = ddrphy_phyinit_usercustom_fwstring(entry->value);
+        printf("  stream 0x%08x %s\n\r", (unsigned int)entry->value,
+               (fmt != NULL) ? fmt : "");
+        break;
+      default:
+        printf("    0x%08x\n\r", (unsigned int)entry->value);
+        break;
+    }
+  }
+#else /* DDRPHY_PHYINIT_FW_LOG_SIZE > 0 */
+  printf("firmware log disabled (DDRPHY_PHYINIT_FW_LOG_SIZE = 0)\n\r");
+#endif /* DDRPHY_PHYINIT_FW_LOG_SIZE > 0 */
+
+  fw_phase_print();
+}
+
+/*
+ * Records the training result of a pstate, called by ddrphy_phyinit_sequence()
+ * after the firmware execution of each pstate. The training of pstate 0
+ * starts a new report.
+ *
+ * \param pstate  trained pstate.
+ * \param result  return value of the firmware execution, 0 on success.
+ */
+void ddrphy_phyinit_usercustom_g_trainresult(int32_t pstate, int32_t result)
+{
+  if ((pstate < 0) || (pstate >= NB_PS))
+  {
+    return;
+  }
+
+  if (pstate == 0)
+  {
+    fw_pstate_nb = 0;
+  }
+
+  fw_pstate[pstate].result = result;
+  fw_pstate[pstate].duration = fw_end - fw_start;
+  fw_pstate_nb = pstate + 1;
+}
+
+/*
+ * Prints the frequency, the training result and the firmware execution time of
+ * each pstate of the last training.
+ */
+void ddrphy_phyinit_usercustom_pstate_dump(void)
+{
+  int32_t pstate;
+
+  if (fw_pstate_nb == 0)
+  {
+    printf("no training executed\n\r");
+    return;
+  }
+
+  printf("pstate  frequency  training\n\r");
+
+  for (pstate = 0; pstate < userinputbasic.numpstates; pstate++)
+  {
+    printf("  %ld     %5ld MHz  ", (long)pstate, (long)userinputbasic.frequency[pstate]);
+
+    if (pstate >= fw_pstate_nb)
+    {
+      printf("not trained\n\r");
+    }
+    else
+    {
+      printf("%-6s %8lu us\n\r", (fw_pstate[pstate].result == 0) ? "passed" : "failed",
+             (unsigned long)HAL_DDR_Counter_To_Us(fw_pstate[pstate].duration));
+    }
+  }
+}
@@ -14,6 +14,118 @@
 
 #include "stm32mp2xx_hal_ddr_ddrphy_phyinit.h"
 
+/*
+ * Define DDRPHY_PHYINIT_USE_DMA (with HAL_DMA_MODULE_ENABLED) to load the SRAM
+ * with a HPDMA channel (DDRPHY_PHYINIT_DMA_CHANNEL) instead of CPU writes. The
+ * source buffers (firmware image and message block) shall not be in a cacheable
+ * area.
+ */
+#if defined(DDRPHY_PHYINIT_USE_DMA) && defined(HAL_DMA_MODULE_ENABLED) && \
+    !defined(USE_STM32MP257CXX_EMU)
+#ifndef DDRPHY_PHYINIT_DMA_CHANNEL
+#define DDRPHY_PHYINIT_DMA_CHANNEL    HPDMA1_Channel0
+#endif /* DDRPHY_PHYINIT_DMA_CHANNEL */
+#define DDRPHY_PHYINIT_DMA_TIMEOUT_MS 100U
+/* smaller transfers are faster with CPU writes than with the DMA setup */
+#define DDRPHY_PHYINIT_DMA_MIN_SIZE   64U
+
+/*
+ * Copies nb 16-bit values to consecutive CSRs with the HPDMA: each half-word
+ * read from the source is written as a zero-padded word, i.e. the 4 bytes
+ * stride of the CSRs in the APB address space.
+ */
+static HAL_StatusTypeDef phyinit_writeout_dma(const uint16_t *src, uint32_t mem_offset,
+                                              uint32_t nb)
+{
+  DMA_HandleTypeDef hdma = {0};
+  DMA_DataHandlingConfTypeDef handling;
+  HAL_StatusTypeDef ret;
+
+  __HAL_RCC_HPDMA1_CLK_ENABLE();
+
+  hdma.Instance = DDRPHY_PHYINIT_DMA_CHANNEL;
+  hdma.Init.Request = DMA_REQUEST_SW;
+  hdma.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  hdma.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  hdma.Init.SrcInc = DMA_SINC_INCREMENTED;
+  hdma.Init.DestInc = DMA_DINC_INCREMENTED;
+  hdma.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_HALFWORD;
+  hdma.Init.DestDataWidth = DMA_DEST_DATAWIDTH_WORD;
+  hdma.Init.Priority = DMA_HIGH_PRIORITY;
+  hdma.Init.SrcBurstLength = 1U;
+  hdma.Init.DestBurstLength = 1U;
+  hdma.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT1;
+  hdma.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  hdma.Init.Mode = DMA_NORMAL;
+
+  ret = HAL_DMA_Init(&hdma);
+  if (ret != HAL_OK)
+  {
+    return ret;
+  }
+
+  handling.DataExchange = DMA_EXCHANGE_NONE;
+  handling.DataAlignment = DMA_DATA_RIGHTALIGN_ZEROPADDED;
+  ret = HAL_DMAEx_ConfigDataHandling(&hdma, &handling);
+
+  if (ret == HAL_OK)
+  {
+    ret = HAL_DMA_Start(&hdma, (uint32_t)(uintptr_t)src,
+                        (uint32_t)(DDRPHYC_BASE + (4U * mem_offset)),
+                        nb * (uint32_t)sizeof(uint16_t));
+  }
+
+  if (ret == HAL_OK)
+  {
+    ret = HAL_DMA_PollForTransfer(&hdma, HAL_DMA_FULL_TRANSFER,
+                                  DDRPHY_PHYINIT_DMA_TIMEOUT_MS);
+  }
+
+  (void)HAL_DMA_DeInit(&hdma);
+
+  return ret;
+}
+#endif /* DDRPHY_PHYINIT_USE_DMA && HAL_DMA_MODULE_ENABLED && !USE_STM32MP257CXX_EMU */
+
+/*
+ * Copies nb 16-bit values to consecutive CSRs starting at mem_offset.
+ *
+ * The upper half of the 32-bit APB slots is not implemented, so the values are
+ * directly written without the read-modify-write of mmio_write_16(), with the
+ * loop unrolled by 8 to issue back to back APB writes.
+ */
+static void phyinit_writeout(const uint16_t *src, uint32_t mem_offset, uint32_t nb)
+{
+  volatile uint32_t *dst = (volatile uint32_t *)(DDRPHYC_BASE + (4U * mem_offset));
+  uint32_t index = 0U;
+
+#if defined(DDRPHY_PHYINIT_USE_DMA) && defined(HAL_DMA_MODULE_ENABLED) && \
+    !defined(USE_STM32MP257CXX_EMU)
+  if ((nb >= DDRPHY_PHYINIT_DMA_MIN_SIZE) &&
+      (phyinit_writeout_dma(src, mem_offset, nb) == HAL_OK))
+  {
+    return;
+  }
+#endif /* DDRPHY_PHYINIT_USE_DMA && HAL_DMA_MODULE_ENABLED && !USE_STM32MP257CXX_EMU */
+
+  for (; (index + 8U) <= nb; index += 8U)
+  {
+    dst[index] = src[index];
+    dst[index + 1U] = src[index + 1U];
+    dst[index + 2U] = src[index + 2U];
+    dst[index + 3U] = src[index + 3U];
+    dst[index + 4U] = src[index + 4U];
+    dst[index + 5U] = src[index + 5U];
+    dst[index + 6U] = src[index + 6U];
+    dst[index + 7U] = src[index + 7U];
+  }
+
+  for (; index < nb; index++)
+  {
+    dst[index] = src[index];
+  }
+}
+
 /*
  * Writes local memory content into the SRAM via APB interface.
  *
@@ -28,7 +140,9 @@
  */
 void ddrphy_phyinit_writeoutmem(const uint32_t *mem, uint32_t mem_offset, int32_t mem_size)
 {
+#ifdef USE_STM32MP257CXX_EMU
   uint32_t index;
+#endif /* USE_STM32MP257CXX_EMU */
 
   /*
    * 1. Enable access to the internal CSRs by setting the MicroContMuxSel CSR to 0.
@@ -36,22 +150,21 @@ void ddrphy_phyinit_writeoutmem(const uint32_t *mem, uint32_t mem_offset, int32_
    */
   mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TAPBONLY | CSR_MICROCONTMUXSEL_ADDR))), 0x0U);
 
+#ifdef USE_STM32MP257CXX_EMU
   for (index = 0; index < ((uint32_t)mem_size / sizeof(uint32_t)); index++)
   {
     uint32_t data = mem[index];
 
-#ifdef USE_STM32MP257CXX_EMU
     mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * ((index * 2U) + mem_offset))),
                   (uint16_t)((data >> 16) & 0xFFFFU));
     mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * ((index * 2U) + 1U + mem_offset))),
                   (uint16_t)(data & 0xFFFFU));
+  }
 #else /* USE_STM32MP257CXX_EMU */
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * ((index * 2U) + mem_offset))),
-                  (uint16_t)(data & 0xFFFFU));
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * ((index * 2U) + 1U + mem_offset))),
-                  (uint16_t)((data >> 16) & 0xFFFFU));
+  /* Little endian: the low half-word of each 32-bit word is written first */
+  phyinit_writeout((const uint16_t *)mem, mem_offset,
+                   ((uint32_t)mem_size / sizeof(uint32_t)) * 2U);
 #endif /* USE_STM32MP257CXX_EMU */
-  }
 
   /*
    * 2. Isolate the APB access from the internal CSRs by setting the MicroContMuxSel CSR to 1.
@@ -65,19 +178,13 @@ void ddrphy_phyinit_writeoutmem(const uint32_t *mem, uint32_t mem_offset, int32_
  */
 void ddrphy_phyinit_writeoutmsgblk(uint16_t *mem, uint32_t mem_offset, int32_t mem_size)
 {
-  uint32_t index;
-
   /*
    * 1. Enable access to the internal CSRs by setting the MicroContMuxSel CSR to 0.
    *    This allows the memory controller unrestricted access to the configuration CSRs.
    */
   mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TAPBONLY | CSR_MICROCONTMUXSEL_ADDR))), 0x0U);
 
-
-  for (index = 0; index < ((uint32_t)mem_size / sizeof(uint16_t)); index++)
-  {
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (index + mem_offset))), mem[index]);
-  }
+  phyinit_writeout(mem, mem_offset, (uint32_t)mem_size / sizeof(uint16_t));
 
   /*
    * 2. Isolate the APB access from the internal CSRs by setting the MicroContMuxSel CSR to 1.
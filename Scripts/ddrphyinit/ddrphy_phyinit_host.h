@@ -0,0 +1,34 @@
+/**
+  ******************************************************************************
+  * @file    ddrphy_phyinit_host.h
+  * @author  MCD Application Team
+  * @brief   Replaces stm32mp2xx_hal.h in the host build of PhyInit
+  *          (DDRPHY_PHYINIT_HOST): the PHY registers are not accessed, the
+  *          writes are recorded by ddrphyinit_gen.c.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDRPHY_PHYINIT_HOST_H
+#define __DDRPHY_PHYINIT_HOST_H
+
+#include <stdint.h>
+
+#ifndef __unused
+#define __unused __attribute__((unused))
+#endif /* __unused */
+
+/* Register address divided by 4 is the register index of the PHY */
+#define DDRPHYC_BASE 0UL
+
+#endif /* __DDRPHY_PHYINIT_HOST_H */
@@ -0,0 +1,397 @@
+/**
+  ******************************************************************************
+  * @file    ddrphyinit_gen.c
+  * @author  MCD Application Team
+  * @brief   Host generator of the PhyInit results of a static DDR
+  *          configuration: executes ddrphy_phyinit_initstruct(),
+  *          ddrphy_phyinit_calcmb() and ddrphy_phyinit_c_initphyconfig() of
+  *          the HAL sources with the user inputs of the DDR settings header,
+  *          then writes the message blocks and the register writes in a
+  *          header loaded by ddrphy_phyinit_loadprecomp().
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32mp2xx_hal_ddr_ddrphy_phyinit.h"
+
+/* The DDR settings header is included by the Makefile (-include) */
+#ifndef DDR_MEM_NAME
+#error "no DDR settings defined."
+#endif /* DDR_MEM_NAME */
+
+#include "stm32mp2xx_hal_ddr_pstate.h"
+
+#if (STM32MP_DDR3_TYPE && (DDR_UIB_DRAMTYPE != DDR_DRAMTYPE_DDR3)) || \
+    (STM32MP_DDR4_TYPE && (DDR_UIB_DRAMTYPE != DDR_DRAMTYPE_DDR4)) || \
+    (STM32MP_LPDDR4_TYPE && (DDR_UIB_DRAMTYPE != DDR_DRAMTYPE_LPDDR4))
+#error "DDR settings of another DDR type."
+#endif
+
+/* Private define ------------------------------------------------------------*/
+#if STM32MP_DDR3_TYPE
+#define GEN_TYPE "STM32MP_DDR3_TYPE"
+#elif STM32MP_DDR4_TYPE
+#define GEN_TYPE "STM32MP_DDR4_TYPE"
+#elif STM32MP_LPDDR4_TYPE
+#define GEN_TYPE "STM32MP_LPDDR4_TYPE"
+#endif /* STM32MP_LPDDR4_TYPE */
+
+/* values per line of the generated tables */
+#define GEN_LINE 8U
+
+/* Private variables ---------------------------------------------------------*/
+/* User inputs of the DDR settings, as static_ddr_config of stm32mp2xx_hal_ddr.c */
+static const user_input_basic_t uib_conf =
+{
+  .dramtype           = DDR_UIB_DRAMTYPE,
+  .dimmtype           = DDR_UIB_DIMMTYPE,
+  .lp4xmode           = DDR_UIB_LP4XMODE,
+  .numdbyte           = DDR_UIB_NUMDBYTE,
+  .numactivedbytedfi0 = DDR_UIB_NUMACTIVEDBYTEDFI0,
+  .numactivedbytedfi1 = DDR_UIB_NUMACTIVEDBYTEDFI1,
+  .numanib            = DDR_UIB_NUMANIB,
+  .numrank_dfi0       = DDR_UIB_NUMRANK_DFI0,
+  .numrank_dfi1       = DDR_UIB_NUMRANK_DFI1,
+  .dramdatawidth      = DDR_UIB_DRAMDATAWIDTH,
+  .numpstates         = DDR_UIB_NUMPSTATES,
+  .frequency[0]       = DDR_UIB_FREQUENCY_0,
+  .pllbypass[0]       = DDR_UIB_PLLBYPASS_0,
+  .dfifreqratio[0]    = DDR_UIB_DFIFREQRATIO_0,
+  .dfi1exists         = DDR_UIB_DFI1EXISTS,
+  .train2d            = DDR_UIB_TRAIN2D,
+  .hardmacrover       = DDR_UIB_HARDMACROVER,
+  .readdbienable[0]   = DDR_UIB_READDBIENABLE_0,
+  .dfimode            = DDR_UIB_DFIMODE,
+#if NB_PS > 1
+  .frequency[1]       = DDR_UIB_FREQUENCY_1,
+  .pllbypass[1]       = DDR_UIB_PLLBYPASS_1,
+  .dfifreqratio[1]    = DDR_UIB_DFIFREQRATIO_1,
+  .readdbienable[1]   = DDR_UIB_READDBIENABLE_1
+#endif /* NB_PS > 1 */
+};
+
+static const user_input_advanced_t uia_conf =
+{
+  .lp4rxpreamblemode[0]    = DDR_UIA_LP4RXPREAMBLEMODE_0,
+  .lp4postambleext[0]      = DDR_UIA_LP4POSTAMBLEEXT_0,
+  .d4rxpreamblelength[0]   = DDR_UIA_D4RXPREAMBLELENGTH_0,
+  .d4txpreamblelength[0]   = DDR_UIA_D4TXPREAMBLELENGTH_0,
+  .extcalresval            = DDR_UIA_EXTCALRESVAL,
+  .is2ttiming[0]           = DDR_UIA_IS2TTIMING_0,
+  .odtimpedance[0]         = DDR_UIA_ODTIMPEDANCE_0,
+  .tximpedance[0]          = DDR_UIA_TXIMPEDANCE_0,
+  .atximpedance            = DDR_UIA_ATXIMPEDANCE,
+  .memalerten              = DDR_UIA_MEMALERTEN,
+  .memalertpuimp           = DDR_UIA_MEMALERTPUIMP,
+  .memalertvreflevel       = DDR_UIA_MEMALERTVREFLEVEL,
+  .memalertsyncbypass      = DDR_UIA_MEMALERTSYNCBYPASS,
+  .disdynadrtri[0]         = DDR_UIA_DISDYNADRTRI_0,
+  .phymstrtraininterval[0] = DDR_UIA_PHYMSTRTRAININTERVAL_0,
+  .phymstrmaxreqtoack[0]   = DDR_UIA_PHYMSTRMAXREQTOACK_0,
+  .wdqsext                 = DDR_UIA_WDQSEXT,
+  .calinterval             = DDR_UIA_CALINTERVAL,
+  .calonce                 = DDR_UIA_CALONCE,
+  .lp4rl[0]                = DDR_UIA_LP4RL_0,
+  .lp4wl[0]                = DDR_UIA_LP4WL_0,
+  .lp4wls[0]               = DDR_UIA_LP4WLS_0,
+  .lp4dbird[0]             = DDR_UIA_LP4DBIRD_0,
+  .lp4dbiwr[0]             = DDR_UIA_LP4DBIWR_0,
+  .lp4nwr[0]               = DDR_UIA_LP4NWR_0,
+  .lp4lowpowerdrv          = DDR_UIA_LP4LOWPOWERDRV,
+  .drambyteswap            = DDR_UIA_DRAMBYTESWAP,
+  .rxenbackoff             = DDR_UIA_RXENBACKOFF,
+  .trainsequencectrl       = DDR_UIA_TRAINSEQUENCECTRL,
+  .snpsumctlopt            = DDR_UIA_SNPSUMCTLOPT,
+  .snpsumctlf0rc5x[0]      = DDR_UIA_SNPSUMCTLF0RC5X_0,
+  .txslewrisedq[0]         = DDR_UIA_TXSLEWRISEDQ_0,
+  .txslewfalldq[0]         = DDR_UIA_TXSLEWFALLDQ_0,
+  .txslewriseac            = DDR_UIA_TXSLEWRISEAC,
+  .txslewfallac            = DDR_UIA_TXSLEWFALLAC,
+  .disableretraining       = DDR_UIA_DISABLERETRAINING,
+  .disablephyupdate        = DDR_UIA_DISABLEPHYUPDATE,
+  .enablehighclkskewfix    = DDR_UIA_ENABLEHIGHCLKSKEWFIX,
+  .disableunusedaddrlns    = DDR_UIA_DISABLEUNUSEDADDRLNS,
+  .phyinitsequencenum      = DDR_UIA_PHYINITSEQUENCENUM,
+  .enabledficspolarityfix  = DDR_UIA_ENABLEDFICSPOLARITYFIX,
+  .phyvref                 = DDR_UIA_PHYVREF,
+  .sequencectrl[0]         = DDR_UIA_SEQUENCECTRL_0,
+#if NB_PS > 1
+  .lp4rxpreamblemode[1]    = DDR_UIA_LP4RXPREAMBLEMODE_1,
+  .lp4postambleext[1]      = DDR_UIA_LP4POSTAMBLEEXT_1,
+  .d4rxpreamblelength[1]   = DDR_UIA_D4RXPREAMBLELENGTH_1,
+  .d4txpreamblelength[1]   = DDR_UIA_D4TXPREAMBLELENGTH_1,
+  .is2ttiming[1]           = DDR_UIA_IS2TTIMING_1,
+  .odtimpedance[1]         = DDR_UIA_ODTIMPEDANCE_1,
+  .tximpedance[1]          = DDR_UIA_TXIMPEDANCE_1,
+  .disdynadrtri[1]         = DDR_UIA_DISDYNADRTRI_1,
+  .phymstrtraininterval[1] = DDR_UIA_PHYMSTRTRAININTERVAL_1,
+  .phymstrmaxreqtoack[1]   = DDR_UIA_PHYMSTRMAXREQTOACK_1,
+  .lp4rl[1]                = DDR_UIA_LP4RL_1,
+  .lp4wl[1]                = DDR_UIA_LP4WL_1,
+  .lp4wls[1]               = DDR_UIA_LP4WLS_1,
+  .lp4dbird[1]             = DDR_UIA_LP4DBIRD_1,
+  .lp4dbiwr[1]             = DDR_UIA_LP4DBIWR_1,
+  .lp4nwr[1]               = DDR_UIA_LP4NWR_1,
+  .snpsumctlf0rc5x[1]      = DDR_UIA_SNPSUMCTLF0RC5X_1,
+  .txslewrisedq[1]         = DDR_UIA_TXSLEWRISEDQ_1,
+  .txslewfalldq[1]         = DDR_UIA_TXSLEWFALLDQ_1,
+  .sequencectrl[1]         = DDR_UIA_SEQUENCECTRL_1
+#endif /* NB_PS > 1 */
+};
+
+static const user_input_mode_register_t uim_conf =
+{
+  .mr0[0]  = DDR_UIM_MR0_0,
+  .mr1[0]  = DDR_UIM_MR1_0,
+  .mr2[0]  = DDR_UIM_MR2_0,
+  .mr3[0]  = DDR_UIM_MR3_0,
+  .mr4[0]  = DDR_UIM_MR4_0,
+  .mr5[0]  = DDR_UIM_MR5_0,
+  .mr6[0]  = DDR_UIM_MR6_0,
+  .mr11[0] = DDR_UIM_MR11_0,
+  .mr12[0] = DDR_UIM_MR12_0,
+  .mr13[0] = DDR_UIM_MR13_0,
+  .mr14[0] = DDR_UIM_MR14_0,
+  .mr22[0] = DDR_UIM_MR22_0,
+#if NB_PS > 1
+  .mr0[1]  = DDR_UIM_MR0_1,
+  .mr1[1]  = DDR_UIM_MR1_1,
+  .mr2[1]  = DDR_UIM_MR2_1,
+  .mr3[1]  = DDR_UIM_MR3_1,
+  .mr4[1]  = DDR_UIM_MR4_1,
+  .mr5[1]  = DDR_UIM_MR5_1,
+  .mr6[1]  = DDR_UIM_MR6_1,
+  .mr11[1] = DDR_UIM_MR11_1,
+  .mr12[1] = DDR_UIM_MR12_1,
+  .mr13[1] = DDR_UIM_MR13_1,
+  .mr14[1] = DDR_UIM_MR14_1,
+  .mr22[1] = DDR_UIM_MR22_1
+#endif /* NB_PS > 1 */
+};
+
+static const user_input_swizzle_t uis_conf =
+{
+  .swizzle[0]  = DDR_UIS_SWIZZLE_0,
+  .swizzle[1]  = DDR_UIS_SWIZZLE_1,
+  .swizzle[2]  = DDR_UIS_SWIZZLE_2,
+  .swizzle[3]  = DDR_UIS_SWIZZLE_3,
+  .swizzle[4]  = DDR_UIS_SWIZZLE_4,
+  .swizzle[5]  = DDR_UIS_SWIZZLE_5,
+  .swizzle[6]  = DDR_UIS_SWIZZLE_6,
+  .swizzle[7]  = DDR_UIS_SWIZZLE_7,
+  .swizzle[8]  = DDR_UIS_SWIZZLE_8,
+  .swizzle[9]  = DDR_UIS_SWIZZLE_9,
+  .swizzle[10] = DDR_UIS_SWIZZLE_10,
+  .swizzle[11] = DDR_UIS_SWIZZLE_11,
+  .swizzle[12] = DDR_UIS_SWIZZLE_12,
+  .swizzle[13] = DDR_UIS_SWIZZLE_13,
+  .swizzle[14] = DDR_UIS_SWIZZLE_14,
+  .swizzle[15] = DDR_UIS_SWIZZLE_15,
+  .swizzle[16] = DDR_UIS_SWIZZLE_16,
+  .swizzle[17] = DDR_UIS_SWIZZLE_17,
+  .swizzle[18] = DDR_UIS_SWIZZLE_18,
+  .swizzle[19] = DDR_UIS_SWIZZLE_19,
+  .swizzle[20] = DDR_UIS_SWIZZLE_20,
+  .swizzle[21] = DDR_UIS_SWIZZLE_21,
+  .swizzle[22] = DDR_UIS_SWIZZLE_22,
+  .swizzle[23] = DDR_UIS_SWIZZLE_23,
+  .swizzle[24] = DDR_UIS_SWIZZLE_24,
+  .swizzle[25] = DDR_UIS_SWIZZLE_25,
+  .swizzle[26] = DDR_UIS_SWIZZLE_26,
+  .swizzle[27] = DDR_UIS_SWIZZLE_27,
+  .swizzle[28] = DDR_UIS_SWIZZLE_28,
+  .swizzle[29] = DDR_UIS_SWIZZLE_29,
+  .swizzle[30] = DDR_UIS_SWIZZLE_30,
+  .swizzle[31] = DDR_UIS_SWIZZLE_31,
+  .swizzle[32] = DDR_UIS_SWIZZLE_32,
+  .swizzle[33] = DDR_UIS_SWIZZLE_33,
+  .swizzle[34] = DDR_UIS_SWIZZLE_34,
+  .swizzle[35] = DDR_UIS_SWIZZLE_35,
+  .swizzle[36] = DDR_UIS_SWIZZLE_36,
+  .swizzle[37] = DDR_UIS_SWIZZLE_37,
+  .swizzle[38] = DDR_UIS_SWIZZLE_38,
+  .swizzle[39] = DDR_UIS_SWIZZLE_39,
+  .swizzle[40] = DDR_UIS_SWIZZLE_40,
+  .swizzle[41] = DDR_UIS_SWIZZLE_41,
+  .swizzle[42] = DDR_UIS_SWIZZLE_42,
+  .swizzle[43] = DDR_UIS_SWIZZLE_43
+};
+
+/* Register writes of ddrphy_phyinit_c_initphyconfig() */
+static reg_addr_val_t *regs;
+static uint32_t numregs;
+static uint32_t maxregs;
+
+/* Exported functions --------------------------------------------------------*/
+/* Register accesses of the host build of PhyInit */
+void mmio_write_16(uintptr_t addr, uint16_t value)
+{
+  if (numregs == maxregs)
+  {
+    maxregs = (maxregs == 0U) ? 256U : (maxregs * 2U);
+    regs = realloc(regs, maxregs * sizeof(reg_addr_val_t));
+    if (regs == NULL)
+    {
+      fprintf(stderr, "out of memory\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  regs[numregs].address = (uint32_t)((addr - DDRPHYC_BASE) / 4U);
+  regs[numregs].value = value;
+  numregs++;
+}
+
+uint16_t mmio_read_16(uintptr_t addr)
+{
+  fprintf(stderr, "register 0x%lx read: not supported on host\n",
+          (unsigned long)((addr - DDRPHYC_BASE) / 4U));
+  exit(EXIT_FAILURE);
+}
+
+void mmio_write_32(uintptr_t addr, uint32_t value)
+{
+  fprintf(stderr, "register 0x%lx 32-bit write 0x%08x: not supported on host\n",
+          (unsigned long)((addr - DDRPHYC_BASE) / 4U), value);
+  exit(EXIT_FAILURE);
+}
+
+/* Private functions ---------------------------------------------------------*/
+static void gen_words(FILE *out, const char *name, const void *data, size_t size)
+{
+  const uint16_t *word = (const uint16_t *)data;
+  size_t nb = size / sizeof(uint16_t);
+  size_t i;
+
+  fprintf(out, "static const uint16_t %s[%zu] =\n{", name, nb);
+  for (i = 0U; i < nb; i++)
+  {
+    fprintf(out, "%s0x%04xU%s", ((i % GEN_LINE) == 0U) ? "\n  " : " ", word[i],
+            (i == (nb - 1U)) ? "" : ",");
+  }
+  fprintf(out, "\n};\n\n");
+}
+
+static void gen_header(FILE *out, const char *conf, uint32_t uihash)
+{
+  const char *name = strrchr(conf, '/');
+  uint32_t i;
+  int32_t ps;
+
+  name = (name == NULL) ? conf : (name + 1);
+
+  fprintf(out, "/*\n"
+          " * PhyInit results of %s\n"
+          " * from %s,\n"
+          " * generated by Scripts/ddrphyinit: do not edit.\n"
+          " */\n\n", DDR_MEM_NAME, name);
+  fprintf(out, "#ifndef __STM32MP_UTIL_DDR_PHYINIT_H\n"
+          "#define __STM32MP_UTIL_DDR_PHYINIT_H\n\n"
+          "#include \"stm32mp2xx_hal_ddr_ddrphy_phyinit.h\"\n\n");
+  fprintf(out, "#if !%s || (NB_PS != %d)\n"
+          "#error \"PhyInit results generated for another DDR type.\"\n"
+          "#endif\n\n", GEN_TYPE, NB_PS);
+
+  gen_words(out, "ddrphy_phyinit_precomp_mb", mb_ddr_1d, sizeof(mb_ddr_1d));
+  gen_words(out, "ddrphy_phyinit_precomp_shdw", shdw_ddr_1d, sizeof(shdw_ddr_1d));
+
+  fprintf(out, "static const reg_addr_val_t ddrphy_phyinit_precomp_regs[%u] =\n{\n",
+          numregs);
+  for (i = 0U; i < numregs; i++)
+  {
+    fprintf(out, "  { 0x%05xU, 0x%04xU }%s\n", regs[i].address, regs[i].value,
+            (i == (numregs - 1U)) ? "" : ",");
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "static const phyinit_precomp_t ddrphy_phyinit_precomp =\n{\n");
+  fprintf(out, "  .uihash        = 0x%08xU,\n", uihash);
+  fprintf(out, "  .mbsize        = %zuU,\n", sizeof(pmu_smb_ddr_1d_t));
+  fprintf(out, "  .mb            = ddrphy_phyinit_precomp_mb,\n");
+  fprintf(out, "  .shdw          = ddrphy_phyinit_precomp_shdw,\n");
+  fprintf(out, "  .ardptrinitval = {");
+  for (ps = 0; ps < NB_PS; ps++)
+  {
+    fprintf(out, " %d%s", ardptrinitval[ps], (ps == (NB_PS - 1)) ? " " : ",");
+  }
+  fprintf(out, "},\n");
+  fprintf(out, "  .numregs       = %uU,\n", numregs);
+  fprintf(out, "  .regs          = ddrphy_phyinit_precomp_regs\n");
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "#endif /* __STM32MP_UTIL_DDR_PHYINIT_H */\n");
+}
+
+/**
+  * @brief  Generates the header of the PhyInit results.
+  *         ddrphyinit_gen <output header> <DDR settings header name>
+  * @retval 0 on success, else 1
+  */
+int main(int argc, char *argv[])
+{
+  uint32_t uihash;
+  FILE *out;
+
+  if (argc != 3)
+  {
+    fprintf(stderr, "usage: %s <output header> <DDR settings header>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  userinputbasic = uib_conf;
+  userinputadvanced = uia_conf;
+  userinputmoderegister = uim_conf;
+  userinputswizzle = uis_conf;
+
+  /* Key of the table: user inputs before the PhyInit sequence */
+  uihash = ddrphy_phyinit_uihash();
+
+  /* Same steps as ddrphy_phyinit_sequence() */
+  ddrphy_phyinit_initstruct();
+
+  if ((ddrphy_phyinit_calcmb() != 0) || (ddrphy_phyinit_c_initphyconfig() != 0))
+  {
+    fprintf(stderr, "%s: PhyInit calculation failed\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  if (uihash != ddrphy_phyinit_uihash())
+  {
+    fprintf(stderr, "%s: user inputs modified by PhyInit\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  out = fopen(argv[1], "w");
+  if (out == NULL)
+  {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  gen_header(out, argv[2], uihash);
+
+  if (fclose(out) != 0)
+  {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  printf("%s: %s, %u register writes, hash 0x%08x\n", argv[1], DDR_MEM_NAME,
+         numregs, uihash);
+
+  return EXIT_SUCCESS;
+}
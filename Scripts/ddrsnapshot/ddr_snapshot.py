@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+#
+#  ******************************************************************************
+#  * @attention
+#  *
+#  * Copyright (c) 2023 STMicroelectronics.
+#  * All rights reserved.
+#  *
+#  * This software is licensed under terms that can be found in the LICENSE file
+#  * in the root directory of this software component.
+#  * If no LICENSE file comes with this software, it is provided AS-IS.
+#  *
+#  ******************************************************************************
+#
+# Decoder of the DDR register snapshots of the DDR tool.
+#
+# The inputs are console logs containing the output of "snap layout" (register
+# names, once per firmware) and of "snap dump <n>", or binary snapshot files
+# written with --bin. The snapshots are printed with the register names, or
+# compared with --diff (first snapshot against each following one).
+#
+#   ddr_snapshot.py good.log
+#   ddr_snapshot.py --diff good.log bad.log
+#   ddr_snapshot.py --bin out good.log      (out_0.bin, out_1.bin...)
+
+import argparse
+import re
+import struct
+import sys
+import zlib
+
+SNAP_MAGIC = 0x50414E53
+SNAP_VERSION = 1
+SNAP_HEADER = "<IHHIIII"
+
+
+class Snapshot:
+    def __init__(self, data, origin):
+        size = struct.calcsize(SNAP_HEADER)
+        if len(data) < size:
+            raise ValueError("{}: truncated snapshot".format(origin))
+
+        (magic, self.version, header_size, self.layout, nb, self.speed,
+         crc) = struct.unpack_from(SNAP_HEADER, data)
+        if magic != SNAP_MAGIC:
+            raise ValueError("{}: not a snapshot".format(origin))
+        if self.version != SNAP_VERSION:
+            raise ValueError("{}: unsupported version {}".format(origin,
+                                                                 self.version))
+
+        values = data[header_size:header_size + 4 * nb]
+        if len(values) != 4 * nb:
+            raise ValueError("{}: truncated snapshot".format(origin))
+        if zlib.crc32(values) != crc:
+            raise ValueError("{}: bad CRC".format(origin))
+
+        self.data = data[:header_size + 4 * nb]
+        self.values = struct.unpack("<{}I".format(nb), values)
+        self.origin = origin
+
+
+def parse_log(path, layouts, snapshots):
+    names = None
+    hexdata = None
+    count = 0
+
+    with open(path, "r", errors="replace") as file:
+        for line in file:
+            line = line.strip()
+            words = line.split()
+            if not words:
+                continue
+
+            if words[0] == "LAYOUT" and len(words) == 3 and words[1] != "END":
+                if names is None:
+                    names = []
+                else:
+                    names.append(words[2])
+            elif words[0] == "LAYOUT" and words[1:] == ["END"]:
+                text = "".join(name + "\n" for name in names)
+                layouts[zlib.crc32(text.encode())] = names
+                names = None
+            elif words[0] == "SNAP" and len(words) > 1 and words[1] == "BEGIN":
+                hexdata = ""
+            elif words[0] == "SNAP" and words[1:] == ["END"]:
+                origin = "{}#{}".format(path, count)
+                snapshots.append(Snapshot(bytes.fromhex(hexdata), origin))
+                hexdata = None
+                count += 1
+            elif words[0] == "SNAP" and hexdata is not None and \
+                    re.fullmatch("[0-9a-fA-F]+", words[1]):
+                hexdata += words[1]
+
+
+def load(paths):
+    layouts = {}
+    snapshots = []
+
+    for path in paths:
+        with open(path, "rb") as file:
+            data = file.read()
+        if data[:4] == struct.pack("<I", SNAP_MAGIC):
+            snapshots.append(Snapshot(data, path))
+        else:
+            parse_log(path, layouts, snapshots)
+
+    return layouts, snapshots
+
+
+def reg_name(layouts, snap, i):
+    names = layouts.get(snap.layout)
+    if names is None or i >= len(names):
+        return "#{}".format(i)
+    return names[i]
+
+
+def print_snapshot(layouts, snap):
+    print("{}: {} registers at {} kHz".format(snap.origin, len(snap.values),
+                                              snap.speed))
+    if snap.layout not in layouts:
+        print("  layout {:08x} unknown, add the output of 'snap layout'"
+              .format(snap.layout))
+    for i, value in enumerate(snap.values):
+        print("  {} = 0x{:08x}".format(reg_name(layouts, snap, i), value))
+
+
+def diff_snapshot(layouts, ref, snap):
+    print("{} -> {}".format(ref.origin, snap.origin))
+    if ref.layout != snap.layout or len(ref.values) != len(snap.values):
+        print("  snapshots of different register layouts")
+        return
+    if ref.speed != snap.speed:
+        print("  speed: {} -> {} kHz".format(ref.speed, snap.speed))
+
+    nb = 0
+    for i, (old, new) in enumerate(zip(ref.values, snap.values)):
+        if old != new:
+            print("  {}: 0x{:08x} -> 0x{:08x} (bits 0x{:08x})".format(
+                reg_name(layouts, snap, i), old, new, old ^ new))
+            nb += 1
+    print("  {}/{} registers changed".format(nb, len(snap.values)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode DDR register snapshots")
+    parser.add_argument('inputs', nargs='+', help='console logs or binary snapshots')
+    parser.add_argument('-d', '--diff', action='store_true',
+                        help='compare the first snapshot to the others')
+    parser.add_argument('-b', '--bin', metavar='PREFIX',
+                        help='write the snapshots in PREFIX_<n>.bin')
+
+    args = parser.parse_args()
+
+    try:
+        layouts, snapshots = load(args.inputs)
+    except (OSError, ValueError) as err:
+        print(err)
+        return 1
+
+    if not snapshots:
+        print("no snapshot found")
+        return 1
+
+    if args.bin:
+        for i, snap in enumerate(snapshots):
+            name = "{}_{}.bin".format(args.bin, i)
+            with open(name, "wb") as file:
+                file.write(snap.data)
+            print("{} written".format(name))
+    elif args.diff:
+        for snap in snapshots[1:]:
+            diff_snapshot(layouts, snapshots[0], snap)
+    else:
+        for snap in snapshots:
+            print_snapshot(layouts, snap)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())